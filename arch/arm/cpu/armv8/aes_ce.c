@@ -0,0 +1,62 @@
+/*
+ * AES using the ARMv8 Crypto Extensions, see aes_ce_asm.S
+ *
+ * The AES instructions are optional, so ID_AA64ISAR0_EL1 is checked on each
+ * call. Data and keys are read with byte-element loads, so no alignment is
+ * needed.
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <errno.h>
+#include <uboot_aes.h>
+
+#define ID_AA64ISAR0_AES_SHIFT		4
+
+void aes_ce_encrypt_blocks(const u32 *rk, int rounds, u8 *iv, const u8 *src,
+			   u8 *dst, uint blocks);
+void aes_ce_cbc_encrypt(const u32 *rk, int rounds, u8 *iv, const u8 *src,
+			u8 *dst, uint blocks);
+void aes_ce_cbc_decrypt(const u32 *rk, int rounds, u8 *iv, const u8 *src,
+			u8 *dst, uint blocks);
+
+static bool cpu_has_aes(void)
+{
+	u64 isar0;
+
+	asm volatile("mrs %0, id_aa64isar0_el1" : "=r" (isar0));
+
+	return ((isar0 >> ID_AA64ISAR0_AES_SHIFT) & 0xf) != 0;
+}
+
+int arch_aes_encrypt_blocks(const struct aes_ctx *ctx, const u8 *src, u8 *dst,
+			    u32 blocks)
+{
+	if (!cpu_has_aes())
+		return -ENOSYS;
+	aes_ce_encrypt_blocks(ctx->enc_key, ctx->rounds, NULL, src, dst,
+			      blocks);
+
+	return 0;
+}
+
+int arch_aes_cbc_encrypt(const struct aes_ctx *ctx, u8 *iv, const u8 *src,
+			 u8 *dst, u32 blocks)
+{
+	if (!cpu_has_aes())
+		return -ENOSYS;
+	aes_ce_cbc_encrypt(ctx->enc_key, ctx->rounds, iv, src, dst, blocks);
+
+	return 0;
+}
+
+int arch_aes_cbc_decrypt(const struct aes_ctx *ctx, u8 *iv, const u8 *src,
+			 u8 *dst, u32 blocks)
+{
+	if (!cpu_has_aes())
+		return -ENOSYS;
+	aes_ce_cbc_decrypt(ctx->dec_key, ctx->rounds, iv, src, dst, blocks);
+
+	return 0;
+}
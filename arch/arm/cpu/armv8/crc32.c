@@ -0,0 +1,50 @@
+/*
+ * CRC32 and CRC32C using the ARMv8 CRC32 instructions
+ *
+ * The instructions are optional in ARMv8.0, so ID_AA64ISAR0_EL1 is checked
+ * on each call. Data is read with aligned loads only, since this may run
+ * before the MMU is on, when unaligned accesses to memory fault.
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <errno.h>
+#include <u-boot/crc.h>
+
+#define ID_AA64ISAR0_CRC32_SHIFT	16
+
+static bool cpu_has_crc32(void)
+{
+	u64 isar0;
+
+	asm volatile("mrs %0, id_aa64isar0_el1" : "=r" (isar0));
+
+	return ((isar0 >> ID_AA64ISAR0_CRC32_SHIFT) & 0xf) != 0;
+}
+
+#define CRC32_INSN(insn, reg, crc, val) \
+	asm(".arch armv8-a+crc\n" \
+	    insn " %w0, %w0, %" reg "1" : "+r" (crc) : "r" (val))
+
+#define DEFINE_CRC32_FUNC(name, prefix)					\
+int name(uint32_t *crcp, const unsigned char *buf, uint len)		\
+{									\
+	uint32_t crc = *crcp;						\
+									\
+	if (!cpu_has_crc32())						\
+		return -ENOSYS;						\
+									\
+	for (; len && ((ulong)buf & 7); len--)				\
+		CRC32_INSN(prefix "b", "w", crc, *buf++);		\
+	for (; len >= 8; len -= 8, buf += 8)				\
+		CRC32_INSN(prefix "x", "x", crc, *(const u64 *)buf);	\
+	for (; len; len--)						\
+		CRC32_INSN(prefix "b", "w", crc, *buf++);		\
+	*crcp = crc;							\
+									\
+	return 0;							\
+}
+
+DEFINE_CRC32_FUNC(arch_crc32_le, "crc32")
+DEFINE_CRC32_FUNC(arch_crc32c_le, "crc32c")
@@ -0,0 +1,51 @@
+/*
+ * SHA-1 and SHA-256 using the ARMv8 Crypto Extensions, see sha_ce_asm.S
+ *
+ * The SHA instructions are optional, so ID_AA64ISAR0_EL1 is checked on each
+ * call. The message is read with 32-bit element loads, which fault on
+ * unaligned addresses while the MMU is off, so unaligned data is left to
+ * the generic C code.
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <errno.h>
+#include <u-boot/sha1.h>
+#include <u-boot/sha256.h>
+
+#define ID_AA64ISAR0_SHA1_SHIFT		8
+#define ID_AA64ISAR0_SHA2_SHIFT		12
+
+void sha1_ce_blocks(uint32_t state[5], const uint8_t *data, uint blocks);
+void sha256_ce_blocks(uint32_t state[8], const uint8_t *data, uint blocks);
+
+static bool cpu_has_sha(int shift, const uint8_t *data)
+{
+	u64 isar0;
+
+	if ((ulong)data & 3)
+		return false;
+
+	asm volatile("mrs %0, id_aa64isar0_el1" : "=r" (isar0));
+
+	return ((isar0 >> shift) & 0xf) != 0;
+}
+
+int arch_sha1_blocks(uint32_t state[5], const uint8_t *data, uint blocks)
+{
+	if (!cpu_has_sha(ID_AA64ISAR0_SHA1_SHIFT, data))
+		return -ENOSYS;
+	sha1_ce_blocks(state, data, blocks);
+
+	return 0;
+}
+
+int arch_sha256_blocks(uint32_t state[8], const uint8_t *data, uint blocks)
+{
+	if (!cpu_has_sha(ID_AA64ISAR0_SHA2_SHIFT, data))
+		return -ENOSYS;
+	sha256_ce_blocks(state, data, blocks);
+
+	return 0;
+}
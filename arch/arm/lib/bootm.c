@@ -14,6 +14,7 @@
 
 #include <common.h>
 #include <command.h>
+#include <cyclic.h>
 #include <dm.h>
 #include <dm/root.h>
 #include <image.h>
@@ -94,6 +95,9 @@ static void announce_and_cleanup(int fake)
 
 	board_quiesce_devices();
 
+	/* Nothing may run in the background once devices are removed */
+	cyclic_uninit();
+
 	/*
 	 * Call remove function of all devices with a removal flag set.
 	 * This may be useful for last-stage operations, like cancelling
@@ -4,6 +4,7 @@
  */
 
 #include <dirent.h>
+#include <elf.h>
 #include <errno.h>
 #include <fcntl.h>
 #include <getopt.h>
@@ -609,3 +610,41 @@ void os_localtime(struct rtc_time *rt)
 	rt->tm_yday = tm->tm_yday;
 	rt->tm_isdst = tm->tm_isdst;
 }
+
+void *os_find_text_base(void)
+{
+	char line[500];
+	void *base = NULL;
+	uintptr_t addr;
+	char *end;
+	int len;
+	int fd;
+
+	/*
+	 * The first line of /proc/self/maps describes the start of the
+	 * executable, for example:
+	 *
+	 * 5622d9907000-5622d9a55000 r-xp 00000000 08:01 15067168   u-boot
+	 */
+	fd = open("/proc/self/maps", O_RDONLY);
+	if (fd == -1)
+		return NULL;
+	len = read(fd, line, sizeof(line) - 1);
+	close(fd);
+	if (len <= 0)
+		return NULL;
+	line[len] = '\0';
+	end = strchr(line, '-');
+	if (!end)
+		return NULL;
+	*end = '\0';
+	if (sscanf(line, "%zx", &addr) != 1)
+		return NULL;
+
+	/* A position-dependent executable is loaded at its link address */
+	base = (void *)addr;
+	if (((Elf32_Ehdr *)base)->e_type != ET_DYN)
+		return NULL;
+
+	return base;
+}
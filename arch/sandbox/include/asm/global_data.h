@@ -13,6 +13,7 @@
 /* Architecture-specific global data */
 struct arch_global_data {
 	uint8_t		*ram_buf;	/* emulated RAM buffer */
+	void		*text_base;	/* executable load address, if moved */
 };
 
 #include <asm-generic/global_data.h>
@@ -79,4 +79,28 @@ long sandbox_i2c_rtc_get_set_base_time(struct udevice *dev, long base_time);
 
 int sandbox_usb_keyb_add_string(struct udevice *dev, const char *str);
 
+/**
+ * sandbox_hash_set_algos() - Set the algorithms a hash engine supports
+ *
+ * @dev:	Sandbox hash device
+ * @algos:	Mask of algorithms, (1 << enum hash_algo_id)
+ */
+void sandbox_hash_set_algos(struct udevice *dev, ulong algos);
+
+/**
+ * sandbox_hash_get_bytes() - Get the number of bytes a hash engine hashed
+ *
+ * @dev:	Sandbox hash device
+ * @return number of bytes hashed since the device was probed
+ */
+ulong sandbox_hash_get_bytes(struct udevice *dev);
+
+/**
+ * sandbox_hash_get_polls() - Get the number of polls which found it busy
+ *
+ * @dev:	Sandbox hash device
+ * @return number of calls to poll() which returned -EBUSY
+ */
+uint sandbox_hash_get_polls(struct udevice *dev);
+
 #endif
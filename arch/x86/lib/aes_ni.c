@@ -0,0 +1,65 @@
+/*
+ * AES using the x86 AES-NI instructions, see aes_ni_asm.S
+ *
+ * As with the SHA extensions, the instructions need SSE state to be
+ * enabled (CR4.OSFXSR), which is only the case when running as an EFI
+ * application or as a coreboot payload. Otherwise the generic C code is
+ * used.
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <errno.h>
+#include <uboot_aes.h>
+#include <asm/control_regs.h>
+#include <asm/cpu.h>
+#include <asm/processor-flags.h>
+
+#define CPUID1_ECX_AES		(1 << 25)
+
+void aes_ni_encrypt_blocks(const u32 *rk, int rounds, u8 *iv, const u8 *src,
+			   u8 *dst, uint blocks);
+void aes_ni_cbc_encrypt(const u32 *rk, int rounds, u8 *iv, const u8 *src,
+			u8 *dst, uint blocks);
+void aes_ni_cbc_decrypt(const u32 *rk, int rounds, u8 *iv, const u8 *src,
+			u8 *dst, uint blocks);
+
+static bool cpu_has_aes_ni(void)
+{
+	if (!(read_cr4() & X86_CR4_OSFXSR))
+		return false;
+
+	return cpuid_ecx(1) & CPUID1_ECX_AES;
+}
+
+int arch_aes_encrypt_blocks(const struct aes_ctx *ctx, const u8 *src, u8 *dst,
+			    u32 blocks)
+{
+	if (!cpu_has_aes_ni())
+		return -ENOSYS;
+	aes_ni_encrypt_blocks(ctx->enc_key, ctx->rounds, NULL, src, dst,
+			      blocks);
+
+	return 0;
+}
+
+int arch_aes_cbc_encrypt(const struct aes_ctx *ctx, u8 *iv, const u8 *src,
+			 u8 *dst, u32 blocks)
+{
+	if (!cpu_has_aes_ni())
+		return -ENOSYS;
+	aes_ni_cbc_encrypt(ctx->enc_key, ctx->rounds, iv, src, dst, blocks);
+
+	return 0;
+}
+
+int arch_aes_cbc_decrypt(const struct aes_ctx *ctx, u8 *iv, const u8 *src,
+			 u8 *dst, u32 blocks)
+{
+	if (!cpu_has_aes_ni())
+		return -ENOSYS;
+	aes_ni_cbc_decrypt(ctx->dec_key, ctx->rounds, iv, src, dst, blocks);
+
+	return 0;
+}
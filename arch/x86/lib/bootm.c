@@ -10,6 +10,7 @@
 
 #include <common.h>
 #include <command.h>
+#include <cyclic.h>
 #include <dm/device.h>
 #include <dm/root.h>
 #include <errno.h>
@@ -49,6 +50,9 @@ void bootm_announce_and_cleanup(void)
 	bootstage_report();
 #endif
 
+	/* Nothing may run in the background once devices are removed */
+	cyclic_uninit();
+
 	/*
 	 * Call remove function of all devices with a removal flag set.
 	 * This may be useful for last-stage operations, like cancelling
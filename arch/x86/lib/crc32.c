@@ -0,0 +1,34 @@
+/*
+ * CRC32C using the SSE4.2 crc32 instruction
+ *
+ * The instruction only works on general-purpose registers, so it can be
+ * used even though U-Boot does not enable SSE state. It implements the
+ * Castagnoli polynomial only; CRC32 stays with the table code.
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <errno.h>
+#include <u-boot/crc.h>
+#include <asm/cpu.h>
+
+#define CPUID_ECX_SSE4_2	(1 << 20)
+
+int arch_crc32c_le(uint32_t *crcp, const unsigned char *buf, uint len)
+{
+	uint32_t crc = *crcp;
+
+	if (!(cpuid_ecx(1) & CPUID_ECX_SSE4_2))
+		return -ENOSYS;
+
+	for (; len && ((ulong)buf & 3); len--)
+		asm("crc32b %1, %0" : "+r" (crc) : "qm" (*buf++));
+	for (; len >= 4; len -= 4, buf += 4)
+		asm("crc32l %1, %0" : "+r" (crc) : "rm" (*(const u32 *)buf));
+	for (; len; len--)
+		asm("crc32b %1, %0" : "+r" (crc) : "qm" (*buf++));
+	*crcp = crc;
+
+	return 0;
+}
@@ -0,0 +1,55 @@
+/*
+ * SHA-1 and SHA-256 using the x86 SHA extensions, see sha_ni_asm.S
+ *
+ * The instructions work on %xmm registers, so besides the CPUID bits they
+ * need SSE state to be enabled (CR4.OSFXSR). U-Boot does not set that up
+ * itself, but it is set when running as an EFI application or as a
+ * coreboot payload. Otherwise the generic C code is used.
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <errno.h>
+#include <u-boot/sha1.h>
+#include <u-boot/sha256.h>
+#include <asm/control_regs.h>
+#include <asm/cpu.h>
+#include <asm/processor-flags.h>
+
+#define CPUID1_ECX_SSSE3	(1 << 9)
+#define CPUID1_ECX_SSE4_1	(1 << 19)
+#define CPUID7_EBX_SHA		(1 << 29)
+
+void sha1_ni_blocks(uint32_t state[5], const uint8_t *data, uint blocks);
+void sha256_ni_blocks(uint32_t state[8], const uint8_t *data, uint blocks);
+
+static bool cpu_has_sha_ni(void)
+{
+	const uint ecx = CPUID1_ECX_SSSE3 | CPUID1_ECX_SSE4_1;
+
+	if (!(read_cr4() & X86_CR4_OSFXSR))
+		return false;
+	if (cpuid_eax(0) < 7 || (cpuid_ecx(1) & ecx) != ecx)
+		return false;
+
+	return cpuid_ext(7, 0).ebx & CPUID7_EBX_SHA;
+}
+
+int arch_sha1_blocks(uint32_t state[5], const uint8_t *data, uint blocks)
+{
+	if (!cpu_has_sha_ni())
+		return -ENOSYS;
+	sha1_ni_blocks(state, data, blocks);
+
+	return 0;
+}
+
+int arch_sha256_blocks(uint32_t state[8], const uint8_t *data, uint blocks)
+{
+	if (!cpu_has_sha_ni())
+		return -ENOSYS;
+	sha256_ni_blocks(state, data, blocks);
+
+	return 0;
+}
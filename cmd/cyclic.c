@@ -0,0 +1,124 @@
+/*
+ * Commands for cyclic functions
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <command.h>
+#include <cyclic.h>
+#include <div64.h>
+
+struct cyclic_demo_info {
+	ulong delay_us;
+};
+
+/* There is only one demo function, so its context need not be allocated */
+static struct cyclic_demo_info demo_info;
+
+static void cyclic_demo(void *ctx)
+{
+	struct cyclic_demo_info *info = ctx;
+
+	/* Just a small delay here to eat up some cycles */
+	udelay(info->delay_us);
+}
+
+static int do_cyclic_demo(cmd_tbl_t *cmdtp, int flag, int argc,
+			  char * const argv[])
+{
+	struct list_head *head = cyclic_get_list();
+	struct cyclic_info *cyclic, *next;
+	ulong period_ms;
+
+	if (argc < 3)
+		return CMD_RET_USAGE;
+
+	/* Replace the demo function if it is already registered */
+	if (head) {
+		list_for_each_entry_safe(cyclic, next, head, sibling_node) {
+			if (cyclic->func == cyclic_demo)
+				cyclic_unregister(cyclic);
+		}
+	}
+	period_ms = simple_strtoul(argv[1], NULL, 0);
+	demo_info.delay_us = simple_strtoul(argv[2], NULL, 0);
+
+	cyclic = cyclic_register(cyclic_demo, period_ms * 1000, "cyclic_demo",
+				 &demo_info);
+	if (!cyclic) {
+		printf("Registering of cyclic_demo failed\n");
+		return CMD_RET_FAILURE;
+	}
+	printf("Registered 'cyclic_demo' to run every %lums\n", period_ms);
+
+	return 0;
+}
+
+static int do_cyclic_list(cmd_tbl_t *cmdtp, int flag, int argc,
+			  char * const argv[])
+{
+	struct list_head *head = cyclic_get_list();
+	struct cyclic_info *cyclic;
+	ulong elapsed, avg;
+	u64 permille;
+
+	if (!head || list_empty(head)) {
+		printf("No cyclic functions\n");
+		return 0;
+	}
+
+	printf("%-20s %10s %10s %10s %10s %8s\n", "Name", "Period us",
+	       "Runs", "Avg us", "Max us", "CPU %");
+	list_for_each_entry(cyclic, head, sibling_node) {
+		elapsed = timer_get_us() - cyclic->start_time_us;
+		avg = 0;
+		if (cyclic->run_cnt) {
+			permille = cyclic->cpu_time_us;
+			do_div(permille, cyclic->run_cnt);
+			avg = permille;
+		}
+		permille = cyclic->cpu_time_us * 1000;
+		if (elapsed)
+			do_div(permille, elapsed);
+		printf("%-20s %10lu %10lu %10lu %10lu %6lu.%lu\n", cyclic->name,
+		       cyclic->delay_us, cyclic->run_cnt, avg,
+		       cyclic->max_time_us, (ulong)permille / 10,
+		       (ulong)permille % 10);
+	}
+
+	return 0;
+}
+
+static cmd_tbl_t cmd_cyclic_sub[] = {
+	U_BOOT_CMD_MKENT(demo, 3, 0, do_cyclic_demo, "", ""),
+	U_BOOT_CMD_MKENT(list, 1, 1, do_cyclic_list, "", ""),
+};
+
+static int do_cyclic(cmd_tbl_t *cmdtp, int flag, int argc,
+		     char * const argv[])
+{
+	cmd_tbl_t *c;
+
+	if (argc < 2)
+		return CMD_RET_USAGE;
+
+	/* Strip off leading 'cyclic' command argument */
+	argc--;
+	argv++;
+
+	c = find_cmd_tbl(argv[0], cmd_cyclic_sub, ARRAY_SIZE(cmd_cyclic_sub));
+	if (c)
+		return c->cmd(cmdtp, flag, argc, argv);
+	else
+		return CMD_RET_USAGE;
+}
+
+U_BOOT_CMD(cyclic, 4, 1, do_cyclic,
+	"Cyclic functions",
+	" - show and test functions which run in the background\n"
+	"list                          - Show cyclic functions and their overhead\n"
+	"demo <period_ms> <delay_us>   - Register a demo function which waits\n"
+	"                                for <delay_us> every <period_ms>,\n"
+	"                                replacing any earlier one"
+);
@@ -75,6 +75,23 @@ U_BOOT_CMD(
 	"      device type 'interface' instance 'dev'."
 )
 
+static int do_cat_wrapper(cmd_tbl_t *cmdtp, int flag, int argc,
+				char * const argv[])
+{
+	return do_cat(cmdtp, flag, argc, argv, FS_TYPE_ANY);
+}
+
+U_BOOT_CMD(
+	cat,	6,	0,	do_cat_wrapper,
+	"print a file from a filesystem",
+	"<interface> <dev[:part]> <filename> [bytes [pos]]\n"
+	"    - Print file 'filename' from partition 'part' on device\n"
+	"      type 'interface' instance 'dev' to the console.\n"
+	"      'bytes' gives the number of bytes to print (hex).\n"
+	"      If 'bytes' is 0 or omitted, the file is printed until the end.\n"
+	"      'pos' gives the file byte position to start from (hex)."
+)
+
 static int do_fstype_wrapper(cmd_tbl_t *cmdtp, int flag, int argc,
 				char * const argv[])
 {
@@ -25,8 +25,17 @@ static int do_unzip(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 			return CMD_RET_USAGE;
 	}
 
-	if (gunzip((void *) dst, dst_len, (void *) src, &src_len) != 0)
+	/* zstd frames start with the magic 0xfd2fb528 (little-endian) */
+	if (IS_ENABLED(CONFIG_ZSTD) &&
+	    !memcmp((void *)src, "\x28\xb5\x2f\xfd", 4)) {
+		size_t len = dst_len;
+
+		if (zstd_decompress((void *)src, src_len, (void *)dst, &len))
+			return 1;
+		src_len = len;
+	} else if (gunzip((void *) dst, dst_len, (void *) src, &src_len) != 0) {
 		return 1;
+	}
 
 	printf("Uncompressed size: %ld = 0x%lX\n", src_len, src_len);
 	env_set_hex("filesize", src_len);
@@ -18,6 +18,7 @@
 #endif
 #include <command.h>
 #include <console.h>
+#include <cyclic.h>
 #ifdef CONFIG_HAS_DATAFLASH
 #include <dataflash.h>
 #endif
@@ -309,9 +310,18 @@ static int initr_dm(void)
 	gd->dm_root = NULL;
 #ifdef CONFIG_TIMER
 	gd->timer = NULL;
+#endif
+#ifdef CONFIG_DM_COMPAT_INDEX
+	/* The index is in the pre-relocation heap, so build a new one */
+	gd->dm_compat_index = NULL;
+	gd->dm_compat_count = 0;
 #endif
 	bootstage_start(BOOTSTATE_ID_ACCUM_DM_R, "dm_r");
+#ifdef CONFIG_DM_RELOC_TREE
+	ret = dm_init_and_relocate(gd->dm_root_f);
+#else
 	ret = dm_init_and_scan(false);
+#endif
 	bootstage_accum(BOOTSTATE_ID_ACCUM_DM_R);
 	if (ret)
 		return ret;
@@ -438,6 +448,20 @@ static int initr_onenand(void)
 }
 #endif
 
+#if defined(CONFIG_DM_ASYNC_PROBE) && defined(CONFIG_DM_MMC)
+/*
+ * Start probing the MMC controllers so that their cards can power up while
+ * the rest of U-Boot is set up. initr_mmc() waits for them. Errors are
+ * reported when the devices are probed again there.
+ */
+static int initr_dm_async_probe(void)
+{
+	dm_async_probe_uclass(UCLASS_MMC);
+
+	return 0;
+}
+#endif
+
 #ifdef CONFIG_MMC
 static int initr_mmc(void)
 {
@@ -722,6 +746,9 @@ static init_fnc_t init_sequence_r[] = {
 	initr_barrier,
 	initr_malloc,
 	initr_bootstage,	/* Needs malloc() but has its own timer */
+#ifdef CONFIG_CYCLIC
+	cyclic_init,
+#endif
 	initr_console_record,
 #ifdef CONFIG_SYS_NONCACHED_MEMORY
 	initr_noncached,
@@ -783,6 +810,9 @@ static init_fnc_t init_sequence_r[] = {
 	arch_early_init_r,
 #endif
 	power_init_board,
+#if defined(CONFIG_DM_ASYNC_PROBE) && defined(CONFIG_DM_MMC)
+	initr_dm_async_probe,
+#endif
 #ifdef CONFIG_MTD_NOR_FLASH
 	initr_flash,
 #endif
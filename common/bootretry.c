@@ -8,6 +8,7 @@
 #include <common.h>
 #include <bootretry.h>
 #include <cli.h>
+#include <cyclic.h>
 #include <errno.h>
 #include <watchdog.h>
 
@@ -47,7 +48,7 @@ int bootretry_tstc_timeout(void)
 	while (!tstc()) {	/* while no incoming data */
 		if (retry_time >= 0 && get_ticks() > endtime)
 			return -ETIMEDOUT;
-		WATCHDOG_RESET();
+		cyclic_schedule();
 	}
 
 	return 0;
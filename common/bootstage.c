@@ -24,21 +24,34 @@ enum {
 struct bootstage_record {
 	ulong time_us;
 	uint32_t start_us;
+	uint32_t duration_us;	/* Time taken, for BOOTSTAGEF_SPAN records */
+	const void *func;	/* Function called, for BOOTSTAGEF_SPAN */
 	const char *name;
 	int flags;		/* see enum bootstage_flags */
 	enum bootstage_id id;
 };
 
+/*
+ * The records follow this header. There is room for RECORD_COUNT of them to
+ * start with, more are added once full malloc() is available.
+ */
 struct bootstage_data {
 	uint rec_count;
+	uint rec_max;
 	uint next_id;
-	struct bootstage_record record[RECORD_COUNT];
+	uint dropped;		/* Number of records which did not fit */
+	bool no_spans;		/* true to ignore bootstage_add_span() */
+	bool on_heap;		/* true if allocated by bootstage_grow() */
+	struct bootstage_record record[];
 };
 
 enum {
-	BOOTSTAGE_VERSION	= 0,
+	BOOTSTAGE_VERSION	= 1,
 	BOOTSTAGE_MAGIC		= 0xb00757a3,
 	BOOTSTAGE_DIGITS	= 9,
+
+	/* Enough for "call " followed by a 64-bit address */
+	BOOTSTAGE_NAME_LEN	= 30,
 };
 
 struct bootstage_hdr {
@@ -64,6 +77,60 @@ int bootstage_relocate(void)
 	return 0;
 }
 
+/**
+ * bootstage_grow() - Make space for more records
+ *
+ * This doubles the number of records which can be stored. It only works once
+ * full malloc() is available, since before relocation the data is copied to
+ * an area of a fixed size (see bootstage_get_size()).
+ *
+ * @return new bootstage data, or NULL if there is no more space
+ */
+static struct bootstage_data *bootstage_grow(void)
+{
+	struct bootstage_data *data = gd->bootstage;
+	struct bootstage_data *new_data;
+	uint rec_max = data->rec_max * 2;
+
+	if (!(gd->flags & GD_FLG_FULL_MALLOC_INIT))
+		return NULL;
+	new_data = malloc(sizeof(*data) + rec_max * sizeof(data->record[0]));
+	if (!new_data)
+		return NULL;
+	memcpy(new_data, data, sizeof(*data) +
+	       data->rec_count * sizeof(data->record[0]));
+	new_data->rec_max = rec_max;
+	new_data->on_heap = true;
+	if (data->on_heap)
+		free(data);
+	gd->bootstage = new_data;
+
+	return new_data;
+}
+
+/**
+ * add_record() - Add a new record to the end of the list
+ *
+ * @return pointer to the new record, which is zeroed, or NULL if there is no
+ *	space
+ */
+static struct bootstage_record *add_record(struct bootstage_data *data)
+{
+	struct bootstage_record *rec;
+
+	if (data->rec_count == data->rec_max) {
+		data = bootstage_grow();
+		if (!data) {
+			gd->bootstage->dropped++;
+			return NULL;
+		}
+	}
+	rec = &data->record[data->rec_count++];
+	memset(rec, '\0', sizeof(*rec));
+
+	return rec;
+}
+
 struct bootstage_record *find_id(struct bootstage_data *data,
 				 enum bootstage_id id)
 {
@@ -85,10 +152,10 @@ struct bootstage_record *ensure_id(struct bootstage_data *data,
 	struct bootstage_record *rec;
 
 	rec = find_id(data, id);
-	if (!rec && data->rec_count < RECORD_COUNT) {
-		rec = &data->record[data->rec_count++];
-		rec->id = id;
-		return rec;
+	if (!rec) {
+		rec = add_record(data);
+		if (rec)
+			rec->id = id;
 	}
 
 	return rec;
@@ -105,12 +172,14 @@ ulong bootstage_add_record(enum bootstage_id id, const char *name,
 
 	/* Only record the first event for each */
 	rec = find_id(data, id);
-	if (!rec && data->rec_count < RECORD_COUNT) {
-		rec = &data->record[data->rec_count++];
-		rec->time_us = mark;
-		rec->name = name;
-		rec->flags = flags;
-		rec->id = id;
+	if (!rec) {
+		rec = add_record(data);
+		if (rec) {
+			rec->time_us = mark;
+			rec->name = name;
+			rec->flags = flags;
+			rec->id = id;
+		}
 	}
 
 	/* Tell the board about this progress */
@@ -168,6 +237,53 @@ ulong bootstage_mark_code(const char *file, const char *func, int linenum)
 	return bootstage_mark_name(BOOTSTAGE_ID_ALLOC, str);
 }
 
+ulong bootstage_add_span(const char *name, const void *func, ulong start_us)
+{
+	struct bootstage_data *data = gd->bootstage;
+	struct bootstage_record *rec;
+	ulong duration;
+
+	/* Spans can be recorded before bootstage_init() is called */
+	if (!data)
+		return 0;
+	duration = timer_get_boot_us() - start_us;
+	if (data->no_spans)
+		return duration;
+	rec = add_record(data);
+	if (!rec)
+		return duration;
+	rec->time_us = start_us;
+	rec->duration_us = duration;
+	rec->func = func;
+	/*
+	 * Before relocation the name is copied by bootstage_relocate(), so
+	 * save the space in the small pre-relocation malloc() area
+	 */
+	rec->name = name;
+	if (name && (gd->flags & GD_FLG_FULL_MALLOC_INIT)) {
+		rec->name = strdup(name);
+		if (!rec->name)
+			rec->name = name;
+	}
+	rec->flags = BOOTSTAGEF_SPAN;
+	rec->id = BOOTSTAGE_ID_SPAN;
+
+	return duration;
+}
+
+bool bootstage_set_spans(bool enable)
+{
+	struct bootstage_data *data = gd->bootstage;
+	bool old;
+
+	if (!data)
+		return false;
+	old = !data->no_spans;
+	data->no_spans = !enable;
+
+	return old;
+}
+
 uint32_t bootstage_start(enum bootstage_id id, const char *name)
 {
 	struct bootstage_data *data = gd->bootstage;
@@ -209,6 +325,8 @@ static const char *get_record_name(char *buf, int len,
 {
 	if (rec->name)
 		return rec->name;
+	else if (rec->func)
+		snprintf(buf, len, "call %lx", (ulong)rec->func);
 	else if (rec->id >= BOOTSTAGE_ID_USER)
 		snprintf(buf, len, "user_%d", rec->id - BOOTSTAGE_ID_USER);
 	else
@@ -219,7 +337,7 @@ static const char *get_record_name(char *buf, int len,
 
 static uint32_t print_time_record(struct bootstage_record *rec, uint32_t prev)
 {
-	char buf[20];
+	char buf[BOOTSTAGE_NAME_LEN];
 
 	if (prev == -1U) {
 		printf("%11s", "");
@@ -228,7 +346,10 @@ static uint32_t print_time_record(struct bootstage_record *rec, uint32_t prev)
 		print_grouped_ull(rec->time_us, BOOTSTAGE_DIGITS);
 		print_grouped_ull(rec->time_us - prev, BOOTSTAGE_DIGITS);
 	}
-	printf("  %s\n", get_record_name(buf, sizeof(buf), rec));
+	printf("  %s", get_record_name(buf, sizeof(buf), rec));
+	if (rec->flags & BOOTSTAGEF_SPAN)
+		printf(" (%u us)", rec->duration_us);
+	putc('\n');
 
 	return rec->time_us;
 }
@@ -251,7 +372,7 @@ static int add_bootstages_devicetree(struct fdt_header *blob)
 {
 	struct bootstage_data *data = gd->bootstage;
 	int bootstage;
-	char buf[20];
+	char buf[BOOTSTAGE_NAME_LEN];
 	int recnum;
 	int i;
 
@@ -277,6 +398,10 @@ static int add_bootstages_devicetree(struct fdt_header *blob)
 		if (rec->id != BOOTSTAGE_ID_AWAKE && rec->time_us == 0)
 			continue;
 
+		/* There may be hundreds of these; use 'bootstage export' */
+		if (rec->flags & BOOTSTAGEF_SPAN)
+			continue;
+
 		node = fdt_add_subnode(blob, bootstage, simple_itoa(i));
 		if (node < 0)
 			break;
@@ -325,10 +450,10 @@ void bootstage_report(void)
 		if (rec->id && !rec->start_us)
 			prev = print_time_record(rec, prev);
 	}
-	if (data->rec_count > RECORD_COUNT)
+	if (data->dropped)
 		printf("Overflowed internal boot id table by %d entries\n"
 		       "- please increase CONFIG_BOOTSTAGE_RECORD_COUNT\n",
-		       data->rec_count - RECORD_COUNT);
+		       data->dropped);
 
 	puts("\nAccumulated time:\n");
 	for (i = 0, rec = data->record; i < data->rec_count; i++, rec++) {
@@ -359,12 +484,83 @@ static void append_data(char **ptrp, char *end, const void *data, int size)
 	memcpy(ptr, data, size);
 }
 
+/* Output for bootstage_export_chrome() */
+struct export_buf {
+	char *ptr;	/* Next byte to write, or NULL to use the console */
+	char *end;	/* End of buffer */
+	int len;	/* Total length of the output so far */
+};
+
+static void export_out(struct export_buf *buf, const char *str)
+{
+	int len = strlen(str);
+
+	buf->len += len;
+	if (buf->ptr)
+		append_data(&buf->ptr, buf->end, str, len);
+	else
+		puts(str);
+}
+
+/* Output a string, escaped for use inside a JSON string */
+static void export_str(struct export_buf *buf, const char *str)
+{
+	char chr[2] = "";
+
+	for (; *str; str++) {
+		if (*str == '"' || *str == '\\')
+			export_out(buf, "\\");
+		chr[0] = *str;
+		export_out(buf, chr);
+	}
+}
+
+int bootstage_export_chrome(char *out, int size)
+{
+	struct bootstage_data *data = gd->bootstage;
+	struct export_buf buf = { .ptr = out, .end = out + size };
+	struct bootstage_record *rec;
+	const char *sep = "\n";
+	char line[100];
+	char name[BOOTSTAGE_NAME_LEN];
+	int i;
+
+	export_out(&buf, "{\"traceEvents\":[");
+	for (i = 0, rec = data->record; i < data->rec_count; i++, rec++) {
+		if (rec->id != BOOTSTAGE_ID_AWAKE && rec->time_us == 0)
+			continue;
+		export_out(&buf, sep);
+		export_out(&buf, "{\"name\":\"");
+		sep = ",\n";
+		export_str(&buf, get_record_name(name, sizeof(name), rec));
+		if (rec->flags & BOOTSTAGEF_SPAN) {
+			snprintf(line, sizeof(line),
+				 "\",\"cat\":\"span\",\"ph\":\"X\",\"ts\":%lu,\"dur\":%u",
+				 rec->time_us, rec->duration_us);
+		} else if (rec->start_us) {
+			/* Only the total is known; show it at the last start */
+			snprintf(line, sizeof(line),
+				 "\",\"cat\":\"accum\",\"ph\":\"i\",\"s\":\"g\",\"ts\":%u,\"args\":{\"total_us\":%lu}",
+				 rec->start_us, rec->time_us);
+		} else {
+			snprintf(line, sizeof(line),
+				 "\",\"cat\":\"mark\",\"ph\":\"i\",\"s\":\"g\",\"ts\":%lu",
+				 rec->time_us);
+		}
+		export_out(&buf, line);
+		export_out(&buf, ",\"pid\":0,\"tid\":0}");
+	}
+	export_out(&buf, "\n],\"displayTimeUnit\":\"ms\"}\n");
+
+	return buf.len;
+}
+
 int bootstage_stash(void *base, int size)
 {
 	const struct bootstage_data *data = gd->bootstage;
 	struct bootstage_hdr *hdr = (struct bootstage_hdr *)base;
 	const struct bootstage_record *rec;
-	char buf[20];
+	char buf[BOOTSTAGE_NAME_LEN];
 	char *ptr = base, *end = ptr + size;
 	uint32_t count;
 	int i;
@@ -454,11 +650,15 @@ int bootstage_unstash(const void *base, int size)
 		return -EINVAL;
 	}
 
-	if (data->rec_count + hdr->count > RECORD_COUNT) {
-		debug("%s: Bootstage has %d records, we have space for %d\n"
-			"- please increase CONFIG_BOOTSTAGE_USER_COUNT\n",
-		      __func__, hdr->count, RECORD_COUNT - data->rec_count);
-		return -ENOSPC;
+	while (data->rec_count + hdr->count > data->rec_max) {
+		if (!bootstage_grow()) {
+			debug("%s: Bootstage has %d records, we have space for %d\n"
+				"- please increase CONFIG_BOOTSTAGE_RECORD_COUNT\n",
+			      __func__, hdr->count,
+			      data->rec_max - data->rec_count);
+			return -ENOSPC;
+		}
+		data = gd->bootstage;
 	}
 
 	ptr += sizeof(*hdr);
@@ -486,19 +686,25 @@ int bootstage_unstash(const void *base, int size)
 
 int bootstage_get_size(void)
 {
-	return sizeof(struct bootstage_data);
+	struct bootstage_data *data = gd->bootstage;
+	uint rec_max = data ? data->rec_max : RECORD_COUNT;
+
+	return sizeof(struct bootstage_data) +
+		rec_max * sizeof(data->record[0]);
 }
 
 int bootstage_init(bool first)
 {
 	struct bootstage_data *data;
-	int size = sizeof(struct bootstage_data);
+	int size = sizeof(struct bootstage_data) +
+		RECORD_COUNT * sizeof(data->record[0]);
 
 	gd->bootstage = (struct bootstage_data *)malloc(size);
 	if (!gd->bootstage)
 		return -ENOMEM;
 	data = gd->bootstage;
 	memset(data, '\0', size);
+	data->rec_max = RECORD_COUNT;
 	if (first) {
 		data->next_id = BOOTSTAGE_ID_USER;
 		bootstage_add_record(BOOTSTAGE_ID_AWAKE, "reset", 0, 0);
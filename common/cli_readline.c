@@ -12,6 +12,7 @@
 #include <common.h>
 #include <bootretry.h>
 #include <cli.h>
+#include <cyclic.h>
 #include <watchdog.h>
 
 DECLARE_GLOBAL_DATA_PTR;
@@ -267,7 +268,7 @@ static int cread_line(const char *const prompt, char *buf, unsigned int *len,
 			while (!tstc()) {	/* while no incoming data */
 				if (get_ticks() >= etime)
 					return -2;	/* timed out */
-				WATCHDOG_RESET();
+				cyclic_schedule();
 			}
 			first = 0;
 		}
@@ -569,7 +570,7 @@ int cli_readline_into_buffer(const char *const prompt, char *buffer,
 #ifdef CONFIG_SHOW_ACTIVITY
 		while (!tstc()) {
 			show_activity(0);
-			WATCHDOG_RESET();
+			cyclic_schedule();
 		}
 #endif
 		c = getc();
@@ -7,6 +7,7 @@
 
 #include <common.h>
 #include <console.h>
+#include <cyclic.h>
 #include <debug_uart.h>
 #include <dm.h>
 #include <stdarg.h>
@@ -316,7 +317,7 @@ int fgetc(int file)
 		 * Effectively poll for input wherever it may be available.
 		 */
 		for (;;) {
-			WATCHDOG_RESET();
+			cyclic_schedule();
 			/*
 			 * Upper layer may have already called tstc() so
 			 * check for that first.
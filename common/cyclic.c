@@ -0,0 +1,181 @@
+/*
+ * Cyclic functions, run in the background while U-Boot waits
+ *
+ * Functions registered here are called at their requested period from
+ * cyclic_schedule(), which the delay and polling helpers call while they
+ * wait. This lets background work such as LED heartbeats and link polling
+ * carry on during long operations.
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <cyclic.h>
+#include <errno.h>
+#include <malloc.h>
+#include <time.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+/**
+ * struct cyclic_drv - State of the cyclic functions
+ *
+ * @cyclic_list: List of struct cyclic_info
+ * @next: Next function to look at in cyclic_run(), so that a function can
+ * unregister any other function
+ * @current: Function being called, or NULL if it unregistered itself
+ * @running: true while cyclic_run() is calling functions
+ */
+struct cyclic_drv {
+	struct list_head cyclic_list;
+	struct cyclic_info *next;
+	struct cyclic_info *current;
+	bool running;
+};
+
+struct list_head *cyclic_get_list(void)
+{
+	struct cyclic_drv *drv = gd->cyclic;
+
+	return drv ? &drv->cyclic_list : NULL;
+}
+
+static struct cyclic_info *cyclic_next(struct cyclic_drv *drv,
+				       struct cyclic_info *cyclic)
+{
+	if (list_is_last(&cyclic->sibling_node, &drv->cyclic_list))
+		return NULL;
+
+	return list_entry(cyclic->sibling_node.next, struct cyclic_info,
+			  sibling_node);
+}
+
+struct cyclic_info *cyclic_register(cyclic_func_t func, ulong delay_us,
+				    const char *name, void *ctx)
+{
+	struct cyclic_drv *drv = gd->cyclic;
+	struct cyclic_info *cyclic;
+
+	if (!drv) {
+		debug("%s: Cyclic functions not ready for '%s'\n", __func__,
+		      name);
+		return NULL;
+	}
+	cyclic = calloc(1, sizeof(*cyclic));
+	if (!cyclic)
+		return NULL;
+
+	cyclic->func = func;
+	cyclic->ctx = ctx;
+	cyclic->name = name;
+	cyclic->delay_us = delay_us;
+	cyclic->budget_us = CONFIG_CYCLIC_MAX_CPU_TIME_US;
+	cyclic->start_time_us = timer_get_us();
+	cyclic->next_call = cyclic->start_time_us + delay_us;
+	list_add_tail(&cyclic->sibling_node, &drv->cyclic_list);
+
+	return cyclic;
+}
+
+void cyclic_unregister(struct cyclic_info *cyclic)
+{
+	struct cyclic_drv *drv = gd->cyclic;
+
+	/* After cyclic_uninit() the function has already been freed */
+	if (!cyclic || !drv)
+		return;
+	if (drv->next == cyclic)
+		drv->next = cyclic_next(drv, cyclic);
+	if (drv->current == cyclic)
+		drv->current = NULL;
+	list_del(&cyclic->sibling_node);
+	free(cyclic);
+}
+
+static void cyclic_call(struct cyclic_drv *drv, struct cyclic_info *cyclic,
+			ulong now)
+{
+	ulong cpu_time;
+
+	drv->current = cyclic;
+	cyclic->run_cnt++;
+	cyclic->func(cyclic->ctx);
+
+	/* The function may have unregistered itself */
+	if (!drv->current)
+		return;
+	drv->current = NULL;
+	cpu_time = timer_get_us() - now;
+	cyclic->cpu_time_us += cpu_time;
+	if (cpu_time > cyclic->max_time_us)
+		cyclic->max_time_us = cpu_time;
+	if (cpu_time > cyclic->budget_us && !cyclic->already_warned) {
+		printf("WARNING: Cyclic function '%s' took %luus (budget %luus)\n",
+		       cyclic->name, cpu_time, cyclic->budget_us);
+		cyclic->already_warned = true;
+	}
+}
+
+bool cyclic_registered(void)
+{
+	struct cyclic_drv *drv = gd->cyclic;
+
+	return drv && !list_empty(&drv->cyclic_list);
+}
+
+void cyclic_run(void)
+{
+	struct cyclic_drv *drv = gd->cyclic;
+	struct cyclic_info *cyclic;
+	ulong now;
+
+	/* Cyclic functions may wait, which comes back here */
+	if (!drv || drv->running || list_empty(&drv->cyclic_list))
+		return;
+
+	drv->running = true;
+	drv->next = list_first_entry(&drv->cyclic_list, struct cyclic_info,
+				     sibling_node);
+	while (drv->next) {
+		cyclic = drv->next;
+		drv->next = cyclic_next(drv, cyclic);
+
+		now = timer_get_us();
+		if (!time_after_eq(now, cyclic->next_call))
+			continue;
+
+		/* Skip periods that were missed rather than catching up */
+		cyclic->next_call = now + cyclic->delay_us;
+		cyclic_call(drv, cyclic, now);
+	}
+	drv->running = false;
+}
+
+int cyclic_init(void)
+{
+	struct cyclic_drv *drv;
+
+	if (gd->cyclic)
+		return 0;
+	drv = calloc(1, sizeof(*drv));
+	if (!drv)
+		return -ENOMEM;
+	INIT_LIST_HEAD(&drv->cyclic_list);
+	gd->cyclic = drv;
+
+	return 0;
+}
+
+void cyclic_uninit(void)
+{
+	struct cyclic_drv *drv = gd->cyclic;
+	struct cyclic_info *cyclic, *next;
+
+	if (!drv)
+		return;
+	list_for_each_entry_safe(cyclic, next, &drv->cyclic_list,
+				 sibling_node)
+		cyclic_unregister(cyclic);
+	free(drv);
+	gd->cyclic = NULL;
+}
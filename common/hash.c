@@ -18,6 +18,7 @@
 #include <hw_sha.h>
 #include <asm/io.h>
 #include <linux/errno.h>
+#include <u-boot/hash.h>
 #else
 #include "mkimage.h"
 #include <time.h>
@@ -28,6 +29,7 @@
 #include <u-boot/crc.h>
 #include <u-boot/sha1.h>
 #include <u-boot/sha256.h>
+#include <u-boot/sha512.h>
 #include <u-boot/md5.h>
 
 #if defined(CONFIG_SHA1) && !defined(CONFIG_SHA_PROG_HW_ACCEL)
@@ -86,6 +88,53 @@ static int hash_finish_sha256(struct hash_algo *algo, void *ctx, void
 }
 #endif
 
+#ifdef CONFIG_SHA512
+static int hash_init_sha384(struct hash_algo *algo, void **ctxp)
+{
+	sha512_context *ctx = malloc(sizeof(sha512_context));
+	sha384_starts(ctx);
+	*ctxp = ctx;
+	return 0;
+}
+
+static int hash_init_sha512(struct hash_algo *algo, void **ctxp)
+{
+	sha512_context *ctx = malloc(sizeof(sha512_context));
+	sha512_starts(ctx);
+	*ctxp = ctx;
+	return 0;
+}
+
+static int hash_update_sha512(struct hash_algo *algo, void *ctx,
+			      const void *buf, unsigned int size, int is_last)
+{
+	sha512_update((sha512_context *)ctx, buf, size);
+	return 0;
+}
+
+static int hash_finish_sha384(struct hash_algo *algo, void *ctx, void
+			      *dest_buf, int size)
+{
+	if (size < algo->digest_size)
+		return -1;
+
+	sha384_finish((sha512_context *)ctx, dest_buf);
+	free(ctx);
+	return 0;
+}
+
+static int hash_finish_sha512(struct hash_algo *algo, void *ctx, void
+			      *dest_buf, int size)
+{
+	if (size < algo->digest_size)
+		return -1;
+
+	sha512_finish((sha512_context *)ctx, dest_buf);
+	free(ctx);
+	return 0;
+}
+#endif
+
 static int hash_init_crc32(struct hash_algo *algo, void **ctxp)
 {
 	uint32_t *ctx = malloc(sizeof(uint32_t));
@@ -159,6 +208,26 @@ static struct hash_algo hash_algo[] = {
 		.hash_finish	= hash_finish_sha256,
 #endif
 	},
+#endif
+#ifdef CONFIG_SHA512
+	{
+		.name		= "sha384",
+		.digest_size	= SHA384_SUM_LEN,
+		.chunk_size	= CHUNKSZ_SHA384,
+		.hash_func_ws	= sha384_csum_wd,
+		.hash_init	= hash_init_sha384,
+		.hash_update	= hash_update_sha512,
+		.hash_finish	= hash_finish_sha384,
+	},
+	{
+		.name		= "sha512",
+		.digest_size	= SHA512_SUM_LEN,
+		.chunk_size	= CHUNKSZ_SHA512,
+		.hash_func_ws	= sha512_csum_wd,
+		.hash_init	= hash_init_sha512,
+		.hash_update	= hash_update_sha512,
+		.hash_finish	= hash_finish_sha512,
+	},
 #endif
 	{
 		.name		= "crc32",
@@ -171,9 +240,118 @@ static struct hash_algo hash_algo[] = {
 	},
 };
 
+#ifndef USE_HOSTCC
+#if CONFIG_IS_ENABLED(DM_HASH)
+/* Context for progressive hashing with a hash engine, or in software */
+struct hash_dm_ctx {
+	struct udevice *dev;	/* Hash engine, or NULL to use @sw */
+	struct hash_algo *sw;	/* Software algorithm */
+	void *ctx;		/* Context for the engine or @sw */
+};
+
+static int hash_init_dm(struct hash_algo *algo, void **ctxp)
+{
+	struct hash_dm_ctx *ctx;
+	int id, ret;
+
+	ctx = calloc(1, sizeof(*ctx));
+	if (!ctx)
+		return -ENOMEM;
+
+	/* Use an engine if there is one, else fall back to software */
+	id = dm_hash_lookup_algo(algo->name);
+	if (!dm_hash_find(id, &ctx->dev) &&
+	    !dm_hash_init(ctx->dev, id, &ctx->ctx)) {
+		*ctxp = ctx;
+		return 0;
+	}
+	ctx->dev = NULL;
+	ret = hash_lookup_algo(algo->name, &ctx->sw);
+	if (!ret)
+		ret = ctx->sw->hash_init(ctx->sw, &ctx->ctx);
+	if (ret) {
+		free(ctx);
+		return ret;
+	}
+	*ctxp = ctx;
+
+	return 0;
+}
+
+static int hash_update_dm(struct hash_algo *algo, void *ctx, const void *buf,
+			  unsigned int size, int is_last)
+{
+	struct hash_dm_ctx *dctx = ctx;
+	uint8_t digest[HASH_MAX_DIGEST_SIZE];
+	int ret;
+
+	if (dctx->dev) {
+		ret = dm_hash_update(dctx->dev, dctx->ctx, buf, size);
+		if (ret)
+			dm_hash_finish(dctx->dev, dctx->ctx, digest);
+	} else {
+		ret = dctx->sw->hash_update(dctx->sw, dctx->ctx, buf, size,
+					    is_last);
+	}
+	if (ret)
+		free(dctx);
+
+	return ret;
+}
+
+static int hash_finish_dm(struct hash_algo *algo, void *ctx, void *dest_buf,
+			  int size)
+{
+	struct hash_dm_ctx *dctx = ctx;
+	int ret;
+
+	if (size < algo->digest_size)
+		return -1;
+
+	if (dctx->dev)
+		ret = dm_hash_finish(dctx->dev, dctx->ctx, dest_buf);
+	else
+		ret = dctx->sw->hash_finish(dctx->sw, dctx->ctx, dest_buf,
+					    size);
+	free(dctx);
+
+	return ret;
+}
+
+/*
+ * Get a copy of hash_algo[i] which uses a hash engine for progressive
+ * hashing, if there is one when the hash is started
+ */
+static struct hash_algo *hash_dm_algo(int i)
+{
+	static struct hash_algo dm_algo[ARRAY_SIZE(hash_algo)];
+	struct hash_algo *algo = &dm_algo[i];
+
+	*algo = hash_algo[i];
+	algo->hash_init = hash_init_dm;
+	algo->hash_update = hash_update_dm;
+	algo->hash_finish = hash_finish_dm;
+
+	return algo;
+}
+#endif
+
+/* Hash a buffer with a hash engine if there is one, else in software */
+static void hash_algo_calculate(struct hash_algo *algo, const void *buf,
+				unsigned int len, uint8_t *output)
+{
+#if CONFIG_IS_ENABLED(DM_HASH)
+	if (!dm_hash_block(algo->name, buf, len, output, NULL))
+		return;
+#endif
+	algo->hash_func_ws(buf, len, output, algo->chunk_size);
+}
+#endif /* !USE_HOSTCC */
+
 /* Try to minimize code size for boards that don't want much hashing */
-#if defined(CONFIG_SHA256) || defined(CONFIG_CMD_SHA1SUM) || \
-	defined(CONFIG_CRC32_VERIFY) || defined(CONFIG_CMD_HASH)
+#if defined(CONFIG_SHA256) || defined(CONFIG_SHA512) || \
+	defined(CONFIG_CMD_SHA1SUM) || defined(CONFIG_CRC32_VERIFY) || \
+	defined(CONFIG_CMD_HASH)
 #define multi_hash()	1
 #else
 #define multi_hash()	0
@@ -202,6 +380,14 @@ int hash_progressive_lookup_algo(const char *algo_name,
 	for (i = 0; i < ARRAY_SIZE(hash_algo); i++) {
 		if (!strcmp(algo_name, hash_algo[i].name)) {
 			if (hash_algo[i].hash_init) {
+#ifndef USE_HOSTCC
+#if CONFIG_IS_ENABLED(DM_HASH)
+				if (dm_hash_lookup_algo(algo_name) >= 0) {
+					*algop = hash_dm_algo(i);
+					return 0;
+				}
+#endif
+#endif
 				*algop = &hash_algo[i];
 				return 0;
 			}
@@ -250,7 +436,7 @@ int hash_block(const char *algo_name, const void *data, unsigned int len,
 	}
 	if (output_size)
 		*output_size = algo->digest_size;
-	algo->hash_func_ws(data, len, output, algo->chunk_size);
+	hash_algo_calculate(algo, data, len, output);
 
 	return 0;
 }
@@ -406,7 +592,7 @@ int hash_command(const char *algo_name, int flags, cmd_tbl_t *cmdtp, int flag,
 		}
 
 		buf = map_sysmem(addr, len);
-		algo->hash_func_ws(buf, len, output, algo->chunk_size);
+		hash_algo_calculate(algo, buf, len, output);
 		unmap_sysmem(buf);
 
 		/* Try to avoid code bloat when verify is not needed */
@@ -19,7 +19,10 @@
 #include <errno.h>
 #include <mapmem.h>
 #include <asm/io.h>
+#include <hash.h>
 #include <malloc.h>
+#include <watchdog.h>
+#include <u-boot/hash.h>
 DECLARE_GLOBAL_DATA_PTR;
 #endif /* !USE_HOSTCC*/
 
@@ -29,6 +32,7 @@ DECLARE_GLOBAL_DATA_PTR;
 #include <u-boot/md5.h>
 #include <u-boot/sha1.h>
 #include <u-boot/sha256.h>
+#include <u-boot/sha512.h>
 
 /*****************************************************************************/
 /* New uImage format routines */
@@ -972,6 +976,13 @@ int fit_set_timestamp(void *fit, int noffset, time_t timestamp)
 int calculate_hash(const void *data, int data_len, const char *algo,
 			uint8_t *value, int *value_len)
 {
+#ifndef USE_HOSTCC
+#if CONFIG_IS_ENABLED(DM_HASH)
+	/* Use a hash engine if there is one for this algorithm */
+	if (!dm_hash_block(algo, data, data_len, value, value_len))
+		return 0;
+#endif
+#endif
 	if (IMAGE_ENABLE_CRC32 && strcmp(algo, "crc32") == 0) {
 		*((uint32_t *)value) = crc32_wd(0, data, data_len,
 							CHUNKSZ_CRC32);
@@ -985,6 +996,14 @@ int calculate_hash(const void *data, int data_len, const char *algo,
 		sha256_csum_wd((unsigned char *)data, data_len,
 			       (unsigned char *)value, CHUNKSZ_SHA256);
 		*value_len = SHA256_SUM_LEN;
+	} else if (IMAGE_ENABLE_SHA512 && strcmp(algo, "sha384") == 0) {
+		sha384_csum_wd((unsigned char *)data, data_len,
+			       (unsigned char *)value, CHUNKSZ_SHA384);
+		*value_len = SHA384_SUM_LEN;
+	} else if (IMAGE_ENABLE_SHA512 && strcmp(algo, "sha512") == 0) {
+		sha512_csum_wd((unsigned char *)data, data_len,
+			       (unsigned char *)value, CHUNKSZ_SHA512);
+		*value_len = SHA512_SUM_LEN;
 	} else if (IMAGE_ENABLE_MD5 && strcmp(algo, "md5") == 0) {
 		md5_wd((unsigned char *)data, data_len, value, CHUNKSZ_MD5);
 		*value_len = 16;
@@ -995,14 +1014,40 @@ int calculate_hash(const void *data, int data_len, const char *algo,
 	return 0;
 }
 
+/*
+ * Compare a calculated hash @value with the value stored in hash node
+ * @noffset, returning 0 if they match and -1 (with *@err_msgp set) if not.
+ */
+static int fit_image_hash_compare(const void *fit, int noffset,
+				  const uint8_t *value, int value_len,
+				  char **err_msgp)
+{
+	uint8_t *fit_value;
+	int fit_value_len;
+
+	if (fit_image_hash_get_value(fit, noffset, &fit_value,
+				     &fit_value_len)) {
+		*err_msgp = "Can't get hash value property";
+		return -1;
+	}
+
+	if (value_len != fit_value_len) {
+		*err_msgp = "Bad hash value len";
+		return -1;
+	} else if (memcmp(value, fit_value, value_len) != 0) {
+		*err_msgp = "Bad hash value";
+		return -1;
+	}
+
+	return 0;
+}
+
 static int fit_image_check_hash(const void *fit, int noffset, const void *data,
 				size_t size, char **err_msgp)
 {
 	uint8_t value[FIT_MAX_HASH_LEN];
 	int value_len;
 	char *algo;
-	uint8_t *fit_value;
-	int fit_value_len;
 	int ignore;
 
 	*err_msgp = NULL;
@@ -1021,26 +1066,13 @@ static int fit_image_check_hash(const void *fit, int noffset, const void *data,
 		}
 	}
 
-	if (fit_image_hash_get_value(fit, noffset, &fit_value,
-				     &fit_value_len)) {
-		*err_msgp = "Can't get hash value property";
-		return -1;
-	}
-
 	if (calculate_hash(data, size, algo, value, &value_len)) {
 		*err_msgp = "Unsupported hash algorithm";
 		return -1;
 	}
 
-	if (value_len != fit_value_len) {
-		*err_msgp = "Bad hash value len";
-		return -1;
-	} else if (memcmp(value, fit_value, value_len) != 0) {
-		*err_msgp = "Bad hash value";
-		return -1;
-	}
-
-	return 0;
+	return fit_image_hash_compare(fit, noffset, value, value_len,
+				      err_msgp);
 }
 
 /**
@@ -1603,6 +1635,190 @@ void fit_conf_print(const void *fit, int noffset, const char *p)
 	}
 }
 
+#if !defined(USE_HOSTCC) && !defined(CONFIG_SPL_BUILD) && \
+	defined(CONFIG_HASH) && !defined(CONFIG_FIT_IMAGE_POST_PROCESS)
+#define FIT_VERIFY_COPY		1
+#else
+#define FIT_VERIFY_COPY		0
+#endif
+
+#if FIT_VERIFY_COPY
+/* Most hash nodes fit_image_verify_copy() handles in one image */
+#define FIT_MAX_HASH_NODES	4
+
+struct fit_copy_hash {
+	int noffset;
+	struct hash_algo *algo;
+	void *ctx;
+};
+
+/**
+ * fit_image_verify_copy() - verify data integrity while copying the data
+ * @fit: pointer to the FIT format image header
+ * @image_noffset: component image node offset
+ * @data: image data
+ * @size: image data size
+ * @dst: destination, which must not overlap @data
+ *
+ * Does the same checks as fit_image_verify(), but feeds the data to all
+ * hash algorithms and copies it to @dst a chunk at a time, so that large
+ * images are read from memory once instead of once per hash node and once
+ * more for the copy. On a bad hash @dst holds garbage and must not be used.
+ *
+ * returns:
+ *     1, if all hashes are valid
+ *     0, otherwise (or on error)
+ *     -ENOSYS, if a hash cannot be computed progressively; nothing has been
+ *        checked or copied in this case
+ */
+static int fit_image_verify_copy(const void *fit, int image_noffset,
+				 const void *data, size_t size, void *dst)
+{
+	struct fit_copy_hash hashes[FIT_MAX_HASH_NODES], *hash;
+	uint8_t value[FIT_MAX_HASH_LEN];
+	int count = 0, verify_all = 1;
+	char *err_msg = "";
+	int noffset = 0;
+	size_t pos, chunk;
+	char *algo;
+	int ignore;
+	int i, ret;
+
+	/* Collect the hash nodes, giving up on any we cannot stream */
+	fdt_for_each_subnode(noffset, fit, image_noffset) {
+		const char *name = fit_get_name(fit, noffset, NULL);
+
+		if (strncmp(name, FIT_HASH_NODENAME, strlen(FIT_HASH_NODENAME)))
+			continue;
+		if (IMAGE_ENABLE_IGNORE) {
+			fit_image_hash_get_ignore(fit, noffset, &ignore);
+			if (ignore)
+				continue;
+		}
+		if (count == FIT_MAX_HASH_NODES ||
+		    fit_image_hash_get_algo(fit, noffset, &algo) ||
+		    hash_progressive_lookup_algo(algo, &hashes[count].algo))
+			return -ENOSYS;
+		hashes[count].ctx = NULL;
+		hashes[count++].noffset = noffset;
+	}
+	if (noffset == -FDT_ERR_TRUNCATED || noffset == -FDT_ERR_BADSTRUCTURE)
+		return -ENOSYS;
+
+	/* Verify all required signatures */
+	if (IMAGE_ENABLE_VERIFY &&
+	    fit_image_verify_required_sigs(fit, image_noffset, data, size,
+					   gd_fdt_blob(), &verify_all)) {
+		err_msg = "Unable to verify required signature";
+		noffset = image_noffset;
+		goto error;
+	}
+
+	for (i = 0, hash = hashes; i < count; i++, hash++) {
+		noffset = hash->noffset;
+		if (hash->algo->hash_init(hash->algo, &hash->ctx)) {
+			err_msg = "Can't initialise hash";
+			goto error_free;
+		}
+	}
+
+	for (pos = 0; pos < size; pos += chunk) {
+		chunk = min_t(size_t, size - pos, CHUNKSZ);
+		for (i = 0, hash = hashes; i < count; i++, hash++) {
+			ret = hash->algo->hash_update(hash->algo, hash->ctx,
+						      data + pos, chunk,
+						      pos + chunk == size);
+			if (ret) {
+				/* the context has been freed already */
+				hash->ctx = NULL;
+				noffset = hash->noffset;
+				err_msg = "Can't update hash";
+				goto error_free;
+			}
+		}
+		memcpy(dst + pos, data + pos, chunk);
+		WATCHDOG_RESET();
+	}
+
+	for (i = 0, hash = hashes; i < count; i++, hash++) {
+		noffset = hash->noffset;
+		fit_image_hash_get_algo(fit, noffset, &algo);
+		printf("%s", algo);
+		ret = hash->algo->hash_finish(hash->algo, hash->ctx, value,
+					      sizeof(value));
+		hash->ctx = NULL;
+		if (ret) {
+			err_msg = "Can't finish hash";
+			goto error_free;
+		}
+		/* FIT stores CRC32 values big-endian, see calculate_hash() */
+		if (!strcmp(algo, "crc32"))
+			*((uint32_t *)value) =
+				cpu_to_uimage(*((uint32_t *)value));
+
+		if (fit_image_hash_compare(fit, noffset, value,
+					   hash->algo->digest_size, &err_msg))
+			goto error_free;
+		puts("+ ");
+	}
+
+	/* Check optional signatures, as fit_image_verify() does */
+	fdt_for_each_subnode(noffset, fit, image_noffset) {
+		const char *name = fit_get_name(fit, noffset, NULL);
+
+		if (IMAGE_ENABLE_VERIFY && verify_all &&
+		    !strncmp(name, FIT_SIG_NODENAME, strlen(FIT_SIG_NODENAME))) {
+			ret = fit_image_check_sig(fit, noffset, data, size, -1,
+						  &err_msg);
+			puts(ret ? "- " : "+ ");
+		}
+	}
+
+	return 1;
+
+error_free:
+	for (i = 0, hash = hashes; i < count; i++, hash++) {
+		if (hash->ctx)
+			hash->algo->hash_finish(hash->algo, hash->ctx, value,
+						sizeof(value));
+		hash->ctx = NULL;
+	}
+error:
+	printf(" error!\n%s for '%s' hash node in '%s' image node\n",
+	       err_msg, fit_get_name(fit, noffset, NULL),
+	       fit_get_name(fit, image_noffset, NULL));
+	return 0;
+}
+#endif /* FIT_VERIFY_COPY */
+
+/*
+ * Verify an image whose checks fit_image_select() left to the load step,
+ * copying it to @dst (if not NULL) at the same time where possible.
+ */
+static int fit_image_verify_load(const void *fit, int noffset, const void *buf,
+				 size_t len, void *dst)
+{
+	int ret = -ENOSYS;
+
+	puts("   Verifying Hash Integrity ... ");
+#if FIT_VERIFY_COPY
+	if (dst && (dst + len <= buf || buf + len <= dst))
+		ret = fit_image_verify_copy(fit, noffset, buf, len, dst);
+#endif
+	if (ret == -ENOSYS) {
+		ret = fit_image_verify(fit, noffset);
+		if (ret && dst)
+			memmove(dst, buf, len);
+	}
+	if (!ret) {
+		puts("Bad Data Hash\n");
+		return -EACCES;
+	}
+	puts("OK\n");
+
+	return 0;
+}
+
 static int fit_image_select(const void *fit, int rd_noffset, int verify)
 {
 	fit_image_print(fit, rd_noffset, "   ");
@@ -1696,6 +1912,7 @@ int fit_image_load(bootm_headers_t *images, ulong addr,
 	uint8_t os_arch;
 #endif
 	const char *prop_name;
+	int verify_later;
 	int ret;
 
 	fit = map_sysmem(addr, 0);
@@ -1765,7 +1982,13 @@ int fit_image_load(bootm_headers_t *images, ulong addr,
 
 	printf("   Trying '%s' %s subimage\n", fit_uname, prop_name);
 
-	ret = fit_image_select(fit, noffset, images->verify);
+	/*
+	 * Where the data can be hashed while it is copied to the load
+	 * address, leave verification to the load step below so that the
+	 * image is only read once.
+	 */
+	verify_later = FIT_VERIFY_COPY && images->verify;
+	ret = fit_image_select(fit, noffset, images->verify && !verify_later);
 	if (ret) {
 		bootstage_error(bootstage_id + BOOTSTAGE_SUB_HASH);
 		return ret;
@@ -1853,6 +2076,21 @@ int fit_image_load(bootm_headers_t *images, ulong addr,
 		data = map_to_sysmem(vbuf);
 	}
 
+	/*
+	 * bootm_load_os() would copy an uncompressed kernel to its load
+	 * address only after it has been verified here. Copy it now instead,
+	 * hashing it on the way, so that bootm finds it already in place.
+	 * This needs the load address to be clear of the FIT, which bootm
+	 * still uses.
+	 */
+	if (load_op == FIT_LOAD_IGNORED && verify_later &&
+	    image_type == IH_TYPE_KERNEL &&
+	    fit_image_check_type(fit, noffset, IH_TYPE_KERNEL) &&
+	    fit_image_check_comp(fit, noffset, IH_COMP_NONE) &&
+	    !fit_image_get_load(fit, noffset, &load) && load != data &&
+	    (load + len <= addr || load >= addr + fit_get_size(fit)))
+		load_op = FIT_LOAD_REQUIRED;
+
 	if (load_op == FIT_LOAD_IGNORED) {
 		/* Don't load */
 	} else if (fit_image_get_load(fit, noffset, &load)) {
@@ -1885,9 +2123,26 @@ int fit_image_load(bootm_headers_t *images, ulong addr,
 		       prop_name, data, load);
 
 		dst = map_sysmem(load, len);
-		memmove(dst, buf, len);
+		if (verify_later) {
+			ret = fit_image_verify_load(fit, noffset, buf, len, dst);
+			if (ret) {
+				bootstage_error(bootstage_id +
+						BOOTSTAGE_SUB_HASH);
+				return ret;
+			}
+			verify_later = 0;
+		} else {
+			memmove(dst, buf, len);
+		}
 		data = load;
 	}
+	if (verify_later) {
+		ret = fit_image_verify_load(fit, noffset, buf, len, NULL);
+		if (ret) {
+			bootstage_error(bootstage_id + BOOTSTAGE_SUB_HASH);
+			return ret;
+		}
+	}
 	bootstage_mark(bootstage_id + BOOTSTAGE_SUB_LOAD);
 
 	*datap = data;
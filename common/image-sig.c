@@ -13,6 +13,7 @@
 DECLARE_GLOBAL_DATA_PTR;
 #endif /* !USE_HOSTCC*/
 #include <image.h>
+#include <u-boot/ecdsa.h>
 #include <u-boot/rsa.h>
 #include <u-boot/rsa-checksum.h>
 
@@ -50,7 +51,29 @@ struct checksum_algo checksum_algos[] = {
 		EVP_sha256,
 #endif
 		hash_calculate,
-	}
+	},
+#ifdef CONFIG_SHA512
+	{
+		"sha384",
+		SHA384_SUM_LEN,
+		SHA384_DER_LEN,
+		sha384_der_prefix,
+#if IMAGE_ENABLE_SIGN
+		EVP_sha384,
+#endif
+		hash_calculate,
+	},
+	{
+		"sha512",
+		SHA512_SUM_LEN,
+		SHA512_DER_LEN,
+		sha512_der_prefix,
+#if IMAGE_ENABLE_SIGN
+		EVP_sha512,
+#endif
+		hash_calculate,
+	},
+#endif
 
 };
 
@@ -68,7 +91,23 @@ struct crypto_algo crypto_algos[] = {
 		rsa_sign,
 		rsa_add_verify_data,
 		rsa_verify,
-	}
+	},
+#ifdef CONFIG_ECDSA
+	{
+		"ecdsa256",
+		ECDSA256_BYTES,
+		ecdsa_sign,
+		ecdsa_add_verify_data,
+		ecdsa_verify,
+	},
+	{
+		"ecdsa384",
+		ECDSA384_BYTES,
+		ecdsa_sign,
+		ecdsa_add_verify_data,
+		ecdsa_verify,
+	},
+#endif
 
 };
 
@@ -9,6 +9,7 @@
 
 #ifndef USE_HOSTCC
 #include <common.h>
+#include <cyclic.h>
 #include <watchdog.h>
 
 #ifdef CONFIG_SHOW_BOOT_PROGRESS
@@ -178,6 +179,7 @@ static const table_entry_t uimage_comp[] = {
 	{	IH_COMP_LZMA,	"lzma",		"lzma compressed",	},
 	{	IH_COMP_LZO,	"lzo",		"lzo compressed",	},
 	{	IH_COMP_LZ4,	"lz4",		"lz4 compressed",	},
+	{	IH_COMP_ZSTD,	"zstd",		"zstd compressed",	},
 	{	-1,		"",		"",			},
 };
 
@@ -531,14 +533,22 @@ void memmove_wd(void *to, void *from, size_t len, ulong chunksz)
 	if (to == from)
 		return;
 
-#if defined(CONFIG_HW_WATCHDOG) || defined(CONFIG_WATCHDOG)
+#if defined(CONFIG_HW_WATCHDOG) || defined(CONFIG_WATCHDOG) || \
+	CONFIG_IS_ENABLED(CYCLIC)
+#if !defined(CONFIG_HW_WATCHDOG) && !defined(CONFIG_WATCHDOG)
+	/* Without a watchdog, only cyclic functions need the copy split up */
+	if (!cyclic_registered()) {
+		memmove(to, from, len);
+		return;
+	}
+#endif
 	if (to > from) {
 		from += len;
 		to += len;
 	}
 	while (len > 0) {
 		size_t tail = (len > chunksz) ? chunksz : len;
-		WATCHDOG_RESET();
+		cyclic_schedule();
 		if (to > from) {
 			to -= tail;
 			from -= tail;
@@ -550,9 +560,9 @@ void memmove_wd(void *to, void *from, size_t len, ulong chunksz)
 		}
 		len -= tail;
 	}
-#else	/* !(CONFIG_HW_WATCHDOG || CONFIG_WATCHDOG) */
+#else	/* !(CONFIG_HW_WATCHDOG || CONFIG_WATCHDOG || CONFIG_CYCLIC) */
 	memmove(to, from, len);
-#endif	/* CONFIG_HW_WATCHDOG || CONFIG_WATCHDOG */
+#endif	/* CONFIG_HW_WATCHDOG || CONFIG_WATCHDOG || CONFIG_CYCLIC */
 }
 #endif /* !USE_HOSTCC */
 
@@ -219,6 +219,7 @@ void part_init(struct blk_desc *dev_desc)
 	struct part_driver *entry;
 
 	blkcache_invalidate(dev_desc->if_type, dev_desc->devnum);
+	fs_cache_invalidate();
 
 	dev_desc->part_type = PART_TYPE_UNKNOWN;
 	for (entry = drv; entry != drv + n_ents; entry++) {
@@ -432,6 +432,7 @@ unsigned long blk_dwrite(struct blk_desc *block_dev, lbaint_t start,
 		return -ENOSYS;
 
 	blkcache_invalidate(block_dev->if_type, block_dev->devnum);
+	fs_cache_invalidate();
 	return ops->write(dev, start, blkcnt, buffer);
 }
 
@@ -445,6 +446,7 @@ unsigned long blk_derase(struct blk_desc *block_dev, lbaint_t start,
 		return -ENOSYS;
 
 	blkcache_invalidate(block_dev->if_type, block_dev->devnum);
+	fs_cache_invalidate();
 	return ops->erase(dev, start, blkcnt);
 }
 
@@ -247,7 +247,7 @@ ulong blk_write_devnum(enum if_type if_type, int devnum, lbaint_t start,
 	ret = get_desc(drv, devnum, &desc);
 	if (ret)
 		return ret;
-	return desc->block_write(desc, start, blkcnt, buffer);
+	return blk_dwrite(desc, start, blkcnt, buffer);
 }
 
 int blk_select_hwpart_devnum(enum if_type if_type, int devnum, int hwpart)
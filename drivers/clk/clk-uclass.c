@@ -22,20 +22,40 @@ static inline struct clk_ops *clk_dev_ops(struct udevice *dev)
 
 #if CONFIG_IS_ENABLED(OF_CONTROL)
 # if CONFIG_IS_ENABLED(OF_PLATDATA)
-int clk_get_by_index_platdata(struct udevice *dev, int index,
-			      struct phandle_1_arg *cells, struct clk *clk)
+int clk_get_by_platdata_cells(struct udevice *dev, int index,
+			      const void *cells, int count, int size,
+			      struct clk *clk)
 {
+	const struct phandle_1_arg *cell;
 	int ret;
 
-	if (index != 0)
-		return -ENOSYS;
-	ret = uclass_get_device(UCLASS_CLK, 0, &clk->dev);
+	if (index < 0 || index >= count)
+		return -ENOENT;
+	/* All phandle_<n>_arg structs start the same; only arg[] differs */
+	cell = cells + index * size;
+	ret = device_get_by_of_platdata(cell->node, &clk->dev);
+	if (ret == -ENOENT) {
+		/* The clock may have been bound without of-platdata */
+		if (index != 0)
+			return -ENOSYS;
+		ret = uclass_get_device(UCLASS_CLK, 0, &clk->dev);
+	}
 	if (ret)
 		return ret;
-	clk->id = cells[0].arg[0];
+	/* A provider with #clock-cells = <0> has no arguments */
+	if (size > offsetof(struct phandle_1_arg, arg))
+		clk->id = cell->arg[0];
+	else
+		clk->id = 0;
 
 	return 0;
 }
+
+int clk_get_by_index(struct udevice *dev, int index, struct clk *clk)
+{
+	/* Drivers must use clk_get_by_index_platdata() with their dtplat */
+	return -ENOSYS;
+}
 # else
 static int clk_of_xlate_default(struct clk *clk,
 				struct ofnode_phandle_args *args)
@@ -0,0 +1,320 @@
+/*
+ * Probing devices in the background
+ *
+ * With CONFIG_DM_ASYNC_PROBE, a driver whose probe() method returns
+ * -EINPROGRESS is left part-way through probing and its probe_poll() method
+ * is called until it finishes. Several devices can be probed like this at
+ * once: they all make progress whenever something waits for one of them.
+ * Children of a device which is still probing are queued until it is ready.
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <dm.h>
+#include <errno.h>
+#include <malloc.h>
+#include <watchdog.h>
+#include <dm/device-internal.h>
+#include <dm/root.h>
+#include <dm/uclass-internal.h>
+#include <dm/util.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+enum dm_async_stage {
+	DM_ASYNC_WAIT_PARENT,	/* Waiting for the parent to be probed */
+	DM_ASYNC_PROBING,	/* Driver is probing the device */
+	DM_ASYNC_DONE,		/* Finished, see @ret */
+};
+
+/**
+ * struct dm_async_probe - A device which is being probed in the background
+ *
+ * @sibling_node: Node in the list of devices being probed
+ * @dev: Device being probed
+ * @stage: Progress of the probe
+ * @ret: Result of the probe, once @stage is DM_ASYNC_DONE
+ * @waiters: Number of callers waiting for this device
+ * @busy: true while the driver is being called for this device
+ */
+struct dm_async_probe {
+	struct list_head sibling_node;
+	struct udevice *dev;
+	enum dm_async_stage stage;
+	int ret;
+	int waiters;
+	bool busy;
+};
+
+/**
+ * struct dm_async_state - Devices which are being probed in the background
+ *
+ * @head: List of struct dm_async_probe
+ * @depth: Number of nested calls to dm_async_poll(). Entries are only freed
+ * by the outermost call.
+ */
+struct dm_async_state {
+	struct list_head head;
+	int depth;
+};
+
+static struct dm_async_state *dm_async_get_state(void)
+{
+	struct dm_async_state *state = gd->dm_async;
+
+	if (!state) {
+		state = calloc(1, sizeof(*state));
+		if (!state)
+			return NULL;
+		INIT_LIST_HEAD(&state->head);
+		gd->dm_async = state;
+	}
+
+	return state;
+}
+
+static struct dm_async_probe *dm_async_find(struct dm_async_state *state,
+					    struct udevice *dev)
+{
+	struct dm_async_probe *ap;
+
+	list_for_each_entry(ap, &state->head, sibling_node) {
+		if (ap->dev == dev && ap->stage != DM_ASYNC_DONE)
+			return ap;
+	}
+
+	return NULL;
+}
+
+static void dm_async_reap(struct dm_async_state *state)
+{
+	struct dm_async_probe *ap, *next;
+
+	if (state->depth)
+		return;
+	list_for_each_entry_safe(ap, next, &state->head, sibling_node) {
+		if (ap->stage == DM_ASYNC_DONE && !ap->waiters) {
+			list_del(&ap->sibling_node);
+			free(ap);
+		}
+	}
+}
+
+static void dm_async_done(struct dm_async_probe *ap, int ret)
+{
+	ap->stage = DM_ASYNC_DONE;
+	ap->ret = ret;
+	if (ret)
+		debug("%s: Device '%s' failed to probe (err=%d)\n", __func__,
+		      ap->dev->name, ret);
+	else
+		dm_dbg("Probed device '%s'\n", ap->dev->name);
+}
+
+/* Move a device along, returning -EINPROGRESS if it is not done yet */
+static int dm_async_step(struct dm_async_probe *ap)
+{
+	struct udevice *dev = ap->dev;
+	int ret;
+
+	if (ap->stage == DM_ASYNC_WAIT_PARENT &&
+	    (dev->parent->flags & DM_FLAG_PROBE_PENDING))
+		return -EINPROGRESS;
+
+	ap->busy = true;
+	if (ap->stage == DM_ASYNC_WAIT_PARENT) {
+		ret = device_probe_start(dev);
+		if (ret == -EINPROGRESS)
+			ap->stage = DM_ASYNC_PROBING;
+	} else {
+		ret = dev->driver->probe_poll(dev);
+		if (ret != -EINPROGRESS) {
+			/* Let device_remove() clean up if the uclass fails */
+			dev->flags &= ~DM_FLAG_PROBE_PENDING;
+			ret = device_probe_finish(dev, ret);
+		}
+	}
+	ap->busy = false;
+	if (ret != -EINPROGRESS) {
+		dev->flags &= ~DM_FLAG_PROBE_PENDING;
+		dm_async_done(ap, ret);
+	}
+
+	return ret;
+}
+
+static int dm_async_add(struct udevice *dev, enum dm_async_stage stage)
+{
+	struct dm_async_state *state;
+	struct dm_async_probe *ap;
+	int ret;
+
+	state = dm_async_get_state();
+	ap = state ? calloc(1, sizeof(*ap)) : NULL;
+	if (!ap) {
+		/* Finish the probe here rather than lose track of it */
+		if (stage == DM_ASYNC_WAIT_PARENT) {
+			ret = device_probe_wait(dev->parent);
+			if (!ret)
+				ret = device_probe_start(dev);
+			if (ret != -EINPROGRESS)
+				return ret;
+		}
+		do {
+			ret = dev->driver->probe_poll(dev);
+			WATCHDOG_RESET();
+		} while (ret == -EINPROGRESS);
+
+		return device_probe_finish(dev, ret);
+	}
+	ap->dev = dev;
+	ap->stage = stage;
+	dev->flags |= DM_FLAG_PROBE_PENDING;
+	list_add_tail(&ap->sibling_node, &state->head);
+
+	return -EINPROGRESS;
+}
+
+int device_probe_async(struct udevice *dev)
+{
+	int ret;
+
+	if (!dev)
+		return -EINVAL;
+	if (dev->flags & DM_FLAG_PROBE_PENDING)
+		return -EINPROGRESS;
+	if (dev->flags & DM_FLAG_ACTIVATED)
+		return 0;
+
+	if (dev->parent) {
+		ret = device_probe_async(dev->parent);
+		if (ret == -EINPROGRESS)
+			return dm_async_add(dev, DM_ASYNC_WAIT_PARENT);
+		if (ret)
+			return ret;
+	}
+
+	ret = device_probe_start(dev);
+	if (ret == -EINPROGRESS)
+		return dm_async_add(dev, DM_ASYNC_PROBING);
+
+	return ret;
+}
+
+int device_probe_wait(struct udevice *dev)
+{
+	struct dm_async_state *state = gd->dm_async;
+	struct dm_async_probe *ap;
+	int ret;
+
+	if (!dev)
+		return -EINVAL;
+	if (!(dev->flags & DM_FLAG_PROBE_PENDING))
+		return device_probe(dev);
+	ap = state ? dm_async_find(state, dev) : NULL;
+	if (!ap)
+		return -ENOENT;
+
+	ap->waiters++;
+	while (ap->stage != DM_ASYNC_DONE) {
+		/* The driver is using something that needs this device */
+		if (ap->busy) {
+			dm_warn("Device '%s' depends on itself\n", dev->name);
+			ap->waiters--;
+			return -EDEADLK;
+		}
+		dm_async_poll();
+		WATCHDOG_RESET();
+	}
+	ret = ap->ret;
+	ap->waiters--;
+	dm_async_reap(state);
+
+	return ret;
+}
+
+int dm_async_poll(void)
+{
+	struct dm_async_state *state = gd->dm_async;
+	struct dm_async_probe *ap;
+	int count = 0;
+
+	if (!state)
+		return 0;
+
+	/* Entries may be added while this runs, but not removed */
+	state->depth++;
+	list_for_each_entry(ap, &state->head, sibling_node) {
+		if (ap->stage == DM_ASYNC_DONE || ap->busy)
+			continue;
+		if (dm_async_step(ap) == -EINPROGRESS)
+			count++;
+	}
+	state->depth--;
+	dm_async_reap(state);
+
+	return count;
+}
+
+int dm_async_probe_uclass(enum uclass_id id)
+{
+	struct udevice *dev;
+	struct uclass *uc;
+	int ret, err = 0;
+	int pass;
+
+	ret = uclass_get(id, &uc);
+	if (ret)
+		return ret;
+
+	/*
+	 * Sequence numbers are assigned when probing starts, so start the
+	 * devices which have an alias first. Otherwise another device could
+	 * take the number that the alias asks for.
+	 */
+	for (pass = 0; pass < 2; pass++) {
+		uclass_foreach_dev(dev, uc) {
+			if ((dev->req_seq == -1) != pass)
+				continue;
+			ret = device_probe_async(dev);
+			if (ret && ret != -EINPROGRESS && !err)
+				err = ret;
+		}
+	}
+
+	return err;
+}
+
+void dm_async_wait_all(void)
+{
+	while (dm_async_poll())
+		WATCHDOG_RESET();
+}
+
+void dm_async_forget(struct udevice *dev)
+{
+	struct dm_async_state *state = gd->dm_async;
+	struct dm_async_probe *ap;
+
+	if (!state || !(dev->flags & DM_FLAG_PROBE_PENDING))
+		return;
+	ap = dm_async_find(state, dev);
+	if (ap && ap->stage == DM_ASYNC_WAIT_PARENT) {
+		dev->flags &= ~DM_FLAG_PROBE_PENDING;
+		dm_async_done(ap, -ENODEV);
+		dm_async_reap(state);
+	}
+}
+
+void dm_async_reset(void)
+{
+	struct dm_async_state *state = gd->dm_async;
+
+	if (!state)
+		return;
+	dm_async_wait_all();
+	dm_async_reap(state);
+	free(state);
+	gd->dm_async = NULL;
+}
@@ -14,6 +14,7 @@
 #include <malloc.h>
 #include <dm/device.h>
 #include <dm/device-internal.h>
+#include <dm/root.h>
 #include <dm/uclass.h>
 #include <dm/uclass-internal.h>
 #include <dm/util.h>
@@ -79,6 +80,8 @@ int device_unbind(struct udevice *dev)
 	if (!(dev->flags & DM_FLAG_BOUND))
 		return -EINVAL;
 
+	dm_async_forget(dev);
+
 	drv = dev->driver;
 	assert(drv);
 
@@ -91,6 +94,7 @@ int device_unbind(struct udevice *dev)
 	ret = device_chld_unbind(dev);
 	if (ret)
 		return ret;
+	dm_lazy_forget(dev);
 
 	if (dev->flags & DM_FLAG_ALLOC_PDATA) {
 		free(dev->platdata);
@@ -169,6 +173,10 @@ int device_remove(struct udevice *dev, uint flags)
 	if (!dev)
 		return -EINVAL;
 
+	if (CONFIG_IS_ENABLED(DM_ASYNC_PROBE) &&
+	    (dev->flags & DM_FLAG_PROBE_PENDING))
+		device_probe_wait(dev);
+
 	if (!(dev->flags & DM_FLAG_ACTIVATED))
 		return 0;
 
@@ -204,7 +212,7 @@ int device_remove(struct udevice *dev, uint flags)
 	if (flags_remove(flags, drv->flags)) {
 		device_free(dev);
 
-		dev->seq = -1;
+		uclass_set_device_seq(dev, -1);
 		dev->flags &= ~DM_FLAG_ACTIVATED;
 	}
 
@@ -20,6 +20,7 @@
 #include <dm/pinctrl.h>
 #include <dm/platdata.h>
 #include <dm/read.h>
+#include <dm/root.h>
 #include <dm/uclass.h>
 #include <dm/uclass-internal.h>
 #include <dm/util.h>
@@ -42,7 +43,7 @@ static int device_bind_common(struct udevice *parent, const struct driver *drv,
 	if (!name)
 		return -EINVAL;
 
-	ret = uclass_get(drv->id, &uc);
+	ret = uclass_get_nolazy(drv->id, &uc);
 	if (ret) {
 		debug("Missing uclass for driver %s\n", drv->name);
 		return ret;
@@ -233,7 +234,9 @@ int device_bind_by_name(struct udevice *parent, bool pre_reloc_only,
 			const struct driver_info *info, struct udevice **devp)
 {
 	struct driver *drv;
+	struct udevice *dev;
 	uint platdata_size = 0;
+	int ret;
 
 	drv = lists_driver_lookup_name(info->name);
 	if (!drv)
@@ -244,9 +247,18 @@ int device_bind_by_name(struct udevice *parent, bool pre_reloc_only,
 #if CONFIG_IS_ENABLED(OF_PLATDATA)
 	platdata_size = info->platdata_size;
 #endif
-	return device_bind_common(parent, drv, info->name,
+	ret = device_bind_common(parent, drv, info->name,
 			(void *)info->platdata, 0, ofnode_null(), platdata_size,
-			devp);
+			&dev);
+	if (ret)
+		return ret;
+#if CONFIG_IS_ENABLED(OF_PLATDATA)
+	dev->of_platdata = info->platdata;
+#endif
+	if (devp)
+		*devp = dev;
+
+	return 0;
 }
 
 static void *alloc_priv(int size, uint flags)
@@ -292,7 +304,7 @@ static void *alloc_priv(int size, uint flags)
 	return priv;
 }
 
-int device_probe(struct udevice *dev)
+int device_probe_start(struct udevice *dev)
 {
 	const struct driver *drv;
 	int size = 0;
@@ -360,7 +372,7 @@ int device_probe(struct udevice *dev)
 		ret = seq;
 		goto fail;
 	}
-	dev->seq = seq;
+	uclass_set_device_seq(dev, seq);
 
 	dev->flags |= DM_FLAG_ACTIVATED;
 
@@ -391,12 +403,28 @@ int device_probe(struct udevice *dev)
 
 	if (drv->probe) {
 		ret = drv->probe(dev);
-		if (ret) {
-			dev->flags &= ~DM_FLAG_ACTIVATED;
+		/* The driver finishes the probe in its probe_poll() method */
+		if (ret == -EINPROGRESS && drv->probe_poll)
+			return ret;
+		if (ret)
 			goto fail;
-		}
 	}
 
+	return device_probe_finish(dev, 0);
+fail:
+	dev->flags &= ~DM_FLAG_ACTIVATED;
+
+	uclass_set_device_seq(dev, -1);
+	device_free(dev);
+
+	return ret;
+}
+
+int device_probe_finish(struct udevice *dev, int ret)
+{
+	if (ret)
+		goto fail;
+
 	ret = uclass_post_probe_device(dev);
 	if (ret)
 		goto fail_uclass;
@@ -413,12 +441,55 @@ fail_uclass:
 fail:
 	dev->flags &= ~DM_FLAG_ACTIVATED;
 
-	dev->seq = -1;
+	uclass_set_device_seq(dev, -1);
 	device_free(dev);
 
 	return ret;
 }
 
+static int device_probe_run(struct udevice *dev)
+{
+	int ret;
+
+	if (CONFIG_IS_ENABLED(DM_ASYNC_PROBE)) {
+		ret = device_probe_async(dev);
+		if (ret == -EINPROGRESS)
+			ret = device_probe_wait(dev);
+
+		return ret;
+	}
+
+	ret = device_probe_start(dev);
+	if (ret != -EINPROGRESS)
+		return ret;
+
+	/* Without asynchronous probing, just wait for the driver to finish */
+	do {
+		ret = dev->driver->probe_poll(dev);
+	} while (ret == -EINPROGRESS);
+
+	return device_probe_finish(dev, ret);
+}
+
+int device_probe(struct udevice *dev)
+{
+#if CONFIG_IS_ENABLED(BOOTSTAGE_DM_PROBE)
+	/* Only time devices which are actually probed here */
+	if (dev && gd->bootstage && !(dev->flags & DM_FLAG_ACTIVATED)) {
+		ulong start_us = timer_get_boot_us();
+		int ret;
+
+		ret = device_probe_run(dev);
+		if (!ret)
+			bootstage_add_span(dev->name, NULL, start_us);
+
+		return ret;
+	}
+#endif
+
+	return device_probe_run(dev);
+}
+
 void *dev_get_platdata(struct udevice *dev)
 {
 	if (!dev) {
@@ -498,6 +569,7 @@ int device_get_child(struct udevice *parent, int index, struct udevice **devp)
 {
 	struct udevice *dev;
 
+	dm_lazy_bind_children(parent);
 	list_for_each_entry(dev, &parent->child_head, sibling_node) {
 		if (!index--)
 			return device_get_device_tail(dev, 0, devp);
@@ -514,6 +586,9 @@ int device_find_child_by_seq(struct udevice *parent, int seq_or_req_seq,
 	*devp = NULL;
 	if (seq_or_req_seq == -1)
 		return -ENODEV;
+	/* Only probed devices have a sequence, so only bind for req_seq */
+	if (find_req_seq)
+		dm_lazy_bind_children(parent);
 
 	list_for_each_entry(dev, &parent->child_head, sibling_node) {
 		if ((find_req_seq ? dev->req_seq : dev->seq) ==
@@ -557,6 +632,11 @@ int device_find_child_by_of_offset(struct udevice *parent, int of_offset,
 			return 0;
 		}
 	}
+	if (!dm_lazy_bind_node(offset_to_ofnode(of_offset), &dev) &&
+	    dev->parent == parent) {
+		*devp = dev;
+		return 0;
+	}
 
 	return -ENODEV;
 }
@@ -594,11 +674,42 @@ int device_get_global_by_of_offset(int of_offset, struct udevice **devp)
 	struct udevice *dev;
 
 	dev = _device_find_global_by_of_offset(gd->dm_root, of_offset);
+	if (!dev)
+		dm_lazy_bind_node(offset_to_ofnode(of_offset), &dev);
 	return device_get_device_tail(dev, dev ? 0 : -ENOENT, devp);
 }
 
+#if CONFIG_IS_ENABLED(OF_PLATDATA)
+static struct udevice *_device_find_by_of_platdata(struct udevice *parent,
+						   const void *of_platdata)
+{
+	struct udevice *dev, *found;
+
+	if (parent->of_platdata == of_platdata)
+		return parent;
+
+	list_for_each_entry(dev, &parent->child_head, sibling_node) {
+		found = _device_find_by_of_platdata(dev, of_platdata);
+		if (found)
+			return found;
+	}
+
+	return NULL;
+}
+
+int device_get_by_of_platdata(const void *of_platdata, struct udevice **devp)
+{
+	struct udevice *dev = NULL;
+
+	if (of_platdata)
+		dev = _device_find_by_of_platdata(gd->dm_root, of_platdata);
+	return device_get_device_tail(dev, dev ? 0 : -ENOENT, devp);
+}
+#endif
+
 int device_find_first_child(struct udevice *parent, struct udevice **devp)
 {
+	dm_lazy_bind_children(parent);
 	if (list_empty(&parent->child_head)) {
 		*devp = NULL;
 	} else {
@@ -657,6 +768,7 @@ const char *dev_get_uclass_name(struct udevice *dev)
 
 bool device_has_children(struct udevice *dev)
 {
+	dm_lazy_bind_children(dev);
 	return !list_empty(&dev->child_head);
 }
 
@@ -699,6 +811,11 @@ int device_set_name(struct udevice *dev, const char *name)
 	return 0;
 }
 
+void dev_set_ofnode(struct udevice *dev, ofnode node)
+{
+	uclass_set_device_node(dev, node);
+}
+
 bool device_is_compatible(struct udevice *dev, const char *compat)
 {
 	const void *fdt = gd->fdt_blob;
@@ -0,0 +1,292 @@
+/*
+ * Deferred binding of device tree nodes
+ *
+ * With CONFIG_DM_LAZY_BIND, device tree nodes which are not needed before
+ * relocation, have no subnodes to scan and whose driver does not create
+ * children when bound are not bound when the tree is scanned. Instead they
+ * are recorded here and bound when something looks for them: by node or
+ * phandle, or by asking for their uclass.
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <dm.h>
+#include <errno.h>
+#include <malloc.h>
+#include <dm/lists.h>
+#include <dm/of_access.h>
+#include <dm/root.h>
+#include <dm/util.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+/**
+ * struct dm_lazy_node - A device tree node which has not been bound yet
+ *
+ * @parent: Parent device to bind to, or NULL if no longer pending
+ * @node: Device tree node
+ * @id: uclass of the driver that matches the node
+ */
+struct dm_lazy_node {
+	struct udevice *parent;
+	ofnode node;
+	enum uclass_id id;
+};
+
+/**
+ * struct dm_lazy_state - Nodes whose binding has been deferred
+ *
+ * @nodes: Deferred nodes, in the order they were scanned
+ * @count: Number of entries used in @nodes
+ * @size: Number of entries allocated in @nodes
+ * @total: Number of nodes still pending
+ * @pending: Number of nodes still pending in each uclass
+ */
+struct dm_lazy_state {
+	struct dm_lazy_node *nodes;
+	int count;
+	int size;
+	int total;
+	int pending[UCLASS_COUNT];
+};
+
+static bool dm_lazy_has_subnodes(ofnode node)
+{
+	ofnode subnode;
+
+	ofnode_for_each_subnode(subnode, node) {
+		if (ofnode_read_bool(subnode, "compatible"))
+			return true;
+	}
+
+	return false;
+}
+
+/*
+ * A driver's bind() method or its uclass's post_bind() method may create
+ * child devices, e.g. MMC controllers add a UCLASS_BLK child in bind().
+ * Those children would be missing when their own uclass is requested, so
+ * such drivers are never deferred.
+ */
+static bool dm_lazy_may_bind_children(struct driver *drv)
+{
+	struct uclass_driver *uc_drv;
+
+	if (drv->bind)
+		return true;
+	uc_drv = lists_uclass_lookup(drv->id);
+
+	return uc_drv && uc_drv->post_bind;
+}
+
+/*
+ * Find the uclass of the driver that lists_bind_fdt() would use, returning
+ * -ENOENT if there is none and -EBUSY if the node must be bound now
+ */
+static int dm_lazy_get_uclass(ofnode node, enum uclass_id *idp)
+{
+	const struct udevice_id *of_id;
+	const char *compat_list, *compat;
+	struct driver *drv;
+	int compat_length, i;
+
+	compat_list = ofnode_get_property(node, "compatible", &compat_length);
+	if (!compat_list)
+		return -ENOENT;
+	for (i = 0; i < compat_length; i += strlen(compat) + 1) {
+		compat = compat_list + i;
+		if (!lists_driver_lookup_compat(compat, true, &drv, &of_id)) {
+			if (dm_lazy_may_bind_children(drv))
+				return -EBUSY;
+			*idp = drv->id;
+			return 0;
+		}
+	}
+
+	return -ENOENT;
+}
+
+static struct dm_lazy_state *dm_lazy_get_state(void)
+{
+	if (!gd->dm_lazy)
+		gd->dm_lazy = calloc(1, sizeof(struct dm_lazy_state));
+
+	return gd->dm_lazy;
+}
+
+bool dm_lazy_defer(struct udevice *parent, ofnode node)
+{
+	struct dm_lazy_state *state;
+	struct dm_lazy_node *lazy;
+	enum uclass_id id;
+	int size;
+
+	/* Before relocation only the nodes that are needed are bound anyway */
+	if (!(gd->flags & GD_FLG_RELOC))
+		return false;
+	if (ofnode_read_bool(node, "u-boot,dm-pre-reloc") ||
+	    ofnode_read_bool(node, "u-boot,dm-spl") ||
+	    ofnode_read_bool(node, "u-boot,dm-tpl"))
+		return false;
+
+	/*
+	 * Bind buses now so that their children are scanned, nodes whose
+	 * driver may create children, and nodes without a driver so that
+	 * lists_bind_fdt() reports them as usual.
+	 */
+	if (dm_lazy_has_subnodes(node) || dm_lazy_get_uclass(node, &id))
+		return false;
+
+	state = dm_lazy_get_state();
+	if (!state)
+		return false;
+	if (state->count == state->size) {
+		size = state->size ? state->size * 2 : 32;
+		lazy = realloc(state->nodes, size * sizeof(*lazy));
+		if (!lazy)
+			return false;
+		state->nodes = lazy;
+		state->size = size;
+	}
+	lazy = &state->nodes[state->count++];
+	lazy->parent = parent;
+	lazy->node = node;
+	lazy->id = id;
+	state->total++;
+	state->pending[id]++;
+	dm_dbg("Deferred binding of node '%s'\n", ofnode_get_name(node));
+
+	return true;
+}
+
+static int dm_lazy_bind(struct dm_lazy_state *state, struct dm_lazy_node *lazy,
+			struct udevice **devp)
+{
+	struct udevice *parent = lazy->parent;
+
+	/* Mark it as done first, since binding may come back here */
+	lazy->parent = NULL;
+	state->total--;
+	state->pending[lazy->id]--;
+
+	return lists_bind_fdt(parent, lazy->node, devp);
+}
+
+int dm_lazy_bind_node(ofnode node, struct udevice **devp)
+{
+	struct dm_lazy_state *state = gd->dm_lazy;
+	struct dm_lazy_node *lazy;
+	int ret;
+
+	*devp = NULL;
+	if (!state || !state->total || !ofnode_valid(node))
+		return -ENOENT;
+	for (lazy = state->nodes; lazy != state->nodes + state->count;
+	     lazy++) {
+		if (lazy->parent && ofnode_equal(lazy->node, node)) {
+			ret = dm_lazy_bind(state, lazy, devp);
+			if (ret)
+				return ret;
+
+			return *devp ? 0 : -ENOENT;
+		}
+	}
+
+	return -ENOENT;
+}
+
+int dm_lazy_bind_phandle(uint phandle, struct udevice **devp)
+{
+	ofnode node;
+
+	*devp = NULL;
+	if (!dm_lazy_count())
+		return -ENOENT;
+#if CONFIG_IS_ENABLED(OF_LIVE)
+	if (of_live_active())
+		node = np_to_ofnode(of_find_node_by_phandle(phandle));
+	else
+#endif
+		node = offset_to_ofnode(fdt_node_offset_by_phandle(gd->fdt_blob,
+								   phandle));
+
+	return dm_lazy_bind_node(node, devp);
+}
+
+int dm_lazy_bind_uclass(enum uclass_id id)
+{
+	struct dm_lazy_state *state = gd->dm_lazy;
+	struct udevice *dev;
+	int i, ret = 0, err;
+
+	if (!state || id < 0 || id >= UCLASS_COUNT || !state->pending[id])
+		return 0;
+
+	/* The array may move as nodes are bound, so use an index */
+	for (i = 0; i < state->count && state->pending[id]; i++) {
+		if (!state->nodes[i].parent || state->nodes[i].id != id)
+			continue;
+		err = dm_lazy_bind(state, &state->nodes[i], &dev);
+		if (err && !ret)
+			ret = err;
+	}
+
+	return ret;
+}
+
+int dm_lazy_bind_children(struct udevice *parent)
+{
+	struct dm_lazy_state *state = gd->dm_lazy;
+	struct udevice *dev;
+	int i, ret = 0, err;
+
+	if (!state || !state->total)
+		return 0;
+
+	/* Bind in scan order so that children keep the order in the tree */
+	for (i = 0; i < state->count && state->total; i++) {
+		if (state->nodes[i].parent != parent)
+			continue;
+		err = dm_lazy_bind(state, &state->nodes[i], &dev);
+		if (err && !ret)
+			ret = err;
+	}
+
+	return ret;
+}
+
+void dm_lazy_forget(struct udevice *parent)
+{
+	struct dm_lazy_state *state = gd->dm_lazy;
+	struct dm_lazy_node *lazy;
+
+	if (!state)
+		return;
+	for (lazy = state->nodes; lazy != state->nodes + state->count;
+	     lazy++) {
+		if (lazy->parent == parent) {
+			lazy->parent = NULL;
+			state->total--;
+			state->pending[lazy->id]--;
+		}
+	}
+}
+
+void dm_lazy_reset(void)
+{
+	struct dm_lazy_state *state = gd->dm_lazy;
+
+	if (!state)
+		return;
+	free(state->nodes);
+	free(state);
+	gd->dm_lazy = NULL;
+}
+
+int dm_lazy_count(void)
+{
+	struct dm_lazy_state *state = gd->dm_lazy;
+
+	return state ? state->total : 0;
+}
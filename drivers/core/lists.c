@@ -16,8 +16,11 @@
 #include <dm/uclass.h>
 #include <dm/util.h>
 #include <fdtdec.h>
+#include <malloc.h>
 #include <linux/compiler.h>
 
+DECLARE_GLOBAL_DATA_PTR;
+
 struct driver *lists_driver_lookup_name(const char *name)
 {
 	struct driver *drv =
@@ -123,10 +126,151 @@ static int driver_check_compatible(const struct udevice_id *of_match,
 	return -ENOENT;
 }
 
-int lists_bind_fdt(struct udevice *parent, ofnode node, struct udevice **devp)
+static int lists_lookup_compat_linear(const char *compat,
+				      struct driver **drvp,
+				      const struct udevice_id **of_idp)
 {
 	struct driver *driver = ll_entry_start(struct driver, driver);
 	const int n_ents = ll_entry_count(struct driver, driver);
+	struct driver *entry;
+
+	for (entry = driver; entry != driver + n_ents; entry++) {
+		if (!driver_check_compatible(entry->of_match, of_idp, compat)) {
+			*drvp = entry;
+			return 0;
+		}
+	}
+
+	return -ENOENT;
+}
+
+#if CONFIG_IS_ENABLED(DM_COMPAT_INDEX)
+/*
+ * The index holds one entry per of_match[] entry of every driver, sorted by
+ * compatible string and then by position, so that the first entry for a
+ * string is the one that a linear scan would find.
+ */
+struct compat_index_entry {
+	struct driver *drv;
+	const struct udevice_id *id;
+};
+
+static int compat_index_cmp(const void *a, const void *b)
+{
+	const struct compat_index_entry *ea = a;
+	const struct compat_index_entry *eb = b;
+	int ret;
+
+	ret = strcmp(ea->id->compatible, eb->id->compatible);
+	if (ret)
+		return ret;
+	if (ea->drv != eb->drv)
+		return ea->drv < eb->drv ? -1 : 1;
+	if (ea->id != eb->id)
+		return ea->id < eb->id ? -1 : 1;
+
+	return 0;
+}
+
+/**
+ * compat_index_build() - Build the compatible-string index
+ *
+ * This is done on first use, and again after relocation since the index is
+ * allocated in the pre-relocation heap.
+ *
+ * @return 0 if OK, -ENOMEM if there is no space (the caller should fall back
+ * to a linear scan)
+ */
+static int compat_index_build(void)
+{
+	struct driver *driver = ll_entry_start(struct driver, driver);
+	const int n_ents = ll_entry_count(struct driver, driver);
+	struct compat_index_entry *index, *ent;
+	const struct udevice_id *of_match;
+	struct driver *entry;
+	int count;
+
+	count = 0;
+	for (entry = driver; entry != driver + n_ents; entry++) {
+		for (of_match = entry->of_match;
+		     of_match && of_match->compatible; of_match++)
+			count++;
+	}
+
+	index = malloc(count * sizeof(*index));
+	if (!index) {
+		gd->dm_compat_count = -ENOMEM;
+		return -ENOMEM;
+	}
+	ent = index;
+	for (entry = driver; entry != driver + n_ents; entry++) {
+		for (of_match = entry->of_match;
+		     of_match && of_match->compatible; of_match++) {
+			ent->drv = entry;
+			ent->id = of_match;
+			ent++;
+		}
+	}
+	qsort(index, count, sizeof(*index), compat_index_cmp);
+	gd->dm_compat_index = index;
+	gd->dm_compat_count = count;
+	dm_dbg("Compatible-string index has %d entries\n", count);
+
+	return 0;
+}
+
+static int lists_lookup_compat_index(const char *compat,
+				     struct driver **drvp,
+				     const struct udevice_id **of_idp)
+{
+	struct compat_index_entry *index = gd->dm_compat_index;
+	int low, high, mid;
+
+	/* Find the first entry for @compat */
+	low = 0;
+	high = gd->dm_compat_count;
+	while (low < high) {
+		mid = (low + high) / 2;
+		if (strcmp(index[mid].id->compatible, compat) < 0)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+	if (low == gd->dm_compat_count ||
+	    strcmp(index[low].id->compatible, compat))
+		return -ENOENT;
+	*drvp = index[low].drv;
+	*of_idp = index[low].id;
+
+	return 0;
+}
+
+static bool compat_index_wanted(void)
+{
+	if (gd->dm_compat_count < 0)
+		return false;
+	if (!(gd->flags & GD_FLG_RELOC) &&
+	    !IS_ENABLED(CONFIG_DM_COMPAT_INDEX_F))
+		return false;
+
+	return gd->dm_compat_index || !compat_index_build();
+}
+#endif
+
+int lists_driver_lookup_compat(const char *compat, bool use_index,
+			       struct driver **drvp,
+			       const struct udevice_id **of_idp)
+{
+#if CONFIG_IS_ENABLED(DM_COMPAT_INDEX)
+	if (use_index && compat_index_wanted())
+		return lists_lookup_compat_index(compat, drvp, of_idp);
+#endif
+
+	return lists_lookup_compat_linear(compat, drvp, of_idp);
+}
+
+int lists_bind_fdt(struct udevice *parent, ofnode node, struct udevice **devp)
+{
 	const struct udevice_id *id;
 	struct driver *entry;
 	struct udevice *dev;
@@ -162,13 +306,8 @@ int lists_bind_fdt(struct udevice *parent, ofnode node, struct udevice **devp)
 		dm_dbg("   - attempt to match compatible string '%s'\n",
 		       compat);
 
-		for (entry = driver; entry != driver + n_ents; entry++) {
-			ret = driver_check_compatible(entry->of_match, &id,
-						      compat);
-			if (!ret)
-				break;
-		}
-		if (entry == driver + n_ents)
+		ret = lists_driver_lookup_compat(compat, true, &entry, &id);
+		if (ret)
 			continue;
 
 		dm_dbg("   - found match at '%s'\n", entry->name);
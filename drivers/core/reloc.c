@@ -0,0 +1,257 @@
+/*
+ * Moving the pre-relocation driver model tree into the relocated U-Boot
+ *
+ * With CONFIG_DM_RELOC_TREE, devices bound before relocation are copied to
+ * the full malloc() heap instead of being bound a second time. Pointers into
+ * the U-Boot image (drivers, names, platdata and driver data) are adjusted
+ * by gd->reloc_off. Devices are moved in the bound state: anything that was
+ * probed before relocation is probed again when it is next used, since its
+ * private data may point anywhere.
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <dm.h>
+#include <errno.h>
+#include <malloc.h>
+#include <dm/device-internal.h>
+#include <dm/lists.h>
+#include <dm/of_access.h>
+#include <dm/root.h>
+#include <dm/uclass-internal.h>
+#include <dm/util.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+/* Move a pointer into the pre-relocation U-Boot image to the new image */
+static ulong dm_reloc_addr(ulong addr)
+{
+	ulong start = gd->relocaddr - gd->reloc_off;
+
+	if (gd->reloc_off && addr >= start && addr < start + gd->mon_len)
+		return addr + gd->reloc_off;
+
+	return addr;
+}
+
+static void *dm_reloc_ptr(const void *ptr)
+{
+	return (void *)dm_reloc_addr((ulong)ptr);
+}
+
+/*
+ * The live tree is only set up after relocation, so the pre-relocation tree
+ * normally uses offsets into the flat tree. Its root node tells which it is.
+ */
+static bool dm_reloc_old_valid(struct udevice *root_f, ofnode node)
+{
+	return root_f->node.np ? node.np != NULL : node.of_offset != -1;
+}
+
+/* Find the node in the tree used after relocation, which may be live */
+static ofnode dm_reloc_node(struct udevice *root_f, ofnode node)
+{
+#if CONFIG_IS_ENABLED(OF_LIVE)
+	char path[256];
+
+	if (!dm_reloc_old_valid(root_f, node))
+		return ofnode_null();
+	if (of_live_active() && !root_f->node.np) {
+		if (fdt_get_path(gd->fdt_blob, node.of_offset, path,
+				 sizeof(path)))
+			return ofnode_null();
+
+		return np_to_ofnode(of_find_node_by_path(path));
+	}
+#endif
+
+	return node;
+}
+
+/**
+ * dm_reloc_wanted() - Check whether a device can be moved
+ *
+ * The bind() and post_bind() methods of a moved device are not called
+ * again. They may create child devices or bind subnodes (as simple-bus and
+ * pinctrl do), or set up state outside the device, so a device whose driver
+ * or uclass has one of these is bound again instead. Its subnodes are then
+ * scanned as usual.
+ *
+ * @root_f: Root device of the pre-relocation tree
+ * @old: Device from the pre-relocation tree
+ * @nodep: Returns the node to use after relocation
+ * @return true to move the device, false to bind it again
+ */
+static bool dm_reloc_wanted(struct udevice *root_f, struct udevice *old,
+			    ofnode *nodep)
+{
+	const struct driver *drv = dm_reloc_ptr(old->driver);
+	struct uclass_driver *uc_drv;
+
+	*nodep = dm_reloc_node(root_f, old->node);
+	if (drv->bind)
+		return false;
+	uc_drv = lists_uclass_lookup(drv->id);
+	if (uc_drv && uc_drv->post_bind)
+		return false;
+	if (!dm_reloc_old_valid(root_f, old->node))
+		return true;
+
+	return ofnode_valid(*nodep);
+}
+
+static int dm_reloc_copy(void **datap, int size)
+{
+	void *data;
+
+	data = malloc(size);
+	if (!data)
+		return -ENOMEM;
+	memcpy(data, *datap, size);
+	*datap = data;
+
+	return 0;
+}
+
+static int dm_reloc_device(struct udevice *root_f, struct udevice *parent,
+			   struct udevice *old, ofnode node, int *countp)
+{
+	const struct driver *drv = dm_reloc_ptr(old->driver);
+	struct udevice *dev, *child;
+	ofnode child_node;
+	const char *name;
+	int size, ret;
+
+	dev = calloc(1, sizeof(struct udevice));
+	if (!dev)
+		return -ENOMEM;
+	ret = uclass_get_nolazy(drv->id, &dev->uclass);
+	if (ret)
+		goto err;
+
+	INIT_LIST_HEAD(&dev->sibling_node);
+	INIT_LIST_HEAD(&dev->child_head);
+	INIT_LIST_HEAD(&dev->uclass_node);
+#ifdef CONFIG_DEVRES
+	INIT_LIST_HEAD(&dev->devres_head);
+#endif
+	dev->driver = drv;
+	dev->parent = parent;
+	dev->node = node;
+	dev->driver_data = dm_reloc_addr(old->driver_data);
+	dev->seq = -1;
+	dev->req_seq = old->req_seq;
+	dev->flags = (old->flags & ~DM_FLAG_ACTIVATED) | DM_FLAG_RELOCATED;
+
+	/* Names from the device tree are in the old copy of the blob */
+	name = ofnode_valid(node) ? ofnode_get_name(node) : NULL;
+	if (name && !strcmp(name, old->name)) {
+		dev->name = name;
+		dev->flags &= ~DM_FLAG_NAME_ALLOCED;
+	} else if (dm_reloc_ptr(old->name) != old->name &&
+		   !(old->flags & DM_FLAG_NAME_ALLOCED)) {
+		dev->name = dm_reloc_ptr(old->name);
+	} else {
+		dev->name = strdup(old->name);
+		if (!dev->name) {
+			ret = -ENOMEM;
+			goto err;
+		}
+		dev->flags |= DM_FLAG_NAME_ALLOCED;
+	}
+
+	/* Data allocated by driver model is copied, the rest stays put */
+	dev->platdata = dm_reloc_ptr(old->platdata);
+	if (old->flags & DM_FLAG_ALLOC_PDATA) {
+		ret = dm_reloc_copy(&dev->platdata,
+				    drv->platdata_auto_alloc_size);
+		if (ret)
+			goto err_name;
+	}
+	dev->uclass_platdata = old->uclass_platdata;
+	if (old->flags & DM_FLAG_ALLOC_UCLASS_PDATA) {
+		size = dev->uclass->uc_drv->
+				per_device_platdata_auto_alloc_size;
+		ret = dm_reloc_copy(&dev->uclass_platdata, size);
+		if (ret)
+			goto err_pdata;
+	}
+	dev->parent_platdata = old->parent_platdata;
+	if (old->flags & DM_FLAG_ALLOC_PARENT_PDATA) {
+		size = parent->driver->per_child_platdata_auto_alloc_size;
+		if (!size) {
+			size = parent->uclass->uc_drv->
+					per_child_platdata_auto_alloc_size;
+		}
+		ret = dm_reloc_copy(&dev->parent_platdata, size);
+		if (ret)
+			goto err_uclass_pdata;
+	}
+
+	list_add_tail(&dev->sibling_node, &parent->child_head);
+	uclass_add_device(dev);
+	(*countp)++;
+	dm_dbg("Relocated device %s to %s\n", dev->name, parent->name);
+
+	list_for_each_entry(child, &old->child_head, sibling_node) {
+		if (!dm_reloc_wanted(root_f, child, &child_node))
+			continue;
+		ret = dm_reloc_device(root_f, dev, child, child_node, countp);
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+
+err_uclass_pdata:
+	if (old->flags & DM_FLAG_ALLOC_UCLASS_PDATA)
+		free(dev->uclass_platdata);
+err_pdata:
+	if (old->flags & DM_FLAG_ALLOC_PDATA)
+		free(dev->platdata);
+err_name:
+	if (dev->flags & DM_FLAG_NAME_ALLOCED)
+		free((char *)dev->name);
+err:
+	free(dev);
+
+	return ret;
+}
+
+int dm_reloc_tree(struct udevice *root_f)
+{
+	struct udevice *old;
+	ofnode node;
+	int count = 0;
+	int ret;
+
+	list_for_each_entry(old, &root_f->child_head, sibling_node) {
+		/* Devices from platform data are bound again by the scan */
+		if (!dm_reloc_old_valid(root_f, old->node) ||
+		    !dm_reloc_wanted(root_f, old, &node))
+			continue;
+		ret = dm_reloc_device(root_f, gd->dm_root, old, node, &count);
+		if (ret) {
+			dm_warn("Cannot relocate device '%s' (err=%d)\n",
+				old->name, ret);
+			return ret;
+		}
+	}
+	debug("%s: Relocated %d devices\n", __func__, count);
+
+	return 0;
+}
+
+bool dm_reloc_node_bound(struct udevice *parent, ofnode node)
+{
+	struct udevice *dev;
+
+	list_for_each_entry(dev, &parent->child_head, sibling_node) {
+		if ((dev->flags & DM_FLAG_RELOCATED) &&
+		    ofnode_equal(dev->node, node))
+			return true;
+	}
+
+	return false;
+}
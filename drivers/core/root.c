@@ -159,6 +159,19 @@ int dm_init(bool of_live)
 		return -EINVAL;
 	}
 	INIT_LIST_HEAD(&DM_UCLASS_ROOT_NON_CONST);
+	dm_lazy_reset();
+	dm_async_reset();
+#if CONFIG_IS_ENABLED(DM_UCLASS_INDEX)
+	/*
+	 * Only index uclasses after relocation, to save space in the
+	 * pre-relocation heap. If this fails, the list is searched instead.
+	 */
+	if (gd->uclass_tbl)
+		memset(gd->uclass_tbl, '\0',
+		       UCLASS_COUNT * sizeof(struct uclass *));
+	else if (gd->flags & GD_FLG_RELOC)
+		gd->uclass_tbl = calloc(UCLASS_COUNT, sizeof(struct uclass *));
+#endif
 
 #if defined(CONFIG_NEEDS_MANUAL_RELOC)
 	fix_drivers();
@@ -172,10 +185,10 @@ int dm_init(bool of_live)
 #if CONFIG_IS_ENABLED(OF_CONTROL)
 # if CONFIG_IS_ENABLED(OF_LIVE)
 	if (of_live)
-		DM_ROOT_NON_CONST->node = np_to_ofnode(gd->of_root);
+		dev_set_ofnode(DM_ROOT_NON_CONST, np_to_ofnode(gd->of_root));
 	else
 #endif
-		DM_ROOT_NON_CONST->node = offset_to_ofnode(0);
+		dev_set_ofnode(DM_ROOT_NON_CONST, offset_to_ofnode(0));
 #endif
 	ret = device_probe(DM_ROOT_NON_CONST);
 	if (ret)
@@ -186,6 +199,7 @@ int dm_init(bool of_live)
 
 int dm_uninit(void)
 {
+	dm_async_reset();
 	device_remove(dm_root(), DM_REMOVE_NORMAL);
 	device_unbind(dm_root());
 
@@ -195,6 +209,7 @@ int dm_uninit(void)
 #if CONFIG_IS_ENABLED(DM_DEVICE_REMOVE)
 int dm_remove_devices_flags(uint flags)
 {
+	dm_async_wait_all();
 	device_remove(dm_root(), flags);
 
 	return 0;
@@ -230,6 +245,10 @@ static int dm_scan_fdt_live(struct udevice *parent,
 			dm_dbg("   - ignoring disabled device\n");
 			continue;
 		}
+		if (dm_reloc_node_bound(parent, np_to_ofnode(np)))
+			continue;
+		if (!pre_reloc_only && dm_lazy_defer(parent, np_to_ofnode(np)))
+			continue;
 		err = lists_bind_fdt(parent, np_to_ofnode(np), NULL);
 		if (err && !ret) {
 			ret = err;
@@ -273,6 +292,11 @@ static int dm_scan_fdt_node(struct udevice *parent, const void *blob,
 			dm_dbg("   - ignoring disabled device\n");
 			continue;
 		}
+		if (dm_reloc_node_bound(parent, offset_to_ofnode(offset)))
+			continue;
+		if (!pre_reloc_only &&
+		    dm_lazy_defer(parent, offset_to_ofnode(offset)))
+			continue;
 		err = lists_bind_fdt(parent, offset_to_ofnode(offset), NULL);
 		if (err && !ret) {
 			ret = err;
@@ -318,6 +342,19 @@ static int dm_scan_fdt_node(struct udevice *parent, const void *blob,
 {
 	return 0;
 }
+
+#if CONFIG_IS_ENABLED(OF_PLATDATA)
+/* All devices are bound from U_BOOT_DEVICE() declarations instead */
+int dm_scan_fdt_dev(struct udevice *dev)
+{
+	return 0;
+}
+
+int dm_scan_fdt(const void *blob, bool pre_reloc_only)
+{
+	return 0;
+}
+#endif
 #endif
 
 int dm_extended_scan_fdt(const void *blob, bool pre_reloc_only)
@@ -349,15 +386,10 @@ __weak int dm_scan_other(bool pre_reloc_only)
 	return 0;
 }
 
-int dm_init_and_scan(bool pre_reloc_only)
+static int dm_scan(bool pre_reloc_only)
 {
 	int ret;
 
-	ret = dm_init(IS_ENABLED(CONFIG_OF_LIVE));
-	if (ret) {
-		debug("dm_init() failed: %d\n", ret);
-		return ret;
-	}
 	ret = dm_scan_platdata(pre_reloc_only);
 	if (ret) {
 		debug("dm_scan_platdata() failed: %d\n", ret);
@@ -379,6 +411,41 @@ int dm_init_and_scan(bool pre_reloc_only)
 	return 0;
 }
 
+int dm_init_and_scan(bool pre_reloc_only)
+{
+	int ret;
+
+	ret = dm_init(IS_ENABLED(CONFIG_OF_LIVE));
+	if (ret) {
+		debug("dm_init() failed: %d\n", ret);
+		return ret;
+	}
+
+	return dm_scan(pre_reloc_only);
+}
+
+#if CONFIG_IS_ENABLED(DM_RELOC_TREE)
+int dm_init_and_relocate(struct udevice *root_f)
+{
+	int ret;
+
+	ret = dm_init(IS_ENABLED(CONFIG_OF_LIVE));
+	if (ret) {
+		debug("dm_init() failed: %d\n", ret);
+		return ret;
+	}
+	if (root_f) {
+		bootstage_start(BOOTSTATE_ID_ACCUM_DM_RELOC, "dm_reloc");
+		ret = dm_reloc_tree(root_f);
+		bootstage_accum(BOOTSTATE_ID_ACCUM_DM_RELOC);
+		if (ret)
+			return ret;
+	}
+
+	return dm_scan(false);
+}
+#endif
+
 /* This is the root driver - all drivers are children of this */
 U_BOOT_DRIVER(root_driver) = {
 	.name	= "root_driver",
@@ -16,21 +16,92 @@
 #include <dm/lists.h>
 #include <dm/uclass.h>
 #include <dm/uclass-internal.h>
+#include <dm/read.h>
+#include <dm/root.h>
 #include <dm/util.h>
 
 DECLARE_GLOBAL_DATA_PTR;
 
+#if CONFIG_IS_ENABLED(DM_UCLASS_INDEX)
+#define UC_HASH(val)	((val) & (DM_UC_HASH_SIZE - 1))
+
+static uint uclass_hash_node(ofnode node)
+{
+	ulong val = (ulong)node.np;
+
+	/* Node pointers and offsets are both at least 4-byte aligned */
+	return UC_HASH(val >> 2 ^ val >> 7);
+}
+
+static void uclass_index_add_node(struct uclass_index *idx,
+				  struct udevice *dev)
+{
+	ofnode node = dev_ofnode(dev);
+#if CONFIG_IS_ENABLED(OF_CONTROL)
+	uint phandle;
+#endif
+
+	if (!ofnode_valid(node))
+		return;
+	hlist_add_head(&dev->node_hash, &idx->node[uclass_hash_node(node)]);
+#if CONFIG_IS_ENABLED(OF_CONTROL)
+	phandle = dev_read_phandle(dev);
+	if (phandle)
+		hlist_add_head(&dev->phandle_hash,
+			       &idx->phandle[UC_HASH(phandle)]);
+#endif
+}
+
+static void uclass_index_add(struct uclass_index *idx, struct udevice *dev)
+{
+	if (dev->seq != -1)
+		hlist_add_head(&dev->seq_hash, &idx->seq[UC_HASH(dev->seq)]);
+	uclass_index_add_node(idx, dev);
+}
+
+static void uclass_index_remove(struct udevice *dev)
+{
+	hlist_del_init(&dev->seq_hash);
+	hlist_del_init(&dev->node_hash);
+	hlist_del_init(&dev->phandle_hash);
+}
+
+/**
+ * uclass_get_index() - Get the index for a uclass, building it if needed
+ *
+ * The index is not built before relocation, to avoid using up the small
+ * pre-relocation heap.
+ *
+ * @uc: uclass to check
+ * @return index, or NULL if there is none (search the device list instead)
+ */
+static struct uclass_index *uclass_get_index(struct uclass *uc)
+{
+	struct udevice *dev;
+
+	if (uc->index || !(gd->flags & GD_FLG_RELOC))
+		return uc->index;
+	uc->index = calloc(1, sizeof(*uc->index));
+	if (!uc->index)
+		return NULL;
+	list_for_each_entry(dev, &uc->dev_head, uclass_node)
+		uclass_index_add(uc->index, dev);
+
+	return uc->index;
+}
+#endif
+
 struct uclass *uclass_find(enum uclass_id key)
 {
 	struct uclass *uc;
 
 	if (!gd->dm_root)
 		return NULL;
-	/*
-	 * TODO(sjg@chromium.org): Optimise this, perhaps moving the found
-	 * node to the start of the list, or creating a linear array mapping
-	 * id to node.
-	 */
+#if CONFIG_IS_ENABLED(DM_UCLASS_INDEX)
+	if (gd->uclass_tbl)
+		return key >= 0 && key < UCLASS_COUNT ? gd->uclass_tbl[key] :
+			NULL;
+#endif
 	list_for_each_entry(uc, &gd->uclass_root, sibling_node) {
 		if (uc->uc_drv->id == key)
 			return uc;
@@ -80,6 +151,10 @@ static int uclass_add(enum uclass_id id, struct uclass **ucp)
 	INIT_LIST_HEAD(&uc->sibling_node);
 	INIT_LIST_HEAD(&uc->dev_head);
 	list_add(&uc->sibling_node, &DM_UCLASS_ROOT_NON_CONST);
+#if CONFIG_IS_ENABLED(DM_UCLASS_INDEX)
+	if (gd->uclass_tbl)
+		gd->uclass_tbl[id] = uc;
+#endif
 
 	if (uc_drv->init) {
 		ret = uc_drv->init(uc);
@@ -96,6 +171,10 @@ fail:
 		uc->priv = NULL;
 	}
 	list_del(&uc->sibling_node);
+#if CONFIG_IS_ENABLED(DM_UCLASS_INDEX)
+	if (gd->uclass_tbl)
+		gd->uclass_tbl[id] = NULL;
+#endif
 fail_mem:
 	free(uc);
 
@@ -129,6 +208,11 @@ int uclass_destroy(struct uclass *uc)
 	if (uc_drv->destroy)
 		uc_drv->destroy(uc);
 	list_del(&uc->sibling_node);
+#if CONFIG_IS_ENABLED(DM_UCLASS_INDEX)
+	if (gd->uclass_tbl)
+		gd->uclass_tbl[uc_drv->id] = NULL;
+	free(uc->index);
+#endif
 	if (uc_drv->priv_auto_alloc_size)
 		free(uc->priv);
 	free(uc);
@@ -136,7 +220,7 @@ int uclass_destroy(struct uclass *uc)
 	return 0;
 }
 
-int uclass_get(enum uclass_id id, struct uclass **ucp)
+int uclass_get_nolazy(enum uclass_id id, struct uclass **ucp)
 {
 	struct uclass *uc;
 
@@ -149,11 +233,48 @@ int uclass_get(enum uclass_id id, struct uclass **ucp)
 	return 0;
 }
 
+int uclass_get(enum uclass_id id, struct uclass **ucp)
+{
+	/* Errors are reported when binding, as with dm_scan_fdt() */
+	dm_lazy_bind_uclass(id);
+
+	return uclass_get_nolazy(id, ucp);
+}
+
+/**
+ * uclass_bind_lazy() - Bind a deferred device tree node for a lookup
+ *
+ * This is called when a device cannot be found by node or phandle, in case
+ * the node's binding was deferred (CONFIG_DM_LAZY_BIND).
+ *
+ * @id: uclass ID the device must be in
+ * @node: Device tree node to bind, or ofnode_null() to use @phandle
+ * @phandle: Phandle of the node to bind, if @node is not valid
+ * @devp: Returns the device if it was bound and is in the uclass
+ * @return 0 if OK, -ENODEV if there is no such device
+ */
+static int uclass_bind_lazy(enum uclass_id id, ofnode node, uint phandle,
+			    struct udevice **devp)
+{
+	struct udevice *dev;
+	int ret;
+
+	if (ofnode_valid(node))
+		ret = dm_lazy_bind_node(node, &dev);
+	else
+		ret = dm_lazy_bind_phandle(phandle, &dev);
+	if (ret || device_get_uclass_id(dev) != id)
+		return -ENODEV;
+	*devp = dev;
+
+	return 0;
+}
+
 const char *uclass_get_name(enum uclass_id id)
 {
 	struct uclass *uc;
 
-	if (uclass_get(id, &uc))
+	if (uclass_get_nolazy(id, &uc))
 		return NULL;
 	return uc->uc_drv->name;
 }
@@ -240,16 +361,40 @@ int uclass_find_device_by_seq(enum uclass_id id, int seq_or_req_seq,
 {
 	struct uclass *uc;
 	struct udevice *dev;
+#if CONFIG_IS_ENABLED(DM_UCLASS_INDEX)
+	struct uclass_index *idx;
+	struct hlist_node *pos;
+#endif
 	int ret;
 
 	*devp = NULL;
 	debug("%s: %d %d\n", __func__, find_req_seq, seq_or_req_seq);
 	if (seq_or_req_seq == -1)
 		return -ENODEV;
-	ret = uclass_get(id, &uc);
+	/* Only probed devices have a sequence, so only bind for req_seq */
+	if (find_req_seq)
+		ret = uclass_get(id, &uc);
+	else
+		ret = uclass_get_nolazy(id, &uc);
 	if (ret)
 		return ret;
 
+#if CONFIG_IS_ENABLED(DM_UCLASS_INDEX)
+	/* Allocated sequence numbers are unique, so take the only match */
+	idx = find_req_seq ? NULL : uclass_get_index(uc);
+	if (idx) {
+		hlist_for_each_entry(dev, pos,
+				     &idx->seq[UC_HASH(seq_or_req_seq)],
+				     seq_hash) {
+			if (dev->seq == seq_or_req_seq) {
+				*devp = dev;
+				return 0;
+			}
+		}
+
+		return -ENODEV;
+	}
+#endif
 	list_for_each_entry(dev, &uc->dev_head, uclass_node) {
 		debug("   - %d %d '%s'\n", dev->req_seq, dev->seq, dev->name);
 		if ((find_req_seq ? dev->req_seq : dev->seq) ==
@@ -274,7 +419,7 @@ int uclass_find_device_by_of_offset(enum uclass_id id, int node,
 	*devp = NULL;
 	if (node < 0)
 		return -ENODEV;
-	ret = uclass_get(id, &uc);
+	ret = uclass_get_nolazy(id, &uc);
 	if (ret)
 		return ret;
 
@@ -285,7 +430,7 @@ int uclass_find_device_by_of_offset(enum uclass_id id, int node,
 		}
 	}
 
-	return -ENODEV;
+	return uclass_bind_lazy(id, offset_to_ofnode(node), 0, devp);
 }
 
 int uclass_find_device_by_ofnode(enum uclass_id id, ofnode node,
@@ -293,15 +438,40 @@ int uclass_find_device_by_ofnode(enum uclass_id id, ofnode node,
 {
 	struct uclass *uc;
 	struct udevice *dev;
+#if CONFIG_IS_ENABLED(DM_UCLASS_INDEX)
+	struct uclass_index *idx;
+	struct hlist_node *pos;
+#endif
 	int ret;
 
 	*devp = NULL;
 	if (!ofnode_valid(node))
 		return -ENODEV;
-	ret = uclass_get(id, &uc);
+	ret = uclass_get_nolazy(id, &uc);
 	if (ret)
 		return ret;
 
+#if CONFIG_IS_ENABLED(DM_UCLASS_INDEX)
+	idx = uclass_get_index(uc);
+	if (idx) {
+		hlist_for_each_entry(dev, pos,
+				     &idx->node[uclass_hash_node(node)],
+				     node_hash) {
+			if (ofnode_equal(dev_ofnode(dev), node)) {
+				/* Fall back to the list if there are several */
+				if (*devp)
+					goto scan;
+				*devp = dev;
+			}
+		}
+		if (*devp)
+			return 0;
+
+		return uclass_bind_lazy(id, node, 0, devp);
+	}
+scan:
+	*devp = NULL;
+#endif
 	list_for_each_entry(dev, &uc->dev_head, uclass_node) {
 		if (ofnode_equal(dev_ofnode(dev), node)) {
 			*devp = dev;
@@ -309,7 +479,7 @@ int uclass_find_device_by_ofnode(enum uclass_id id, ofnode node,
 		}
 	}
 
-	return -ENODEV;
+	return uclass_bind_lazy(id, node, 0, devp);
 }
 
 #if CONFIG_IS_ENABLED(OF_CONTROL)
@@ -320,6 +490,10 @@ static int uclass_find_device_by_phandle(enum uclass_id id,
 {
 	struct udevice *dev;
 	struct uclass *uc;
+#if CONFIG_IS_ENABLED(DM_UCLASS_INDEX)
+	struct uclass_index *idx;
+	struct hlist_node *pos;
+#endif
 	int find_phandle;
 	int ret;
 
@@ -327,10 +501,32 @@ static int uclass_find_device_by_phandle(enum uclass_id id,
 	find_phandle = dev_read_u32_default(parent, name, -1);
 	if (find_phandle <= 0)
 		return -ENOENT;
-	ret = uclass_get(id, &uc);
+	ret = uclass_get_nolazy(id, &uc);
 	if (ret)
 		return ret;
 
+#if CONFIG_IS_ENABLED(DM_UCLASS_INDEX)
+	idx = uclass_get_index(uc);
+	if (idx) {
+		hlist_for_each_entry(dev, pos,
+				     &idx->phandle[UC_HASH(find_phandle)],
+				     phandle_hash) {
+			if (dev_read_phandle(dev) == find_phandle) {
+				/* Fall back to the list if there are several */
+				if (*devp)
+					goto scan;
+				*devp = dev;
+			}
+		}
+
+		if (*devp)
+			return 0;
+
+		return uclass_bind_lazy(id, ofnode_null(), find_phandle, devp);
+	}
+scan:
+	*devp = NULL;
+#endif
 	list_for_each_entry(dev, &uc->dev_head, uclass_node) {
 		uint phandle;
 
@@ -342,7 +538,7 @@ static int uclass_find_device_by_phandle(enum uclass_id id,
 		}
 	}
 
-	return -ENODEV;
+	return uclass_bind_lazy(id, ofnode_null(), find_phandle, devp);
 }
 #endif
 
@@ -519,14 +715,22 @@ int uclass_next_device_check(struct udevice **devp)
 	return device_probe(*devp);
 }
 
-int uclass_bind_device(struct udevice *dev)
+void uclass_add_device(struct udevice *dev)
 {
-	struct uclass *uc;
-	int ret;
+	struct uclass *uc = dev->uclass;
 
-	uc = dev->uclass;
 	list_add_tail(&dev->uclass_node, &uc->dev_head);
+#if CONFIG_IS_ENABLED(DM_UCLASS_INDEX)
+	if (uc->index)
+		uclass_index_add(uc->index, dev);
+#endif
+}
 
+int uclass_bind_device(struct udevice *dev)
+{
+	int ret;
+
+	uclass_add_device(dev);
 	if (dev->parent) {
 		struct uclass_driver *uc_drv = dev->parent->uclass->uc_drv;
 
@@ -541,6 +745,9 @@ int uclass_bind_device(struct udevice *dev)
 err:
 	/* There is no need to undo the parent's post_bind call */
 	list_del(&dev->uclass_node);
+#if CONFIG_IS_ENABLED(DM_UCLASS_INDEX)
+	uclass_index_remove(dev);
+#endif
 
 	return ret;
 }
@@ -559,10 +766,40 @@ int uclass_unbind_device(struct udevice *dev)
 	}
 
 	list_del(&dev->uclass_node);
+#if CONFIG_IS_ENABLED(DM_UCLASS_INDEX)
+	uclass_index_remove(dev);
+#endif
 	return 0;
 }
 #endif
 
+void uclass_set_device_seq(struct udevice *dev, int seq)
+{
+#if CONFIG_IS_ENABLED(DM_UCLASS_INDEX)
+	struct uclass_index *idx = dev->uclass->index;
+
+	hlist_del_init(&dev->seq_hash);
+	if (idx && seq != -1)
+		hlist_add_head(&dev->seq_hash, &idx->seq[UC_HASH(seq)]);
+#endif
+	dev->seq = seq;
+}
+
+void uclass_set_device_node(struct udevice *dev, ofnode node)
+{
+#if CONFIG_IS_ENABLED(DM_UCLASS_INDEX)
+	struct uclass_index *idx = dev->uclass ? dev->uclass->index : NULL;
+
+	hlist_del_init(&dev->node_hash);
+	hlist_del_init(&dev->phandle_hash);
+	dev->node = node;
+	if (idx)
+		uclass_index_add_node(idx, dev);
+#else
+	dev->node = node;
+#endif
+}
+
 int uclass_resolve_seq(struct udevice *dev)
 {
 	struct udevice *dup;
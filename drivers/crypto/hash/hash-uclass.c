@@ -0,0 +1,188 @@
+/*
+ * Driver model uclass for hash engines
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <dm.h>
+#include <errno.h>
+#include <watchdog.h>
+#include <u-boot/hash.h>
+#include <u-boot/sha1.h>
+#include <u-boot/sha256.h>
+#include <u-boot/sha512.h>
+
+/* How long dm_hash_wait() waits for an engine before giving up */
+#define HASH_WAIT_TIMEOUT_MS	10000
+
+static const struct {
+	const char *name;
+	int digest_size;
+} hash_algo_info[HASH_ALGO_COUNT] = {
+	[HASH_ALGO_SHA1]	= { "sha1", SHA1_SUM_LEN },
+	[HASH_ALGO_SHA256]	= { "sha256", SHA256_SUM_LEN },
+	[HASH_ALGO_SHA384]	= { "sha384", SHA384_SUM_LEN },
+	[HASH_ALGO_SHA512]	= { "sha512", SHA512_SUM_LEN },
+};
+
+int dm_hash_init(struct udevice *dev, enum hash_algo_id algo, void **ctxp)
+{
+	struct hash_uc_priv *uc_priv = dev_get_uclass_priv(dev);
+	struct hash_ops *ops = hash_get_ops(dev);
+
+	if (algo >= HASH_ALGO_COUNT || !(uc_priv->algos & (1UL << algo)))
+		return -EPROTONOSUPPORT;
+	if (!ops->init)
+		return -ENOSYS;
+
+	return ops->init(dev, algo, ctxp);
+}
+
+int dm_hash_update(struct udevice *dev, void *ctx, const void *buf,
+		   uint size)
+{
+	struct hash_ops *ops = hash_get_ops(dev);
+
+	if (!ops->update)
+		return -ENOSYS;
+
+	return ops->update(dev, ctx, buf, size);
+}
+
+int dm_hash_submit(struct udevice *dev, void *ctx, const void *buf,
+		   uint size)
+{
+	struct hash_ops *ops = hash_get_ops(dev);
+
+	if (!ops->submit)
+		return dm_hash_update(dev, ctx, buf, size);
+
+	return ops->submit(dev, ctx, buf, size);
+}
+
+int dm_hash_poll(struct udevice *dev, void *ctx)
+{
+	struct hash_ops *ops = hash_get_ops(dev);
+
+	if (!ops->poll)
+		return 0;
+
+	return ops->poll(dev, ctx);
+}
+
+int dm_hash_wait(struct udevice *dev, void *ctx)
+{
+	ulong start = get_timer(0);
+	int ret;
+
+	while (1) {
+		ret = dm_hash_poll(dev, ctx);
+		if (ret != -EBUSY)
+			return ret;
+		if (get_timer(start) > HASH_WAIT_TIMEOUT_MS) {
+			debug("%s: %s timed out\n", __func__, dev->name);
+			return -ETIMEDOUT;
+		}
+		WATCHDOG_RESET();
+	}
+}
+
+int dm_hash_finish(struct udevice *dev, void *ctx, void *digest)
+{
+	struct hash_ops *ops = hash_get_ops(dev);
+	int ret;
+
+	if (!ops->finish)
+		return -ENOSYS;
+
+	ret = dm_hash_wait(dev, ctx);
+	if (ret) {
+		/* Still let the driver free the context */
+		ops->finish(dev, ctx, digest);
+		return ret;
+	}
+
+	return ops->finish(dev, ctx, digest);
+}
+
+int dm_hash_digest(struct udevice *dev, enum hash_algo_id algo,
+		   const void *buf, uint size, void *digest)
+{
+	void *ctx;
+	int ret;
+
+	ret = dm_hash_init(dev, algo, &ctx);
+	if (ret)
+		return ret;
+	ret = dm_hash_submit(dev, ctx, buf, size);
+	if (ret) {
+		dm_hash_finish(dev, ctx, digest);
+		return ret;
+	}
+
+	return dm_hash_finish(dev, ctx, digest);
+}
+
+int dm_hash_find(enum hash_algo_id algo, struct udevice **devp)
+{
+	struct hash_uc_priv *uc_priv;
+	struct udevice *dev;
+
+	for (uclass_first_device(UCLASS_HASH, &dev); dev;
+	     uclass_next_device(&dev)) {
+		uc_priv = dev_get_uclass_priv(dev);
+		if (uc_priv->algos & (1UL << algo)) {
+			*devp = dev;
+			return 0;
+		}
+	}
+
+	return -ENODEV;
+}
+
+int dm_hash_lookup_algo(const char *name)
+{
+	int i;
+
+	for (i = 0; i < HASH_ALGO_COUNT; i++) {
+		if (!strcmp(name, hash_algo_info[i].name))
+			return i;
+	}
+
+	return -EPROTONOSUPPORT;
+}
+
+int dm_hash_digest_size(enum hash_algo_id algo)
+{
+	return hash_algo_info[algo].digest_size;
+}
+
+int dm_hash_block(const char *algo_name, const void *buf, uint size,
+		  void *digest, int *digest_size)
+{
+	struct udevice *dev;
+	int algo, ret;
+
+	algo = dm_hash_lookup_algo(algo_name);
+	if (algo < 0)
+		return algo;
+	ret = dm_hash_find(algo, &dev);
+	if (ret)
+		return ret;
+	ret = dm_hash_digest(dev, algo, buf, size, digest);
+	if (ret) {
+		printf("%s: %s failed (err=%d)\n", dev->name, algo_name, ret);
+		return ret;
+	}
+	if (digest_size)
+		*digest_size = dm_hash_digest_size(algo);
+
+	return 0;
+}
+
+UCLASS_DRIVER(hash) = {
+	.id		= UCLASS_HASH,
+	.name		= "hash",
+	.per_device_auto_alloc_size = sizeof(struct hash_uc_priv),
+};
@@ -0,0 +1,214 @@
+/*
+ * Sandbox hash engine, which hashes in software
+ *
+ * Submitted data is hashed a piece at a time by each call to poll(), to
+ * behave like an engine which works in the background.
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <dm.h>
+#include <errno.h>
+#include <malloc.h>
+#include <asm/test.h>
+#include <u-boot/hash.h>
+#include <u-boot/sha1.h>
+#include <u-boot/sha256.h>
+#include <u-boot/sha512.h>
+
+/* Number of bytes hashed by each call to poll() */
+#define SANDBOX_HASH_POLL_BYTES		4096
+
+struct sandbox_hash_ctx {
+	enum hash_algo_id algo;
+	const u8 *pending;	/* Submitted data not yet hashed */
+	uint pending_size;
+	union {
+		sha1_context sha1;
+		sha256_context sha256;
+		sha512_context sha512;
+	};
+};
+
+/**
+ * struct sandbox_hash_priv - Private information for the sandbox engine
+ *
+ * @bytes:	Number of bytes hashed
+ * @polls:	Number of calls to poll() which returned -EBUSY
+ */
+struct sandbox_hash_priv {
+	ulong bytes;
+	uint polls;
+};
+
+static void sandbox_hash_data(struct udevice *dev,
+			      struct sandbox_hash_ctx *ctx, const void *buf,
+			      uint size)
+{
+	struct sandbox_hash_priv *priv = dev_get_priv(dev);
+
+	switch (ctx->algo) {
+	case HASH_ALGO_SHA1:
+		sha1_update(&ctx->sha1, buf, size);
+		break;
+	case HASH_ALGO_SHA256:
+		sha256_update(&ctx->sha256, buf, size);
+		break;
+	default:
+		sha512_update(&ctx->sha512, buf, size);
+		break;
+	}
+	priv->bytes += size;
+}
+
+static int sandbox_hash_init(struct udevice *dev, enum hash_algo_id algo,
+			     void **ctxp)
+{
+	struct sandbox_hash_ctx *ctx;
+
+	ctx = calloc(1, sizeof(*ctx));
+	if (!ctx)
+		return -ENOMEM;
+	ctx->algo = algo;
+	switch (algo) {
+	case HASH_ALGO_SHA1:
+		sha1_starts(&ctx->sha1);
+		break;
+	case HASH_ALGO_SHA256:
+		sha256_starts(&ctx->sha256);
+		break;
+	case HASH_ALGO_SHA384:
+		sha384_starts(&ctx->sha512);
+		break;
+	case HASH_ALGO_SHA512:
+		sha512_starts(&ctx->sha512);
+		break;
+	default:
+		free(ctx);
+		return -EPROTONOSUPPORT;
+	}
+	*ctxp = ctx;
+
+	return 0;
+}
+
+static int sandbox_hash_update(struct udevice *dev, void *ctx,
+			       const void *buf, uint size)
+{
+	struct sandbox_hash_ctx *hctx = ctx;
+
+	if (hctx->pending_size)
+		return -EBUSY;
+	sandbox_hash_data(dev, hctx, buf, size);
+
+	return 0;
+}
+
+static int sandbox_hash_submit(struct udevice *dev, void *ctx,
+			       const void *buf, uint size)
+{
+	struct sandbox_hash_ctx *hctx = ctx;
+
+	if (hctx->pending_size)
+		return -EBUSY;
+	hctx->pending = buf;
+	hctx->pending_size = size;
+
+	return 0;
+}
+
+static int sandbox_hash_poll(struct udevice *dev, void *ctx)
+{
+	struct sandbox_hash_priv *priv = dev_get_priv(dev);
+	struct sandbox_hash_ctx *hctx = ctx;
+	uint size;
+
+	if (!hctx->pending_size)
+		return 0;
+	size = min(hctx->pending_size, (uint)SANDBOX_HASH_POLL_BYTES);
+	sandbox_hash_data(dev, hctx, hctx->pending, size);
+	hctx->pending += size;
+	hctx->pending_size -= size;
+	if (!hctx->pending_size)
+		return 0;
+	priv->polls++;
+
+	return -EBUSY;
+}
+
+static int sandbox_hash_finish(struct udevice *dev, void *ctx, void *digest)
+{
+	struct sandbox_hash_ctx *hctx = ctx;
+
+	switch (hctx->algo) {
+	case HASH_ALGO_SHA1:
+		sha1_finish(&hctx->sha1, digest);
+		break;
+	case HASH_ALGO_SHA256:
+		sha256_finish(&hctx->sha256, digest);
+		break;
+	case HASH_ALGO_SHA384:
+		sha384_finish(&hctx->sha512, digest);
+		break;
+	default:
+		sha512_finish(&hctx->sha512, digest);
+		break;
+	}
+	free(hctx);
+
+	return 0;
+}
+
+void sandbox_hash_set_algos(struct udevice *dev, ulong algos)
+{
+	struct hash_uc_priv *uc_priv = dev_get_uclass_priv(dev);
+
+	uc_priv->algos = algos;
+}
+
+ulong sandbox_hash_get_bytes(struct udevice *dev)
+{
+	struct sandbox_hash_priv *priv = dev_get_priv(dev);
+
+	return priv->bytes;
+}
+
+uint sandbox_hash_get_polls(struct udevice *dev)
+{
+	struct sandbox_hash_priv *priv = dev_get_priv(dev);
+
+	return priv->polls;
+}
+
+static int sandbox_hash_probe(struct udevice *dev)
+{
+	struct hash_uc_priv *uc_priv = dev_get_uclass_priv(dev);
+
+	uc_priv->algos = 1 << HASH_ALGO_SHA1 | 1 << HASH_ALGO_SHA256 |
+			 1 << HASH_ALGO_SHA384 | 1 << HASH_ALGO_SHA512;
+
+	return 0;
+}
+
+static const struct hash_ops sandbox_hash_ops = {
+	.init	= sandbox_hash_init,
+	.update	= sandbox_hash_update,
+	.submit	= sandbox_hash_submit,
+	.poll	= sandbox_hash_poll,
+	.finish	= sandbox_hash_finish,
+};
+
+static const struct udevice_id sandbox_hash_ids[] = {
+	{ .compatible = "sandbox,hash" },
+	{ }
+};
+
+U_BOOT_DRIVER(sandbox_hash) = {
+	.name		= "sandbox_hash",
+	.id		= UCLASS_HASH,
+	.of_match	= sandbox_hash_ids,
+	.probe		= sandbox_hash_probe,
+	.ops		= &sandbox_hash_ops,
+	.priv_auto_alloc_size = sizeof(struct sandbox_hash_priv),
+};
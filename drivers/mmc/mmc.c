@@ -446,6 +446,7 @@ static int mmc_send_op_cond(struct mmc *mmc)
 			break;
 	}
 	mmc->op_cond_pending = 1;
+	mmc->op_cond_start = get_timer(0);
 	return 0;
 }
 
@@ -1760,6 +1761,28 @@ int mmc_init(struct mmc *mmc)
 	return err;
 }
 
+int mmc_poll_init(struct mmc *mmc)
+{
+	int err;
+
+	if (!mmc->init_in_progress)
+		return mmc_init(mmc);
+
+	/* After the timeout, mmc_complete_op_cond() tries once more */
+	if (mmc->op_cond_pending && !(mmc->ocr & OCR_BUSY) &&
+	    get_timer(mmc->op_cond_start) < 1000) {
+		err = mmc_send_op_cond_iter(mmc, 1);
+		if (err) {
+			mmc->init_in_progress = 0;
+			return err;
+		}
+		if (!(mmc->ocr & OCR_BUSY))
+			return -EINPROGRESS;
+	}
+
+	return mmc_init(mmc);
+}
+
 int mmc_set_dsr(struct mmc *mmc, u16 val)
 {
 	mmc->dsr = val;
@@ -101,11 +101,27 @@ static const struct dm_mmc_ops sandbox_mmc_ops = {
 	.get_cd = sandbox_mmc_get_cd,
 };
 
+/*
+ * Start initialising the card here and finish in sandbox_mmc_probe_poll(), so
+ * that other devices can be probed while the card powers up
+ */
 int sandbox_mmc_probe(struct udevice *dev)
+{
+	struct sandbox_mmc_plat *plat = dev_get_platdata(dev);
+	int ret;
+
+	ret = mmc_start_init(&plat->mmc);
+	if (ret)
+		return ret;
+
+	return -EINPROGRESS;
+}
+
+static int sandbox_mmc_probe_poll(struct udevice *dev)
 {
 	struct sandbox_mmc_plat *plat = dev_get_platdata(dev);
 
-	return mmc_init(&plat->mmc);
+	return mmc_poll_init(&plat->mmc);
 }
 
 int sandbox_mmc_bind(struct udevice *dev)
@@ -143,5 +159,6 @@ U_BOOT_DRIVER(mmc_sandbox) = {
 	.bind		= sandbox_mmc_bind,
 	.unbind		= sandbox_mmc_unbind,
 	.probe		= sandbox_mmc_probe,
+	.probe_poll	= sandbox_mmc_probe_poll,
 	.platdata_auto_alloc_size = sizeof(struct sandbox_mmc_plat),
 };
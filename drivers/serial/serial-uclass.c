@@ -5,6 +5,7 @@
  */
 
 #include <common.h>
+#include <cyclic.h>
 #include <dm.h>
 #include <environment.h>
 #include <errno.h>
@@ -168,7 +169,7 @@ static int __serial_getc(struct udevice *dev)
 	do {
 		err = ops->getc(dev);
 		if (err == -EAGAIN)
-			WATCHDOG_RESET();
+			cyclic_schedule();
 	} while (err == -EAGAIN);
 
 	return err >= 0 ? err : 0;
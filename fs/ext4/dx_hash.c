@@ -0,0 +1,258 @@
+/*
+ * dx_hash.c - directory index (HTree) hash functions, taken from
+ * fs/ext4/hash.c in the Linux kernel.
+ *
+ * Copyright (C) 2002 by Theodore Ts'o
+ *
+ * SPDX-License-Identifier:	GPL-2.0
+ */
+
+#include <common.h>
+#include <linux/errno.h>
+#include "dx_hash.h"
+
+#define DELTA 0x9E3779B9
+
+static inline uint32_t rol32(uint32_t word, unsigned int shift)
+{
+	return (word << shift) | (word >> (32 - shift));
+}
+
+/* Largest hash value, reserved as end-of-directory marker */
+#define EXT4_HTREE_EOF_32BIT	((1UL << (32 - 1)) - 1)
+
+static void tea_transform(uint32_t buf[4], const uint32_t in[])
+{
+	uint32_t sum = 0;
+	uint32_t b0 = buf[0], b1 = buf[1];
+	uint32_t a = in[0], b = in[1], c = in[2], d = in[3];
+	int n = 16;
+
+	do {
+		sum += DELTA;
+		b0 += ((b1 << 4) + a) ^ (b1 + sum) ^ ((b1 >> 5) + b);
+		b1 += ((b0 << 4) + c) ^ (b0 + sum) ^ ((b0 >> 5) + d);
+	} while (--n);
+
+	buf[0] += b0;
+	buf[1] += b1;
+}
+
+/* F, G and H are basic MD4 functions: selection, majority, parity */
+#define F(x, y, z) ((z) ^ ((x) & ((y) ^ (z))))
+#define G(x, y, z) (((x) & (y)) + (((x) ^ (y)) & (z)))
+#define H(x, y, z) ((x) ^ (y) ^ (z))
+
+/*
+ * The generic round function. The application is so specific that
+ * we don't bother protecting all the arguments with parens, as is
+ * generally good macro practice, in favor of extra legibility.
+ */
+#define MD4_ROUND(f, a, b, c, d, x, s)	\
+	(a += f(b, c, d) + x, a = rol32(a, s))
+#define K1 0
+#define K2 013240474631UL
+#define K3 015666365641UL
+
+/* Basic cut-down MD4 transform; returns only 32 bits of result */
+static void half_md4_transform(uint32_t buf[4], const uint32_t in[8])
+{
+	uint32_t a = buf[0], b = buf[1], c = buf[2], d = buf[3];
+
+	/* Round 1 */
+	MD4_ROUND(F, a, b, c, d, in[0] + K1,  3);
+	MD4_ROUND(F, d, a, b, c, in[1] + K1,  7);
+	MD4_ROUND(F, c, d, a, b, in[2] + K1, 11);
+	MD4_ROUND(F, b, c, d, a, in[3] + K1, 19);
+	MD4_ROUND(F, a, b, c, d, in[4] + K1,  3);
+	MD4_ROUND(F, d, a, b, c, in[5] + K1,  7);
+	MD4_ROUND(F, c, d, a, b, in[6] + K1, 11);
+	MD4_ROUND(F, b, c, d, a, in[7] + K1, 19);
+
+	/* Round 2 */
+	MD4_ROUND(G, a, b, c, d, in[1] + K2,  3);
+	MD4_ROUND(G, d, a, b, c, in[3] + K2,  5);
+	MD4_ROUND(G, c, d, a, b, in[5] + K2,  9);
+	MD4_ROUND(G, b, c, d, a, in[7] + K2, 13);
+	MD4_ROUND(G, a, b, c, d, in[0] + K2,  3);
+	MD4_ROUND(G, d, a, b, c, in[2] + K2,  5);
+	MD4_ROUND(G, c, d, a, b, in[4] + K2,  9);
+	MD4_ROUND(G, b, c, d, a, in[6] + K2, 13);
+
+	/* Round 3 */
+	MD4_ROUND(H, a, b, c, d, in[3] + K3,  3);
+	MD4_ROUND(H, d, a, b, c, in[7] + K3,  9);
+	MD4_ROUND(H, c, d, a, b, in[2] + K3, 11);
+	MD4_ROUND(H, b, c, d, a, in[6] + K3, 15);
+	MD4_ROUND(H, a, b, c, d, in[1] + K3,  3);
+	MD4_ROUND(H, d, a, b, c, in[5] + K3,  9);
+	MD4_ROUND(H, c, d, a, b, in[0] + K3, 11);
+	MD4_ROUND(H, b, c, d, a, in[4] + K3, 15);
+
+	buf[0] += a;
+	buf[1] += b;
+	buf[2] += c;
+	buf[3] += d;
+}
+
+#undef MD4_ROUND
+#undef K1
+#undef K2
+#undef K3
+#undef F
+#undef G
+#undef H
+
+/* The old legacy hash */
+static uint32_t dx_hack_hash_unsigned(const char *name, int len)
+{
+	uint32_t hash, hash0 = 0x12a3fe2d, hash1 = 0x37abe8f9;
+	const unsigned char *ucp = (const unsigned char *)name;
+
+	while (len--) {
+		hash = hash1 + (hash0 ^ (((int)*ucp++) * 7152373));
+
+		if (hash & 0x80000000)
+			hash -= 0x7fffffff;
+		hash1 = hash0;
+		hash0 = hash;
+	}
+	return hash0 << 1;
+}
+
+static uint32_t dx_hack_hash_signed(const char *name, int len)
+{
+	uint32_t hash, hash0 = 0x12a3fe2d, hash1 = 0x37abe8f9;
+	const signed char *scp = (const signed char *)name;
+
+	while (len--) {
+		hash = hash1 + (hash0 ^ (((int)*scp++) * 7152373));
+
+		if (hash & 0x80000000)
+			hash -= 0x7fffffff;
+		hash1 = hash0;
+		hash0 = hash;
+	}
+	return hash0 << 1;
+}
+
+static void str2hashbuf_signed(const char *msg, int len, uint32_t *buf,
+			       int num)
+{
+	uint32_t pad, val;
+	int i;
+	const signed char *scp = (const signed char *)msg;
+
+	pad = (uint32_t)len | ((uint32_t)len << 8);
+	pad |= pad << 16;
+
+	val = pad;
+	if (len > num * 4)
+		len = num * 4;
+	for (i = 0; i < len; i++) {
+		val = ((int)scp[i]) + (val << 8);
+		if ((i % 4) == 3) {
+			*buf++ = val;
+			val = pad;
+			num--;
+		}
+	}
+	if (--num >= 0)
+		*buf++ = val;
+	while (--num >= 0)
+		*buf++ = pad;
+}
+
+static void str2hashbuf_unsigned(const char *msg, int len, uint32_t *buf,
+				 int num)
+{
+	uint32_t pad, val;
+	int i;
+	const unsigned char *ucp = (const unsigned char *)msg;
+
+	pad = (uint32_t)len | ((uint32_t)len << 8);
+	pad |= pad << 16;
+
+	val = pad;
+	if (len > num * 4)
+		len = num * 4;
+	for (i = 0; i < len; i++) {
+		val = ((int)ucp[i]) + (val << 8);
+		if ((i % 4) == 3) {
+			*buf++ = val;
+			val = pad;
+			num--;
+		}
+	}
+	if (--num >= 0)
+		*buf++ = val;
+	while (--num >= 0)
+		*buf++ = pad;
+}
+
+int ext4fs_dirhash(const char *name, int len, int version,
+		   const uint32_t seed[4], uint32_t *hash)
+{
+	uint32_t buf[4], in[8];
+	const char *p;
+	int i;
+	void (*str2hashbuf)(const char *, int, uint32_t *, int) =
+		str2hashbuf_signed;
+
+	/* Initialize the default seed for the hash checksum functions */
+	buf[0] = 0x67452301;
+	buf[1] = 0xefcdab89;
+	buf[2] = 0x98badcfe;
+	buf[3] = 0x10325476;
+
+	/* Check to see if the seed is all zero's */
+	for (i = 0; i < 4; i++) {
+		if (seed[i])
+			break;
+	}
+	if (i < 4)
+		memcpy(buf, seed, sizeof(buf));
+
+	switch (version) {
+	case DX_HASH_LEGACY_UNSIGNED:
+		*hash = dx_hack_hash_unsigned(name, len);
+		break;
+	case DX_HASH_LEGACY:
+		*hash = dx_hack_hash_signed(name, len);
+		break;
+	case DX_HASH_HALF_MD4_UNSIGNED:
+		str2hashbuf = str2hashbuf_unsigned;
+		/* fall through */
+	case DX_HASH_HALF_MD4:
+		p = name;
+		while (len > 0) {
+			str2hashbuf(p, len, in, 8);
+			half_md4_transform(buf, in);
+			len -= 32;
+			p += 32;
+		}
+		*hash = buf[1];
+		break;
+	case DX_HASH_TEA_UNSIGNED:
+		str2hashbuf = str2hashbuf_unsigned;
+		/* fall through */
+	case DX_HASH_TEA:
+		p = name;
+		while (len > 0) {
+			str2hashbuf(p, len, in, 4);
+			tea_transform(buf, in);
+			len -= 16;
+			p += 16;
+		}
+		*hash = buf[0];
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	*hash &= ~1;
+	if (*hash == (EXT4_HTREE_EOF_32BIT << 1))
+		*hash = (EXT4_HTREE_EOF_32BIT - 1) << 1;
+
+	return 0;
+}
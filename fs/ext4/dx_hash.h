@@ -0,0 +1,31 @@
+/*
+ * dx_hash.h - directory index (HTree) hash functions
+ *
+ * Copyright (C) 2002 by Theodore Ts'o
+ *
+ * SPDX-License-Identifier:	GPL-2.0
+ */
+#ifndef __DX_HASH_H
+#define __DX_HASH_H
+
+/* Hash versions as stored in dx_root_info.hash_version */
+#define DX_HASH_LEGACY			0
+#define DX_HASH_HALF_MD4		1
+#define DX_HASH_TEA			2
+#define DX_HASH_LEGACY_UNSIGNED		3
+#define DX_HASH_HALF_MD4_UNSIGNED	4
+#define DX_HASH_TEA_UNSIGNED		5
+
+/**
+ * ext4fs_dirhash() - compute the major hash of a directory entry name
+ *
+ * @name:	name of the entry (need not be NUL-terminated)
+ * @len:	length of @name
+ * @version:	one of DX_HASH_*
+ * @seed:	hash seed from the superblock, in CPU order
+ * @hash:	returns the hash with the collision bit cleared
+ * @return 0 if OK, -EINVAL if @version is not supported
+ */
+int ext4fs_dirhash(const char *name, int len, int version,
+		   const uint32_t seed[4], uint32_t *hash);
+#endif
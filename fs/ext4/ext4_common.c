@@ -26,10 +26,12 @@
 #include <malloc.h>
 #include <memalign.h>
 #include <stddef.h>
+#include <linux/bug.h>
 #include <linux/stat.h>
 #include <linux/time.h>
 #include <asm/byteorder.h>
 #include "ext4_common.h"
+#include "dx_hash.h"
 
 struct ext2_data *ext4fs_root;
 struct ext2fs_node *ext4fs_file;
@@ -58,16 +60,33 @@ static inline void ext4fs_sb_free_inodes_dec(struct ext2_sblock *sb)
 	sb->free_inodes = cpu_to_le32(le32_to_cpu(sb->free_inodes) - 1);
 }
 
-static inline void ext4fs_sb_free_blocks_dec(struct ext2_sblock *sb)
+static inline void ext4fs_sb_free_blocks_sub(struct ext2_sblock *sb,
+					     uint32_t count)
 {
 	uint64_t free_blocks = le32_to_cpu(sb->free_blocks);
 	free_blocks += (uint64_t)le32_to_cpu(sb->free_blocks_high) << 32;
-	free_blocks--;
+	free_blocks -= count;
 
 	sb->free_blocks = cpu_to_le32(free_blocks & 0xffffffff);
 	sb->free_blocks_high = cpu_to_le16(free_blocks >> 32);
 }
 
+static inline void ext4fs_sb_free_blocks_add(struct ext2_sblock *sb,
+					     uint32_t count)
+{
+	uint64_t free_blocks = le32_to_cpu(sb->free_blocks);
+	free_blocks += (uint64_t)le32_to_cpu(sb->free_blocks_high) << 32;
+	free_blocks += count;
+
+	sb->free_blocks = cpu_to_le32(free_blocks & 0xffffffff);
+	sb->free_blocks_high = cpu_to_le16(free_blocks >> 32);
+}
+
+static inline void ext4fs_sb_free_blocks_dec(struct ext2_sblock *sb)
+{
+	ext4fs_sb_free_blocks_sub(sb, 1);
+}
+
 static inline void ext4fs_bg_free_inodes_dec
 	(struct ext2_block_group *bg, const struct ext_filesystem *fs)
 {
@@ -81,19 +100,40 @@ static inline void ext4fs_bg_free_inodes_dec
 		bg->free_inodes_high = cpu_to_le16(free_inodes >> 16);
 }
 
-static inline void ext4fs_bg_free_blocks_dec
-	(struct ext2_block_group *bg, const struct ext_filesystem *fs)
+static inline void ext4fs_bg_free_blocks_sub
+	(struct ext2_block_group *bg, const struct ext_filesystem *fs,
+	 uint32_t count)
 {
 	uint32_t free_blocks = le16_to_cpu(bg->free_blocks);
 	if (fs->gdsize == 64)
 		free_blocks += le16_to_cpu(bg->free_blocks_high) << 16;
-	free_blocks--;
+	free_blocks -= count;
 
 	bg->free_blocks = cpu_to_le16(free_blocks & 0xffff);
 	if (fs->gdsize == 64)
 		bg->free_blocks_high = cpu_to_le16(free_blocks >> 16);
 }
 
+static inline void ext4fs_bg_free_blocks_add
+	(struct ext2_block_group *bg, const struct ext_filesystem *fs,
+	 uint32_t count)
+{
+	uint32_t free_blocks = le16_to_cpu(bg->free_blocks);
+	if (fs->gdsize == 64)
+		free_blocks += le16_to_cpu(bg->free_blocks_high) << 16;
+	free_blocks += count;
+
+	bg->free_blocks = cpu_to_le16(free_blocks & 0xffff);
+	if (fs->gdsize == 64)
+		bg->free_blocks_high = cpu_to_le16(free_blocks >> 16);
+}
+
+static inline void ext4fs_bg_free_blocks_dec
+	(struct ext2_block_group *bg, const struct ext_filesystem *fs)
+{
+	ext4fs_bg_free_blocks_sub(bg, fs, 1);
+}
+
 static inline void ext4fs_bg_itable_unused_dec
 	(struct ext2_block_group *bg, const struct ext_filesystem *fs)
 {
@@ -1477,20 +1517,330 @@ fail:
 	free(ti_gp_buff_start_addr);
 }
 
-void ext4fs_allocate_blocks(struct ext2_inode *file_inode,
-				unsigned int total_remaining_blocks,
-				unsigned int *total_no_of_block)
+/*
+ * Build the block bitmap of a group flagged EXT4_BG_BLOCK_UNINIT.
+ * Such a group only holds its own metadata (superblock backup, group
+ * descriptors and, without flex_bg, bitmaps and inode table), which
+ * always sits at the start of the group, so the used blocks are the
+ * ones not accounted as free in the descriptor. Bits past the end of
+ * a short last group are marked as used as well.
+ */
+static void ext4fs_init_block_bitmap(struct ext2_block_group *bgd,
+				     unsigned int bg_idx)
+{
+	struct ext_filesystem *fs = get_fs();
+	uint32_t blk_per_grp =
+		le32_to_cpu(ext4fs_root->sblock.blocks_per_group);
+	uint32_t blks_in_grp = blk_per_grp;
+	uint32_t used, i;
+	unsigned char *bmap = fs->blk_bmaps[bg_idx];
+
+	if (bg_idx == fs->no_blkgrp - 1)
+		blks_in_grp = le32_to_cpu(ext4fs_root->sblock.total_blocks) -
+			le32_to_cpu(ext4fs_root->sblock.first_data_block) -
+			bg_idx * blk_per_grp;
+	used = blks_in_grp - ext4fs_bg_get_free_blocks(bgd, fs);
+
+	memset(bmap, 0, fs->blksz);
+	for (i = 0; i < used; i++)
+		bmap[i >> 3] |= 1 << (i & 7);
+	for (i = blks_in_grp; i < fs->blksz * 8; i++)
+		bmap[i >> 3] |= 1 << (i & 7);
+
+	ext4fs_bg_set_flags(bgd,
+			    ext4fs_bg_get_flags(bgd) & ~EXT4_BG_BLOCK_UNINIT);
+}
+
+/*
+ * Allocate a run of up to @want physically contiguous blocks, searching
+ * the block group bitmaps from the current allocation cursor onwards.
+ * Returns the first block of the run and stores its length in @count,
+ * or returns -1 if no free block is left.
+ */
+static long int ext4fs_get_new_blk_run(uint32_t want, uint32_t *count)
+{
+	struct ext_filesystem *fs = get_fs();
+	uint32_t blk_per_grp =
+		le32_to_cpu(ext4fs_root->sblock.blocks_per_group);
+	uint32_t first_data_blk =
+		le32_to_cpu(ext4fs_root->sblock.first_data_block);
+	struct ext2_block_group *bgd;
+	unsigned char *bmap;
+	uint32_t bg_idx = 0, bit = 0, start;
+	long int blkno = -1;
+	int pass;
+	char *journal_buffer = zalloc(fs->blksz);
+
+	if (!journal_buffer)
+		return -1;
+
+	if (fs->first_pass_bbmap) {
+		bg_idx = (fs->curr_blkno + 1 - first_data_blk) / blk_per_grp;
+		bit = (fs->curr_blkno + 1 - first_data_blk) % blk_per_grp;
+	}
+
+	/* second pass wraps around to pick up blocks behind the cursor */
+	for (pass = 0; pass < 2 && blkno == -1; pass++) {
+		for (; bg_idx < fs->no_blkgrp; bg_idx++, bit = 0) {
+			uint64_t b_bitmap_blk;
+
+			bgd = ext4fs_get_group_descriptor(fs, bg_idx);
+			if (ext4fs_bg_get_free_blocks(bgd, fs) == 0)
+				continue;
+
+			b_bitmap_blk = ext4fs_bg_get_block_id(bgd, fs);
+			if (ext4fs_bg_get_flags(bgd) & EXT4_BG_BLOCK_UNINIT)
+				ext4fs_init_block_bitmap(bgd, bg_idx);
+
+			bmap = fs->blk_bmaps[bg_idx];
+			while (bit < blk_per_grp) {
+				if (!(bit & 7) && bmap[bit >> 3] == 0xff)
+					bit += 8;
+				else if (bmap[bit >> 3] & (1 << (bit & 7)))
+					bit++;
+				else
+					break;
+			}
+			if (bit >= blk_per_grp)
+				continue;
+
+			/* journal backup of the bitmap before changing it */
+			if (ext4fs_devread(b_bitmap_blk * fs->sect_perblk, 0,
+					   fs->blksz, journal_buffer) == 0 ||
+			    ext4fs_log_journal(journal_buffer, b_bitmap_blk))
+				goto fail;
+
+			start = bit;
+			while (bit < blk_per_grp && bit - start < want &&
+			       !(bmap[bit >> 3] & (1 << (bit & 7)))) {
+				bmap[bit >> 3] |= 1 << (bit & 7);
+				bit++;
+			}
+
+			*count = bit - start;
+			ext4fs_bg_free_blocks_sub(bgd, fs, *count);
+			ext4fs_sb_free_blocks_sub(fs->sb, *count);
+
+			blkno = first_data_blk + bg_idx * blk_per_grp + start;
+			fs->curr_blkno = blkno + *count - 1;
+			fs->first_pass_bbmap = 1;
+			break;
+		}
+		bg_idx = 0;
+		bit = 0;
+	}
+fail:
+	free(journal_buffer);
+
+	return blkno;
+}
+
+/* Give back a run of blocks taken by ext4fs_get_new_blk_run() */
+static void ext4fs_free_blk_run(uint64_t start, uint32_t len)
+{
+	struct ext_filesystem *fs = get_fs();
+	uint32_t blk_per_grp =
+		le32_to_cpu(ext4fs_root->sblock.blocks_per_group);
+	uint32_t first_data_blk =
+		le32_to_cpu(ext4fs_root->sblock.first_data_block);
+	struct ext2_block_group *bgd;
+	uint32_t bg_idx, bit;
+
+	for (; len; start++, len--) {
+		bg_idx = (start - first_data_blk) / blk_per_grp;
+		bit = (start - first_data_blk) % blk_per_grp;
+		fs->blk_bmaps[bg_idx][bit >> 3] &= ~(1 << (bit & 7));
+		bgd = ext4fs_get_group_descriptor(fs, bg_idx);
+		ext4fs_bg_free_blocks_add(bgd, fs, 1);
+		ext4fs_sb_free_blocks_add(fs->sb, 1);
+	}
+}
+
+/*
+ * Allocate the data blocks of a new file as an extent tree. Blocks are
+ * grabbed in contiguous runs; up to four extents fit into the inode
+ * itself, beyond that as many levels of index blocks as needed are added.
+ * On failure every block taken here is given back.
+ */
+static int ext4fs_allocate_extents(struct ext2_inode *file_inode,
+				   unsigned int total_remaining_blocks,
+				   unsigned int *total_no_of_block)
+{
+	struct ext_filesystem *fs = get_fs();
+	struct ext4_extent_header *eh =
+		(struct ext4_extent_header *)file_inode->b.blocks.dir_blocks;
+	struct ext4_extent_header *node_eh;
+	struct ext4_extent *extents = NULL, *entries, *next, *new_ext;
+	struct ext4_extent_idx *idx;
+	uint32_t *tree_blks = NULL;
+	char *node_buf = NULL;
+	int in_inode = (sizeof(file_inode->b.blocks) - sizeof(*eh)) /
+		       sizeof(struct ext4_extent);
+	int per_node = (fs->blksz - sizeof(*eh)) / sizeof(struct ext4_extent);
+	int nr_ext = 0, max_ext = 0;
+	int nr_tree = 0, nr_tree_blks = 0;
+	int i, n, nr, nr_nodes, depth;
+	uint32_t lblk = 0;
+	int ret = 0;
+
+	/* An index entry has the same size as an extent */
+	BUILD_BUG_ON(sizeof(struct ext4_extent_idx) !=
+		     sizeof(struct ext4_extent));
+
+	while (total_remaining_blocks) {
+		struct ext4_extent *prev = nr_ext ? &extents[nr_ext - 1] : NULL;
+		uint32_t want = min_t(uint32_t, total_remaining_blocks,
+				      EXT_INIT_MAX_LEN);
+		uint32_t len;
+		long int start;
+
+		start = ext4fs_get_new_blk_run(want, &len);
+		if (start == -1) {
+			printf("no block left to assign\n");
+			ret = -ENOSPC;
+			goto fail;
+		}
+		debug("EXT %u: %ld+%u\n", lblk, start, len);
+
+		if (prev && ext4fs_extent_start(prev) +
+		    le16_to_cpu(prev->ee_len) == start &&
+		    le16_to_cpu(prev->ee_len) + len <= EXT_INIT_MAX_LEN) {
+			prev->ee_len = cpu_to_le16(le16_to_cpu(prev->ee_len) +
+						   len);
+		} else {
+			if (nr_ext == max_ext) {
+				max_ext = max_ext ? max_ext * 2 : per_node;
+				new_ext = realloc(extents,
+						  max_ext * sizeof(*extents));
+				if (!new_ext) {
+					ext4fs_free_blk_run(start, len);
+					ret = -ENOMEM;
+					goto fail;
+				}
+				extents = new_ext;
+			}
+			extents[nr_ext].ee_block = cpu_to_le32(lblk);
+			extents[nr_ext].ee_len = cpu_to_le16(len);
+			extents[nr_ext].ee_start_hi =
+				cpu_to_le16((uint64_t)start >> 32);
+			extents[nr_ext].ee_start_lo = cpu_to_le32(start);
+			nr_ext++;
+		}
+		lblk += len;
+		total_remaining_blocks -= len;
+	}
+
+	/* Grab the blocks for all levels of the tree before writing any */
+	for (nr = nr_ext; nr > in_inode; nr = DIV_ROUND_UP(nr, per_node))
+		nr_tree += DIV_ROUND_UP(nr, per_node);
+	if (nr_tree) {
+		tree_blks = malloc(nr_tree * sizeof(*tree_blks));
+		node_buf = malloc(fs->blksz);
+		if (!tree_blks || !node_buf) {
+			printf("No Memory\n");
+			ret = -ENOMEM;
+			goto fail;
+		}
+	}
+	for (; nr_tree_blks < nr_tree; nr_tree_blks++) {
+		/* this returns (uint32_t)-1 when no block is left */
+		tree_blks[nr_tree_blks] = ext4fs_get_new_blk_no();
+		if (tree_blks[nr_tree_blks] == (uint32_t)-1) {
+			printf("no block left to assign\n");
+			ret = -ENOSPC;
+			goto fail;
+		}
+	}
+
+	/*
+	 * Build the tree bottom-up: each pass packs the entries of one level
+	 * into blocks and makes an index entry for each block, until the
+	 * entries fit into the inode
+	 */
+	entries = extents;
+	nr = nr_ext;
+	for (depth = 0, i = 0; nr > in_inode; depth++) {
+		nr_nodes = DIV_ROUND_UP(nr, per_node);
+		next = malloc(nr_nodes * sizeof(*next));
+		if (!next) {
+			printf("No Memory\n");
+			ret = -ENOMEM;
+			goto fail;
+		}
+		idx = (struct ext4_extent_idx *)next;
+		for (n = 0; n < nr_nodes; n++, i++) {
+			int count = min(per_node, nr - n * per_node);
+
+			memset(node_buf, '\0', fs->blksz);
+			node_eh = (struct ext4_extent_header *)node_buf;
+			node_eh->eh_magic = cpu_to_le16(EXT4_EXT_MAGIC);
+			node_eh->eh_entries = cpu_to_le16(count);
+			node_eh->eh_max = cpu_to_le16(per_node);
+			node_eh->eh_depth = cpu_to_le16(depth);
+			memcpy(node_eh + 1, &entries[n * per_node],
+			       count * sizeof(*entries));
+			put_ext4((uint64_t)tree_blks[i] * fs->blksz, node_buf,
+				 fs->blksz);
+
+			/* ee_block and ei_block are both the first field */
+			idx[n].ei_block = entries[n * per_node].ee_block;
+			idx[n].ei_leaf_lo = cpu_to_le32(tree_blks[i]);
+			idx[n].ei_leaf_hi =
+				cpu_to_le16((uint64_t)tree_blks[i] >> 32);
+			idx[n].ei_unused = 0;
+		}
+		if (entries != extents)
+			free(entries);
+		entries = next;
+		nr = nr_nodes;
+	}
+
+	file_inode->flags |= cpu_to_le32(EXT4_EXTENTS_FL);
+	memset(eh, '\0', sizeof(file_inode->b.blocks));
+	eh->eh_magic = cpu_to_le16(EXT4_EXT_MAGIC);
+	eh->eh_max = cpu_to_le16(in_inode);
+	eh->eh_entries = cpu_to_le16(nr);
+	eh->eh_depth = cpu_to_le16(depth);
+	memcpy(eh + 1, entries, nr * sizeof(*entries));
+	if (entries != extents)
+		free(entries);
+	*total_no_of_block += nr_tree;
+	goto out;
+
+fail:
+	for (i = 0; i < nr_ext; i++)
+		ext4fs_free_blk_run(ext4fs_extent_start(&extents[i]),
+				    le16_to_cpu(extents[i].ee_len));
+	for (i = 0; i < nr_tree_blks; i++)
+		ext4fs_free_blk_run(tree_blks[i], 1);
+out:
+	free(node_buf);
+	free(tree_blks);
+	free(extents);
+
+	return ret;
+}
+
+int ext4fs_allocate_blocks(struct ext2_inode *file_inode,
+			   unsigned int total_remaining_blocks,
+			   unsigned int *total_no_of_block)
 {
 	short i;
 	long int direct_blockno;
 	unsigned int no_blks_reqd = 0;
 
+	if (le32_to_cpu(get_fs()->sb->feature_incompat) &
+	    EXT4_FEATURE_INCOMPAT_EXTENTS)
+		return ext4fs_allocate_extents(file_inode,
+					       total_remaining_blocks,
+					       total_no_of_block);
+
 	/* allocation of direct blocks */
 	for (i = 0; total_remaining_blocks && i < INDIRECT_BLOCKS; i++) {
 		direct_blockno = ext4fs_get_new_blk_no();
 		if (direct_blockno == -1) {
 			printf("no block left to assign\n");
-			return;
+			return -ENOSPC;
 		}
 		file_inode->b.blocks.dir_blocks[i] = cpu_to_le32(direct_blockno);
 		debug("DB %ld: %u\n", direct_blockno, total_remaining_blocks);
@@ -1505,6 +1855,9 @@ void ext4fs_allocate_blocks(struct ext2_inode *file_inode,
 	alloc_triple_indirect_block(file_inode, &total_remaining_blocks,
 				    &no_blks_reqd);
 	*total_no_of_block += no_blks_reqd;
+
+	/* the indirect block helpers stop when no block is left */
+	return total_remaining_blocks ? -ENOSPC : 0;
 }
 
 #endif
@@ -1601,6 +1954,81 @@ int ext4fs_read_inode(struct ext2_data *data, int ino, struct ext2_inode *inode)
 	return 1;
 }
 
+/*
+ * Map @fileblock of @inode to a disk block, returning 0 for a hole. For
+ * extent-mapped files *@count is set to the number of blocks from
+ * @fileblock on that map contiguously (or are part of the same hole), so
+ * that callers need not look each of them up; otherwise it is 1.
+ *
+ * Returns the disk block number, or a negative errno on error.
+ */
+long int ext4fs_map_blocks(struct ext2_inode *inode, uint32_t fileblock,
+			   uint32_t *count)
+{
+	struct ext4_extent_header *ext_block;
+	struct ext4_extent *extent;
+	unsigned long long start;
+	uint32_t startblock, len;
+	int log2_blksz;
+	long int blknr;
+	char *buf;
+	int i;
+
+	*count = 1;
+	if (!(le32_to_cpu(inode->flags) & EXT4_EXTENTS_FL)) {
+		blknr = read_allocated_block(inode, fileblock);
+		return blknr < 0 ? -EIO : blknr;
+	}
+
+	log2_blksz = LOG2_BLOCK_SIZE(ext4fs_root) -
+		     get_fs()->dev_desc->log2blksz;
+	buf = zalloc(EXT2_BLOCK_SIZE(ext4fs_root));
+	if (!buf)
+		return -ENOMEM;
+
+	ext_block = ext4fs_get_extent_block(ext4fs_root, buf,
+					    (struct ext4_extent_header *)
+					    inode->b.blocks.dir_blocks,
+					    fileblock, log2_blksz);
+	if (!ext_block) {
+		printf("invalid extent block\n");
+		free(buf);
+		return -EINVAL;
+	}
+
+	blknr = 0;
+	extent = (struct ext4_extent *)(ext_block + 1);
+	for (i = 0; i < le16_to_cpu(ext_block->eh_entries); i++) {
+		startblock = le32_to_cpu(extent[i].ee_block);
+		len = le16_to_cpu(extent[i].ee_len);
+
+		if (startblock > fileblock) {
+			/* Sparse file */
+			*count = startblock - fileblock;
+			break;
+		}
+
+		/* uninitialized extents read as zeroes */
+		if (len > EXT_INIT_MAX_LEN) {
+			len -= EXT_INIT_MAX_LEN;
+			if (fileblock < startblock + len) {
+				*count = startblock + len - fileblock;
+				break;
+			}
+		} else if (fileblock < startblock + len) {
+			start = le16_to_cpu(extent[i].ee_start_hi);
+			start = (start << 32) +
+				le32_to_cpu(extent[i].ee_start_lo);
+			*count = startblock + len - fileblock;
+			blknr = (fileblock - startblock) + start;
+			break;
+		}
+	}
+
+	free(buf);
+	return blknr;
+}
+
 long int read_allocated_block(struct ext2_inode *inode, int fileblock)
 {
 	long int blknr;
@@ -1991,6 +2419,255 @@ void ext4fs_close(void)
 	ext4fs_reinit_global();
 }
 
+/*
+ * Allocate a node for the directory entry @dirent of @diro and work out
+ * its file type, reading the inode if the entry does not record it.
+ */
+static struct ext2fs_node *ext4fs_dirent_node(struct ext2fs_node *diro,
+					      struct ext2_dirent *dirent,
+					      int *ftype)
+{
+	struct ext2fs_node *fdiro;
+	int type = FILETYPE_UNKNOWN;
+	int status;
+
+	fdiro = zalloc(sizeof(struct ext2fs_node));
+	if (!fdiro)
+		return NULL;
+
+	fdiro->data = diro->data;
+	fdiro->ino = le32_to_cpu(dirent->inode);
+
+	if (dirent->filetype != FILETYPE_UNKNOWN) {
+		fdiro->inode_read = 0;
+
+		if (dirent->filetype == FILETYPE_DIRECTORY)
+			type = FILETYPE_DIRECTORY;
+		else if (dirent->filetype == FILETYPE_SYMLINK)
+			type = FILETYPE_SYMLINK;
+		else if (dirent->filetype == FILETYPE_REG)
+			type = FILETYPE_REG;
+	} else {
+		status = ext4fs_read_inode(diro->data,
+					   le32_to_cpu(dirent->inode),
+					   &fdiro->inode);
+		if (status == 0) {
+			free(fdiro);
+			return NULL;
+		}
+		fdiro->inode_read = 1;
+
+		if ((le16_to_cpu(fdiro->inode.mode) &
+		     FILETYPE_INO_MASK) == FILETYPE_INO_DIRECTORY) {
+			type = FILETYPE_DIRECTORY;
+		} else if ((le16_to_cpu(fdiro->inode.mode)
+			    & FILETYPE_INO_MASK) == FILETYPE_INO_SYMLINK) {
+			type = FILETYPE_SYMLINK;
+		} else if ((le16_to_cpu(fdiro->inode.mode)
+			    & FILETYPE_INO_MASK) == FILETYPE_INO_REG) {
+			type = FILETYPE_REG;
+		}
+	}
+
+	*ftype = type;
+
+	return fdiro;
+}
+
+/* Deepest HTree supported: the root plus two (three with largedir) levels */
+#define DX_MAX_LEVELS	3
+
+/* One level of an HTree lookup path */
+struct dx_frame {
+	char *buf;
+	struct dx_entry *entries;
+	int count;
+	int at;
+};
+
+static inline uint32_t dx_get_block(const struct dx_entry *entry)
+{
+	return le32_to_cpu(entry->block) & 0x0fffffff;
+}
+
+static int dx_read_block(struct ext2fs_node *diro, uint32_t blk, char *buf)
+{
+	int blksz = EXT2_BLOCK_SIZE(diro->data);
+	loff_t actread;
+
+	if ((loff_t)(blk + 1) * blksz > le32_to_cpu(diro->inode.size))
+		return -EINVAL;
+	if (ext4fs_read_file(diro, (loff_t)blk * blksz, blksz, buf,
+			     &actread) < 0 || actread != blksz)
+		return -EIO;
+
+	return 0;
+}
+
+/*
+ * Set up @frame for the dx_entry array found at @offset in its block and
+ * pick the entry covering @hash by binary search.
+ */
+static int dx_frame_search(struct ext2fs_node *diro, struct dx_frame *frame,
+			   int offset, uint32_t hash)
+{
+	int blksz = EXT2_BLOCK_SIZE(diro->data);
+	struct dx_countlimit *cl;
+	int lo, hi, mid;
+
+	frame->entries = (struct dx_entry *)(frame->buf + offset);
+	cl = (struct dx_countlimit *)frame->entries;
+	frame->count = le16_to_cpu(cl->count);
+	if (!frame->count || frame->count > le16_to_cpu(cl->limit) ||
+	    le16_to_cpu(cl->limit) > (blksz - offset) / sizeof(struct dx_entry))
+		return -EINVAL;
+
+	/* entries[0] has no hash and covers everything below entries[1] */
+	lo = 1;
+	hi = frame->count - 1;
+	while (lo <= hi) {
+		mid = (lo + hi) / 2;
+		if (le32_to_cpu(frame->entries[mid].hash) > hash)
+			hi = mid - 1;
+		else
+			lo = mid + 1;
+	}
+	frame->at = lo - 1;
+
+	return 0;
+}
+
+/* Load the interior node below the current entry of @parent */
+static int dx_descend(struct ext2fs_node *diro, struct dx_frame *parent,
+		      uint32_t hash)
+{
+	struct dx_frame *frame = parent + 1;
+	int ret;
+
+	ret = dx_read_block(diro, dx_get_block(&parent->entries[parent->at]),
+			    frame->buf);
+	if (ret)
+		return ret;
+
+	/* skip the empty directory entry hiding the node */
+	return dx_frame_search(diro, frame, sizeof(struct ext2_dirent), hash);
+}
+
+static int dx_search_leaf(struct ext2fs_node *diro, char *buf, char *name,
+			  struct ext2fs_node **fnode, int *ftype)
+{
+	int blksz = EXT2_BLOCK_SIZE(diro->data);
+	int namelen = strlen(name);
+	struct ext2_dirent *dirent;
+	unsigned int off = 0;
+
+	while (off + sizeof(struct ext2_dirent) <= blksz) {
+		dirent = (struct ext2_dirent *)(buf + off);
+		if (le16_to_cpu(dirent->direntlen) < sizeof(*dirent) ||
+		    off + le16_to_cpu(dirent->direntlen) > blksz)
+			return -EINVAL;
+
+		if (dirent->inode && dirent->namelen == namelen &&
+		    !memcmp(dirent + 1, name, namelen)) {
+			*fnode = ext4fs_dirent_node(diro, dirent, ftype);
+			return *fnode ? 1 : -ENOMEM;
+		}
+		off += le16_to_cpu(dirent->direntlen);
+	}
+
+	return 0;
+}
+
+/*
+ * Look up @name in a hash indexed directory, reading only the index
+ * blocks on the path to the leaf plus any leaves continuing a hash
+ * collision. Returns 1 if found, 0 if not, or a negative error if the
+ * index cannot be used and the caller should fall back to a linear scan.
+ */
+static int ext4fs_dx_find(struct ext2fs_node *diro, char *name,
+			  struct ext2fs_node **fnode, int *ftype)
+{
+	struct ext2_sblock *sblock = &diro->data->sblock;
+	int blksz = EXT2_BLOCK_SIZE(diro->data);
+	struct dx_frame frames[DX_MAX_LEVELS];
+	struct dx_root_info *info;
+	uint32_t seed[4], hash, bhash;
+	char *bufs, *leaf;
+	int version, levels;
+	int i, ret;
+
+	bufs = zalloc((DX_MAX_LEVELS + 1) * blksz);
+	if (!bufs)
+		return -ENOMEM;
+	for (i = 0; i < DX_MAX_LEVELS; i++)
+		frames[i].buf = bufs + i * blksz;
+	leaf = bufs + DX_MAX_LEVELS * blksz;
+
+	ret = dx_read_block(diro, 0, frames[0].buf);
+	if (ret)
+		goto out;
+
+	/* dx_root_info follows the "." and ".." entries, 12 bytes each */
+	info = (struct dx_root_info *)(frames[0].buf + 24);
+	levels = info->indirect_levels + 1;
+	if (info->reserved_zero || info->info_length < sizeof(*info) ||
+	    levels > DX_MAX_LEVELS) {
+		ret = -EINVAL;
+		goto out;
+	}
+
+	version = info->hash_version;
+	if (version <= DX_HASH_TEA &&
+	    (le32_to_cpu(sblock->flags) & EXT2_FLAGS_UNSIGNED_HASH))
+		version += DX_HASH_LEGACY_UNSIGNED;
+	for (i = 0; i < 4; i++)
+		seed[i] = le32_to_cpu(sblock->hash_seed[i]);
+	ret = ext4fs_dirhash(name, strlen(name), version, seed, &hash);
+	if (ret) {
+		debug("unsupported dx hash version %d\n", info->hash_version);
+		goto out;
+	}
+
+	ret = dx_frame_search(diro, &frames[0], 24 + info->info_length, hash);
+	for (i = 1; !ret && i < levels; i++)
+		ret = dx_descend(diro, &frames[i - 1], hash);
+	if (ret)
+		goto out;
+
+	while (1) {
+		struct dx_frame *frame = &frames[levels - 1];
+
+		ret = dx_read_block(diro, dx_get_block(&frame->entries[frame->at]),
+				    leaf);
+		if (!ret)
+			ret = dx_search_leaf(diro, leaf, name, fnode, ftype);
+		if (ret)
+			goto out;
+
+		/* names with colliding hashes may spill into the next leaf */
+		for (i = levels - 1; i >= 0; i--) {
+			if (++frames[i].at < frames[i].count)
+				break;
+		}
+		if (i < 0)
+			break;
+		bhash = le32_to_cpu(frames[i].entries[frames[i].at].hash);
+		if ((bhash & ~1) != hash)
+			break;
+		for (; !ret && i < levels - 1; i++) {
+			ret = dx_descend(diro, &frames[i], hash);
+			frames[i + 1].at = 0;
+		}
+		if (ret)
+			goto out;
+	}
+	ret = 0;
+out:
+	free(bufs);
+
+	return ret;
+}
+
 int ext4fs_iterate_dir(struct ext2fs_node *dir, char *name,
 				struct ext2fs_node **fnode, int *ftype)
 {
@@ -2008,6 +2685,21 @@ int ext4fs_iterate_dir(struct ext2fs_node *dir, char *name,
 		if (status == 0)
 			return 0;
 	}
+
+	/*
+	 * "." and ".." are only in the first block, which is not covered by
+	 * the hash index, so look for them with a linear scan, as Linux does
+	 */
+	if ((name != NULL) && (fnode != NULL) && (ftype != NULL) &&
+	    (le32_to_cpu(diro->inode.flags) & EXT4_INDEX_FL) &&
+	    strcmp(name, ".") && strcmp(name, "..")) {
+		status = ext4fs_dx_find(diro, name, fnode, ftype);
+		if (status >= 0)
+			return status;
+		debug("dx lookup failed (%d), scanning %s linearly\n",
+		      status, name);
+	}
+
 	/* Search the file.  */
 	while (fpos < le32_to_cpu(diro->inode.size)) {
 		struct ext2_dirent dirent;
@@ -2026,7 +2718,7 @@ int ext4fs_iterate_dir(struct ext2fs_node *dir, char *name,
 		if (dirent.namelen != 0) {
 			char filename[dirent.namelen + 1];
 			struct ext2fs_node *fdiro;
-			int type = FILETYPE_UNKNOWN;
+			int type;
 
 			status = ext4fs_read_file(diro,
 						  fpos +
@@ -2036,49 +2728,11 @@ int ext4fs_iterate_dir(struct ext2fs_node *dir, char *name,
 			if (status < 0)
 				return 0;
 
-			fdiro = zalloc(sizeof(struct ext2fs_node));
+			fdiro = ext4fs_dirent_node(diro, &dirent, &type);
 			if (!fdiro)
 				return 0;
 
-			fdiro->data = diro->data;
-			fdiro->ino = le32_to_cpu(dirent.inode);
-
 			filename[dirent.namelen] = '\0';
-
-			if (dirent.filetype != FILETYPE_UNKNOWN) {
-				fdiro->inode_read = 0;
-
-				if (dirent.filetype == FILETYPE_DIRECTORY)
-					type = FILETYPE_DIRECTORY;
-				else if (dirent.filetype == FILETYPE_SYMLINK)
-					type = FILETYPE_SYMLINK;
-				else if (dirent.filetype == FILETYPE_REG)
-					type = FILETYPE_REG;
-			} else {
-				status = ext4fs_read_inode(diro->data,
-							   le32_to_cpu
-							   (dirent.inode),
-							   &fdiro->inode);
-				if (status == 0) {
-					free(fdiro);
-					return 0;
-				}
-				fdiro->inode_read = 1;
-
-				if ((le16_to_cpu(fdiro->inode.mode) &
-				     FILETYPE_INO_MASK) ==
-				    FILETYPE_INO_DIRECTORY) {
-					type = FILETYPE_DIRECTORY;
-				} else if ((le16_to_cpu(fdiro->inode.mode)
-					    & FILETYPE_INO_MASK) ==
-					   FILETYPE_INO_SYMLINK) {
-					type = FILETYPE_SYMLINK;
-				} else if ((le16_to_cpu(fdiro->inode.mode)
-					    & FILETYPE_INO_MASK) ==
-					   FILETYPE_INO_REG) {
-					type = FILETYPE_REG;
-				}
-			}
 #ifdef DEBUG
 			printf("iterate >%s<\n", filename);
 #endif /* of DEBUG */
@@ -2290,7 +2944,11 @@ int ext4fs_open(const char *filename, loff_t *len)
 	if (ext4fs_root == NULL)
 		return -1;
 
-	ext4fs_file = NULL;
+	/* A size lookup, e.g. from fs_read_cached(), leaves a file open */
+	if (ext4fs_file) {
+		ext4fs_free_node(ext4fs_file, &ext4fs_root->diropen);
+		ext4fs_file = NULL;
+	}
 	status = ext4fs_find_file(filename, &ext4fs_root->diropen, &fdiro,
 				  FILETYPE_REG);
 	if (status == 0)
@@ -48,6 +48,19 @@ static inline void *zalloc(size_t size)
 	return p;
 }
 
+/* Physical block number of the first block covered by an extent */
+static inline uint64_t ext4fs_extent_start(const struct ext4_extent *ext)
+{
+	return ((uint64_t)le16_to_cpu(ext->ee_start_hi) << 32) +
+		le32_to_cpu(ext->ee_start_lo);
+}
+
+static inline uint64_t ext4fs_extent_idx_leaf(const struct ext4_extent_idx *idx)
+{
+	return ((uint64_t)le16_to_cpu(idx->ei_leaf_hi) << 32) +
+		le32_to_cpu(idx->ei_leaf_lo);
+}
+
 int ext4fs_read_inode(struct ext2_data *data, int ino,
 		      struct ext2_inode *inode);
 int ext4fs_read_file(struct ext2fs_node *node, loff_t pos, loff_t len,
@@ -70,9 +83,9 @@ int ext4fs_set_block_bmap(long int blockno, unsigned char *buffer, int index);
 int ext4fs_set_inode_bmap(int inode_no, unsigned char *buffer, int index);
 void ext4fs_reset_inode_bmap(int inode_no, unsigned char *buffer, int index);
 int ext4fs_iget(int inode_no, struct ext2_inode *inode);
-void ext4fs_allocate_blocks(struct ext2_inode *file_inode,
-				unsigned int total_remaining_blocks,
-				unsigned int *total_no_of_block);
+int ext4fs_allocate_blocks(struct ext2_inode *file_inode,
+			   unsigned int total_remaining_blocks,
+			   unsigned int *total_no_of_block);
 void put_ext4(uint64_t off, void *buf, uint32_t size);
 struct ext2_block_group *ext4fs_get_group_descriptor
 	(const struct ext_filesystem *fs, uint32_t bg_idx);
@@ -432,6 +432,74 @@ fail:
 	free(journal_buffer);
 }
 
+/* release the blocks holding the extent tree below the inode, if any */
+static void delete_extent_index_blocks(struct ext4_extent_header *eh)
+{
+	struct ext2_block_group *bgd = NULL;
+	struct ext4_extent_idx *idx;
+	uint64_t blknr;
+	int remainder;
+	int bg_idx;
+	int i;
+	uint32_t blk_per_grp = le32_to_cpu(ext4fs_root->sblock.blocks_per_group);
+	struct ext_filesystem *fs = get_fs();
+	char *journal_buffer;
+	char *child = NULL;
+
+	if (le16_to_cpu(eh->eh_depth) == 0)
+		return;
+
+	journal_buffer = zalloc(fs->blksz);
+	if (!journal_buffer) {
+		printf("No memory\n");
+		return;
+	}
+	if (le16_to_cpu(eh->eh_depth) > 1) {
+		child = zalloc(fs->blksz);
+		if (!child) {
+			printf("No memory\n");
+			goto fail;
+		}
+	}
+
+	idx = (struct ext4_extent_idx *)(eh + 1);
+	for (i = 0; i < le16_to_cpu(eh->eh_entries); i++) {
+		blknr = ext4fs_extent_idx_leaf(&idx[i]);
+		if (child) {
+			if (ext4fs_devread(blknr * fs->sect_perblk, 0,
+					   fs->blksz, child) == 0)
+				goto fail;
+			delete_extent_index_blocks(
+				(struct ext4_extent_header *)child);
+		}
+
+		debug("EXT index block releasing %llu\n",
+		      (unsigned long long)blknr);
+		bg_idx = blknr / blk_per_grp;
+		if (fs->blksz == 1024) {
+			remainder = blknr % blk_per_grp;
+			if (!remainder)
+				bg_idx--;
+		}
+		ext4fs_reset_block_bmap(blknr, fs->blk_bmaps[bg_idx], bg_idx);
+		/* get  block group descriptor table */
+		bgd = ext4fs_get_group_descriptor(fs, bg_idx);
+		ext4fs_bg_free_blocks_inc(bgd, fs);
+		ext4fs_sb_free_blocks_inc(fs->sb);
+		/* journal backup */
+		if (ext4fs_devread(ext4fs_bg_get_block_id(bgd, fs) *
+				   fs->sect_perblk, 0, fs->blksz,
+				   journal_buffer) == 0)
+			goto fail;
+		if (ext4fs_log_journal(journal_buffer,
+				       ext4fs_bg_get_block_id(bgd, fs)))
+			goto fail;
+	}
+fail:
+	free(child);
+	free(journal_buffer);
+}
+
 static int ext4fs_delete_file(int inodeno)
 {
 	struct ext2_inode inode;
@@ -467,11 +535,11 @@ static int ext4fs_delete_file(int inodeno)
 		no_blocks++;
 
 	if (le32_to_cpu(inode.flags) & EXT4_EXTENTS_FL) {
-		/* FIXME delete extent index blocks, i.e. eh_depth >= 1 */
 		struct ext4_extent_header *eh =
 			(struct ext4_extent_header *)
 				inode.b.blocks.dir_blocks;
 		debug("del: dep=%d entries=%d\n", eh->eh_depth, eh->eh_entries);
+		delete_extent_index_blocks(eh);
 	} else {
 		delete_single_indirect_block(&inode);
 		delete_double_indirect_block(&inode);
@@ -831,6 +899,89 @@ static int ext4fs_write_file(struct ext2_inode *file_inode,
 	return len;
 }
 
+/*
+ * Write the first @len bytes of @buf to the extents of one leaf. Each
+ * extent is a single contiguous run on disk and is written in one go;
+ * a partial last block is padded with zeroes.
+ */
+static int ext4fs_write_extent_leaf(struct ext4_extent_header *eh,
+				    unsigned int len, char *buf)
+{
+	struct ext_filesystem *fs = get_fs();
+	struct ext4_extent *extent = (struct ext4_extent *)(eh + 1);
+	char *tail_buf;
+	int i;
+
+	for (i = 0; i < le16_to_cpu(eh->eh_entries); i++) {
+		uint64_t start = ext4fs_extent_start(&extent[i]);
+		uint64_t off = (uint64_t)le32_to_cpu(extent[i].ee_block) *
+			       fs->blksz;
+		uint32_t n, full;
+
+		if (off >= len)
+			continue;
+		n = min_t(uint64_t, len - off,
+			  (uint64_t)le16_to_cpu(extent[i].ee_len) * fs->blksz);
+		full = n & ~(fs->blksz - 1);
+
+		if (full)
+			put_ext4(start * fs->blksz, buf + off, full);
+		if (n == full)
+			continue;
+
+		tail_buf = zalloc(fs->blksz);
+		if (!tail_buf)
+			return -1;
+		memcpy(tail_buf, buf + off + full, n - full);
+		put_ext4((start + full / fs->blksz) * fs->blksz, tail_buf,
+			 fs->blksz);
+		free(tail_buf);
+	}
+
+	return 0;
+}
+
+/*
+ * Write data to a file allocated as an extent tree, one extent at a
+ * time rather than looking up every block through the tree.
+ */
+static int ext4fs_write_extent_tree(struct ext4_extent_header *eh,
+				    unsigned int len, char *buf)
+{
+	struct ext_filesystem *fs = get_fs();
+	struct ext4_extent_idx *idx = (struct ext4_extent_idx *)(eh + 1);
+	char *node;
+	int ret = 0;
+	int i;
+
+	if (le16_to_cpu(eh->eh_depth) == 0)
+		return ext4fs_write_extent_leaf(eh, len, buf);
+
+	node = zalloc(fs->blksz);
+	if (!node)
+		return -1;
+	for (i = 0; !ret && i < le16_to_cpu(eh->eh_entries); i++) {
+		if (ext4fs_devread(ext4fs_extent_idx_leaf(&idx[i]) *
+				   fs->sect_perblk, 0, fs->blksz, node) == 0)
+			ret = -1;
+		else
+			ret = ext4fs_write_extent_tree(
+				(struct ext4_extent_header *)node, len, buf);
+	}
+	free(node);
+
+	return ret;
+}
+
+static int ext4fs_write_extents(struct ext2_inode *file_inode,
+				unsigned int len, char *buf)
+{
+	struct ext4_extent_header *eh =
+		(struct ext4_extent_header *)file_inode->b.blocks.dir_blocks;
+
+	return ext4fs_write_extent_tree(eh, len, buf) ? -1 : len;
+}
+
 int ext4fs_write(const char *fname, unsigned char *buffer,
 					unsigned long sizebytes)
 {
@@ -902,9 +1053,6 @@ int ext4fs_write(const char *fname, unsigned char *buffer,
 		goto fail;
 	}
 
-	inodeno = ext4fs_update_parent_dentry(filename, FILETYPE_REG);
-	if (inodeno == -1)
-		goto fail;
 	/* prepare file inode */
 	inode_buffer = zalloc(fs->inodesz);
 	if (!inode_buffer)
@@ -919,9 +1067,19 @@ int ext4fs_write(const char *fname, unsigned char *buffer,
 	file_inode->nlinks = cpu_to_le16(1);
 	file_inode->size = cpu_to_le32(sizebytes);
 
-	/* Allocate data blocks */
-	ext4fs_allocate_blocks(file_inode, blocks_remaining,
-			       &blks_reqd_for_file);
+	/*
+	 * Allocate data blocks before adding the directory entry, so that
+	 * nothing refers to the file if there is not enough space for it
+	 */
+	if (ext4fs_allocate_blocks(file_inode, blocks_remaining,
+				   &blks_reqd_for_file)) {
+		printf("Error in allocating blocks\n");
+		goto fail;
+	}
+
+	inodeno = ext4fs_update_parent_dentry(filename, FILETYPE_REG);
+	if (inodeno == -1)
+		goto fail;
 	file_inode->blockcnt = cpu_to_le32((blks_reqd_for_file * fs->blksz) >>
 		fs->dev_desc->log2blksz);
 
@@ -944,7 +1102,13 @@ int ext4fs_write(const char *fname, unsigned char *buffer,
 	if (ext4fs_put_metadata(temp_ptr, itable_blkno))
 		goto fail;
 	/* copy the file content into data blocks */
-	if (ext4fs_write_file(file_inode, 0, sizebytes, (char *)buffer) == -1) {
+	if (le32_to_cpu(file_inode->flags) & EXT4_EXTENTS_FL)
+		ret = ext4fs_write_extents(file_inode, sizebytes,
+					   (char *)buffer);
+	else
+		ret = ext4fs_write_file(file_inode, 0, sizebytes,
+					(char *)buffer);
+	if (ret == -1) {
 		printf("Error in copying content\n");
 		/* FIXME: Deallocate data blocks */
 		goto fail;
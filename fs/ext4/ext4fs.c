@@ -26,6 +26,8 @@
 #include <ext4fs.h>
 #include "ext4_common.h"
 #include <div64.h>
+#include <fs.h>
+#include <linux/sizes.h>
 
 int ext4fs_symlinknest;
 struct ext_filesystem ext_fs;
@@ -229,6 +231,98 @@ int ext4_read_file(const char *filename, void *buf, loff_t offset, loff_t len,
 	return ext4fs_read(buf, offset, len, len_read);
 }
 
+struct ext4fs_file_handle {
+	struct fs_file parent;
+	struct ext2_inode inode;
+	/* the run of file blocks mapped by the last lookup */
+	uint32_t run_block;	/* first file block */
+	uint32_t run_len;	/* number of blocks, 0 if none */
+	long int run_start;	/* first disk block, 0 for a hole */
+};
+
+int ext4fs_file_open(const char *filename, struct fs_file **filep)
+{
+	struct ext4fs_file_handle *file;
+	loff_t len;
+
+	if (ext4fs_open(filename, &len) < 0)
+		return -ENOENT;
+
+	file = calloc(1, sizeof(*file));
+	if (!file)
+		return -ENOMEM;
+
+	/* ext4fs_file is freed by ext4fs_close(), so keep the inode only */
+	memcpy(&file->inode, &ext4fs_file->inode, sizeof(file->inode));
+	file->parent.size = len;
+	*filep = &file->parent;
+
+	return 0;
+}
+
+/*
+ * Read from the current position of the file. Each extent is looked up
+ * once and then read with as few device reads as possible, instead of
+ * mapping every block separately as ext4fs_read_file() does.
+ */
+int ext4fs_file_read(struct fs_file *parent, void *buf, loff_t len,
+		     loff_t *actread)
+{
+	struct ext4fs_file_handle *file = (struct ext4fs_file_handle *)parent;
+	int log2blksz = get_fs()->dev_desc->log2blksz;
+	int log2_fs_blocksize = LOG2_BLOCK_SIZE(ext4fs_root);
+	loff_t pos = parent->pos;
+	uint32_t fileblock, count;
+	long int blknr;
+	loff_t offset, n;
+
+	*actread = 0;
+
+	while (len) {
+		fileblock = pos >> log2_fs_blocksize;
+		offset = pos & (EXT2_BLOCK_SIZE(ext4fs_root) - 1);
+
+		if (!file->run_len || fileblock < file->run_block ||
+		    fileblock - file->run_block >= file->run_len) {
+			blknr = ext4fs_map_blocks(&file->inode, fileblock,
+						  &count);
+			if (blknr < 0)
+				return blknr;
+			file->run_block = fileblock;
+			file->run_len = count;
+			file->run_start = blknr;
+		}
+
+		count = file->run_len - (fileblock - file->run_block);
+		n = ((loff_t)count << log2_fs_blocksize) - offset;
+		n = min(n, len);
+		/* ext4fs_devread() takes an int length */
+		n = min(n, (loff_t)SZ_1G);
+
+		if (file->run_start) {
+			blknr = file->run_start + fileblock - file->run_block;
+			if (!ext4fs_devread((lbaint_t)blknr <<
+					    (log2_fs_blocksize - log2blksz),
+					    offset, n, buf))
+				return -EIO;
+		} else {
+			memset(buf, 0, n);
+		}
+
+		buf += n;
+		pos += n;
+		len -= n;
+		*actread += n;
+	}
+
+	return 0;
+}
+
+void ext4fs_file_close(struct fs_file *file)
+{
+	free(file);
+}
+
 int ext4fs_uuid(char *uuid_str)
 {
 	if (ext4fs_root == NULL)
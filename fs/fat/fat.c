@@ -1186,6 +1186,129 @@ void fat_closedir(struct fs_dir_stream *dirs)
 	free(dir);
 }
 
+typedef struct {
+	struct fs_file parent;
+	fsdata fsdata;
+	__u32 start;		/* first cluster of the file */
+	__u32 clust;		/* cluster holding clust_pos */
+	loff_t clust_pos;	/* file offset of the start of 'clust' */
+} fat_file;
+
+int fat_file_open(const char *filename, struct fs_file **filep)
+{
+	fat_file *file = calloc(1, sizeof(*file));
+	fat_itr itrblock, *itr = &itrblock;
+	fsdata *mydata;
+	int ret;
+
+	if (!file)
+		return -ENOMEM;
+	mydata = &file->fsdata;	/* for silly macros */
+
+	ret = fat_itr_root(itr, &file->fsdata);
+	if (ret)
+		goto fail;
+
+	ret = fat_itr_resolve(itr, filename, TYPE_FILE);
+	if (ret)
+		goto fail;
+
+	file->parent.size = FAT2CPU32(itr->dent->size);
+	file->start = START(itr->dent);
+	file->clust = file->start;
+	file->clust_pos = 0;
+
+	*filep = (struct fs_file *)file;
+	return 0;
+
+fail:
+	free(file->fsdata.fatbuf);
+	free(file);
+	return ret;
+}
+
+/*
+ * Read from the current position of the file. The cluster reached by the
+ * previous read is remembered, so sequential reads walk the cluster chain
+ * only once in total; seeking backwards restarts from the first cluster.
+ */
+int fat_file_read(struct fs_file *parent, void *buf, loff_t len,
+		  loff_t *actread)
+{
+	fat_file *file = (fat_file *)parent;
+	fsdata *mydata = &file->fsdata;
+	unsigned int bytesperclust = mydata->clust_size * mydata->sect_size;
+	loff_t pos = parent->pos;
+	__u32 endclust, newclust;
+	loff_t offset, n;
+
+	*actread = 0;
+
+	if (pos < file->clust_pos) {
+		file->clust = file->start;
+		file->clust_pos = 0;
+	}
+
+	while (len) {
+		/* go to cluster at pos */
+		while (pos >= file->clust_pos + bytesperclust) {
+			newclust = get_fatent(mydata, file->clust);
+			if (CHECK_CLUST(newclust, mydata->fatsize)) {
+				debug("curclust: 0x%x\n", newclust);
+				printf("Invalid FAT entry\n");
+				return -EIO;
+			}
+			file->clust = newclust;
+			file->clust_pos += bytesperclust;
+		}
+
+		offset = pos - file->clust_pos;
+		if (offset || len < bytesperclust) {
+			n = min(len, (loff_t)bytesperclust - offset);
+			if (get_cluster(mydata, file->clust,
+					get_contents_vfatname_block,
+					offset + n) != 0) {
+				printf("Error reading cluster\n");
+				return -EIO;
+			}
+			memcpy(buf, get_contents_vfatname_block + offset, n);
+		} else {
+			/* search for consecutive clusters */
+			n = bytesperclust;
+			endclust = file->clust;
+			while (n + bytesperclust <= len) {
+				newclust = get_fatent(mydata, endclust);
+				if (newclust - 1 != endclust ||
+				    CHECK_CLUST(newclust, mydata->fatsize))
+					break;
+				endclust = newclust;
+				n += bytesperclust;
+			}
+			if (get_cluster(mydata, file->clust, buf, n) != 0) {
+				printf("Error reading cluster\n");
+				return -EIO;
+			}
+			file->clust = endclust;
+			file->clust_pos += n - bytesperclust;
+		}
+
+		buf += n;
+		pos += n;
+		len -= n;
+		*actread += n;
+	}
+
+	return 0;
+}
+
+void fat_file_close(struct fs_file *parent)
+{
+	fat_file *file = (fat_file *)parent;
+
+	free(file->fsdata.fatbuf);
+	free(file);
+}
+
 void fat_close(void)
 {
 }
@@ -7,12 +7,15 @@
 #include <config.h>
 #include <errno.h>
 #include <common.h>
+#include <console.h>
 #include <mapmem.h>
 #include <part.h>
 #include <ext4fs.h>
 #include <fat.h>
 #include <fs.h>
+#include <malloc.h>
 #include <sandboxfs.h>
+#include <squashfs.h>
 #include <ubifs_uboot.h>
 #include <asm/io.h>
 #include <div64.h>
@@ -105,6 +108,22 @@ static inline int fs_opendir_unsupported(const char *filename,
 	return -EACCES;
 }
 
+static inline int fs_file_open_unsupported(const char *filename,
+					   struct fs_file **filep)
+{
+	return -EACCES;
+}
+
+static inline int fs_file_read_unsupported(struct fs_file *file, void *buf,
+					   loff_t len, loff_t *actread)
+{
+	return -ENODEV;
+}
+
+static inline void fs_file_close_unsupported(struct fs_file *file)
+{
+}
+
 struct fstype_info {
 	int fstype;
 	char *name;
@@ -142,8 +161,73 @@ struct fstype_info {
 	int (*readdir)(struct fs_dir_stream *dirs, struct fs_dirent **dentp);
 	/* see fs_closedir() */
 	void (*closedir)(struct fs_dir_stream *dirs);
+	/*
+	 * Open a file for reading.  On success return 0 and the file handle
+	 * via 'filep', with ->size set.  On error, return -errno.  See
+	 * fs_file_open().
+	 */
+	int (*file_open)(const char *filename, struct fs_file **filep);
+	/*
+	 * Read up to 'len' bytes at file->pos, which the caller has already
+	 * limited to the end of the file.  Seeking only changes file->pos,
+	 * so the driver must check it against any cursor it keeps.
+	 */
+	int (*file_read)(struct fs_file *file, void *buf, loff_t len,
+			 loff_t *actread);
+	/* see fs_file_close() */
+	void (*file_close)(struct fs_file *file);
+};
+
+/*
+ * Generic file handle for filesystems without a native one: every read
+ * looks the file up again through ->read().
+ */
+struct fs_file_generic {
+	struct fs_file file;
+	char name[];
 };
 
+static struct fstype_info *fs_get_info(int fstype);
+
+__maybe_unused
+static int fs_file_open_generic(const char *filename, struct fs_file **filep)
+{
+	struct fstype_info *info = fs_get_info(fs_type);
+	struct fs_file_generic *gen;
+	loff_t size;
+
+	if (!info->exists(filename) || info->size(filename, &size))
+		return -ENOENT;
+
+	gen = calloc(1, sizeof(*gen) + strlen(filename) + 1);
+	if (!gen)
+		return -ENOMEM;
+	strcpy(gen->name, filename);
+	gen->file.size = size;
+	*filep = &gen->file;
+
+	return 0;
+}
+
+__maybe_unused
+static int fs_file_read_generic(struct fs_file *file, void *buf, loff_t len,
+				loff_t *actread)
+{
+	struct fstype_info *info = fs_get_info(fs_type);
+	struct fs_file_generic *gen = (struct fs_file_generic *)file;
+
+	if (info->read(gen->name, buf, file->pos, len, actread))
+		return -EIO;
+
+	return 0;
+}
+
+__maybe_unused
+static void fs_file_close_generic(struct fs_file *file)
+{
+	free(file);
+}
+
 static struct fstype_info fstypes[] = {
 #ifdef CONFIG_FS_FAT
 	{
@@ -165,6 +249,9 @@ static struct fstype_info fstypes[] = {
 		.opendir = fat_opendir,
 		.readdir = fat_readdir,
 		.closedir = fat_closedir,
+		.file_open = fat_file_open,
+		.file_read = fat_file_read,
+		.file_close = fat_file_close,
 	},
 #endif
 #ifdef CONFIG_FS_EXT4
@@ -185,6 +272,9 @@ static struct fstype_info fstypes[] = {
 #endif
 		.uuid = ext4fs_uuid,
 		.opendir = fs_opendir_unsupported,
+		.file_open = ext4fs_file_open,
+		.file_read = ext4fs_file_read,
+		.file_close = ext4fs_file_close,
 	},
 #endif
 #ifdef CONFIG_SANDBOX
@@ -201,6 +291,9 @@ static struct fstype_info fstypes[] = {
 		.write = fs_write_sandbox,
 		.uuid = fs_uuid_unsupported,
 		.opendir = fs_opendir_unsupported,
+		.file_open = fs_file_open_generic,
+		.file_read = fs_file_read_generic,
+		.file_close = fs_file_close_generic,
 	},
 #endif
 #ifdef CONFIG_CMD_UBIFS
@@ -217,6 +310,30 @@ static struct fstype_info fstypes[] = {
 		.write = fs_write_unsupported,
 		.uuid = fs_uuid_unsupported,
 		.opendir = fs_opendir_unsupported,
+		.file_open = fs_file_open_generic,
+		.file_read = fs_file_read_generic,
+		.file_close = fs_file_close_generic,
+	},
+#endif
+#ifdef CONFIG_FS_SQUASHFS
+	{
+		.fstype = FS_TYPE_SQUASHFS,
+		.name = "squashfs",
+		.null_dev_desc_ok = false,
+		.probe = sqfs_probe,
+		.close = sqfs_close,
+		.ls = fs_ls_generic,
+		.exists = sqfs_exists,
+		.size = sqfs_size,
+		.read = sqfs_read,
+		.write = fs_write_unsupported,
+		.uuid = fs_uuid_unsupported,
+		.opendir = sqfs_opendir,
+		.readdir = sqfs_readdir,
+		.closedir = sqfs_closedir,
+		.file_open = fs_file_open_generic,
+		.file_read = fs_file_read_generic,
+		.file_close = fs_file_close_generic,
 	},
 #endif
 	{
@@ -232,6 +349,9 @@ static struct fstype_info fstypes[] = {
 		.write = fs_write_unsupported,
 		.uuid = fs_uuid_unsupported,
 		.opendir = fs_opendir_unsupported,
+		.file_open = fs_file_open_unsupported,
+		.file_read = fs_file_read_unsupported,
+		.file_close = fs_file_close_unsupported,
 	},
 };
 
@@ -299,15 +419,21 @@ int fs_set_blk_dev_with_part(struct blk_desc *desc, int part)
 	struct fstype_info *info;
 	int ret, i;
 
-	if (part >= 1)
+	/* A NULL descriptor is the host filesystem, which has no partitions */
+	if (!desc)
+		ret = 0;
+	else if (part >= 1)
 		ret = part_get_info(desc, part, &fs_partition);
 	else
 		ret = part_get_info_whole_disk(desc, &fs_partition);
 	if (ret)
 		return ret;
 	fs_dev_desc = desc;
+	fs_dev_part = part;
 
 	for (i = 0, info = fstypes; i < ARRAY_SIZE(fstypes); i++, info++) {
+		if (!desc && !info->null_dev_desc_ok)
+			continue;
 		if (!info->probe(fs_dev_desc, &fs_partition)) {
 			fs_type = info->fstype;
 			return 0;
@@ -373,6 +499,34 @@ int fs_size(const char *filename, loff_t *size)
 	return ret;
 }
 
+#ifdef CONFIG_FS_CACHE
+/*
+ * Read through the file cache. Only block-device filesystems are cached,
+ * since files of the sandbox host filesystem can change underneath us.
+ */
+static int fs_read_cached(struct fstype_info *info, const char *filename,
+			  void *buf, loff_t offset, loff_t len,
+			  loff_t *actread)
+{
+	loff_t size;
+	int ret;
+
+	if (!fs_dev_desc || info->size(filename, &size))
+		return info->read(filename, buf, offset, len, actread);
+
+	if (!fs_cache_read(fs_dev_desc, fs_dev_part, fs_type, filename, size,
+			   buf, offset, len, actread))
+		return 0;
+
+	ret = info->read(filename, buf, offset, len, actread);
+	if (!ret && !offset && *actread == size)
+		fs_cache_store(fs_dev_desc, fs_dev_part, fs_type, filename, buf,
+			       size);
+
+	return ret;
+}
+#endif
+
 int fs_read(const char *filename, ulong addr, loff_t offset, loff_t len,
 	    loff_t *actread)
 {
@@ -385,7 +539,11 @@ int fs_read(const char *filename, ulong addr, loff_t offset, loff_t len,
 	 * means read the whole file.
 	 */
 	buf = map_sysmem(addr, len);
+#ifdef CONFIG_FS_CACHE
+	ret = fs_read_cached(info, filename, buf, offset, len, actread);
+#else
 	ret = info->read(filename, buf, offset, len, actread);
+#endif
 	unmap_sysmem(buf);
 
 	/* If we requested a specific number of bytes, check we got it */
@@ -403,6 +561,8 @@ int fs_write(const char *filename, ulong addr, loff_t offset, loff_t len,
 	void *buf;
 	int ret;
 
+	fs_cache_invalidate();
+
 	buf = map_sysmem(addr, len);
 	ret = info->write(filename, buf, offset, len, actwrite);
 	unmap_sysmem(buf);
@@ -468,6 +628,87 @@ void fs_closedir(struct fs_dir_stream *dirs)
 	fs_close();
 }
 
+struct fs_file *fs_file_open(const char *filename)
+{
+	struct fstype_info *info = fs_get_info(fs_type);
+	struct fs_file *file = NULL;
+	int ret;
+
+	ret = info->file_open(filename, &file);
+	fs_close();
+	if (ret) {
+		errno = -ret;
+		return NULL;
+	}
+
+	file->desc = fs_dev_desc;
+	file->part = fs_dev_part;
+	file->fstype = info->fstype;
+	file->pos = 0;
+
+	return file;
+}
+
+int fs_file_read(struct fs_file *file, void *buf, loff_t len,
+		 loff_t *actread)
+{
+	struct fstype_info *info;
+	int ret;
+
+	*actread = 0;
+	if (file->pos >= file->size || len <= 0)
+		return 0;
+	if (len > file->size - file->pos)
+		len = file->size - file->pos;
+
+	if (fs_set_blk_dev_with_part(file->desc, file->part))
+		return -ENODEV;
+	if (fs_type != file->fstype) {
+		/* The device now holds something else */
+		fs_close();
+		return -ENODEV;
+	}
+	info = fs_get_info(fs_type);
+
+	ret = info->file_read(file, buf, len, actread);
+	fs_close();
+	if (ret)
+		return ret;
+
+	file->pos += *actread;
+
+	return 0;
+}
+
+int fs_file_seek(struct fs_file *file, loff_t offset)
+{
+	if (offset < 0 || offset > file->size)
+		return -EINVAL;
+
+	file->pos = offset;
+
+	return 0;
+}
+
+void fs_file_close(struct fs_file *file)
+{
+	struct fstype_info *info;
+	int ret;
+
+	if (!file)
+		return;
+
+	/*
+	 * Freeing the handle does not need the device, so do it with the
+	 * driver which opened the file even if the device has gone away
+	 */
+	info = fs_get_info(file->fstype);
+	ret = fs_set_blk_dev_with_part(file->desc, file->part);
+	info->file_close(file);
+	if (!ret)
+		fs_close();
+}
+
 
 int do_size(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[],
 		int fstype)
@@ -575,6 +816,59 @@ int do_ls(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[],
 	return 0;
 }
 
+#define CAT_CHUNK_SIZE	512
+
+int do_cat(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[],
+	   int fstype)
+{
+	struct fs_file *file;
+	char buf[CAT_CHUNK_SIZE];
+	loff_t bytes, pos, actread;
+	int ret = 0;
+	int i;
+
+	if (argc < 4 || argc > 6)
+		return CMD_RET_USAGE;
+
+	bytes = argc >= 5 ? simple_strtoull(argv[4], NULL, 16) : 0;
+	pos = argc >= 6 ? simple_strtoull(argv[5], NULL, 16) : 0;
+
+	if (fs_set_blk_dev(argv[1], argv[2], fstype))
+		return 1;
+
+	file = fs_file_open(argv[3]);
+	if (!file) {
+		printf("** Unable to open file %s: %d **\n", argv[3], -errno);
+		return 1;
+	}
+
+	if (fs_file_seek(file, pos)) {
+		printf("** Position %llx is beyond the end of the file **\n",
+		       pos);
+		fs_file_close(file);
+		return 1;
+	}
+	if (!bytes)
+		bytes = file->size - pos;
+
+	while (bytes > 0 && !ctrlc()) {
+		ret = fs_file_read(file, buf, min_t(loff_t, bytes, sizeof(buf)),
+				   &actread);
+		if (ret || !actread)
+			break;
+		for (i = 0; i < actread; i++)
+			putc(buf[i]);
+		bytes -= actread;
+	}
+	fs_file_close(file);
+	if (ret) {
+		printf("** Error reading file %s: %d **\n", argv[3], ret);
+		return 1;
+	}
+
+	return 0;
+}
+
 int file_exists(const char *dev_type, const char *dev_part, const char *file,
 		int fstype)
 {
@@ -0,0 +1,183 @@
+/*
+ * Cache of whole files read through the fs layer
+ *
+ * Boot scripts often load the same file more than once (test -e followed
+ * by load, a DT loaded again for overlays, fallback loops). Files read in
+ * full are kept in a region allocated on first use so that later reads can
+ * be served with a memcpy() instead of going back to the device.
+ *
+ * Entries are keyed by block device, partition, filesystem type, path and
+ * size. The size is looked up from the filesystem metadata on each read,
+ * so a file rewritten with a different size is never served stale. Any
+ * write through fs_write() or blk_dwrite(), and any partition rescan, drops
+ * the whole cache.
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <errno.h>
+#include <fs.h>
+#include <malloc.h>
+#include <memalign.h>
+
+#define FS_CACHE_ENTRIES	16
+
+struct fs_cache_entry {
+	struct blk_desc *desc;
+	int part;
+	int fstype;
+	char *name;		/* NULL if the entry is unused */
+	loff_t size;
+	ulong offset;		/* of the contents within the cache region */
+	ulong stamp;		/* last use */
+};
+
+static struct fs_cache_entry fs_cache[FS_CACHE_ENTRIES];
+static char *fs_cache_region;
+static ulong fs_cache_stamp;
+static bool fs_cache_failed;
+
+static struct fs_cache_entry *fs_cache_find(struct blk_desc *desc, int part,
+					    int fstype, const char *filename)
+{
+	struct fs_cache_entry *entry;
+	int i;
+
+	for (i = 0, entry = fs_cache; i < FS_CACHE_ENTRIES; i++, entry++) {
+		if (entry->name && entry->desc == desc && entry->part == part &&
+		    entry->fstype == fstype && !strcmp(entry->name, filename))
+			return entry;
+	}
+
+	return NULL;
+}
+
+static void fs_cache_drop(struct fs_cache_entry *entry)
+{
+	free(entry->name);
+	entry->name = NULL;
+}
+
+/* Find a free range of @size bytes in the region, or return -ENOSPC */
+static long fs_cache_find_space(ulong size)
+{
+	struct fs_cache_entry *entry;
+	ulong start;
+	int i, j;
+
+	for (i = -1; i < FS_CACHE_ENTRIES; i++) {
+		if (i < 0) {
+			start = 0;
+		} else {
+			entry = &fs_cache[i];
+			if (!entry->name)
+				continue;
+			start = ALIGN(entry->offset + entry->size,
+				      ARCH_DMA_MINALIGN);
+		}
+		if (start + size > CONFIG_FS_CACHE_SIZE)
+			continue;
+
+		for (j = 0, entry = fs_cache; j < FS_CACHE_ENTRIES;
+		     j++, entry++) {
+			if (entry->name && start < entry->offset + entry->size &&
+			    entry->offset < start + size)
+				break;
+		}
+		if (j == FS_CACHE_ENTRIES)
+			return start;
+	}
+
+	return -ENOSPC;
+}
+
+int fs_cache_read(struct blk_desc *desc, int part, int fstype,
+		  const char *filename, loff_t size, void *buf, loff_t offset,
+		  loff_t len, loff_t *actread)
+{
+	struct fs_cache_entry *entry;
+
+	entry = fs_cache_find(desc, part, fstype, filename);
+	if (!entry)
+		return -ENOENT;
+	if (entry->size != size) {
+		fs_cache_drop(entry);
+		return -ENOENT;
+	}
+	if (offset > size)
+		return -EINVAL;
+
+	if (!len || len > size - offset)
+		len = size - offset;
+	memcpy(buf, fs_cache_region + entry->offset + offset, len);
+	entry->stamp = ++fs_cache_stamp;
+	*actread = len;
+	debug("fs_cache: %s served from cache\n", filename);
+
+	return 0;
+}
+
+void fs_cache_store(struct blk_desc *desc, int part, int fstype,
+		    const char *filename, const void *buf, loff_t size)
+{
+	struct fs_cache_entry *entry, *victim;
+	long start;
+	int i;
+
+	if (!size || size > CONFIG_FS_CACHE_SIZE || fs_cache_failed)
+		return;
+
+	if (!fs_cache_region) {
+		fs_cache_region = malloc_cache_aligned(CONFIG_FS_CACHE_SIZE);
+		if (!fs_cache_region) {
+			printf("fs_cache: cannot allocate %#x bytes, disabled\n",
+			       CONFIG_FS_CACHE_SIZE);
+			fs_cache_failed = true;
+			return;
+		}
+	}
+
+	entry = fs_cache_find(desc, part, fstype, filename);
+	if (entry)
+		fs_cache_drop(entry);
+
+	/* evict least recently used entries until both a slot and space */
+	while (1) {
+		victim = NULL;
+		entry = NULL;
+		for (i = 0; i < FS_CACHE_ENTRIES; i++) {
+			if (!fs_cache[i].name)
+				entry = &fs_cache[i];
+			else if (!victim || fs_cache[i].stamp < victim->stamp)
+				victim = &fs_cache[i];
+		}
+		start = fs_cache_find_space(size);
+		if (entry && start >= 0)
+			break;
+		if (!victim)
+			return;
+		fs_cache_drop(victim);
+	}
+
+	entry->name = strdup(filename);
+	if (!entry->name)
+		return;
+	entry->desc = desc;
+	entry->part = part;
+	entry->fstype = fstype;
+	entry->size = size;
+	entry->offset = start;
+	entry->stamp = ++fs_cache_stamp;
+	memcpy(fs_cache_region + start, buf, size);
+}
+
+void fs_cache_invalidate(void)
+{
+	int i;
+
+	for (i = 0; i < FS_CACHE_ENTRIES; i++) {
+		if (fs_cache[i].name)
+			fs_cache_drop(&fs_cache[i]);
+	}
+}
@@ -0,0 +1,891 @@
+/*
+ * Read-only SquashFS support
+ *
+ * Metadata and fragment blocks are decompressed into small LRU caches so
+ * that walking a directory or reading several files that share a fragment
+ * does not decompress the same block over and over. Full data blocks are
+ * decompressed straight into the caller's buffer.
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <blk.h>
+#include <div64.h>
+#include <errno.h>
+#include <fs.h>
+#include <malloc.h>
+#include <memalign.h>
+#include <part.h>
+#include <squashfs.h>
+#include <asm/unaligned.h>
+#include <linux/err.h>
+#include "sqfs_decompressor.h"
+#include "sqfs_filesystem.h"
+
+/* Number of decompressed blocks kept in each cache */
+#define SQFS_META_CACHE_ENTRIES		8
+#define SQFS_FRAG_CACHE_ENTRIES		3
+
+/* Maximum number of symbolic links followed while resolving a path */
+#define SQFS_MAX_SYMLINKS		8
+
+struct sqfs_cache_entry {
+	u64 start;		/* disk offset of the block */
+	u64 next;		/* disk offset of the block following it */
+	u32 len;		/* decompressed length */
+	ulong stamp;		/* last use, 0 if the entry is empty */
+	void *data;
+};
+
+struct sqfs_cache {
+	struct sqfs_cache_entry *entries;
+	int count;
+	ulong stamp;
+};
+
+/* The parts of an inode that this driver needs, for all inode flavours */
+struct sqfs_inode {
+	int type;		/* basic type, SQFS_..._TYPE */
+	u64 size;
+	/* regular files */
+	u64 start_block;
+	u32 fragment;
+	u32 frag_offset;
+	u64 blist_block;	/* position of the block size list */
+	u32 blist_offset;
+	/* directories */
+	u32 dir_block;
+	u32 dir_offset;
+	/* symbolic links */
+	u64 link_block;
+	u32 link_offset;
+};
+
+struct sqfs_dir_stream {
+	struct fs_dir_stream fs_dirs;
+	struct fs_dirent dirent;
+	u64 block;		/* current position in the directory table */
+	u32 offset;
+	u32 size;		/* directory bytes not yet read */
+	u32 entries;		/* entries left under the current header */
+	u32 inode_block;	/* inode metadata block of the current header */
+};
+
+struct sqfs_ctxt {
+	struct blk_desc *dev;
+	disk_partition_t part;
+	struct squashfs_super_block sblk;
+	int comp;
+	u32 block_size;
+	u32 block_log;
+	char *io_buf;
+	u32 io_buf_size;
+	char *data_buf;		/* one decompressed data block */
+	struct sqfs_cache meta;
+	struct sqfs_cache frag;
+};
+
+static struct sqfs_ctxt *ctxt;
+
+/*
+ * Read @len bytes at byte offset @offset of the partition and return a
+ * pointer to them. The data stays valid until the next call.
+ */
+static void *sqfs_disk_read(u64 offset, u32 len)
+{
+	u32 blksz = ctxt->dev->blksz;
+	u32 skip = do_div(offset, blksz);
+	lbaint_t count = DIV_ROUND_UP(skip + len, blksz);
+
+	if (count * blksz > ctxt->io_buf_size)
+		return ERR_PTR(-EFBIG);
+	if (offset + count > ctxt->part.size)
+		return ERR_PTR(-EINVAL);
+	if (blk_dread(ctxt->dev, ctxt->part.start + offset, count,
+		      ctxt->io_buf) != count)
+		return ERR_PTR(-EIO);
+
+	return ctxt->io_buf + skip;
+}
+
+static int sqfs_cache_init(struct sqfs_cache *cache, int count, u32 size)
+{
+	int i;
+
+	cache->entries = calloc(count, sizeof(*cache->entries));
+	if (!cache->entries)
+		return -ENOMEM;
+	cache->count = count;
+	cache->stamp = 0;
+
+	for (i = 0; i < count; i++) {
+		cache->entries[i].data = malloc(size);
+		if (!cache->entries[i].data)
+			return -ENOMEM;
+	}
+
+	return 0;
+}
+
+static void sqfs_cache_free(struct sqfs_cache *cache)
+{
+	int i;
+
+	if (!cache->entries)
+		return;
+	for (i = 0; i < cache->count; i++)
+		free(cache->entries[i].data);
+	free(cache->entries);
+	cache->entries = NULL;
+}
+
+/*
+ * Return the decompressed block at disk offset @start, reading it into
+ * @cache if it is not there yet. @size is the on-disk size word of a data
+ * or fragment block, or 0 for a metadata block, whose size is taken from
+ * its header.
+ */
+static struct sqfs_cache_entry *sqfs_cache_get(struct sqfs_cache *cache,
+					       u64 start, u32 size)
+{
+	struct sqfs_cache_entry *e, *victim = &cache->entries[0];
+	unsigned long len;
+	bool compressed;
+	u64 data_start;
+	u32 csize;
+	void *src;
+	int i, ret;
+
+	for (i = 0; i < cache->count; i++) {
+		e = &cache->entries[i];
+		if (e->stamp && e->start == start) {
+			e->stamp = ++cache->stamp;
+			return e;
+		}
+		if (e->stamp < victim->stamp)
+			victim = e;
+	}
+
+	if (size) {
+		csize = SQFS_BLOCK_SIZE(size);
+		compressed = !(size & SQFS_BLOCK_UNCOMPRESSED);
+		len = ctxt->block_size;
+		data_start = start;
+		src = sqfs_disk_read(data_start, csize);
+	} else {
+		u64 avail = (u64)ctxt->part.size * ctxt->dev->blksz;
+		u32 rlen = SQFS_METADATA_HEADER_SIZE + SQFS_METADATA_BLOCK_SIZE;
+		u16 hdr;
+
+		if (start >= avail)
+			return ERR_PTR(-EINVAL);
+		if (avail - start < rlen)
+			rlen = avail - start;
+
+		src = sqfs_disk_read(start, rlen);
+		if (IS_ERR(src))
+			return src;
+		hdr = get_unaligned_le16(src);
+		csize = SQFS_METADATA_SIZE(hdr);
+		compressed = !(hdr & SQFS_METADATA_UNCOMPRESSED);
+		len = SQFS_METADATA_BLOCK_SIZE;
+		data_start = start + SQFS_METADATA_HEADER_SIZE;
+		if (csize > rlen - SQFS_METADATA_HEADER_SIZE)
+			return ERR_PTR(-EINVAL);
+		src += SQFS_METADATA_HEADER_SIZE;
+	}
+	if (IS_ERR(src))
+		return src;
+
+	victim->stamp = 0;
+	if (compressed) {
+		ret = sqfs_decompress(ctxt->comp, victim->data, &len, src,
+				      csize);
+		if (ret)
+			return ERR_PTR(ret);
+	} else {
+		if (csize > len)
+			return ERR_PTR(-EINVAL);
+		memcpy(victim->data, src, csize);
+		len = csize;
+	}
+
+	victim->start = start;
+	victim->next = data_start + csize;
+	victim->len = len;
+	victim->stamp = ++cache->stamp;
+
+	return victim;
+}
+
+/*
+ * Copy @len bytes of metadata starting at @offset within the metadata
+ * block at disk offset @block, crossing into following blocks as needed.
+ * @block and @offset are advanced past the data read.
+ */
+static int sqfs_read_metadata(u64 *block, u32 *offset, void *buf, u32 len)
+{
+	struct sqfs_cache_entry *e;
+	u32 n;
+
+	while (len) {
+		e = sqfs_cache_get(&ctxt->meta, *block, 0);
+		if (IS_ERR(e))
+			return PTR_ERR(e);
+		if (*offset >= e->len) {
+			if (*offset > e->len)
+				return -EINVAL;
+			*block = e->next;
+			*offset = 0;
+			continue;
+		}
+
+		n = min(len, e->len - *offset);
+		if (buf) {
+			memcpy(buf, e->data + *offset, n);
+			buf += n;
+		}
+		*offset += n;
+		len -= n;
+	}
+
+	return 0;
+}
+
+static int sqfs_read_inode(u64 ref, struct sqfs_inode *inode)
+{
+	u64 block = le64_to_cpu(ctxt->sblk.inode_table_start) +
+		    SQFS_INODE_BLK(ref);
+	u32 offset = SQFS_INODE_OFFSET(ref);
+	struct squashfs_base_inode base;
+	union {
+		struct squashfs_reg_inode reg;
+		struct squashfs_lreg_inode lreg;
+		struct squashfs_dir_inode dir;
+		struct squashfs_ldir_inode ldir;
+		struct squashfs_symlink_inode symlink;
+	} u;
+	int type, ret;
+
+	ret = sqfs_read_metadata(&block, &offset, &base, sizeof(base));
+	if (ret)
+		return ret;
+
+	memset(inode, '\0', sizeof(*inode));
+	type = le16_to_cpu(base.inode_type);
+	switch (type) {
+	case SQFS_REG_TYPE:
+		ret = sqfs_read_metadata(&block, &offset, &u.reg,
+					 sizeof(u.reg));
+		inode->type = SQFS_REG_TYPE;
+		inode->start_block = le32_to_cpu(u.reg.start_block);
+		inode->fragment = le32_to_cpu(u.reg.fragment);
+		inode->frag_offset = le32_to_cpu(u.reg.offset);
+		inode->size = le32_to_cpu(u.reg.file_size);
+		break;
+	case SQFS_LREG_TYPE:
+		ret = sqfs_read_metadata(&block, &offset, &u.lreg,
+					 sizeof(u.lreg));
+		inode->type = SQFS_REG_TYPE;
+		inode->start_block = le64_to_cpu(u.lreg.start_block);
+		inode->fragment = le32_to_cpu(u.lreg.fragment);
+		inode->frag_offset = le32_to_cpu(u.lreg.offset);
+		inode->size = le64_to_cpu(u.lreg.file_size);
+		break;
+	case SQFS_DIR_TYPE:
+		ret = sqfs_read_metadata(&block, &offset, &u.dir,
+					 sizeof(u.dir));
+		inode->type = SQFS_DIR_TYPE;
+		inode->dir_block = le32_to_cpu(u.dir.start_block);
+		inode->dir_offset = le16_to_cpu(u.dir.offset);
+		inode->size = le16_to_cpu(u.dir.file_size);
+		break;
+	case SQFS_LDIR_TYPE:
+		ret = sqfs_read_metadata(&block, &offset, &u.ldir,
+					 sizeof(u.ldir));
+		inode->type = SQFS_DIR_TYPE;
+		inode->dir_block = le32_to_cpu(u.ldir.start_block);
+		inode->dir_offset = le16_to_cpu(u.ldir.offset);
+		inode->size = le32_to_cpu(u.ldir.file_size);
+		break;
+	case SQFS_SYMLINK_TYPE:
+	case SQFS_LSYMLINK_TYPE:
+		ret = sqfs_read_metadata(&block, &offset, &u.symlink,
+					 sizeof(u.symlink));
+		inode->type = SQFS_SYMLINK_TYPE;
+		inode->size = le32_to_cpu(u.symlink.symlink_size);
+		break;
+	default:
+		/* device nodes, fifos and sockets have no contents */
+		inode->type = type > SQFS_SOCKET_TYPE ?
+			      type - SQFS_SOCKET_TYPE : type;
+		break;
+	}
+
+	/* the block list or link target follows the inode */
+	inode->blist_block = block;
+	inode->blist_offset = offset;
+	inode->link_block = block;
+	inode->link_offset = offset;
+
+	return ret;
+}
+
+static int sqfs_dir_open(struct sqfs_inode *dir, struct sqfs_dir_stream *dirs)
+{
+	if (dir->type != SQFS_DIR_TYPE)
+		return -ENOTDIR;
+
+	dirs->block = le64_to_cpu(ctxt->sblk.directory_table_start) +
+		      dir->dir_block;
+	dirs->offset = dir->dir_offset;
+	dirs->size = dir->size > SQFS_DIR_SIZE_OFFSET ?
+		     dir->size - SQFS_DIR_SIZE_OFFSET : 0;
+	dirs->entries = 0;
+
+	return 0;
+}
+
+/*
+ * Read the next directory entry into @name (at least 256 bytes) and
+ * return the reference of its inode. Returns -ENOENT at the end.
+ */
+static int sqfs_dir_next(struct sqfs_dir_stream *dirs, char *name, u64 *ref,
+			 int *type)
+{
+	struct squashfs_dir_header hdr;
+	struct squashfs_dir_entry ent;
+	u32 len;
+	int ret;
+
+	if (!dirs->entries) {
+		if (dirs->size < sizeof(hdr))
+			return -ENOENT;
+		ret = sqfs_read_metadata(&dirs->block, &dirs->offset, &hdr,
+					 sizeof(hdr));
+		if (ret)
+			return ret;
+		dirs->size -= sizeof(hdr);
+		dirs->entries = le32_to_cpu(hdr.count) + 1;
+		dirs->inode_block = le32_to_cpu(hdr.start_block);
+		if (dirs->entries > 256)
+			return -EINVAL;
+	}
+
+	if (dirs->size < sizeof(ent))
+		return -ENOENT;
+	ret = sqfs_read_metadata(&dirs->block, &dirs->offset, &ent,
+				 sizeof(ent));
+	if (ret)
+		return ret;
+
+	len = le16_to_cpu(ent.size) + 1;
+	if (len > 255 || dirs->size < sizeof(ent) + len)
+		return -EINVAL;
+	ret = sqfs_read_metadata(&dirs->block, &dirs->offset, name, len);
+	if (ret)
+		return ret;
+	name[len] = '\0';
+
+	dirs->size -= sizeof(ent) + len;
+	dirs->entries--;
+	*ref = ((u64)dirs->inode_block << 16) | le16_to_cpu(ent.offset);
+	*type = le16_to_cpu(ent.type);
+
+	return 0;
+}
+
+/* Look up the first @len characters of @name in directory @dir */
+static int sqfs_dir_lookup(struct sqfs_inode *dir, const char *name, int len,
+			   struct sqfs_inode *inode)
+{
+	struct sqfs_dir_stream dirs;
+	char ent_name[256];
+	int type, cmp, ret;
+	u64 ref;
+
+	ret = sqfs_dir_open(dir, &dirs);
+	if (ret)
+		return ret;
+
+	while (!(ret = sqfs_dir_next(&dirs, ent_name, &ref, &type))) {
+		cmp = strncmp(ent_name, name, len);
+		if (!cmp && ent_name[len])
+			cmp = 1;
+		if (!cmp)
+			return sqfs_read_inode(ref, inode);
+		/* mksquashfs stores the entries sorted by name */
+		if (cmp > 0)
+			return -ENOENT;
+	}
+
+	return ret;
+}
+
+static char *sqfs_read_link(struct sqfs_inode *inode)
+{
+	u64 block = inode->link_block;
+	u32 offset = inode->link_offset;
+	char *target;
+	int ret;
+
+	if (inode->size >= 4096)
+		return ERR_PTR(-ENAMETOOLONG);
+	target = malloc(inode->size + 1);
+	if (!target)
+		return ERR_PTR(-ENOMEM);
+
+	ret = sqfs_read_metadata(&block, &offset, target, inode->size);
+	if (ret) {
+		free(target);
+		return ERR_PTR(ret);
+	}
+	target[inode->size] = '\0';
+
+	return target;
+}
+
+/*
+ * Resolve @path to an inode, following symbolic links. "." and ".." are
+ * handled on the path itself since SquashFS directories do not store them.
+ */
+static int sqfs_lookup(const char *path, struct sqfs_inode *inode, int nest)
+{
+	const char *p = path, *end;
+	struct sqfs_inode child;
+	char *resolved, *target, *newpath;
+	int len, ret;
+
+	resolved = malloc(strlen(path) + 2);
+	if (!resolved)
+		return -ENOMEM;
+	resolved[0] = '\0';
+
+	ret = sqfs_read_inode(le64_to_cpu(ctxt->sblk.root_inode), inode);
+	while (!ret) {
+		while (*p == '/')
+			p++;
+		if (!*p)
+			break;
+		end = strchrnul(p, '/');
+		len = end - p;
+
+		if (len == 1 && *p == '.') {
+			p = end;
+			continue;
+		}
+		if (len == 2 && !strncmp(p, "..", 2)) {
+			char *slash = strrchr(resolved, '/');
+
+			if (slash)
+				*slash = '\0';
+			ret = sqfs_lookup(resolved, inode, nest);
+			p = end;
+			continue;
+		}
+
+		ret = sqfs_dir_lookup(inode, p, len, &child);
+		if (ret)
+			break;
+
+		if (child.type == SQFS_SYMLINK_TYPE) {
+			if (nest >= SQFS_MAX_SYMLINKS) {
+				ret = -ELOOP;
+				break;
+			}
+			target = sqfs_read_link(&child);
+			if (IS_ERR(target)) {
+				ret = PTR_ERR(target);
+				break;
+			}
+			newpath = malloc(strlen(resolved) + strlen(target) +
+					 strlen(end) + 2);
+			if (!newpath) {
+				free(target);
+				ret = -ENOMEM;
+				break;
+			}
+			sprintf(newpath, "%s/%s%s",
+				target[0] == '/' ? "" : resolved, target, end);
+			free(target);
+			ret = sqfs_lookup(newpath, inode, nest + 1);
+			free(newpath);
+			break;
+		}
+
+		*inode = child;
+		strcat(resolved, "/");
+		strncat(resolved, p, len);
+		p = end;
+	}
+
+	free(resolved);
+	return ret;
+}
+
+static struct sqfs_cache_entry *sqfs_get_fragment(u32 index)
+{
+	struct squashfs_fragment_entry frag;
+	u64 block;
+	u32 offset;
+	void *ptr;
+	int ret;
+
+	if (index >= le32_to_cpu(ctxt->sblk.fragments))
+		return ERR_PTR(-EINVAL);
+
+	ptr = sqfs_disk_read(le64_to_cpu(ctxt->sblk.fragment_table_start) +
+			     (index / SQFS_FRAGMENTS_PER_BLOCK) * sizeof(u64),
+			     sizeof(u64));
+	if (IS_ERR(ptr))
+		return ptr;
+	block = get_unaligned_le64(ptr);
+	offset = (index % SQFS_FRAGMENTS_PER_BLOCK) * sizeof(frag);
+
+	ret = sqfs_read_metadata(&block, &offset, &frag, sizeof(frag));
+	if (ret)
+		return ERR_PTR(ret);
+
+	return sqfs_cache_get(&ctxt->frag, le64_to_cpu(frag.start_block),
+			      le32_to_cpu(frag.size));
+}
+
+/*
+ * Copy bytes [@skip, @skip + @len) of the data block at @pos, which holds
+ * @blk_len bytes of the file, to @dst. A block that is wanted in full is
+ * decompressed directly into @dst.
+ */
+static int sqfs_read_data_block(u64 pos, u32 size, u32 blk_len, u32 skip,
+				u32 len, void *dst)
+{
+	u32 csize = SQFS_BLOCK_SIZE(size);
+	unsigned long out_len;
+	void *src;
+	int ret;
+
+	/* sparse block */
+	if (!csize) {
+		memset(dst, '\0', len);
+		return 0;
+	}
+
+	src = sqfs_disk_read(pos, csize);
+	if (IS_ERR(src))
+		return PTR_ERR(src);
+
+	if (size & SQFS_BLOCK_UNCOMPRESSED) {
+		if (skip + len > csize)
+			return -EINVAL;
+		memcpy(dst, src + skip, len);
+		return 0;
+	}
+
+	if (!skip && len == blk_len) {
+		out_len = len;
+		ret = sqfs_decompress(ctxt->comp, dst, &out_len, src, csize);
+		if (ret)
+			return ret;
+		return out_len == len ? 0 : -EINVAL;
+	}
+
+	out_len = ctxt->block_size;
+	ret = sqfs_decompress(ctxt->comp, ctxt->data_buf, &out_len, src, csize);
+	if (ret)
+		return ret;
+	if (skip + len > out_len)
+		return -EINVAL;
+	memcpy(dst, ctxt->data_buf + skip, len);
+
+	return 0;
+}
+
+static int sqfs_read_inode_data(struct sqfs_inode *inode, void *buf,
+				u64 offset, u64 len)
+{
+	u32 bs = ctxt->block_size;
+	u64 end = offset + len;
+	u64 pos = inode->start_block;
+	u64 blk_start, nblocks;
+	u32 blk_len, skip, n;
+	__le32 *blist;
+	u32 size;
+	u64 i;
+	int ret;
+
+	if (inode->fragment == SQFS_FRAGMENT_NONE)
+		nblocks = (inode->size + bs - 1) >> ctxt->block_log;
+	else
+		nblocks = inode->size >> ctxt->block_log;
+
+	/* only the block sizes up to the end of the range are needed */
+	i = min(nblocks, (end + bs - 1) >> ctxt->block_log);
+	blist = malloc(i * sizeof(*blist) + 1);
+	if (!blist)
+		return -ENOMEM;
+	ret = sqfs_read_metadata(&inode->blist_block, &inode->blist_offset,
+				 blist, i * sizeof(*blist));
+	if (ret)
+		goto out;
+
+	for (i = 0; i < nblocks; i++) {
+		blk_start = i << ctxt->block_log;
+		if (blk_start >= end)
+			break;
+		size = le32_to_cpu(blist[i]);
+		blk_len = min_t(u64, bs, inode->size - blk_start);
+		if (blk_start + blk_len <= offset) {
+			pos += SQFS_BLOCK_SIZE(size);
+			continue;
+		}
+
+		skip = offset > blk_start ? offset - blk_start : 0;
+		n = min_t(u64, blk_len - skip, end - blk_start - skip);
+		ret = sqfs_read_data_block(pos, size, blk_len, skip, n,
+					   buf + (blk_start + skip - offset));
+		if (ret)
+			goto out;
+		pos += SQFS_BLOCK_SIZE(size);
+	}
+
+	blk_start = nblocks << ctxt->block_log;
+	if (inode->fragment != SQFS_FRAGMENT_NONE && end > blk_start) {
+		struct sqfs_cache_entry *e;
+
+		e = sqfs_get_fragment(inode->fragment);
+		if (IS_ERR(e)) {
+			ret = PTR_ERR(e);
+			goto out;
+		}
+
+		skip = offset > blk_start ? offset - blk_start : 0;
+		n = end - blk_start - skip;
+		if (inode->frag_offset + skip + n > e->len) {
+			ret = -EINVAL;
+			goto out;
+		}
+		memcpy(buf + (blk_start + skip - offset),
+		       e->data + inode->frag_offset + skip, n);
+	}
+
+out:
+	free(blist);
+	return ret;
+}
+
+int sqfs_probe(struct blk_desc *fs_dev_desc, disk_partition_t *fs_partition)
+{
+	ALLOC_CACHE_ALIGN_BUFFER(char, buf, fs_dev_desc->blksz);
+	struct squashfs_super_block *sblk = (void *)buf;
+	u32 block_size, block_log;
+	int comp, ret;
+
+	sqfs_close();
+
+	if (fs_partition->size < 1 ||
+	    blk_dread(fs_dev_desc, fs_partition->start, 1, buf) != 1)
+		return -EIO;
+
+	if (le32_to_cpu(sblk->s_magic) != SQFS_MAGIC)
+		return -EINVAL;
+
+	if (le16_to_cpu(sblk->s_major) != SQFS_MAJOR) {
+		printf("SquashFS: unsupported version %d.%d\n",
+		       le16_to_cpu(sblk->s_major), le16_to_cpu(sblk->s_minor));
+		return -EINVAL;
+	}
+
+	block_size = le32_to_cpu(sblk->block_size);
+	block_log = le16_to_cpu(sblk->block_log);
+	if (block_log < 12 || block_log > 20 || block_size != 1 << block_log) {
+		printf("SquashFS: invalid block size %u\n", block_size);
+		return -EINVAL;
+	}
+
+	comp = le16_to_cpu(sblk->compression);
+	if (!sqfs_decompressor_supported(comp)) {
+		printf("SquashFS: unsupported compression type %d\n", comp);
+		return -EINVAL;
+	}
+
+	ctxt = calloc(1, sizeof(*ctxt));
+	if (!ctxt)
+		return -ENOMEM;
+
+	ctxt->dev = fs_dev_desc;
+	ctxt->part = *fs_partition;
+	memcpy(&ctxt->sblk, sblk, sizeof(ctxt->sblk));
+	ctxt->comp = comp;
+	ctxt->block_size = block_size;
+	ctxt->block_log = block_log;
+
+	ctxt->io_buf_size = max_t(u32, block_size, SQFS_METADATA_HEADER_SIZE +
+				  SQFS_METADATA_BLOCK_SIZE) +
+			    2 * fs_dev_desc->blksz;
+	ctxt->io_buf = malloc_cache_aligned(ctxt->io_buf_size);
+	ctxt->data_buf = malloc(block_size);
+	if (!ctxt->io_buf || !ctxt->data_buf) {
+		ret = -ENOMEM;
+		goto err;
+	}
+
+	ret = sqfs_cache_init(&ctxt->meta, SQFS_META_CACHE_ENTRIES,
+			      SQFS_METADATA_BLOCK_SIZE);
+	if (!ret)
+		ret = sqfs_cache_init(&ctxt->frag, SQFS_FRAG_CACHE_ENTRIES,
+				      block_size);
+	if (ret)
+		goto err;
+
+	return 0;
+
+err:
+	sqfs_close();
+	return ret;
+}
+
+int sqfs_opendir(const char *filename, struct fs_dir_stream **dirsp)
+{
+	struct sqfs_dir_stream *dirs;
+	struct sqfs_inode inode;
+	int ret;
+
+	ret = sqfs_lookup(filename, &inode, 0);
+	if (ret)
+		return ret;
+
+	dirs = calloc(1, sizeof(*dirs));
+	if (!dirs)
+		return -ENOMEM;
+
+	ret = sqfs_dir_open(&inode, dirs);
+	if (ret) {
+		free(dirs);
+		return ret;
+	}
+
+	*dirsp = (struct fs_dir_stream *)dirs;
+
+	return 0;
+}
+
+int sqfs_readdir(struct fs_dir_stream *fs_dirs, struct fs_dirent **dentp)
+{
+	struct sqfs_dir_stream *dirs = (struct sqfs_dir_stream *)fs_dirs;
+	struct fs_dirent *dent = &dirs->dirent;
+	struct sqfs_inode inode;
+	int type, ret;
+	u64 ref;
+
+	ret = sqfs_dir_next(dirs, dent->name, &ref, &type);
+	if (ret)
+		return ret;
+
+	dent->size = 0;
+	switch (type) {
+	case SQFS_DIR_TYPE:
+	case SQFS_LDIR_TYPE:
+		dent->type = FS_DT_DIR;
+		break;
+	case SQFS_REG_TYPE:
+	case SQFS_LREG_TYPE:
+		dent->type = FS_DT_REG;
+		ret = sqfs_read_inode(ref, &inode);
+		if (ret)
+			return ret;
+		dent->size = inode.size;
+		break;
+	case SQFS_SYMLINK_TYPE:
+	case SQFS_LSYMLINK_TYPE:
+		dent->type = FS_DT_LNK;
+		break;
+	default:
+		/* no FS_DT_x for device nodes, show them as plain files */
+		dent->type = FS_DT_REG;
+		break;
+	}
+
+	*dentp = dent;
+
+	return 0;
+}
+
+void sqfs_closedir(struct fs_dir_stream *dirs)
+{
+	free(dirs);
+}
+
+int sqfs_exists(const char *filename)
+{
+	struct sqfs_inode inode;
+
+	return sqfs_lookup(filename, &inode, 0) == 0;
+}
+
+int sqfs_size(const char *filename, loff_t *size)
+{
+	struct sqfs_inode inode;
+	int ret;
+
+	ret = sqfs_lookup(filename, &inode, 0);
+	if (ret)
+		return ret;
+
+	*size = inode.size;
+
+	return 0;
+}
+
+int sqfs_read(const char *filename, void *buf, loff_t offset, loff_t len,
+	      loff_t *actread)
+{
+	struct sqfs_inode inode;
+	int ret;
+
+	*actread = 0;
+
+	ret = sqfs_lookup(filename, &inode, 0);
+	if (ret) {
+		printf("** File not found %s **\n", filename);
+		return ret;
+	}
+
+	if (inode.type != SQFS_REG_TYPE) {
+		printf("** %s is not a regular file **\n", filename);
+		return -EISDIR;
+	}
+
+	if (offset > inode.size) {
+		printf("** Invalid offset %llu for %s **\n",
+		       (unsigned long long)offset, filename);
+		return -EINVAL;
+	}
+
+	if (!len || len > inode.size - offset)
+		len = inode.size - offset;
+	if (!len)
+		return 0;
+
+	ret = sqfs_read_inode_data(&inode, buf, offset, len);
+	if (ret) {
+		printf("** Error reading %s: %d **\n", filename, ret);
+		return ret;
+	}
+
+	*actread = len;
+
+	return 0;
+}
+
+void sqfs_close(void)
+{
+	if (!ctxt)
+		return;
+
+	sqfs_cache_free(&ctxt->meta);
+	sqfs_cache_free(&ctxt->frag);
+	free(ctxt->data_buf);
+	free(ctxt->io_buf);
+	free(ctxt);
+	ctxt = NULL;
+}
@@ -0,0 +1,70 @@
+/*
+ * SquashFS block decompressors, wrapping the implementations in lib/
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <errno.h>
+#include <linux/lzo.h>
+#include "sqfs_decompressor.h"
+#include "sqfs_filesystem.h"
+
+bool sqfs_decompressor_supported(int comp)
+{
+	switch (comp) {
+	case SQFS_COMP_ZLIB:
+		return true;
+	case SQFS_COMP_LZO:
+		return IS_ENABLED(CONFIG_LZO);
+	case SQFS_COMP_LZ4:
+		return IS_ENABLED(CONFIG_LZ4);
+	case SQFS_COMP_ZSTD:
+		return IS_ENABLED(CONFIG_ZSTD);
+	default:
+		return false;
+	}
+}
+
+int sqfs_decompress(int comp, void *dst, unsigned long *dstlen,
+		    void *src, unsigned long srclen)
+{
+	__maybe_unused size_t len = *dstlen;
+	int ret;
+
+	switch (comp) {
+	case SQFS_COMP_ZLIB:
+		/* skip the two byte zlib header, the trailer is not checked */
+		ret = zunzip(dst, *dstlen, src, &srclen, 1, 2);
+		if (ret)
+			return -EIO;
+		*dstlen = srclen;
+		return 0;
+#ifdef CONFIG_LZO
+	case SQFS_COMP_LZO:
+		ret = lzo1x_decompress_safe(src, srclen, dst, &len);
+		if (ret != LZO_E_OK)
+			return -EIO;
+		*dstlen = len;
+		return 0;
+#endif
+#ifdef CONFIG_LZ4
+	case SQFS_COMP_LZ4:
+		ret = ulz4_block(src, srclen, dst, &len);
+		if (ret)
+			return ret;
+		*dstlen = len;
+		return 0;
+#endif
+#ifdef CONFIG_ZSTD
+	case SQFS_COMP_ZSTD:
+		ret = zstd_decompress(src, srclen, dst, &len);
+		if (ret)
+			return ret;
+		*dstlen = len;
+		return 0;
+#endif
+	default:
+		return -EPROTONOSUPPORT;
+	}
+}
@@ -0,0 +1,31 @@
+/*
+ * SquashFS block decompressors
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#ifndef __SQFS_DECOMPRESSOR_H
+#define __SQFS_DECOMPRESSOR_H
+
+/**
+ * sqfs_decompressor_supported() - check whether a compressor can be used
+ *
+ * @comp:	compressor id from the superblock (SQFS_COMP_...)
+ * @return true if blocks compressed with @comp can be read
+ */
+bool sqfs_decompressor_supported(int comp);
+
+/**
+ * sqfs_decompress() - decompress one metadata, data or fragment block
+ *
+ * @comp:	compressor id from the superblock (SQFS_COMP_...)
+ * @dst:	destination buffer
+ * @dstlen:	size of @dst on entry, decompressed length on exit
+ * @src:	compressed data
+ * @srclen:	length of @src
+ * @return 0 if OK, -ve on error
+ */
+int sqfs_decompress(int comp, void *dst, unsigned long *dstlen,
+		    void *src, unsigned long srclen);
+
+#endif /* __SQFS_DECOMPRESSOR_H */
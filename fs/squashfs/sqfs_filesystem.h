@@ -0,0 +1,156 @@
+/*
+ * SquashFS on-disk format, see Documentation/filesystems/squashfs.txt
+ * in the Linux kernel.
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#ifndef __SQFS_FILESYSTEM_H
+#define __SQFS_FILESYSTEM_H
+
+#include <linux/types.h>
+
+#define SQFS_MAGIC			0x73717368
+#define SQFS_MAJOR			4
+#define SQFS_SUPER_BLOCK_SIZE		96
+
+/* Metadata blocks hold up to 8 KiB and start with a 16-bit length */
+#define SQFS_METADATA_BLOCK_SIZE	8192
+#define SQFS_METADATA_HEADER_SIZE	2
+#define SQFS_METADATA_UNCOMPRESSED	0x8000
+#define SQFS_METADATA_SIZE(hdr)		((hdr) & ~SQFS_METADATA_UNCOMPRESSED)
+
+/* Data and fragment block sizes: bit 24 flags an uncompressed block */
+#define SQFS_BLOCK_UNCOMPRESSED		(1 << 24)
+#define SQFS_BLOCK_SIZE(size)		((size) & ~SQFS_BLOCK_UNCOMPRESSED)
+
+#define SQFS_FRAGMENT_NONE		0xffffffff
+#define SQFS_FRAGMENTS_PER_BLOCK	\
+	(SQFS_METADATA_BLOCK_SIZE / sizeof(struct squashfs_fragment_entry))
+
+/* Superblock flags */
+#define SQFS_COMP_OPT			0x0400
+
+/* Compressor ids */
+#define SQFS_COMP_ZLIB			1
+#define SQFS_COMP_LZMA			2
+#define SQFS_COMP_LZO			3
+#define SQFS_COMP_XZ			4
+#define SQFS_COMP_LZ4			5
+#define SQFS_COMP_ZSTD			6
+
+/* Inode types */
+#define SQFS_DIR_TYPE			1
+#define SQFS_REG_TYPE			2
+#define SQFS_SYMLINK_TYPE		3
+#define SQFS_BLKDEV_TYPE		4
+#define SQFS_CHRDEV_TYPE		5
+#define SQFS_FIFO_TYPE			6
+#define SQFS_SOCKET_TYPE		7
+#define SQFS_LDIR_TYPE			8
+#define SQFS_LREG_TYPE			9
+#define SQFS_LSYMLINK_TYPE		10
+
+/* Inode references: metadata block offset in the upper bits */
+#define SQFS_INODE_BLK(ref)		((u32)((ref) >> 16))
+#define SQFS_INODE_OFFSET(ref)		((u32)((ref) & 0xffff))
+
+/* Directory sizes include three bytes for the implicit "." and ".." */
+#define SQFS_DIR_SIZE_OFFSET		3
+
+struct squashfs_super_block {
+	__le32 s_magic;
+	__le32 inodes;
+	__le32 mkfs_time;
+	__le32 block_size;
+	__le32 fragments;
+	__le16 compression;
+	__le16 block_log;
+	__le16 flags;
+	__le16 no_ids;
+	__le16 s_major;
+	__le16 s_minor;
+	__le64 root_inode;
+	__le64 bytes_used;
+	__le64 id_table_start;
+	__le64 xattr_id_table_start;
+	__le64 inode_table_start;
+	__le64 directory_table_start;
+	__le64 fragment_table_start;
+	__le64 export_table_start;
+} __packed;
+
+struct squashfs_base_inode {
+	__le16 inode_type;
+	__le16 mode;
+	__le16 uid;
+	__le16 guid;
+	__le32 mtime;
+	__le32 inode_number;
+} __packed;
+
+struct squashfs_reg_inode {
+	__le32 start_block;
+	__le32 fragment;
+	__le32 offset;
+	__le32 file_size;
+	/* followed by the size of each data block */
+} __packed;
+
+struct squashfs_lreg_inode {
+	__le64 start_block;
+	__le64 file_size;
+	__le64 sparse;
+	__le32 nlink;
+	__le32 fragment;
+	__le32 offset;
+	__le32 xattr;
+	/* followed by the size of each data block */
+} __packed;
+
+struct squashfs_dir_inode {
+	__le32 start_block;
+	__le32 nlink;
+	__le16 file_size;
+	__le16 offset;
+	__le32 parent_inode;
+} __packed;
+
+struct squashfs_ldir_inode {
+	__le32 nlink;
+	__le32 file_size;
+	__le32 start_block;
+	__le32 parent_inode;
+	__le16 i_count;
+	__le16 offset;
+	__le32 xattr;
+	/* followed by i_count directory index entries */
+} __packed;
+
+struct squashfs_symlink_inode {
+	__le32 nlink;
+	__le32 symlink_size;
+	/* followed by the target, not NUL-terminated */
+} __packed;
+
+struct squashfs_dir_header {
+	__le32 count;		/* number of entries minus one */
+	__le32 start_block;	/* metadata block holding their inodes */
+	__le32 inode_number;
+} __packed;
+
+struct squashfs_dir_entry {
+	__le16 offset;		/* of the inode in its metadata block */
+	__le16 inode_offset;	/* signed delta to the header's number */
+	__le16 type;
+	__le16 size;		/* length of the name minus one */
+	/* followed by the name, not NUL-terminated */
+} __packed;
+
+struct squashfs_fragment_entry {
+	__le64 start_block;
+	__le32 size;
+	__le32 unused;
+} __packed;
+
+#endif /* __SQFS_FILESYSTEM_H */
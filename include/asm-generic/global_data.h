@@ -65,6 +65,19 @@ typedef struct global_data {
 	struct udevice	*dm_root_f;	/* Pre-relocation root instance */
 	struct list_head uclass_root;	/* Head of core tree */
 #endif
+#ifdef CONFIG_DM_UCLASS_INDEX
+	struct uclass	**uclass_tbl;	/* Uclasses indexed by uclass ID */
+#endif
+#ifdef CONFIG_DM_LAZY_BIND
+	void		*dm_lazy;	/* Device tree nodes not yet bound */
+#endif
+#ifdef CONFIG_DM_ASYNC_PROBE
+	void		*dm_async;	/* Devices probing in the background */
+#endif
+#ifdef CONFIG_DM_COMPAT_INDEX
+	void		*dm_compat_index; /* Sorted driver compatible strings */
+	int		dm_compat_count; /* Entries in index, -ve if failed */
+#endif
 #ifdef CONFIG_TIMER
 	struct udevice	*timer;		/* Timer instance for Driver Model */
 #endif
@@ -110,6 +123,9 @@ typedef struct global_data {
 	ulong video_top;		/* Top of video frame buffer area */
 	ulong video_bottom;		/* Bottom of video frame buffer area */
 #endif
+#ifdef CONFIG_CYCLIC
+	struct cyclic_drv *cyclic;	/* Cyclic functions (common/cyclic.c) */
+#endif
 #ifdef CONFIG_BOOTSTAGE
 	struct bootstage_data *bootstage;	/* Bootstage information */
 	struct bootstage_data *new_bootstage;	/* Relocated bootstage info */
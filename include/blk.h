@@ -179,6 +179,16 @@ static inline void blkcache_invalidate(int iftype, int dev) {}
 
 #endif
 
+#if defined(CONFIG_FS_CACHE) && !defined(CONFIG_SPL_BUILD)
+/**
+ * fs_cache_invalidate() - discard the files cached by the filesystem layer
+ * because of a block write, a filesystem write or a partition rescan.
+ */
+void fs_cache_invalidate(void);
+#else
+static inline void fs_cache_invalidate(void) {}
+#endif
+
 #if CONFIG_IS_ENABLED(BLK)
 struct udevice;
 
@@ -422,6 +432,7 @@ static inline ulong blk_dwrite(struct blk_desc *block_dev, lbaint_t start,
 			       lbaint_t blkcnt, const void *buffer)
 {
 	blkcache_invalidate(block_dev->if_type, block_dev->devnum);
+	fs_cache_invalidate();
 	return block_dev->block_write(block_dev, start, blkcnt, buffer);
 }
 
@@ -429,6 +440,7 @@ static inline ulong blk_derase(struct blk_desc *block_dev, lbaint_t start,
 			       lbaint_t blkcnt)
 {
 	blkcache_invalidate(block_dev->if_type, block_dev->devnum);
+	fs_cache_invalidate();
 	return block_dev->block_erase(block_dev, start, blkcnt);
 }
 
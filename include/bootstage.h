@@ -21,6 +21,7 @@
 enum bootstage_flags {
 	BOOTSTAGEF_ERROR	= 1 << 0,	/* Error record */
 	BOOTSTAGEF_ALLOC	= 1 << 1,	/* Allocate an id */
+	BOOTSTAGEF_SPAN		= 1 << 2,	/* Start time and duration */
 };
 
 /* bootstate sub-IDs used for kernel and ramdisk ranges */
@@ -205,11 +206,13 @@ enum bootstage_id {
 	BOOTSTATE_ID_ACCUM_DM_SPL,
 	BOOTSTATE_ID_ACCUM_DM_F,
 	BOOTSTATE_ID_ACCUM_DM_R,
+	BOOTSTATE_ID_ACCUM_DM_RELOC,
 
 	/* a few spare for the user, from here */
 	BOOTSTAGE_ID_USER,
 	BOOTSTAGE_ID_COUNT = BOOTSTAGE_ID_USER + CONFIG_BOOTSTAGE_USER_COUNT,
 	BOOTSTAGE_ID_ALLOC,
+	BOOTSTAGE_ID_SPAN,	/* All records from bootstage_add_span() */
 };
 
 /*
@@ -284,6 +287,33 @@ ulong bootstage_mark_name(enum bootstage_id id, const char *name);
 ulong bootstage_mark_code(const char *file, const char *func,
 			  int linenum);
 
+/**
+ * bootstage_add_span() - Record an activity which has just finished
+ *
+ * This adds a new record each time it is called, holding the start time and
+ * duration of the activity. It is used to time each initcall and device
+ * probe, see CONFIG_BOOTSTAGE_INITCALL and CONFIG_BOOTSTAGE_DM_PROBE. Once
+ * full malloc() is available, more records are allocated as needed.
+ *
+ * @name:	Name of the activity, or NULL to name it after @func. This is
+ *		copied if there is space.
+ * @func:	Function which was called, or NULL if none
+ * @start_us:	Start time of the activity, from timer_get_boot_us()
+ * @return time taken by the activity in microseconds
+ */
+ulong bootstage_add_span(const char *name, const void *func, ulong start_us);
+
+/**
+ * bootstage_set_spans() - Enable or disable recording of spans
+ *
+ * This can be used to avoid adding records for activities which are not part
+ * of the boot, such as the thousands of device probes in driver-model tests.
+ *
+ * @enable:	true to record spans (the default), false to ignore them
+ * @return previous setting, so that it can be restored
+ */
+bool bootstage_set_spans(bool enable);
+
 /**
  * Mark the start of a bootstage activity. The end will be marked later with
  * bootstage_accum() and at that point we accumulate the time taken. Calling
@@ -314,6 +344,21 @@ uint32_t bootstage_accum(enum bootstage_id id);
 /* Print a report about boot time */
 void bootstage_report(void);
 
+/**
+ * bootstage_export_chrome() - Export bootstage records as a Chrome trace
+ *
+ * This writes the records in the JSON trace-event format used by Chrome's
+ * about://tracing and other trace viewers. Marks become instant events and
+ * spans become complete events, so that nested initcalls and device probes
+ * show as a flame graph.
+ *
+ * @out:	Buffer for the output, or NULL to write it to the console
+ * @size:	Size of buffer in bytes
+ * @return length of the output in bytes. If this is larger than @size, the
+ *	output was truncated
+ */
+int bootstage_export_chrome(char *out, int size);
+
 /**
  * Add bootstage information to the device tree
  *
@@ -400,6 +445,17 @@ static inline ulong bootstage_mark_code(const char *file, const char *func,
 	return 0;
 }
 
+static inline ulong bootstage_add_span(const char *name, const void *func,
+				       ulong start_us)
+{
+	return 0;
+}
+
+static inline bool bootstage_set_spans(bool enable)
+{
+	return false;
+}
+
 static inline uint32_t bootstage_start(enum bootstage_id id, const char *name)
 {
 	return 0;
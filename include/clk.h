@@ -61,9 +61,38 @@ struct clk {
 };
 
 #if CONFIG_IS_ENABLED(OF_CONTROL) && CONFIG_IS_ENABLED(CLK)
-struct phandle_1_arg;
-int clk_get_by_index_platdata(struct udevice *dev, int index,
-			      struct phandle_1_arg *cells, struct clk *clk);
+/**
+ * clk_get_by_platdata_cells() - Get a clock from an of-platdata phandle array
+ *
+ * Use clk_get_by_index_platdata() rather than calling this directly.
+ *
+ * @dev:	Client device
+ * @index:	Index of the clock to get
+ * @cells:	Array of struct phandle_<n>_arg generated by dtoc
+ * @count:	Number of entries in @cells
+ * @size:	Size of each entry in @cells
+ * @clk:	Returns the clock
+ * @return 0 if OK, -ENOENT if @index is out of range, other -ve on error
+ */
+int clk_get_by_platdata_cells(struct udevice *dev, int index,
+			      const void *cells, int count, int size,
+			      struct clk *clk);
+
+/**
+ * clk_get_by_index_platdata() - Get a clock from of-platdata by index
+ *
+ * dtoc sizes the 'clocks' array and picks its element type from the device
+ * tree, so these are taken from the array itself.
+ *
+ * @dev:	Client device
+ * @index:	Index of the clock to get
+ * @cells:	The 'clocks' member of the device's dtoc-generated struct
+ * @clk:	Returns the clock
+ * @return 0 if OK, -ve on error
+ */
+#define clk_get_by_index_platdata(dev, index, cells, clk)		\
+	clk_get_by_platdata_cells(dev, index, cells, ARRAY_SIZE(cells),	\
+				  sizeof((cells)[0]), clk)
 
 /**
  * clock_get_by_index - Get/request a clock by integer index.
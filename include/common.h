@@ -669,6 +669,11 @@ int gzwrite(unsigned char *src, int len,
 
 /* lib/lz4_wrapper.c */
 int ulz4fn(const void *src, size_t srcn, void *dst, size_t *dstn);
+/* decompress a single raw LZ4 block, without frame header */
+int ulz4_block(const void *src, size_t srcn, void *dst, size_t *dstn);
+
+/* lib/zstd.c */
+int zstd_decompress(const void *src, size_t srcn, void *dst, size_t *dstn);
 
 /* lib/qsort.c */
 void qsort(void *base, size_t nmemb, size_t size,
@@ -0,0 +1,150 @@
+/*
+ * Cyclic functions, run in the background while U-Boot waits
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#ifndef __CYCLIC_H
+#define __CYCLIC_H
+
+#include <watchdog.h>
+#include <linux/list.h>
+
+/**
+ * typedef cyclic_func_t - Function called periodically
+ *
+ * @ctx: Context pointer passed to cyclic_register()
+ */
+typedef void (*cyclic_func_t)(void *ctx);
+
+/**
+ * struct cyclic_info - Information about a cyclic function
+ *
+ * @sibling_node: Node in the list of cyclic functions
+ * @func: Function to call
+ * @ctx: Context pointer passed to @func
+ * @name: Name of the function, for 'cyclic list'
+ * @delay_us: Period at which @func is called, in microseconds
+ * @budget_us: Time @func may take each time it is called, in microseconds.
+ * This is set to CONFIG_CYCLIC_MAX_CPU_TIME_US by cyclic_register() and may
+ * be changed by the caller. A warning is printed the first time it is
+ * exceeded
+ * @start_time_us: Time (from timer_get_us()) when @func was registered
+ * @next_call: Time (from timer_get_us()) when @func is next due
+ * @cpu_time_us: Total time spent in @func
+ * @max_time_us: Longest time taken by a single call to @func
+ * @run_cnt: Number of times @func has been called
+ * @already_warned: true if the budget warning has been printed
+ */
+struct cyclic_info {
+	struct list_head sibling_node;
+	cyclic_func_t func;
+	void *ctx;
+	const char *name;
+	ulong delay_us;
+	ulong budget_us;
+	ulong start_time_us;
+	ulong next_call;
+	u64 cpu_time_us;
+	ulong max_time_us;
+	ulong run_cnt;
+	bool already_warned;
+};
+
+#if CONFIG_IS_ENABLED(CYCLIC)
+/**
+ * cyclic_register() - Register a new cyclic function
+ *
+ * The function is called from cyclic_schedule(), which U-Boot calls while it
+ * waits: in udelay(), while waiting for console input and while moving large
+ * amounts of data. It should return quickly. Cyclic functions are only run
+ * after relocation.
+ *
+ * @func: Function to call
+ * @delay_us: Period at which @func should be called, in microseconds
+ * @name: Name of the function
+ * @ctx: Context pointer to pass to @func
+ * @return pointer to the new cyclic function, or NULL if out of memory or
+ * cyclic functions are not ready yet
+ */
+struct cyclic_info *cyclic_register(cyclic_func_t func, ulong delay_us,
+				    const char *name, void *ctx);
+
+/**
+ * cyclic_unregister() - Unregister a cyclic function
+ *
+ * This may be called from the cyclic function itself. It does nothing after
+ * cyclic_uninit(), so a driver's remove() method may call it when devices
+ * are removed before booting an OS.
+ *
+ * @cyclic: Cyclic function to remove, as returned by cyclic_register()
+ */
+void cyclic_unregister(struct cyclic_info *cyclic);
+
+/**
+ * cyclic_init() - Set up cyclic functions
+ *
+ * This is called after relocation, once malloc() is available.
+ *
+ * @return 0 if OK, -ENOMEM if out of memory
+ */
+int cyclic_init(void);
+
+/**
+ * cyclic_uninit() - Unregister all cyclic functions and free their state
+ *
+ * This is called before booting an OS, so that nothing runs while U-Boot
+ * waits after devices have been removed. cyclic_init() must be called before
+ * cyclic functions can be registered again.
+ */
+void cyclic_uninit(void);
+
+/**
+ * cyclic_registered() - Check whether any cyclic functions are registered
+ *
+ * @return true if there is at least one cyclic function
+ */
+bool cyclic_registered(void);
+
+/**
+ * cyclic_get_list() - Get the list of cyclic functions
+ *
+ * @return list of struct cyclic_info, or NULL if cyclic_init() has not been
+ * called
+ */
+struct list_head *cyclic_get_list(void);
+
+/**
+ * cyclic_run() - Call any cyclic functions which are due
+ *
+ * Calls made from inside a cyclic function do nothing.
+ */
+void cyclic_run(void);
+#else
+static inline struct cyclic_info *cyclic_register(cyclic_func_t func,
+						  ulong delay_us,
+						  const char *name, void *ctx)
+{
+	return NULL;
+}
+
+static inline void cyclic_unregister(struct cyclic_info *cyclic) {}
+static inline int cyclic_init(void) { return 0; }
+static inline void cyclic_uninit(void) {}
+static inline bool cyclic_registered(void) { return false; }
+static inline void cyclic_run(void) {}
+#endif
+
+/**
+ * cyclic_schedule() - Service the watchdog and run cyclic functions
+ *
+ * Call this from loops which wait for something or take a long time, instead
+ * of WATCHDOG_RESET().
+ */
+static inline void cyclic_schedule(void)
+{
+	WATCHDOG_RESET();
+	cyclic_run();
+}
+
+#endif /* __CYCLIC_H */
@@ -91,6 +91,57 @@ int device_bind_by_name(struct udevice *parent, bool pre_reloc_only,
  */
 int device_probe(struct udevice *dev);
 
+/**
+ * device_probe_start() - Start probing a device
+ *
+ * This does the work of device_probe() up to and including the driver's
+ * probe() method. If that returns -EINPROGRESS and the driver has a
+ * probe_poll() method, the device is left part-way through probing and
+ * device_probe_finish() must be called once probe_poll() has returned
+ * something other than -EINPROGRESS.
+ *
+ * @dev: Pointer to device to probe
+ * @return 0 if OK, -EINPROGRESS if the driver has not finished, other -ve on
+ * error
+ */
+int device_probe_start(struct udevice *dev);
+
+/**
+ * device_probe_finish() - Finish probing a device
+ *
+ * @dev: Pointer to device being probed, after device_probe_start() returned
+ * -EINPROGRESS
+ * @ret: Final result from the driver's probe_poll() method
+ * @return 0 if OK, -ve on error (the device is then no longer active)
+ */
+int device_probe_finish(struct udevice *dev, int ret);
+
+/**
+ * device_probe_async() - Start probing a device without waiting for it
+ *
+ * This is like device_probe() except that it does not wait for drivers which
+ * can probe in the background (see the probe_poll() method of struct driver).
+ * If a parent is still being probed, the device is queued until the parent is
+ * ready. Use device_probe() or device_probe_wait() to wait for the device.
+ *
+ * @dev: Pointer to device to probe
+ * @return 0 if the device is probed, -EINPROGRESS if probing continues in the
+ * background, other -ve on error
+ */
+int device_probe_async(struct udevice *dev);
+
+/**
+ * device_probe_wait() - Wait for a device to finish probing
+ *
+ * Other devices which are probing in the background make progress while this
+ * waits.
+ *
+ * @dev: Pointer to device which is being probed
+ * @return 0 if OK, -EDEADLK if the device depends on itself, other -ve if the
+ * probe failed
+ */
+int device_probe_wait(struct udevice *dev);
+
 /**
  * device_remove() - Remove a device, de-activating it
  *
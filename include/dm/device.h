@@ -61,6 +61,12 @@ struct driver_info;
  */
 #define DM_FLAG_OS_PREPARE		(1 << 10)
 
+/* Device was moved from the pre-relocation tree (CONFIG_DM_RELOC_TREE) */
+#define DM_FLAG_RELOCATED		(1 << 11)
+
+/* Device is still being probed in the background (CONFIG_DM_ASYNC_PROBE) */
+#define DM_FLAG_PROBE_PENDING		(1 << 12)
+
 /*
  * One or multiple of these flags are passed to device_remove() so that
  * a selective device removal as specified by the remove-stage and the
@@ -123,6 +129,13 @@ enum {
  *		When CONFIG_DEVRES is enabled, devm_kmalloc() and friends will
  *		add to this list. Memory so-allocated will be freed
  *		automatically when the device is removed / unbound
+ * @seq_hash: Used by the uclass index to find this device by @seq
+ * @node_hash: Used by the uclass index to find this device by @node
+ * @phandle_hash: Used by the uclass index to find this device by phandle
+ * @of_platdata: With of-platdata, the dtoc-generated platform data which this
+ *		device was bound from. Phandles in other devices' platform
+ *		data point to this, so it is used to find the device they
+ *		refer to.
  */
 struct udevice {
 	const struct driver *driver;
@@ -146,6 +159,14 @@ struct udevice {
 #ifdef CONFIG_DEVRES
 	struct list_head devres_head;
 #endif
+#if CONFIG_IS_ENABLED(DM_UCLASS_INDEX)
+	struct hlist_node seq_hash;
+	struct hlist_node node_hash;
+	struct hlist_node phandle_hash;
+#endif
+#if CONFIG_IS_ENABLED(OF_PLATDATA)
+	const void *of_platdata;
+#endif
 };
 
 /* Maximum sequence number supported */
@@ -155,16 +176,28 @@ struct udevice {
 #define device_get_ops(dev)	(dev->driver->ops)
 
 /* Returns non-zero if the device is active (probed and not removed) */
-#define device_active(dev)	((dev)->flags & DM_FLAG_ACTIVATED)
+#define device_active(dev)	(((dev)->flags & (DM_FLAG_ACTIVATED | \
+				  DM_FLAG_PROBE_PENDING)) == DM_FLAG_ACTIVATED)
 
 static inline int dev_of_offset(const struct udevice *dev)
 {
 	return ofnode_to_offset(dev->node);
 }
 
+/**
+ * dev_set_ofnode() - Set the device tree node of a device
+ *
+ * Use this rather than setting dev->node directly, so that the device can
+ * still be found by node once it is bound.
+ *
+ * @dev: Device to update
+ * @node: New device tree node
+ */
+void dev_set_ofnode(struct udevice *dev, ofnode node);
+
 static inline void dev_set_of_offset(struct udevice *dev, int of_offset)
 {
-	dev->node = offset_to_ofnode(of_offset);
+	dev_set_ofnode(dev, offset_to_ofnode(of_offset));
 }
 
 static inline bool dev_has_of_node(struct udevice *dev)
@@ -206,7 +239,11 @@ struct udevice_id {
  * @of_match: List of compatible strings to match, and any identifying data
  * for each.
  * @bind: Called to bind a device to its driver
- * @probe: Called to probe a device, i.e. activate it
+ * @probe: Called to probe a device, i.e. activate it. If the driver has a
+ * probe_poll() method, this may return -EINPROGRESS to finish the probe later
+ * @probe_poll: Called to continue a probe which returned -EINPROGRESS. This
+ * should not wait for the hardware, but return -EINPROGRESS again if it is
+ * not ready yet. It returns 0 once the device is probed, or -ve on error
  * @remove: Called to remove a device, i.e. de-activate it
  * @unbind: Called to unbind a device from its driver
  * @ofdata_to_platdata: Called before probe to decode device tree data
@@ -240,6 +277,7 @@ struct driver {
 	const struct udevice_id *of_match;
 	int (*bind)(struct udevice *dev);
 	int (*probe)(struct udevice *dev);
+	int (*probe_poll)(struct udevice *dev);
 	int (*remove)(struct udevice *dev);
 	int (*unbind)(struct udevice *dev);
 	int (*ofdata_to_platdata)(struct udevice *dev);
@@ -486,6 +524,22 @@ int device_get_child_by_of_offset(struct udevice *parent, int of_offset,
  */
 int device_get_global_by_of_offset(int of_offset, struct udevice **devp);
 
+/**
+ * device_get_by_of_platdata() - Get a device based on its of-platdata
+ *
+ * Locates a device by the dtoc-generated platform data it was bound from,
+ * searching globally throughout all driver model devices. This is used to
+ * resolve the phandles in of-platdata structures, whose @node member points
+ * to the platform data of the node they refer to.
+ *
+ * The device is probed to activate it ready for use.
+ *
+ * @of_platdata: Platform data to find (e.g. struct phandle_1_arg.node)
+ * @devp: Returns pointer to device if found, otherwise this is set to NULL
+ * @return 0 if OK, -ENOENT if there is no such device, other -ve on error
+ */
+int device_get_by_of_platdata(const void *of_platdata, struct udevice **devp);
+
 /**
  * device_find_first_child() - Find the first child of a device
  *
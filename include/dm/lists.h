@@ -59,6 +59,25 @@ int lists_bind_drivers(struct udevice *parent, bool pre_reloc_only);
  */
 int lists_bind_fdt(struct udevice *parent, ofnode node, struct udevice **devp);
 
+struct udevice_id;
+
+/**
+ * lists_driver_lookup_compat() - Find the driver for a compatible string
+ *
+ * This finds the first driver (in linker-list order) with @compat in its
+ * of_match[] table, which is the driver that lists_bind_fdt() binds.
+ *
+ * @compat: Compatible string to look up
+ * @use_index: true to use the sorted index (CONFIG_DM_COMPAT_INDEX) if
+ *	available, false to always scan every driver
+ * @drvp: Returns the driver found
+ * @of_idp: Returns the matching entry of the driver's of_match[] table
+ * @return 0 if found, -ENOENT if no driver matches
+ */
+int lists_driver_lookup_compat(const char *compat, bool use_index,
+			       struct driver **drvp,
+			       const struct udevice_id **of_idp);
+
 /**
  * device_bind_driver() - bind a device to a driver
  *
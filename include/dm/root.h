@@ -10,6 +10,9 @@
 #ifndef _DM_ROOT_H_
 #define _DM_ROOT_H_
 
+#include <dm/ofnode.h>
+#include <dm/uclass-id.h>
+
 struct udevice;
 
 /**
@@ -95,6 +98,18 @@ int dm_scan_other(bool pre_reloc_only);
  */
 int dm_init_and_scan(bool pre_reloc_only);
 
+/**
+ * dm_init_and_relocate() - Start Driver Model after relocation
+ *
+ * This is like dm_init_and_scan(false), except that devices bound before
+ * relocation are moved from @root_f instead of being bound again
+ * (CONFIG_DM_RELOC_TREE). Only the remaining devices are then bound.
+ *
+ * @root_f: Root device of the pre-relocation tree
+ * @return 0 if OK, -ve on error
+ */
+int dm_init_and_relocate(struct udevice *root_f);
+
 /**
  * dm_init() - Initialise Driver Model structures
  *
@@ -130,4 +145,180 @@ int dm_remove_devices_flags(uint flags);
 static inline int dm_remove_devices_flags(uint flags) { return 0; }
 #endif
 
+#if CONFIG_IS_ENABLED(DM_LAZY_BIND)
+/**
+ * dm_lazy_defer() - Decide whether to defer binding a device tree node
+ *
+ * This is called while scanning the device tree after relocation. Nodes
+ * which are marked for use before relocation, have subnodes with compatible
+ * strings (e.g. buses) or do not match any driver are bound immediately.
+ * Others are recorded and bound when first needed.
+ *
+ * @parent: Parent device that the node would be bound to
+ * @node: Device tree node to check
+ * @return true if binding was deferred, false to bind the node now
+ */
+bool dm_lazy_defer(struct udevice *parent, ofnode node);
+
+/**
+ * dm_lazy_bind_node() - Bind a device tree node whose binding was deferred
+ *
+ * @node: Device tree node to bind
+ * @devp: Returns the device bound, or NULL if none
+ * @return 0 if OK, -ENOENT if the node is not pending, other -ve on error
+ */
+int dm_lazy_bind_node(ofnode node, struct udevice **devp);
+
+/**
+ * dm_lazy_bind_phandle() - Bind a deferred node given its phandle
+ *
+ * @phandle: Phandle of the device tree node to bind
+ * @devp: Returns the device bound, or NULL if none
+ * @return 0 if OK, -ENOENT if the node is not pending, other -ve on error
+ */
+int dm_lazy_bind_phandle(uint phandle, struct udevice **devp);
+
+/**
+ * dm_lazy_bind_uclass() - Bind all deferred nodes in a uclass
+ *
+ * @id: uclass ID to bind
+ * @return 0 if OK, -ve if any node failed to bind
+ */
+int dm_lazy_bind_uclass(enum uclass_id id);
+
+/**
+ * dm_lazy_bind_children() - Bind all deferred children of a device
+ *
+ * @parent: Parent device whose children are needed
+ * @return 0 if OK, -ve on error (the first error seen)
+ */
+int dm_lazy_bind_children(struct udevice *parent);
+
+/**
+ * dm_lazy_forget() - Drop deferred nodes of a device that is being unbound
+ *
+ * @parent: Device being unbound
+ */
+void dm_lazy_forget(struct udevice *parent);
+
+/**
+ * dm_lazy_reset() - Drop all deferred nodes
+ *
+ * This is called when driver model is started.
+ */
+void dm_lazy_reset(void);
+
+/**
+ * dm_lazy_count() - Get the number of deferred nodes not yet bound
+ *
+ * @return number of nodes
+ */
+int dm_lazy_count(void);
+#else
+static inline bool dm_lazy_defer(struct udevice *parent, ofnode node)
+{
+	return false;
+}
+
+static inline int dm_lazy_bind_node(ofnode node, struct udevice **devp)
+{
+	*devp = NULL;
+
+	return -ENOENT;
+}
+
+static inline int dm_lazy_bind_phandle(uint phandle, struct udevice **devp)
+{
+	*devp = NULL;
+
+	return -ENOENT;
+}
+
+static inline int dm_lazy_bind_uclass(enum uclass_id id) { return 0; }
+static inline int dm_lazy_bind_children(struct udevice *parent) { return 0; }
+
+static inline void dm_lazy_forget(struct udevice *parent) {}
+static inline void dm_lazy_reset(void) {}
+static inline int dm_lazy_count(void) { return 0; }
+#endif
+
+#if CONFIG_IS_ENABLED(DM_ASYNC_PROBE)
+/**
+ * dm_async_poll() - Make progress with devices probing in the background
+ *
+ * This calls the probe_poll() method of each device which is still being
+ * probed, and starts probing devices whose parent has become ready.
+ *
+ * @return number of devices still being probed
+ */
+int dm_async_poll(void);
+
+/**
+ * dm_async_probe_uclass() - Start probing all devices in a uclass
+ *
+ * This calls device_probe_async() on each device in the uclass, so that slow
+ * devices can be probed together. Devices with an alias are started first so
+ * that they get the sequence number it requests.
+ *
+ * @id: uclass ID to probe
+ * @return 0 if OK, -ve on error (the first error from any device)
+ */
+int dm_async_probe_uclass(enum uclass_id id);
+
+/**
+ * dm_async_wait_all() - Wait for all devices probing in the background
+ */
+void dm_async_wait_all(void);
+
+/**
+ * dm_async_forget() - Stop waiting to probe a device that is being unbound
+ *
+ * @dev: Device which is queued until its parent is probed
+ */
+void dm_async_forget(struct udevice *dev);
+
+/**
+ * dm_async_reset() - Finish all probing and drop the background probe state
+ */
+void dm_async_reset(void);
+#else
+static inline int dm_async_poll(void) { return 0; }
+static inline int dm_async_probe_uclass(enum uclass_id id) { return 0; }
+static inline void dm_async_wait_all(void) {}
+static inline void dm_async_forget(struct udevice *dev) {}
+static inline void dm_async_reset(void) {}
+#endif
+
+#if CONFIG_IS_ENABLED(DM_RELOC_TREE)
+/**
+ * dm_reloc_tree() - Move the pre-relocation devices to the new tree
+ *
+ * Devices bound from the device tree before relocation are copied below
+ * gd->dm_root, with their children. They are not probed. Devices whose
+ * driver has a bind() method or whose uclass has a post_bind() method are
+ * left to be bound again.
+ *
+ * @root_f: Root device of the pre-relocation tree
+ * @return 0 if OK, -ve on error
+ */
+int dm_reloc_tree(struct udevice *root_f);
+
+/**
+ * dm_reloc_node_bound() - Check if a node was moved with its device
+ *
+ * This is used when scanning the device tree after dm_reloc_tree(), to
+ * avoid binding a node a second time.
+ *
+ * @parent: Parent device whose children are checked
+ * @node: Device tree node to look for
+ * @return true if a moved child of @parent uses @node
+ */
+bool dm_reloc_node_bound(struct udevice *parent, ofnode node);
+#else
+static inline bool dm_reloc_node_bound(struct udevice *parent, ofnode node)
+{
+	return false;
+}
+#endif
+
 #endif
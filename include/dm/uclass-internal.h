@@ -132,6 +132,17 @@ int uclass_find_device_by_of_offset(enum uclass_id id, int node,
 int uclass_find_device_by_ofnode(enum uclass_id id, ofnode node,
 				 struct udevice **devp);
 
+/**
+ * uclass_add_device() - Add a device to its uclass's list of devices
+ *
+ * Unlike uclass_bind_device() this does not call the parent uclass's
+ * child_post_bind() method. It is used for devices which were bound before
+ * relocation and moved (CONFIG_DM_RELOC_TREE).
+ *
+ * @dev:	Pointer to the device
+ */
+void uclass_add_device(struct udevice *dev);
+
 /**
  * uclass_bind_device() - Associate device with a uclass
  *
@@ -156,6 +167,27 @@ int uclass_unbind_device(struct udevice *dev);
 static inline int uclass_unbind_device(struct udevice *dev) { return 0; }
 #endif
 
+/**
+ * uclass_set_device_seq() - Set the sequence number of a device
+ *
+ * This updates the uclass index as well as @dev->seq.
+ *
+ * @dev:	Pointer to the device
+ * @seq:	Sequence number to set, or -1 for none
+ */
+void uclass_set_device_seq(struct udevice *dev, int seq);
+
+/**
+ * uclass_set_device_node() - Set the device tree node of a device
+ *
+ * This updates the uclass index as well as @dev->node. Drivers should use
+ * dev_set_ofnode() instead.
+ *
+ * @dev:	Pointer to the device
+ * @node:	Device tree node to set
+ */
+void uclass_set_device_node(struct udevice *dev, ofnode node);
+
 /**
  * uclass_pre_probe_device() - Deal with a device that is about to be probed
  *
@@ -193,6 +225,19 @@ int uclass_pre_remove_device(struct udevice *dev);
 static inline int uclass_pre_remove_device(struct udevice *dev) { return 0; }
 #endif
 
+/**
+ * uclass_get_nolazy() - Get a uclass without binding deferred devices
+ *
+ * This is like uclass_get() but does not bind devices in the uclass whose
+ * binding was deferred (CONFIG_DM_LAZY_BIND). It is used when binding a
+ * device, and by lookups which only bind the device they are looking for.
+ *
+ * @id:		ID of uclass to get
+ * @ucp:	Returns pointer to uclass (there is only one per ID)
+ * @return 0 if OK, -ve on error
+ */
+int uclass_get_nolazy(enum uclass_id id, struct uclass **ucp);
+
 /**
  * uclass_find() - Find uclass by its id
  *
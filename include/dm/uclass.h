@@ -31,12 +31,36 @@
  * @dev_head: List of devices in this uclass (devices are attached to their
  * uclass when their bind method is called)
  * @sibling_node: Next uclass in the linked list of uclasses
+ * @index: Hash tables for finding devices in this uclass, or NULL if not
+ * built yet (CONFIG_DM_UCLASS_INDEX)
  */
 struct uclass {
 	void *priv;
 	struct uclass_driver *uc_drv;
 	struct list_head dev_head;
 	struct list_head sibling_node;
+#if CONFIG_IS_ENABLED(DM_UCLASS_INDEX)
+	struct uclass_index *index;
+#endif
+};
+
+/* Number of hash buckets in each table of a uclass index (a power of two) */
+#define DM_UC_HASH_SIZE		16
+
+/**
+ * struct uclass_index - Hash tables for finding devices in a uclass
+ *
+ * This is built the first time a uclass is searched after relocation, and
+ * then kept up to date as devices are bound, unbound, probed and removed.
+ *
+ * @seq: Devices which have a sequence number, hashed by sequence number
+ * @node: Devices which have a device tree node, hashed by node
+ * @phandle: Devices whose node has a phandle, hashed by phandle
+ */
+struct uclass_index {
+	struct hlist_head seq[DM_UC_HASH_SIZE];
+	struct hlist_head node[DM_UC_HASH_SIZE];
+	struct hlist_head phandle[DM_UC_HASH_SIZE];
 };
 
 struct driver;
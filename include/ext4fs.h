@@ -31,11 +31,15 @@
 #define EXT4_INDEX_FL		0x00001000 /* Inode uses hash tree index */
 #define EXT4_EXTENTS_FL		0x00080000 /* Inode uses extents */
 #define EXT4_EXT_MAGIC			0xf30a
+#define EXT_INIT_MAX_LEN		(1UL << 15) /* max initialized extent length */
 #define EXT4_FEATURE_RO_COMPAT_GDT_CSUM	0x0010
 #define EXT4_FEATURE_INCOMPAT_EXTENTS	0x0040
 #define EXT4_FEATURE_INCOMPAT_64BIT	0x0080
 #define EXT4_INDIRECT_BLOCKS		12
 
+/* Superblock flags */
+#define EXT2_FLAGS_UNSIGNED_HASH	0x0002	/* Unsigned dirhash in use */
+
 #define EXT4_BG_INODE_UNINIT		0x0001
 #define EXT4_BG_BLOCK_UNINIT		0x0002
 #define EXT4_BG_INODE_ZEROED		0x0004
@@ -78,6 +82,31 @@ struct ext4_extent_header {
 	__le32	eh_generation;	/* generation of the tree */
 };
 
+/*
+ * Hash indexed (HTree) directories keep the index in directory blocks
+ * disguised as empty directory entries. Block 0 holds the "." and ".."
+ * entries followed by dx_root_info and the top level dx_entry array;
+ * interior nodes hold one empty entry followed by a dx_entry array.
+ * The first dx_entry of each array doubles as dx_countlimit.
+ */
+struct dx_root_info {
+	__le32	reserved_zero;
+	__u8	hash_version;	/* DX_HASH_* */
+	__u8	info_length;	/* 8 */
+	__u8	indirect_levels;
+	__u8	unused_flags;
+};
+
+struct dx_entry {
+	__le32	hash;
+	__le32	block;		/* logical block within the directory */
+};
+
+struct dx_countlimit {
+	__le16	limit;
+	__le16	count;
+};
+
 struct ext_filesystem {
 	/* Total Sector of partition */
 	uint64_t total_sect;
@@ -146,10 +175,17 @@ void ext4fs_free_node(struct ext2fs_node *node, struct ext2fs_node *currroot);
 int ext4fs_devread(lbaint_t sector, int byte_offset, int byte_len, char *buf);
 void ext4fs_set_blk_dev(struct blk_desc *rbdd, disk_partition_t *info);
 long int read_allocated_block(struct ext2_inode *inode, int fileblock);
+long int ext4fs_map_blocks(struct ext2_inode *inode, uint32_t fileblock,
+			   uint32_t *count);
 int ext4fs_probe(struct blk_desc *fs_dev_desc,
 		 disk_partition_t *fs_partition);
 int ext4_read_file(const char *filename, void *buf, loff_t offset, loff_t len,
 		   loff_t *actread);
+struct fs_file;
+int ext4fs_file_open(const char *filename, struct fs_file **filep);
+int ext4fs_file_read(struct fs_file *file, void *buf, loff_t len,
+		     loff_t *actread);
+void ext4fs_file_close(struct fs_file *file);
 int ext4_read_superblock(char *buffer);
 int ext4fs_uuid(char *uuid_str);
 #endif
@@ -203,5 +203,9 @@ int fat_read_file(const char *filename, void *buf, loff_t offset, loff_t len,
 int fat_opendir(const char *filename, struct fs_dir_stream **dirsp);
 int fat_readdir(struct fs_dir_stream *dirs, struct fs_dirent **dentp);
 void fat_closedir(struct fs_dir_stream *dirs);
+int fat_file_open(const char *filename, struct fs_file **filep);
+int fat_file_read(struct fs_file *file, void *buf, loff_t len,
+		  loff_t *actread);
+void fat_file_close(struct fs_file *file);
 void fat_close(void);
 #endif /* _FAT_H_ */
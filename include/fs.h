@@ -13,6 +13,7 @@
 #define FS_TYPE_EXT	2
 #define FS_TYPE_SANDBOX	3
 #define FS_TYPE_UBIFS	4
+#define FS_TYPE_SQUASHFS	5
 
 /*
  * Tell the fs layer which block device an partition to use for future
@@ -145,6 +146,90 @@ struct fs_dirent *fs_readdir(struct fs_dir_stream *dirs);
  */
 void fs_closedir(struct fs_dir_stream *dirs);
 
+/*
+ * An open file, returned by fs_file_open().  Like fs_dir_stream it keeps
+ * the device and partition so that the filesystem can be probed again for
+ * each call; filesystem drivers embed it in their own handle to keep a
+ * read cursor between calls.
+ */
+struct fs_file {
+	/* private to fs. layer: */
+	struct blk_desc *desc;
+	int part;
+	int fstype;
+	/* may be read (not written) by the user: */
+	loff_t pos;          /* current position */
+	loff_t size;         /* file size in bytes */
+};
+
+/*
+ * fs_file_open - Open a file for reading
+ *
+ * Unlike fs_read(), which resolves the path on every call, this looks up
+ * the file once so that it can be read in chunks with fs_file_read().
+ *
+ * @filename: the path to the file to open
+ * @return a pointer to the file handle or NULL on error and errno set
+ *    appropriately
+ */
+struct fs_file *fs_file_open(const char *filename);
+
+/*
+ * fs_file_read - Read from the current position of a file
+ *
+ * Reads up to @len bytes and advances the position by the number of
+ * bytes read, which is only less than @len at the end of the file.
+ *
+ * @file: the file handle
+ * @buf: buffer to read into
+ * @len: number of bytes to read
+ * @actread: returns the number of bytes actually read
+ * @return 0 on success, -errno on error
+ */
+int fs_file_read(struct fs_file *file, void *buf, loff_t len,
+		 loff_t *actread);
+
+/*
+ * fs_file_seek - Set the position of a file
+ *
+ * @file: the file handle
+ * @offset: new position, from the start of the file
+ * @return 0 on success, -EINVAL if @offset lies outside the file
+ */
+int fs_file_seek(struct fs_file *file, loff_t offset);
+
+/*
+ * fs_file_close - close a file handle
+ *
+ * @file: the file handle
+ */
+void fs_file_close(struct fs_file *file);
+
+#ifdef CONFIG_FS_CACHE
+/*
+ * fs_cache_read - Serve a read from the file cache
+ *
+ * @desc, @part, @fstype, @filename: identify the file
+ * @size: current size of the file, a cached copy of another size is dropped
+ * @buf, @offset, @len, @actread: as for fs_read()
+ * @return 0 if the read was served, -ENOENT if the file is not cached
+ */
+int fs_cache_read(struct blk_desc *desc, int part, int fstype,
+		  const char *filename, loff_t size, void *buf, loff_t offset,
+		  loff_t len, loff_t *actread);
+
+/*
+ * fs_cache_store - Add a file read in full to the file cache
+ *
+ * Least recently used files are evicted to make room. Files larger than
+ * CONFIG_FS_CACHE_SIZE are not cached.
+ */
+void fs_cache_store(struct blk_desc *desc, int part, int fstype,
+		    const char *filename, const void *buf, loff_t size);
+
+/* fs_cache_invalidate() is declared in blk.h for the block layer */
+#endif
+
 /*
  * Common implementation for various filesystem commands, optionally limited
  * to a specific filesystem type via the fstype parameter.
@@ -155,6 +240,8 @@ int do_load(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[],
 		int fstype);
 int do_ls(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[],
 		int fstype);
+int do_cat(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[],
+		int fstype);
 int file_exists(const char *dev_type, const char *dev_part, const char *file,
 		int fstype);
 int do_save(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[],
@@ -452,6 +452,7 @@ struct mmc {
 	struct blk_desc block_dev;
 #endif
 	char op_cond_pending;	/* 1 if we are waiting on an op_cond command */
+	uint op_cond_start;	/* get_timer() value when op_cond started */
 	char init_in_progress;	/* 1 if we have done mmc_start_init() */
 	char preinit;		/* start init as early as possible */
 	int ddr_mode;
@@ -562,6 +563,20 @@ int mmc_set_bkops_enable(struct mmc *mmc);
  */
 int mmc_start_init(struct mmc *mmc);
 
+/**
+ * mmc_poll_init() - Continue device initialization without blocking
+ *
+ * This is called after mmc_start_init() to check whether the card has
+ * finished powering up. If it has, initialization is completed as by
+ * mmc_init(). This allows a driver to initialize the card from its probe()
+ * and probe_poll() methods, so that other devices can be probed meanwhile.
+ *
+ * @mmc:	Pointer to a MMC device struct
+ * @return 0 on success, -EINPROGRESS if the card is still busy, other -ve
+ * on error
+ */
+int mmc_poll_init(struct mmc *mmc);
+
 /**
  * Set preinit flag of mmc device.
  *
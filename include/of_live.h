@@ -12,9 +12,30 @@
 
 struct device_node;
 
+/**
+ * struct of_live_builtin - A live tree built into U-Boot
+ *
+ * With CONFIG_OF_LIVE_BUILTIN, dtoc generates this from the control device
+ * tree at build time (see 'dtoc livetree').
+ *
+ * @root: Root node of the live tree
+ * @fdt_size: Total size of the flat tree it was generated from
+ * @fdt_crc32: CRC32 of the flat tree it was generated from
+ */
+struct of_live_builtin {
+	struct device_node *root;
+	u32 fdt_size;
+	u32 fdt_crc32;
+};
+
+extern const struct of_live_builtin of_live_builtin;
+
 /**
  * of_live_build() - build a live (hierarchical) tree from a flat DT
  *
+ * With CONFIG_OF_LIVE_BUILTIN, the live tree built into U-Boot is used
+ * instead if it was generated from the same flat tree as @fdt_blob.
+ *
  * @fdt_blob: Input tree to convert
  * @rootp: Returns live tree that was created
  * @return 0 if OK, -ve on error
@@ -310,4 +310,16 @@ int os_spl_to_uboot(const char *fname);
  */
 void os_localtime(struct rtc_time *rt);
 
+/**
+ * os_find_text_base() - Find the load address of the U-Boot executable
+ *
+ * Sandbox is normally built as a position-independent executable, which the
+ * OS loads at a different address each time. Subtracting this address from
+ * a code address gives the address shown in System.map.
+ *
+ * @return address at which the executable is loaded, or NULL if it was
+ *	loaded at its link address or this cannot be determined
+ */
+void *os_find_text_base(void);
+
 #endif
@@ -0,0 +1,15 @@
+/*
+ * Tests for cyclic functions
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#ifndef __TEST_CYCLIC_H__
+#define __TEST_CYCLIC_H__
+
+#include <test/test.h>
+
+/* Declare a new cyclic test */
+#define CYCLIC_TEST(_name, _flags)	UNIT_TEST(_name, _flags, cyclic_test)
+
+#endif /* __TEST_CYCLIC_H__ */
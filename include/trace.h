@@ -35,6 +35,7 @@ enum trace_chunk_type {
 struct trace_output_func {
 	uint32_t offset;		/* Function offset into code */
 	uint32_t call_count;		/* Number of times called */
+	uint32_t total_us;		/* Time in function and its callees */
 };
 
 /* A header at the start of the trace output buffer */
@@ -49,7 +50,7 @@ void trace_print_stats(void);
 /**
  * Dump a list of functions and call counts into a buffer
  *
- * Each record in the buffer is a struct trace_func_stats. The 'needed'
+ * Each record in the buffer is a struct trace_output_func. The 'needed'
  * parameter returns the number of bytes needed to complete the operation,
  * which may be more than buff_size if your buffer is too small.
  *
@@ -28,4 +28,47 @@ uint32_t crc32_no_comp (uint32_t, const unsigned char *, uint);
 void crc32_wd_buf(const unsigned char *input, uint ilen,
 		    unsigned char *output, uint chunk_sz);
 
+/* lib/crc32.c, with CONFIG_CRC32C */
+uint32_t crc32c(uint32_t, const unsigned char *, uint);
+
+/**
+ * crc32c_no_comp() - Update a CRC32C (Castagnoli) without ones complement
+ *
+ * This is the form used by ext4 and btrfs metadata checksums, which start
+ * from ~0 and store the result as is.
+ *
+ * @crc:	Starting value
+ * @buf:	Data to checksum
+ * @len:	Length of data in bytes
+ * @return updated CRC
+ */
+uint32_t crc32c_no_comp(uint32_t crc, const unsigned char *buf, uint len);
+
+/**
+ * arch_crc32_le() - Update a CRC32 using CPU instructions
+ *
+ * Provided by architectures which select CRC32_ARCH. Like crc32_no_comp()
+ * the CRC is updated without ones complement. Whether the CPU has the
+ * instructions is checked on each call.
+ *
+ * @crcp:	CRC to update
+ * @buf:	Data to checksum
+ * @len:	Length of data in bytes
+ * @return 0 if OK, -ENOSYS if this CPU does not have the instructions
+ */
+int arch_crc32_le(uint32_t *crcp, const unsigned char *buf, uint len);
+
+/**
+ * arch_crc32c_le() - Update a CRC32C using CPU instructions
+ *
+ * Provided by architectures which select CRC32C_ARCH, otherwise the same as
+ * arch_crc32_le().
+ *
+ * @crcp:	CRC to update
+ * @buf:	Data to checksum
+ * @len:	Length of data in bytes
+ * @return 0 if OK, -ENOSYS if this CPU does not have the instructions
+ */
+int arch_crc32c_le(uint32_t *crcp, const unsigned char *buf, uint len);
+
 #endif /* _UBOOT_CRC_H */
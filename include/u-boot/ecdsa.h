@@ -0,0 +1,87 @@
+/*
+ * ECDSA signature support for FIT images
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#ifndef _ECDSA_H
+#define _ECDSA_H
+
+#include <errno.h>
+#include <image.h>
+
+struct image_sign_info;
+
+#if IMAGE_ENABLE_SIGN
+/**
+ * ecdsa_sign() - calculate and return signature for given input data
+ *
+ * @info:	Specifies key and FIT information
+ * @region:	List of regions to sign
+ * @region_count: Number of regions
+ * @sigp:	Set to an allocated buffer holding the signature
+ * @sig_len:	Set to length of the calculated signature
+ *
+ * The signature is stored as the big-endian values r and s, each as long
+ * as the curve's order. The caller should free *sigp.
+ *
+ * @return: 0, on success, -ve on error
+ */
+int ecdsa_sign(struct image_sign_info *info,
+	       const struct image_region region[],
+	       int region_count, uint8_t **sigp, uint *sig_len);
+
+/**
+ * ecdsa_add_verify_data() - Add verification information to FDT
+ *
+ * Add the curve name and the public key point to the FDT node, suitable
+ * for verification at run-time.
+ *
+ * @info:	Specifies key and FIT information
+ * @keydest:	Destination FDT blob for public key data
+ * @return: 0, on success, -ENOSPC if the keydest FDT blob ran out of space,
+ *	other -ve value on error
+ */
+int ecdsa_add_verify_data(struct image_sign_info *info, void *keydest);
+#else
+static inline int ecdsa_sign(struct image_sign_info *info,
+		const struct image_region region[], int region_count,
+		uint8_t **sigp, uint *sig_len)
+{
+	return -ENXIO;
+}
+
+static inline int ecdsa_add_verify_data(struct image_sign_info *info,
+					void *keydest)
+{
+	return -ENXIO;
+}
+#endif
+
+#if IMAGE_ENABLE_VERIFY
+/**
+ * ecdsa_verify() - Verify a signature against some data
+ *
+ * @info:	Specifies key and FIT information
+ * @region:	List of regions that were signed
+ * @region_count: Number of regions
+ * @sig:	Signature, as r followed by s
+ * @sig_len:	Number of bytes in signature
+ * @return 0 if verified, -ve on error
+ */
+int ecdsa_verify(struct image_sign_info *info,
+		 const struct image_region region[], int region_count,
+		 uint8_t *sig, uint sig_len);
+#else
+static inline int ecdsa_verify(struct image_sign_info *info,
+		const struct image_region region[], int region_count,
+		uint8_t *sig, uint sig_len)
+{
+	return -ENXIO;
+}
+#endif
+
+#define ECDSA256_BYTES	(256 / 8)
+#define ECDSA384_BYTES	(384 / 8)
+
+#endif
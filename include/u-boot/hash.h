@@ -0,0 +1,232 @@
+/*
+ * Driver model interface for hash engines
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#ifndef _U_BOOT_HASH_H
+#define _U_BOOT_HASH_H
+
+struct udevice;
+
+/* Hash algorithms which a hash engine may support */
+enum hash_algo_id {
+	HASH_ALGO_SHA1,
+	HASH_ALGO_SHA256,
+	HASH_ALGO_SHA384,
+	HASH_ALGO_SHA512,
+
+	HASH_ALGO_COUNT,
+};
+
+/**
+ * struct hash_uc_priv - Information about a hash engine
+ *
+ * The driver must set this up in its probe() method.
+ *
+ * @algos:	Mask of the algorithms supported, (1 << enum hash_algo_id)
+ */
+struct hash_uc_priv {
+	ulong algos;
+};
+
+/**
+ * struct hash_ops - Operations for a hash engine
+ *
+ * A device may hash several streams at once; each has its own context
+ * which is allocated by init() and freed by finish().
+ */
+struct hash_ops {
+	/**
+	 * init() - Start a new hash
+	 *
+	 * @dev:	Device to use
+	 * @algo:	Algorithm to use, which the device supports
+	 * @ctxp:	Returns a pointer to the new context
+	 * @return 0 if OK, -ve on error
+	 */
+	int (*init)(struct udevice *dev, enum hash_algo_id algo, void **ctxp);
+
+	/**
+	 * update() - Add data to a hash, waiting until it is done
+	 *
+	 * @dev:	Device to use
+	 * @ctx:	Context from init()
+	 * @buf:	Data to hash
+	 * @size:	Size of data in bytes
+	 * @return 0 if OK, -ve on error
+	 */
+	int (*update)(struct udevice *dev, void *ctx, const void *buf,
+		      uint size);
+
+	/**
+	 * submit() - Start adding data to a hash (optional)
+	 *
+	 * This returns as soon as the engine has been started. The data must
+	 * not be changed until poll() reports that the engine is done. Only
+	 * one submit() may be outstanding for each context.
+	 *
+	 * @dev:	Device to use
+	 * @ctx:	Context from init()
+	 * @buf:	Data to hash
+	 * @size:	Size of data in bytes
+	 * @return 0 if OK, -ve on error
+	 */
+	int (*submit)(struct udevice *dev, void *ctx, const void *buf,
+		      uint size);
+
+	/**
+	 * poll() - Check whether submitted data has been hashed
+	 *
+	 * This is required if submit() is provided.
+	 *
+	 * @dev:	Device to use
+	 * @ctx:	Context from init()
+	 * @return 0 if nothing is outstanding, -EBUSY if the engine is still
+	 *	working, other -ve value on error
+	 */
+	int (*poll)(struct udevice *dev, void *ctx);
+
+	/**
+	 * finish() - Finish a hash and free the context
+	 *
+	 * @dev:	Device to use
+	 * @ctx:	Context from init(), which is freed even on error
+	 * @digest:	Place to put the digest, which must be large enough for
+	 *		the algorithm
+	 * @return 0 if OK, -ve on error
+	 */
+	int (*finish)(struct udevice *dev, void *ctx, void *digest);
+};
+
+#define hash_get_ops(dev)	((struct hash_ops *)(dev)->driver->ops)
+
+/**
+ * dm_hash_init() - Start a new hash
+ *
+ * @dev:	Device to use
+ * @algo:	Algorithm to use
+ * @ctxp:	Returns a pointer to the new context
+ * @return 0 if OK, -EPROTONOSUPPORT if the device does not support @algo,
+ *	other -ve on error
+ */
+int dm_hash_init(struct udevice *dev, enum hash_algo_id algo, void **ctxp);
+
+/**
+ * dm_hash_update() - Add data to a hash, waiting until it is done
+ *
+ * @dev:	Device to use
+ * @ctx:	Context from dm_hash_init()
+ * @buf:	Data to hash
+ * @size:	Size of data in bytes
+ * @return 0 if OK, -ve on error
+ */
+int dm_hash_update(struct udevice *dev, void *ctx, const void *buf,
+		   uint size);
+
+/**
+ * dm_hash_submit() - Start adding data to a hash
+ *
+ * If the device cannot work in the background, the data is hashed before
+ * this returns. Otherwise the data must not be changed until
+ * dm_hash_poll() returns 0 or dm_hash_wait() returns.
+ *
+ * @dev:	Device to use
+ * @ctx:	Context from dm_hash_init()
+ * @buf:	Data to hash
+ * @size:	Size of data in bytes
+ * @return 0 if OK, -ve on error
+ */
+int dm_hash_submit(struct udevice *dev, void *ctx, const void *buf,
+		   uint size);
+
+/**
+ * dm_hash_poll() - Check whether submitted data has been hashed
+ *
+ * @dev:	Device to use
+ * @ctx:	Context from dm_hash_init()
+ * @return 0 if nothing is outstanding, -EBUSY if the engine is still
+ *	working, other -ve value on error
+ */
+int dm_hash_poll(struct udevice *dev, void *ctx);
+
+/**
+ * dm_hash_wait() - Wait until submitted data has been hashed
+ *
+ * The watchdog is kept alive while waiting.
+ *
+ * @dev:	Device to use
+ * @ctx:	Context from dm_hash_init()
+ * @return 0 if OK, -ETIMEDOUT if the engine did not finish, other -ve
+ *	value on error
+ */
+int dm_hash_wait(struct udevice *dev, void *ctx);
+
+/**
+ * dm_hash_finish() - Finish a hash and free the context
+ *
+ * This waits for any submitted data first.
+ *
+ * @dev:	Device to use
+ * @ctx:	Context from dm_hash_init(), which is freed even on error
+ * @digest:	Place to put the digest, dm_hash_digest_size() bytes
+ * @return 0 if OK, -ve on error
+ */
+int dm_hash_finish(struct udevice *dev, void *ctx, void *digest);
+
+/**
+ * dm_hash_digest() - Hash a buffer in one go
+ *
+ * @dev:	Device to use
+ * @algo:	Algorithm to use
+ * @buf:	Data to hash
+ * @size:	Size of data in bytes
+ * @digest:	Place to put the digest, dm_hash_digest_size() bytes
+ * @return 0 if OK, -ve on error
+ */
+int dm_hash_digest(struct udevice *dev, enum hash_algo_id algo,
+		   const void *buf, uint size, void *digest);
+
+/**
+ * dm_hash_find() - Find a hash engine which supports an algorithm
+ *
+ * @algo:	Algorithm required
+ * @devp:	Returns the first device supporting @algo
+ * @return 0 if OK, -ENODEV if there is none
+ */
+int dm_hash_find(enum hash_algo_id algo, struct udevice **devp);
+
+/**
+ * dm_hash_lookup_algo() - Look up an algorithm by name
+ *
+ * @name:	Name of algorithm, e.g. "sha256"
+ * @return algorithm ID, or -EPROTONOSUPPORT if hash engines do not know it
+ */
+int dm_hash_lookup_algo(const char *name);
+
+/**
+ * dm_hash_digest_size() - Get the size of the digest for an algorithm
+ *
+ * @algo:	Algorithm to check
+ * @return size of digest in bytes
+ */
+int dm_hash_digest_size(enum hash_algo_id algo);
+
+/**
+ * dm_hash_block() - Hash a buffer with a hash engine if there is one
+ *
+ * This looks for a hash engine which supports the algorithm and uses it to
+ * hash the whole buffer.
+ *
+ * @algo_name:	Name of algorithm, e.g. "sha256"
+ * @buf:	Data to hash
+ * @size:	Size of data in bytes
+ * @digest:	Place to put the digest
+ * @digest_size: Returns the size of the digest in bytes, if not NULL
+ * @return 0 if OK, -EPROTONOSUPPORT or -ENODEV if there is no hash engine
+ *	for this algorithm (so software should be used), other -ve on error
+ */
+int dm_hash_block(const char *algo_name, const void *buf, uint size,
+		  void *digest, int *digest_size);
+
+#endif /* _U_BOOT_HASH_H */
@@ -95,6 +95,20 @@ void sha1_hmac(const unsigned char *key, int keylen,
 		const unsigned char *input, unsigned int ilen,
 		unsigned char *output);
 
+/**
+ * \brief	   Hash whole blocks using CPU instructions
+ *
+ * Provided by architectures which select SHA_ARCH. Whether the CPU has
+ * the instructions is checked on each call.
+ *
+ * \param state    five words of hash state to update
+ * \param data     data to hash
+ * \param blocks   number of 64-byte blocks in data
+ * \return	   0 if OK, -ENOSYS if the CPU lacks the instructions
+ */
+int arch_sha1_blocks(uint32_t state[5], const unsigned char *data,
+		     unsigned int blocks);
+
 /**
  * \brief	   Checkup routine
  *
@@ -22,4 +22,18 @@ void sha256_finish(sha256_context * ctx, uint8_t digest[SHA256_SUM_LEN]);
 void sha256_csum_wd(const unsigned char *input, unsigned int ilen,
 		unsigned char *output, unsigned int chunk_sz);
 
+/**
+ * arch_sha256_blocks() - Hash whole blocks using CPU instructions
+ *
+ * Provided by architectures which select SHA_ARCH. Whether the CPU has the
+ * instructions is checked on each call.
+ *
+ * @state:	Eight words of hash state to update
+ * @data:	Data to hash
+ * @blocks:	Number of 64-byte blocks in @data
+ * @return 0 if OK, -ENOSYS if this CPU does not have the instructions
+ */
+int arch_sha256_blocks(uint32_t state[8], const uint8_t *data,
+		       unsigned int blocks);
+
 #endif /* _SHA256_H */
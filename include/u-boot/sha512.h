@@ -0,0 +1,37 @@
+#ifndef _SHA512_H
+#define _SHA512_H
+
+#define SHA384_SUM_LEN	48
+#define SHA384_DER_LEN	19
+#define SHA512_SUM_LEN	64
+#define SHA512_DER_LEN	19
+
+extern const uint8_t sha384_der_prefix[];
+extern const uint8_t sha512_der_prefix[];
+
+/* Reset watchdog each time we process this many bytes */
+#define CHUNKSZ_SHA384	(64 * 1024)
+#define CHUNKSZ_SHA512	(64 * 1024)
+
+/* SHA-384 is SHA-512 with other initial values, truncated to 48 bytes */
+typedef struct {
+	uint64_t total[2];
+	uint64_t state[8];
+	uint8_t buffer[128];
+} sha512_context;
+
+void sha512_starts(sha512_context *ctx);
+void sha512_update(sha512_context *ctx, const uint8_t *input, uint32_t length);
+void sha512_finish(sha512_context *ctx, uint8_t digest[SHA512_SUM_LEN]);
+
+void sha512_csum_wd(const unsigned char *input, unsigned int ilen,
+		unsigned char *output, unsigned int chunk_sz);
+
+void sha384_starts(sha512_context *ctx);
+#define sha384_update	sha512_update
+void sha384_finish(sha512_context *ctx, uint8_t digest[SHA384_SUM_LEN]);
+
+void sha384_csum_wd(const unsigned char *input, unsigned int ilen,
+		unsigned char *output, unsigned int chunk_sz);
+
+#endif /* _SHA512_H */
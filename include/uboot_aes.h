@@ -16,19 +16,51 @@ typedef unsigned int u32;
 #endif
 
 /*
- * AES encryption library, with small code size, supporting only 128-bit AES
+ * AES encryption library
  *
- * AES is a stream cipher which works a block at a time, with each block
- * in this case being AES_KEY_LENGTH bytes.
+ * AES is a block cipher which works a block at a time, with each block
+ * being AES_BLOCK_LENGTH bytes. The aes_expand_key() functions below only
+ * support 128-bit keys and CBC mode with a zero initial vector; the
+ * struct aes_ctx functions support 128-, 192- and 256-bit keys, CBC and CTR
+ * modes, and use CPU instructions where the architecture provides them.
  */
 
 enum {
 	AES_STATECOLS	= 4,	/* columns in the state & expanded key */
 	AES_KEYCOLS	= 4,	/* columns in a key */
 	AES_ROUNDS	= 10,	/* rounds in encryption */
+	AES_MAX_ROUNDS	= 14,	/* rounds in encryption with a 256-bit key */
 
 	AES_KEY_LENGTH	= 128 / 8,
 	AES_EXPAND_KEY_LENGTH	= 4 * AES_STATECOLS * (AES_ROUNDS + 1),
+
+	AES_BLOCK_LENGTH	= 128 / 8,
+	AES128_KEY_LENGTH	= 128 / 8,
+	AES192_KEY_LENGTH	= 192 / 8,
+	AES256_KEY_LENGTH	= 256 / 8,
+};
+
+/**
+ * struct aes_ctx - Key schedules for one AES key
+ *
+ * Each round key is four 32-bit columns, with the first byte of a column
+ * in the bottom bits. On little-endian machines this is the byte order
+ * used by the standard and by CPU instructions.
+ *
+ * @enc_key:	Round keys for encryption
+ * @dec_key:	Round keys for decryption, in the order they are used, with
+ *		InvMixColumns applied to all but the first and last
+ * @rounds:	Number of rounds: 10, 12 or 14
+ */
+struct aes_ctx {
+	u32 enc_key[AES_STATECOLS * (AES_MAX_ROUNDS + 1)];
+	u32 dec_key[AES_STATECOLS * (AES_MAX_ROUNDS + 1)];
+	int rounds;
+};
+
+enum aes_mode {
+	AES_MODE_CBC,
+	AES_MODE_CTR,
 };
 
 /**
@@ -91,4 +123,121 @@ void aes_cbc_encrypt_blocks(u8 *key_exp, u8 *src, u8 *dst, u32 num_aes_blocks);
  */
 void aes_cbc_decrypt_blocks(u8 *key_exp, u8 *src, u8 *dst, u32 num_aes_blocks);
 
+/**
+ * aes_setkey() - Set up the key schedules for a key
+ *
+ * @ctx:	Context to set up
+ * @key:	Key, of length @key_len
+ * @key_len:	AES128_KEY_LENGTH, AES192_KEY_LENGTH or AES256_KEY_LENGTH
+ * @return 0 if OK, -EINVAL if @key_len is not valid
+ */
+int aes_setkey(struct aes_ctx *ctx, const u8 *key, int key_len);
+
+/**
+ * aes_cbc_encrypt() - Encrypt multiple blocks of data with AES CBC
+ *
+ * @ctx:	Key to use
+ * @iv:		Initial vector, AES_BLOCK_LENGTH bytes. This is updated so that
+ *		a following call continues the same stream.
+ * @src:	Source data to encrypt
+ * @dst:	Destination buffer, which may be the same as @src
+ * @num_aes_blocks: Number of AES blocks to encrypt
+ */
+void aes_cbc_encrypt(const struct aes_ctx *ctx, u8 *iv, const u8 *src,
+		     u8 *dst, u32 num_aes_blocks);
+
+/**
+ * aes_cbc_decrypt() - Decrypt multiple blocks of data with AES CBC
+ *
+ * @ctx:	Key to use
+ * @iv:		Initial vector, AES_BLOCK_LENGTH bytes. This is updated so that
+ *		a following call continues the same stream.
+ * @src:	Source data to decrypt
+ * @dst:	Destination buffer, which may be the same as @src
+ * @num_aes_blocks: Number of AES blocks to decrypt
+ */
+void aes_cbc_decrypt(const struct aes_ctx *ctx, u8 *iv, const u8 *src,
+		     u8 *dst, u32 num_aes_blocks);
+
+/**
+ * aes_ctr_crypt() - Encrypt or decrypt data with AES CTR
+ *
+ * The whole of @ctr is incremented as a big-endian number after each
+ * block. A final partial block uses the start of the next key stream block;
+ * only the last call for a stream may have a @len which is not a multiple
+ * of AES_BLOCK_LENGTH.
+ *
+ * @ctx:	Key to use
+ * @ctr:	Counter block, AES_BLOCK_LENGTH bytes, updated
+ * @src:	Source data
+ * @dst:	Destination buffer, which may be the same as @src
+ * @len:	Number of bytes to process
+ */
+void aes_ctr_crypt(const struct aes_ctx *ctx, u8 *ctr, const u8 *src, u8 *dst,
+		   u32 len);
+
+struct hash_algo;
+
+/**
+ * aes_hash_decrypt() - Hash and decrypt data, a chunk at a time
+ *
+ * This hashes the encrypted data, as a FIT hash node over an encrypted image
+ * would, and decrypts it. Both are done a chunk at a time so that the data
+ * is only read from memory once, which matters for large images.
+ *
+ * @ctx:	Key to use
+ * @mode:	Cipher mode
+ * @iv:		Initial vector (CBC) or counter block (CTR), updated
+ * @src:	Encrypted data
+ * @dst:	Destination buffer, which may be the same as @src
+ * @len:	Number of bytes. For CBC this must be a multiple of
+ *		AES_BLOCK_LENGTH.
+ * @algo:	Hash algorithm, which must support progressive hashing
+ * @hash:	Place to put the hash of the encrypted data
+ * @hash_size:	Size of the @hash buffer
+ * @return 0 if OK, -EINVAL if @len is not valid for @mode or @hash_size
+ *	is too small for @algo, -EIO on hash error
+ */
+int aes_hash_decrypt(const struct aes_ctx *ctx, enum aes_mode mode, u8 *iv,
+		     const u8 *src, u8 *dst, u32 len, struct hash_algo *algo,
+		     u8 *hash, int hash_size);
+
+/*
+ * Provided by architectures which select AES_ARCH. Whether the CPU has the
+ * instructions is checked on each call; each returns 0 if OK, or -ENOSYS
+ * if this CPU does not have the instructions.
+ */
+
+/**
+ * arch_aes_encrypt_blocks() - Encrypt independent blocks (ECB)
+ *
+ * @ctx:	Key to use
+ * @src:	Source data
+ * @dst:	Destination buffer, which may be the same as @src
+ * @blocks:	Number of AES blocks
+ * @return 0 if OK, -ENOSYS if this CPU does not have the instructions
+ */
+int arch_aes_encrypt_blocks(const struct aes_ctx *ctx, const u8 *src, u8 *dst,
+			    u32 blocks);
+
+/**
+ * arch_aes_cbc_encrypt() - Encrypt blocks with AES CBC
+ *
+ * Arguments are as for aes_cbc_encrypt().
+ *
+ * @return 0 if OK, -ENOSYS if this CPU does not have the instructions
+ */
+int arch_aes_cbc_encrypt(const struct aes_ctx *ctx, u8 *iv, const u8 *src,
+			 u8 *dst, u32 blocks);
+
+/**
+ * arch_aes_cbc_decrypt() - Decrypt blocks with AES CBC
+ *
+ * Arguments are as for aes_cbc_decrypt().
+ *
+ * @return 0 if OK, -ENOSYS if this CPU does not have the instructions
+ */
+int arch_aes_cbc_decrypt(const struct aes_ctx *ctx, u8 *iv, const u8 *src,
+			 u8 *dst, u32 blocks);
+
 #endif /* _AES_REF_H_ */
@@ -0,0 +1,452 @@
+/*
+ * ECDSA signing and public key export for mkimage
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include "mkimage.h"
+#include <stdio.h>
+#include <string.h>
+#include <image.h>
+#include <openssl/bn.h>
+#include <openssl/ec.h>
+#include <openssl/ecdsa.h>
+#include <openssl/err.h>
+#include <openssl/evp.h>
+#include <openssl/objects.h>
+#include <openssl/pem.h>
+#include <openssl/x509.h>
+#include <u-boot/ecdsa.h>
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+#include <openssl/core_names.h>
+#endif
+
+#if OPENSSL_VERSION_NUMBER < 0x10100000L
+static void ECDSA_SIG_get0(const ECDSA_SIG *sig, const BIGNUM **pr,
+			   const BIGNUM **ps)
+{
+	if (pr != NULL)
+		*pr = sig->r;
+	if (ps != NULL)
+		*ps = sig->s;
+}
+
+static int BN_bn2binpad(const BIGNUM *a, unsigned char *to, int tolen)
+{
+	int len = BN_num_bytes(a);
+
+	if (len > tolen)
+		return -1;
+	memset(to, '\0', tolen - len);
+	BN_bn2bin(a, to + tolen - len);
+
+	return tolen;
+}
+#endif
+
+static void ecdsa_err(const char *msg)
+{
+	unsigned long sslErr = ERR_get_error();
+
+	fprintf(stderr, "%s", msg);
+	fprintf(stderr, ": %s\n",
+		ERR_error_string(sslErr, 0));
+}
+
+/*
+ * ecdsa_get_curve() - get the NID of the curve of an EC key
+ *
+ * Returns NID_undef if the key is not an EC key on a named curve.
+ */
+static int ecdsa_get_curve(EVP_PKEY *key)
+{
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+	char name[80];
+
+	if (EVP_PKEY_base_id(key) != EVP_PKEY_EC ||
+	    !EVP_PKEY_get_group_name(key, name, sizeof(name), NULL))
+		return NID_undef;
+
+	return OBJ_txt2nid(name);
+#else
+	EC_KEY *ec = EVP_PKEY_get1_EC_KEY(key);
+	int nid;
+
+	if (!ec)
+		return NID_undef;
+	nid = EC_GROUP_get_curve_name(EC_KEY_get0_group(ec));
+	EC_KEY_free(ec);
+
+	return nid;
+#endif
+}
+
+/**
+ * ecdsa_check_key() - check that a key is on the curve for an algorithm
+ *
+ * @info:	Specifies key and FIT information
+ * @key:	Key to check
+ * @return 0 if ok, -EINVAL if the key is not on the expected curve
+ */
+static int ecdsa_check_key(struct image_sign_info *info, EVP_PKEY *key)
+{
+	int nid = ecdsa_get_curve(key);
+
+	if ((nid == NID_X9_62_prime256v1 &&
+	     info->crypto->key_len == ECDSA256_BYTES) ||
+	    (nid == NID_secp384r1 && info->crypto->key_len == ECDSA384_BYTES))
+		return 0;
+
+	fprintf(stderr, "Key '%s' is on curve '%s', which cannot be used for %s\n",
+		info->keyname, nid ? OBJ_nid2sn(nid) : "(unnamed)",
+		info->crypto->name);
+
+	return -EINVAL;
+}
+
+/**
+ * ecdsa_pem_get_pub_key() - read a public key from a .crt file
+ *
+ * @keydir:	Directory containing the key
+ * @name	Name of key file (will have a .crt extension)
+ * @keyp	Returns EVP_PKEY object, or NULL on failure
+ * @return 0 if ok, -ve on error (in which case *keyp will be set to NULL)
+ */
+static int ecdsa_pem_get_pub_key(const char *keydir, const char *name,
+				 EVP_PKEY **keyp)
+{
+	char path[1024];
+	EVP_PKEY *key;
+	X509 *cert;
+	FILE *f;
+	int ret;
+
+	*keyp = NULL;
+	snprintf(path, sizeof(path), "%s/%s.crt", keydir, name);
+	f = fopen(path, "r");
+	if (!f) {
+		fprintf(stderr, "Couldn't open ECDSA certificate: '%s': %s\n",
+			path, strerror(errno));
+		return -EACCES;
+	}
+
+	/* Read the certificate */
+	cert = NULL;
+	if (!PEM_read_X509(f, &cert, NULL, NULL)) {
+		ecdsa_err("Couldn't read certificate");
+		ret = -EINVAL;
+		goto err_cert;
+	}
+
+	/* Get the public key from the certificate. */
+	key = X509_get_pubkey(cert);
+	if (!key) {
+		ecdsa_err("Couldn't read public key\n");
+		ret = -EINVAL;
+		goto err_pubkey;
+	}
+	fclose(f);
+	X509_free(cert);
+	*keyp = key;
+
+	return 0;
+
+err_pubkey:
+	X509_free(cert);
+err_cert:
+	fclose(f);
+	return ret;
+}
+
+/**
+ * ecdsa_pem_get_priv_key() - read a private key from a .key file
+ *
+ * @keydir:	Directory containing the key
+ * @name	Name of key file (will have a .key extension)
+ * @keyp	Returns EVP_PKEY object, or NULL on failure
+ * @return 0 if ok, -ve on error (in which case *keyp will be set to NULL)
+ */
+static int ecdsa_pem_get_priv_key(const char *keydir, const char *name,
+				  EVP_PKEY **keyp)
+{
+	char path[1024];
+	EVP_PKEY *key;
+	FILE *f;
+
+	*keyp = NULL;
+	snprintf(path, sizeof(path), "%s/%s.key", keydir, name);
+	f = fopen(path, "r");
+	if (!f) {
+		fprintf(stderr, "Couldn't open ECDSA private key: '%s': %s\n",
+			path, strerror(errno));
+		return -ENOENT;
+	}
+
+	key = PEM_read_PrivateKey(f, NULL, NULL, path);
+	if (!key) {
+		ecdsa_err("Failure reading private key");
+		fclose(f);
+		return -EPROTO;
+	}
+	fclose(f);
+	*keyp = key;
+
+	return 0;
+}
+
+/*
+ * ecdsa_do_sign() - sign a hash, returning the signature as an ECDSA_SIG
+ *
+ * EVP_PKEY_sign() produces a DER-encoded signature, so decode that to get
+ * at r and s.
+ */
+static ECDSA_SIG *ecdsa_do_sign(EVP_PKEY *key, const uint8_t *hash,
+				int hash_len)
+{
+	ECDSA_SIG *esig = NULL;
+	const unsigned char *p;
+	unsigned char *der;
+	EVP_PKEY_CTX *ctx;
+	size_t der_len;
+
+	ctx = EVP_PKEY_CTX_new(key, NULL);
+	if (!ctx)
+		return NULL;
+	if (EVP_PKEY_sign_init(ctx) <= 0 ||
+	    EVP_PKEY_sign(ctx, NULL, &der_len, hash, hash_len) <= 0)
+		goto err_ctx;
+	der = malloc(der_len);
+	if (!der)
+		goto err_ctx;
+	if (EVP_PKEY_sign(ctx, der, &der_len, hash, hash_len) > 0) {
+		p = der;
+		esig = d2i_ECDSA_SIG(NULL, &p, der_len);
+	}
+	free(der);
+err_ctx:
+	EVP_PKEY_CTX_free(ctx);
+
+	return esig;
+}
+
+static int ecdsa_sign_with_key(EVP_PKEY *key, struct image_sign_info *info,
+		const struct image_region region[], int region_count,
+		uint8_t **sigp, uint *sig_size)
+{
+	const int len = info->crypto->key_len;
+	uint8_t hash[FIT_MAX_HASH_LEN];
+	const BIGNUM *r, *s;
+	ECDSA_SIG *esig;
+	uint8_t *sig;
+	int ret;
+
+	ret = info->checksum->calculate(info->checksum->name, region,
+					region_count, hash);
+	if (ret) {
+		fprintf(stderr, "Failed to hash data to sign\n");
+		return -EINVAL;
+	}
+
+	esig = ecdsa_do_sign(key, hash, info->checksum->checksum_len);
+	if (!esig) {
+		ecdsa_err("Could not obtain signature");
+		return -EINVAL;
+	}
+
+	sig = malloc(len * 2);
+	if (!sig) {
+		fprintf(stderr, "Out of memory for signature (%d bytes)\n",
+			len * 2);
+		ret = -ENOMEM;
+		goto err_alloc;
+	}
+
+	/* Store r and s as fixed-size big-endian values */
+	ECDSA_SIG_get0(esig, &r, &s);
+	if (BN_bn2binpad(r, sig, len) != len ||
+	    BN_bn2binpad(s, sig + len, len) != len) {
+		ecdsa_err("Could not convert signature");
+		ret = -EINVAL;
+		free(sig);
+		goto err_alloc;
+	}
+	ECDSA_SIG_free(esig);
+
+	*sigp = sig;
+	*sig_size = len * 2;
+
+	return 0;
+
+err_alloc:
+	ECDSA_SIG_free(esig);
+	return ret;
+}
+
+int ecdsa_sign(struct image_sign_info *info,
+	       const struct image_region region[], int region_count,
+	       uint8_t **sigp, uint *sig_len)
+{
+	EVP_PKEY *key;
+	int ret;
+
+	if (info->engine_id) {
+		fprintf(stderr, "ECDSA signing does not support engines\n");
+		return -ENOTSUP;
+	}
+
+	ret = ecdsa_pem_get_priv_key(info->keydir, info->keyname, &key);
+	if (ret)
+		return ret;
+	ret = ecdsa_check_key(info, key);
+	if (!ret)
+		ret = ecdsa_sign_with_key(key, info, region, region_count,
+					  sigp, sig_len);
+	EVP_PKEY_free(key);
+
+	return ret;
+}
+
+/*
+ * ecdsa_get_point() - get the coordinates of the public point of a key
+ *
+ * Returns 0 if ok, with *xp and *yp set to new BIGNUMs, else -EINVAL.
+ */
+static int ecdsa_get_point(EVP_PKEY *key, BIGNUM **xp, BIGNUM **yp)
+{
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+	if (EVP_PKEY_get_bn_param(key, OSSL_PKEY_PARAM_EC_PUB_X, xp) &&
+	    EVP_PKEY_get_bn_param(key, OSSL_PKEY_PARAM_EC_PUB_Y, yp))
+		return 0;
+#else
+	EC_KEY *ec = EVP_PKEY_get1_EC_KEY(key);
+	const EC_POINT *point = ec ? EC_KEY_get0_public_key(ec) : NULL;
+	int ok;
+
+	*xp = BN_new();
+	*yp = BN_new();
+	ok = *xp && *yp && point &&
+	     EC_POINT_get_affine_coordinates_GFp(EC_KEY_get0_group(ec), point,
+						 *xp, *yp, NULL);
+	EC_KEY_free(ec);
+	if (ok)
+		return 0;
+#endif
+	BN_free(*xp);
+	BN_free(*yp);
+	*xp = NULL;
+	*yp = NULL;
+
+	return -EINVAL;
+}
+
+/*
+ * fdt_add_point(): - Add the x and y coordinates of a point to the FDT
+ */
+static int fdt_add_point(void *blob, int noffset, EVP_PKEY *key, int len)
+{
+	uint8_t buf[ECDSA384_BYTES];
+	BIGNUM *x = NULL, *y = NULL;
+	int ret = -EINVAL;
+
+	if (ecdsa_get_point(key, &x, &y)) {
+		fprintf(stderr, "Could not read public key point\n");
+		goto done;
+	}
+
+	if (BN_bn2binpad(x, buf, len) != len)
+		goto done;
+	ret = fdt_setprop(blob, noffset, "ecdsa,x-point", buf, len);
+	if (ret)
+		goto done;
+	if (BN_bn2binpad(y, buf, len) != len) {
+		ret = -EINVAL;
+		goto done;
+	}
+	ret = fdt_setprop(blob, noffset, "ecdsa,y-point", buf, len);
+done:
+	BN_free(x);
+	BN_free(y);
+
+	return ret;
+}
+
+int ecdsa_add_verify_data(struct image_sign_info *info, void *keydest)
+{
+	int parent, node;
+	char name[100];
+	EVP_PKEY *key;
+	int ret;
+	int nid;
+
+	debug("%s: Getting verification data\n", __func__);
+	if (info->engine_id) {
+		fprintf(stderr, "ECDSA signing does not support engines\n");
+		return -ENOTSUP;
+	}
+	ret = ecdsa_pem_get_pub_key(info->keydir, info->keyname, &key);
+	if (ret)
+		return ret;
+	ret = ecdsa_check_key(info, key);
+	if (ret)
+		goto err_check_key;
+	nid = ecdsa_get_curve(key);
+
+	parent = fdt_subnode_offset(keydest, 0, FIT_SIG_NODENAME);
+	if (parent == -FDT_ERR_NOTFOUND) {
+		parent = fdt_add_subnode(keydest, 0, FIT_SIG_NODENAME);
+		if (parent < 0) {
+			ret = parent;
+			if (ret != -FDT_ERR_NOSPACE) {
+				fprintf(stderr, "Couldn't create signature node: %s\n",
+					fdt_strerror(parent));
+			}
+		}
+	}
+	if (ret)
+		goto done;
+
+	/* Either create or overwrite the named key node */
+	snprintf(name, sizeof(name), "key-%s", info->keyname);
+	node = fdt_subnode_offset(keydest, parent, name);
+	if (node == -FDT_ERR_NOTFOUND) {
+		node = fdt_add_subnode(keydest, parent, name);
+		if (node < 0) {
+			ret = node;
+			if (ret != -FDT_ERR_NOSPACE) {
+				fprintf(stderr, "Could not create key subnode: %s\n",
+					fdt_strerror(node));
+			}
+		}
+	} else if (node < 0) {
+		fprintf(stderr, "Cannot select keys parent: %s\n",
+			fdt_strerror(node));
+		ret = node;
+	}
+
+	if (!ret) {
+		ret = fdt_setprop_string(keydest, node, "key-name-hint",
+				 info->keyname);
+	}
+	if (!ret) {
+		ret = fdt_setprop_string(keydest, node, "ecdsa,curve",
+					 OBJ_nid2sn(nid));
+	}
+	if (!ret)
+		ret = fdt_add_point(keydest, node, key, info->crypto->key_len);
+	if (!ret) {
+		ret = fdt_setprop_string(keydest, node, FIT_ALGO_PROP,
+					 info->name);
+	}
+	if (!ret && info->require_keys) {
+		ret = fdt_setprop_string(keydest, node, "required",
+					 info->require_keys);
+	}
+done:
+	if (ret)
+		ret = ret == -FDT_ERR_NOSPACE ? -ENOSPC : -EIO;
+err_check_key:
+	EVP_PKEY_free(key);
+
+	return ret;
+}
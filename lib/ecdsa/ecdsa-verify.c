@@ -0,0 +1,775 @@
+/*
+ * ECDSA signature verification on the NIST P-256 and P-384 curves
+ *
+ * Field elements are little-endian arrays of 32-bit words, kept in
+ * Montgomery form. Points use projective coordinates and the complete
+ * addition formula of Renes, Costello and Batina ("Complete addition
+ * formulas for prime order elliptic curves", algorithm 4), which also
+ * handles doubling and the point at infinity. Together with constant-time
+ * modular reduction and table lookups, the sequence of operations and
+ * memory accesses does not depend on the values being processed.
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#ifndef USE_HOSTCC
+#include <common.h>
+#include <fdtdec.h>
+#include <linux/errno.h>
+#else
+#include "fdt_host.h"
+#include "mkimage.h"
+#include <fdt_support.h>
+#endif
+#include <u-boot/ecdsa.h>
+
+#define ECDSA_MAX_WORDS		(384 / 32)
+
+/**
+ * struct ecdsa_mod - Modulus for Montgomery arithmetic
+ *
+ * @words:	Number of 32-bit words in the modulus
+ * @m:		Modulus, as little endian word array
+ * @m0inv:	-1 / m[0] mod 2^32
+ * @rr:		R^2 mod m, where R = 2^(32 * words)
+ */
+struct ecdsa_mod {
+	int words;
+	const uint32_t *m;
+	uint32_t m0inv;
+	uint32_t rr[ECDSA_MAX_WORDS];
+};
+
+/**
+ * struct ecdsa_curve - A short Weierstrass curve y^2 = x^3 - 3x + b
+ *
+ * @name:	Curve name, as in the key's "ecdsa,curve" property
+ * @words:	Number of 32-bit words in values on this curve
+ * @p:		Field prime
+ * @n:		Order of the base point
+ * @b:		Curve parameter b
+ * @gx:		Base point x coordinate
+ * @gy:		Base point y coordinate
+ */
+struct ecdsa_curve {
+	const char *name;
+	int words;
+	const uint32_t *p;
+	const uint32_t *n;
+	const uint32_t *b;
+	const uint32_t *gx;
+	const uint32_t *gy;
+};
+
+/* A point in projective coordinates, in Montgomery form */
+struct ecdsa_point {
+	uint32_t x[ECDSA_MAX_WORDS];
+	uint32_t y[ECDSA_MAX_WORDS];
+	uint32_t z[ECDSA_MAX_WORDS];
+};
+
+/**
+ * struct ecdsa_ctx - Everything needed for arithmetic on one curve
+ *
+ * @curve:	Curve parameters
+ * @fp:		Field prime modulus
+ * @fn:		Group order modulus
+ * @b:		Curve parameter b in Montgomery form
+ * @one:	1 in Montgomery form modulo p
+ */
+struct ecdsa_ctx {
+	const struct ecdsa_curve *curve;
+	struct ecdsa_mod fp;
+	struct ecdsa_mod fn;
+	uint32_t b[ECDSA_MAX_WORDS];
+	uint32_t one[ECDSA_MAX_WORDS];
+};
+
+/* Curve parameters from SEC 2, as little endian word arrays */
+static const uint32_t p256_p[] = {
+	0xffffffff, 0xffffffff, 0xffffffff, 0x00000000,
+	0x00000000, 0x00000000, 0x00000001, 0xffffffff,
+};
+
+static const uint32_t p256_n[] = {
+	0xfc632551, 0xf3b9cac2, 0xa7179e84, 0xbce6faad,
+	0xffffffff, 0xffffffff, 0x00000000, 0xffffffff,
+};
+
+static const uint32_t p256_b[] = {
+	0x27d2604b, 0x3bce3c3e, 0xcc53b0f6, 0x651d06b0,
+	0x769886bc, 0xb3ebbd55, 0xaa3a93e7, 0x5ac635d8,
+};
+
+static const uint32_t p256_gx[] = {
+	0xd898c296, 0xf4a13945, 0x2deb33a0, 0x77037d81,
+	0x63a440f2, 0xf8bce6e5, 0xe12c4247, 0x6b17d1f2,
+};
+
+static const uint32_t p256_gy[] = {
+	0x37bf51f5, 0xcbb64068, 0x6b315ece, 0x2bce3357,
+	0x7c0f9e16, 0x8ee7eb4a, 0xfe1a7f9b, 0x4fe342e2,
+};
+
+static const uint32_t p384_p[] = {
+	0xffffffff, 0x00000000, 0x00000000, 0xffffffff,
+	0xfffffffe, 0xffffffff, 0xffffffff, 0xffffffff,
+	0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff,
+};
+
+static const uint32_t p384_n[] = {
+	0xccc52973, 0xecec196a, 0x48b0a77a, 0x581a0db2,
+	0xf4372ddf, 0xc7634d81, 0xffffffff, 0xffffffff,
+	0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff,
+};
+
+static const uint32_t p384_b[] = {
+	0xd3ec2aef, 0x2a85c8ed, 0x8a2ed19d, 0xc656398d,
+	0x5013875a, 0x0314088f, 0xfe814112, 0x181d9c6e,
+	0xe3f82d19, 0x988e056b, 0xe23ee7e4, 0xb3312fa7,
+};
+
+static const uint32_t p384_gx[] = {
+	0x72760ab7, 0x3a545e38, 0xbf55296c, 0x5502f25d,
+	0x82542a38, 0x59f741e0, 0x8ba79b98, 0x6e1d3b62,
+	0xf320ad74, 0x8eb1c71e, 0xbe8b0537, 0xaa87ca22,
+};
+
+static const uint32_t p384_gy[] = {
+	0x90ea0e5f, 0x7a431d7c, 0x1d7e819d, 0x0a60b1ce,
+	0xb5f0b8c0, 0xe9da3113, 0x289a147c, 0xf8f41dbd,
+	0x9292dc29, 0x5d9e98bf, 0x96262c6f, 0x3617de4a,
+};
+
+static const struct ecdsa_curve ecdsa_curves[] = {
+	{ "prime256v1", 256 / 32, p256_p, p256_n, p256_b, p256_gx, p256_gy },
+	{ "secp384r1", 384 / 32, p384_p, p384_n, p384_b, p384_gx, p384_gy },
+};
+
+/**
+ * bn_add() - Add two numbers
+ *
+ * @r:		Place to put result, may be the same as @a or @b
+ * @a:		First number
+ * @b:		Second number
+ * @words:	Number of words in each number
+ * @return carry out of the top word, 0 or 1
+ */
+static uint32_t bn_add(uint32_t *r, const uint32_t *a, const uint32_t *b,
+		       int words)
+{
+	uint64_t acc = 0;
+	int i;
+
+	for (i = 0; i < words; i++) {
+		acc += (uint64_t)a[i] + b[i];
+		r[i] = (uint32_t)acc;
+		acc >>= 32;
+	}
+
+	return (uint32_t)acc;
+}
+
+/**
+ * bn_sub() - Subtract one number from another
+ *
+ * @r:		Place to put result, may be the same as @a or @b
+ * @a:		Number to subtract from
+ * @b:		Number to subtract
+ * @words:	Number of words in each number
+ * @return borrow out of the top word, 0 or 1
+ */
+static uint32_t bn_sub(uint32_t *r, const uint32_t *a, const uint32_t *b,
+		       int words)
+{
+	int64_t acc = 0;
+	int i;
+
+	for (i = 0; i < words; i++) {
+		acc += (int64_t)a[i] - b[i];
+		r[i] = (uint32_t)acc;
+		acc >>= 32;
+	}
+
+	return (uint32_t)acc & 1;
+}
+
+/**
+ * bn_select() - Copy one of two numbers without branching on the choice
+ *
+ * @r:		Place to put result, may be the same as @a or @b
+ * @a:		Number to copy if @sel is 1
+ * @b:		Number to copy if @sel is 0
+ * @sel:	0 or 1
+ * @words:	Number of words in each number
+ */
+static void bn_select(uint32_t *r, const uint32_t *a, const uint32_t *b,
+		      uint32_t sel, int words)
+{
+	uint32_t mask = 0 - sel;
+	int i;
+
+	for (i = 0; i < words; i++)
+		r[i] = (a[i] & mask) | (b[i] & ~mask);
+}
+
+/* Return 1 if the number is zero, else 0, without branching on it */
+static uint32_t bn_is_zero(const uint32_t *a, int words)
+{
+	uint32_t acc = 0;
+	int i;
+
+	for (i = 0; i < words; i++)
+		acc |= a[i];
+
+	return ((uint64_t)acc - 1) >> 63;
+}
+
+/* Return 1 if a < b, else 0, without branching on the values */
+static uint32_t bn_less(const uint32_t *a, const uint32_t *b, int words)
+{
+	uint32_t tmp[ECDSA_MAX_WORDS];
+
+	return bn_sub(tmp, a, b, words);
+}
+
+/**
+ * bn_from_bytes() - Convert a big endian byte array to a number
+ *
+ * @r:		Place to put result, as little endian word array
+ * @data:	Big endian bytes, 4 * @words of them
+ * @words:	Number of words in the result
+ */
+static void bn_from_bytes(uint32_t *r, const uint8_t *data, int words)
+{
+	int i;
+
+	for (i = 0; i < words; i++, data += 4)
+		r[words - 1 - i] = (uint32_t)data[0] << 24 |
+				   (uint32_t)data[1] << 16 |
+				   (uint32_t)data[2] << 8 | data[3];
+}
+
+/* r = a + b mod m, for a, b < m */
+static void mod_add(const struct ecdsa_mod *md, uint32_t *r,
+		    const uint32_t *a, const uint32_t *b)
+{
+	uint32_t tmp[ECDSA_MAX_WORDS];
+	uint32_t carry, borrow;
+
+	carry = bn_add(r, a, b, md->words);
+	borrow = bn_sub(tmp, r, md->m, md->words);
+	bn_select(r, tmp, r, carry | (borrow ^ 1), md->words);
+}
+
+/* r = a - b mod m, for a, b < m */
+static void mod_sub(const struct ecdsa_mod *md, uint32_t *r,
+		    const uint32_t *a, const uint32_t *b)
+{
+	uint32_t tmp[ECDSA_MAX_WORDS];
+	uint32_t borrow;
+
+	borrow = bn_sub(r, a, b, md->words);
+	bn_add(tmp, r, md->m, md->words);
+	bn_select(r, tmp, r, borrow, md->words);
+}
+
+/**
+ * mod_mul() - Montgomery multiplication
+ *
+ * Operation: r = a * b / R mod m
+ *
+ * @md:		Modulus
+ * @r:		Place to put result, may be the same as @a or @b
+ * @a:		Multiplier, less than m
+ * @b:		Multiplicand, less than m
+ */
+static void mod_mul(const struct ecdsa_mod *md, uint32_t *r,
+		    const uint32_t *a, const uint32_t *b)
+{
+	uint32_t t[ECDSA_MAX_WORDS + 2], tmp[ECDSA_MAX_WORDS];
+	const int words = md->words;
+	uint32_t borrow, u;
+	uint64_t acc;
+	int i, j;
+
+	memset(t, '\0', sizeof(t));
+	for (i = 0; i < words; i++) {
+		acc = 0;
+		for (j = 0; j < words; j++) {
+			acc += (uint64_t)a[j] * b[i] + t[j];
+			t[j] = (uint32_t)acc;
+			acc >>= 32;
+		}
+		acc += t[words];
+		t[words] = (uint32_t)acc;
+		t[words + 1] = acc >> 32;
+
+		/* add a multiple of m to clear the bottom word, and shift */
+		u = t[0] * md->m0inv;
+		acc = ((uint64_t)u * md->m[0] + t[0]) >> 32;
+		for (j = 1; j < words; j++) {
+			acc += (uint64_t)u * md->m[j] + t[j];
+			t[j - 1] = (uint32_t)acc;
+			acc >>= 32;
+		}
+		acc += t[words];
+		t[words - 1] = (uint32_t)acc;
+		t[words] = t[words + 1] + (acc >> 32);
+	}
+
+	/* t < 2m, so subtract m once if t >= m */
+	borrow = bn_sub(tmp, t, md->m, words);
+	bn_select(r, tmp, t, t[words] | (borrow ^ 1), words);
+}
+
+/**
+ * mod_inv() - Modular inverse of a value in Montgomery form
+ *
+ * This raises @a to the power m - 2, so m must be prime. The exponent is
+ * public, so the sequence of operations does not depend on @a.
+ *
+ * @md:		Modulus
+ * @r:		Place to put result, a^-1 * R mod m
+ * @a:		Value a * R mod m
+ * @one:	R mod m
+ */
+static void mod_inv(const struct ecdsa_mod *md, uint32_t *r,
+		    const uint32_t *a, const uint32_t *one)
+{
+	uint32_t exp[ECDSA_MAX_WORDS], two[ECDSA_MAX_WORDS];
+	uint32_t acc[ECDSA_MAX_WORDS];
+	int i;
+
+	memset(two, '\0', sizeof(two));
+	two[0] = 2;
+	bn_sub(exp, md->m, two, md->words);
+
+	memcpy(acc, one, md->words * sizeof(uint32_t));
+	for (i = md->words * 32 - 1; i >= 0; i--) {
+		mod_mul(md, acc, acc, acc);
+		if (exp[i / 32] >> (i % 32) & 1)
+			mod_mul(md, acc, acc, a);
+	}
+	memcpy(r, acc, md->words * sizeof(uint32_t));
+}
+
+/**
+ * mod_init() - Set up a modulus for Montgomery arithmetic
+ *
+ * @md:		Modulus to set up
+ * @m:		Modulus value, odd
+ * @words:	Number of words in @m
+ */
+static void mod_init(struct ecdsa_mod *md, const uint32_t *m, int words)
+{
+	uint32_t inv, carry, borrow;
+	uint32_t tmp[ECDSA_MAX_WORDS];
+	int i;
+
+	md->words = words;
+	md->m = m;
+
+	/* m * m = 1 mod 8 and each Newton step doubles the correct bits */
+	inv = m[0];
+	for (i = 0; i < 4; i++)
+		inv *= 2 - m[0] * inv;
+	md->m0inv = -inv;
+
+	/* R^2 mod m = 2^(64 * words) mod m, by doubling from 1 */
+	memset(md->rr, '\0', sizeof(md->rr));
+	md->rr[0] = 1;
+	for (i = 0; i < 64 * words; i++) {
+		carry = bn_add(md->rr, md->rr, md->rr, words);
+		borrow = bn_sub(tmp, md->rr, m, words);
+		bn_select(md->rr, tmp, md->rr, carry | (borrow ^ 1), words);
+	}
+}
+
+/* Convert a value less than m to Montgomery form */
+static void mod_to_mont(const struct ecdsa_mod *md, uint32_t *r,
+			const uint32_t *a)
+{
+	mod_mul(md, r, a, md->rr);
+}
+
+/* Convert a value from Montgomery form */
+static void mod_from_mont(const struct ecdsa_mod *md, uint32_t *r,
+			  const uint32_t *a)
+{
+	uint32_t one[ECDSA_MAX_WORDS];
+
+	memset(one, '\0', sizeof(one));
+	one[0] = 1;
+	mod_mul(md, r, a, one);
+}
+
+/**
+ * point_add() - Add two points, which may be equal or at infinity
+ *
+ * @ctx:	Curve context
+ * @r:		Place to put result, may be the same as @p or @q
+ * @p:		First point
+ * @q:		Second point
+ */
+static void point_add(const struct ecdsa_ctx *ctx, struct ecdsa_point *r,
+		      const struct ecdsa_point *p, const struct ecdsa_point *q)
+{
+	const struct ecdsa_mod *fp = &ctx->fp;
+	uint32_t t0[ECDSA_MAX_WORDS], t1[ECDSA_MAX_WORDS];
+	uint32_t t2[ECDSA_MAX_WORDS], t3[ECDSA_MAX_WORDS];
+	uint32_t t4[ECDSA_MAX_WORDS];
+	uint32_t x3[ECDSA_MAX_WORDS], y3[ECDSA_MAX_WORDS];
+	uint32_t z3[ECDSA_MAX_WORDS];
+
+	mod_mul(fp, t0, p->x, q->x);
+	mod_mul(fp, t1, p->y, q->y);
+	mod_mul(fp, t2, p->z, q->z);
+	mod_add(fp, t3, p->x, p->y);
+	mod_add(fp, t4, q->x, q->y);
+	mod_mul(fp, t3, t3, t4);
+	mod_add(fp, t4, t0, t1);
+	mod_sub(fp, t3, t3, t4);
+	mod_add(fp, t4, p->y, p->z);
+	mod_add(fp, x3, q->y, q->z);
+	mod_mul(fp, t4, t4, x3);
+	mod_add(fp, x3, t1, t2);
+	mod_sub(fp, t4, t4, x3);
+	mod_add(fp, x3, p->x, p->z);
+	mod_add(fp, y3, q->x, q->z);
+	mod_mul(fp, x3, x3, y3);
+	mod_add(fp, y3, t0, t2);
+	mod_sub(fp, y3, x3, y3);
+	mod_mul(fp, z3, ctx->b, t2);
+	mod_sub(fp, x3, y3, z3);
+	mod_add(fp, z3, x3, x3);
+	mod_add(fp, x3, x3, z3);
+	mod_sub(fp, z3, t1, x3);
+	mod_add(fp, x3, t1, x3);
+	mod_mul(fp, y3, ctx->b, y3);
+	mod_add(fp, t1, t2, t2);
+	mod_add(fp, t2, t1, t2);
+	mod_sub(fp, y3, y3, t2);
+	mod_sub(fp, y3, y3, t0);
+	mod_add(fp, t1, y3, y3);
+	mod_add(fp, y3, t1, y3);
+	mod_add(fp, t1, t0, t0);
+	mod_add(fp, t0, t1, t0);
+	mod_sub(fp, t0, t0, t2);
+	mod_mul(fp, t1, t4, y3);
+	mod_mul(fp, t2, t0, y3);
+	mod_mul(fp, y3, x3, z3);
+	mod_add(fp, y3, y3, t2);
+	mod_mul(fp, x3, t3, x3);
+	mod_sub(fp, x3, x3, t1);
+	mod_mul(fp, z3, t4, z3);
+	mod_mul(fp, t1, t3, t0);
+	mod_add(fp, z3, z3, t1);
+
+	memcpy(r->x, x3, sizeof(x3));
+	memcpy(r->y, y3, sizeof(y3));
+	memcpy(r->z, z3, sizeof(z3));
+}
+
+/**
+ * point_mul2() - Calculate u1 * G + u2 * Q
+ *
+ * This uses Shamir's trick, one doubling and one addition per bit, with
+ * each addend read from a table of O, G, Q and G + Q by scanning the
+ * whole table.
+ *
+ * @ctx:	Curve context
+ * @r:		Place to put result
+ * @u1:		Multiplier for G, less than n
+ * @g:		Base point G
+ * @u2:		Multiplier for Q, less than n
+ * @q:		Point Q
+ */
+static void point_mul2(const struct ecdsa_ctx *ctx, struct ecdsa_point *r,
+		       const uint32_t *u1, const struct ecdsa_point *g,
+		       const uint32_t *u2, const struct ecdsa_point *q)
+{
+	const int words = ctx->fp.words;
+	struct ecdsa_point table[4], addend;
+	uint32_t idx;
+	int i, j;
+
+	memset(&table[0], '\0', sizeof(table[0]));
+	memcpy(table[0].y, ctx->one, sizeof(ctx->one));
+	table[1] = *g;
+	table[2] = *q;
+	point_add(ctx, &table[3], g, q);
+
+	memset(&addend, '\0', sizeof(addend));
+	*r = table[0];
+	for (i = words * 32 - 1; i >= 0; i--) {
+		point_add(ctx, r, r, r);
+		idx = (u1[i / 32] >> (i % 32) & 1) |
+		      (u2[i / 32] >> (i % 32) & 1) << 1;
+		for (j = 0; j < 4; j++) {
+			uint32_t sel = bn_is_zero(&idx, 1);
+
+			bn_select(addend.x, table[j].x, addend.x, sel, words);
+			bn_select(addend.y, table[j].y, addend.y, sel, words);
+			bn_select(addend.z, table[j].z, addend.z, sel, words);
+			idx--;
+		}
+		point_add(ctx, r, r, &addend);
+	}
+}
+
+/**
+ * ecdsa_ctx_init() - Set up for arithmetic on a curve
+ *
+ * @ctx:	Context to set up
+ * @curve:	Curve to use
+ */
+static void ecdsa_ctx_init(struct ecdsa_ctx *ctx,
+			   const struct ecdsa_curve *curve)
+{
+	uint32_t one[ECDSA_MAX_WORDS];
+
+	ctx->curve = curve;
+	mod_init(&ctx->fp, curve->p, curve->words);
+	mod_init(&ctx->fn, curve->n, curve->words);
+	mod_to_mont(&ctx->fp, ctx->b, curve->b);
+	memset(one, '\0', sizeof(one));
+	one[0] = 1;
+	mod_to_mont(&ctx->fp, ctx->one, one);
+}
+
+/**
+ * ecdsa_point_init() - Set up a point from affine coordinates
+ *
+ * @ctx:	Curve context
+ * @pt:		Point to set up
+ * @x:		x coordinate
+ * @y:		y coordinate
+ * @return 0 if the point is on the curve, -EINVAL if not
+ */
+static int ecdsa_point_init(const struct ecdsa_ctx *ctx,
+			    struct ecdsa_point *pt, const uint32_t *x,
+			    const uint32_t *y)
+{
+	const struct ecdsa_mod *fp = &ctx->fp;
+	const int words = fp->words;
+	uint32_t lhs[ECDSA_MAX_WORDS], rhs[ECDSA_MAX_WORDS];
+
+	if (!bn_less(x, fp->m, words) || !bn_less(y, fp->m, words))
+		return -EINVAL;
+	memset(pt, '\0', sizeof(*pt));
+	mod_to_mont(fp, pt->x, x);
+	mod_to_mont(fp, pt->y, y);
+	memcpy(pt->z, ctx->one, sizeof(ctx->one));
+
+	/* y^2 = x^3 - 3x + b */
+	mod_mul(fp, lhs, pt->y, pt->y);
+	mod_mul(fp, rhs, pt->x, pt->x);
+	mod_sub(fp, rhs, rhs, ctx->one);
+	mod_sub(fp, rhs, rhs, ctx->one);
+	mod_sub(fp, rhs, rhs, ctx->one);
+	mod_mul(fp, rhs, rhs, pt->x);
+	mod_add(fp, rhs, rhs, ctx->b);
+
+	return memcmp(lhs, rhs, words * sizeof(uint32_t)) ? -EINVAL : 0;
+}
+
+/**
+ * ecdsa_verify_hash() - Verify a signature against a hash
+ *
+ * @curve:	Curve the key is on
+ * @qx:		Public key x coordinate, big endian
+ * @qy:		Public key y coordinate, big endian
+ * @hash:	Hash of the signed data
+ * @hash_len:	Number of bytes in @hash
+ * @sig:	Signature, r followed by s, big endian
+ * @return 0 if verified, -EINVAL if the key or signature is invalid,
+ *	-EACCES if the signature does not match
+ */
+static int ecdsa_verify_hash(const struct ecdsa_curve *curve,
+			     const uint8_t *qx, const uint8_t *qy,
+			     const uint8_t *hash, int hash_len,
+			     const uint8_t *sig)
+{
+	const int words = curve->words, bytes = words * 4;
+	uint32_t x[ECDSA_MAX_WORDS], y[ECDSA_MAX_WORDS];
+	uint32_t r[ECDSA_MAX_WORDS], s[ECDSA_MAX_WORDS];
+	uint32_t e[ECDSA_MAX_WORDS], w[ECDSA_MAX_WORDS];
+	uint32_t u1[ECDSA_MAX_WORDS], u2[ECDSA_MAX_WORDS];
+	uint8_t ebuf[ECDSA_MAX_WORDS * 4];
+	struct ecdsa_point g, q, res;
+	struct ecdsa_ctx ctx;
+	const struct ecdsa_mod *fn = &ctx.fn;
+	uint32_t tmp[ECDSA_MAX_WORDS];
+	int ret;
+
+	ecdsa_ctx_init(&ctx, curve);
+
+	/* 0 < r, s < n */
+	bn_from_bytes(r, sig, words);
+	bn_from_bytes(s, sig + bytes, words);
+	if (bn_is_zero(r, words) || bn_is_zero(s, words) ||
+	    !bn_less(r, fn->m, words) || !bn_less(s, fn->m, words)) {
+		debug("%s: Signature out of range\n", __func__);
+		return -EINVAL;
+	}
+
+	bn_from_bytes(x, qx, words);
+	bn_from_bytes(y, qy, words);
+	ret = ecdsa_point_init(&ctx, &q, x, y);
+	if (ret) {
+		debug("%s: Public key is not on the curve\n", __func__);
+		return ret;
+	}
+	ecdsa_point_init(&ctx, &g, curve->gx, curve->gy);
+
+	/* e is the leftmost bits of the hash, as many as there are in n */
+	memset(ebuf, '\0', bytes);
+	if (hash_len >= bytes)
+		memcpy(ebuf, hash, bytes);
+	else
+		memcpy(ebuf + bytes - hash_len, hash, hash_len);
+	bn_from_bytes(e, ebuf, words);
+	bn_sub(tmp, e, fn->m, words);
+	bn_select(e, e, tmp, bn_less(e, fn->m, words), words);
+
+	/* w = s^-1 in Montgomery form, u1 = e * w, u2 = r * w mod n */
+	memset(tmp, '\0', sizeof(tmp));
+	tmp[0] = 1;
+	mod_to_mont(fn, tmp, tmp);
+	mod_to_mont(fn, w, s);
+	mod_inv(fn, w, w, tmp);
+	mod_mul(fn, u1, e, w);
+	mod_mul(fn, u2, r, w);
+
+	point_mul2(&ctx, &res, u1, &g, u2, &q);
+	if (bn_is_zero(res.z, words)) {
+		debug("%s: Result is the point at infinity\n", __func__);
+		return -EACCES;
+	}
+
+	/* x = X / Z, reduced mod n, must equal r */
+	mod_inv(&ctx.fp, res.z, res.z, ctx.one);
+	mod_mul(&ctx.fp, x, res.x, res.z);
+	mod_from_mont(&ctx.fp, x, x);
+	bn_sub(tmp, x, fn->m, words);
+	bn_select(x, x, tmp, bn_less(x, fn->m, words), words);
+
+	return memcmp(x, r, bytes) ? -EACCES : 0;
+}
+
+/**
+ * ecdsa_verify_with_keynode() - Verify a signature against a key node
+ *
+ * @info:	Specifies key and FIT information
+ * @hash:	Hash of the signed data
+ * @sig:	Signature, r followed by s
+ * @sig_len:	Number of bytes in signature
+ * @node:	Offset of the key node in the FDT
+ * @return 0 if verified, -ve on error
+ */
+static int ecdsa_verify_with_keynode(struct image_sign_info *info,
+				     const void *hash, uint8_t *sig,
+				     uint sig_len, int node)
+{
+	const void *blob = info->fdt_blob;
+	const struct ecdsa_curve *curve = NULL;
+	const uint8_t *qx, *qy;
+	const char *name;
+	int i, xlen, ylen;
+
+	if (node < 0) {
+		debug("%s: Skipping invalid node", __func__);
+		return -EBADF;
+	}
+
+	name = fdt_getprop(blob, node, "ecdsa,curve", NULL);
+	if (!name) {
+		debug("%s: Missing ECDSA key info", __func__);
+		return -EFAULT;
+	}
+	for (i = 0; i < ARRAY_SIZE(ecdsa_curves); i++) {
+		if (!strcmp(name, ecdsa_curves[i].name))
+			curve = &ecdsa_curves[i];
+	}
+	if (!curve || curve->words * 4 != info->crypto->key_len) {
+		debug("%s: Curve '%s' does not match %s\n", __func__, name,
+		      info->crypto->name);
+		return -EINVAL;
+	}
+
+	qx = fdt_getprop(blob, node, "ecdsa,x-point", &xlen);
+	qy = fdt_getprop(blob, node, "ecdsa,y-point", &ylen);
+	if (!qx || !qy || xlen != info->crypto->key_len ||
+	    ylen != info->crypto->key_len) {
+		debug("%s: Missing ECDSA key info", __func__);
+		return -EFAULT;
+	}
+
+	if (sig_len != 2 * info->crypto->key_len) {
+		debug("%s: Signature is %u bytes, expected %d\n", __func__,
+		      sig_len, 2 * info->crypto->key_len);
+		return -EINVAL;
+	}
+
+	return ecdsa_verify_hash(curve, qx, qy, hash,
+				 info->checksum->checksum_len, sig);
+}
+
+int ecdsa_verify(struct image_sign_info *info,
+		 const struct image_region region[], int region_count,
+		 uint8_t *sig, uint sig_len)
+{
+	const void *blob = info->fdt_blob;
+	uint8_t hash[FIT_MAX_HASH_LEN];
+	int sig_node, node, noffset;
+	char name[100];
+	int ret;
+
+	if (info->checksum->checksum_len > sizeof(hash)) {
+		debug("%s: invalid checksum-algorithm %s for %s\n",
+		      __func__, info->checksum->name, info->crypto->name);
+		return -EINVAL;
+	}
+
+	sig_node = fdt_subnode_offset(blob, 0, FIT_SIG_NODENAME);
+	if (sig_node < 0) {
+		debug("%s: No signature node found\n", __func__);
+		return -ENOENT;
+	}
+
+	/* Calculate checksum with checksum-algorithm */
+	ret = info->checksum->calculate(info->checksum->name,
+					region, region_count, hash);
+	if (ret < 0) {
+		debug("%s: Error in checksum calculation\n", __func__);
+		return -EINVAL;
+	}
+
+	/* See if we must use a particular key */
+	if (info->required_keynode != -1) {
+		ret = ecdsa_verify_with_keynode(info, hash, sig, sig_len,
+						info->required_keynode);
+		if (!ret)
+			return ret;
+	}
+
+	/* Look for a key that matches our hint */
+	snprintf(name, sizeof(name), "key-%s", info->keyname);
+	node = fdt_subnode_offset(blob, sig_node, name);
+	ret = ecdsa_verify_with_keynode(info, hash, sig, sig_len, node);
+	if (!ret)
+		return ret;
+
+	/* No luck, so try each of the keys in turn */
+	fdt_for_each_subnode(noffset, blob, sig_node) {
+		if (noffset != node) {
+			ret = ecdsa_verify_with_keynode(info, hash, sig,
+							sig_len, noffset);
+			if (!ret)
+				break;
+		}
+	}
+
+	return ret;
+}
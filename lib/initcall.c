@@ -10,6 +10,24 @@
 
 DECLARE_GLOBAL_DATA_PTR;
 
+static int initcall_call(init_fnc_t func, unsigned long reloc_ofs)
+{
+#if CONFIG_IS_ENABLED(BOOTSTAGE_INITCALL)
+	/* The timer may not be ready until bootstage is set up */
+	if (gd->bootstage) {
+		ulong start_us = timer_get_boot_us();
+		int ret;
+
+		ret = func();
+		bootstage_add_span(NULL, (char *)func - reloc_ofs, start_us);
+
+		return ret;
+	}
+#endif
+
+	return func();
+}
+
 int initcall_run_list(const init_fnc_t init_sequence[])
 {
 	const init_fnc_t *init_fnc_ptr;
@@ -22,13 +40,17 @@ int initcall_run_list(const init_fnc_t init_sequence[])
 			reloc_ofs = gd->reloc_off;
 #ifdef CONFIG_EFI_APP
 		reloc_ofs = (unsigned long)image_base;
+#endif
+#ifdef CONFIG_SANDBOX
+		/* Sandbox is not relocated but the OS may load it anywhere */
+		reloc_ofs = (unsigned long)gd->arch.text_base;
 #endif
 		debug("initcall: %p", (char *)*init_fnc_ptr - reloc_ofs);
 		if (gd->flags & GD_FLG_RELOC)
 			debug(" (relocated to %p)\n", (char *)*init_fnc_ptr);
 		else
 			debug("\n");
-		ret = (*init_fnc_ptr)();
+		ret = initcall_call(*init_fnc_ptr, reloc_ofs);
 		if (ret) {
 			printf("initcall sequence %p failed at call %p (err=%d)\n",
 			       init_sequence,
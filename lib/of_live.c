@@ -15,6 +15,7 @@
 #include <malloc.h>
 #include <dm/of_access.h>
 #include <linux/err.h>
+#include <u-boot/crc.h>
 
 DECLARE_GLOBAL_DATA_PTR;
 
@@ -317,12 +318,43 @@ static int unflatten_device_tree(const void *blob,
 	return 0;
 }
 
+/**
+ * of_live_builtin_valid() - check whether the built-in live tree can be used
+ *
+ * The built-in tree is only valid if it was generated from exactly the same
+ * flat tree as U-Boot is using.
+ *
+ * @blob: Flat tree in use
+ * @return true if the built-in tree matches @blob
+ */
+static bool of_live_builtin_valid(const void *blob)
+{
+	ulong size;
+
+	if (!blob || fdt_check_header(blob))
+		return false;
+	size = fdt_totalsize(blob);
+	if (size != of_live_builtin.fdt_size) {
+		debug("Built-in live tree does not match the device tree\n");
+		return false;
+	}
+
+	return crc32(0, blob, size) == of_live_builtin.fdt_crc32;
+}
+
 int of_live_build(const void *fdt_blob, struct device_node **rootp)
 {
 	int ret;
 
 	debug("%s: start\n", __func__);
-	ret = unflatten_device_tree(fdt_blob, rootp);
+	if (IS_ENABLED(CONFIG_OF_LIVE_BUILTIN) &&
+	    of_live_builtin_valid(fdt_blob)) {
+		debug("Using built-in live tree\n");
+		*rootp = of_live_builtin.root;
+		ret = 0;
+	} else {
+		ret = unflatten_device_tree(fdt_blob, rootp);
+	}
 	if (ret) {
 		debug("Failed to create live tree: err=%d\n", ret);
 		return ret;
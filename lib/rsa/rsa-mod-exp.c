@@ -12,6 +12,7 @@
 #include <linux/errno.h>
 #include <asm/types.h>
 #include <asm/unaligned.h>
+#include <malloc.h>
 #else
 #include "fdt_host.h"
 #include "mkimage.h"
@@ -20,7 +21,17 @@
 #include <u-boot/rsa.h>
 #include <u-boot/rsa-mod-exp.h>
 
-#define UINT64_MULT32(v, multby)  (((uint64_t)(v)) * ((uint32_t)(multby)))
+#ifndef USE_HOSTCC
+DECLARE_GLOBAL_DATA_PTR;
+#endif
+
+#if RSA_LIMB_BITS == 64
+__extension__ typedef unsigned __int128 rsa_dlimb_t;
+#else
+typedef uint64_t rsa_dlimb_t;
+#endif
+
+#define RSA_WORDS_PER_LIMB	(RSA_LIMB_BITS / 32)
 
 #define get_unaligned_be32(a) fdt32_to_cpu(*(uint32_t *)a)
 #define put_unaligned_be32(a, b) (*(uint32_t *)(b) = cpu_to_fdt32(a))
@@ -28,21 +39,48 @@
 /* Default public exponent for backward compatibility */
 #define RSA_DEFAULT_PUBEXP	65537
 
+/*
+ * Exponents longer than this are processed in windows of up to
+ * RSA_WINDOW_BITS bits using precomputed odd powers of the message. Short
+ * exponents such as 65537 have too few bits set to gain anything.
+ */
+#define RSA_WINDOW_MIN_EXP_BITS	20
+#define RSA_WINDOW_BITS		3
+
+/* Number of keys kept converted for pow_mod() between verifications */
+#define RSA_KEY_CACHE_SIZE	2
+
+/**
+ * struct rsa_key_cache - A key converted by rsa_key_init()
+ *
+ * @prop_modulus:	Modulus property the entry was created from
+ * @modulus_be:		Copy of the property, to check it is unchanged
+ * @words:		Key length in 32-bit words
+ * @key:		Converted key, without the exponent
+ */
+struct rsa_key_cache {
+	const void *prop_modulus;
+	uint8_t *modulus_be;
+	uint words;
+	struct rsa_public_key key;
+};
+
 /**
  * subtract_modulus() - subtract modulus from the given value
  *
  * @key:	Key containing modulus to subtract
- * @num:	Number to subtract modulus from, as little endian word array
+ * @num:	Number to subtract modulus from, as little endian limb array
  */
-static void subtract_modulus(const struct rsa_public_key *key, uint32_t num[])
+static void subtract_modulus(const struct rsa_public_key *key,
+			     rsa_limb_t num[])
 {
-	int64_t acc = 0;
+	rsa_limb_t borrow = 0, sub;
 	uint i;
 
 	for (i = 0; i < key->len; i++) {
-		acc += (uint64_t)num[i] - key->modulus[i];
-		num[i] = (uint32_t)acc;
-		acc >>= 32;
+		sub = key->modulus[i] + borrow;
+		borrow = (sub < borrow) | (num[i] < sub);
+		num[i] -= sub;
 	}
 }
 
@@ -50,11 +88,11 @@ static void subtract_modulus(const struct rsa_public_key *key, uint32_t num[])
  * greater_equal_modulus() - check if a value is >= modulus
  *
  * @key:	Key containing modulus to check
- * @num:	Number to check against modulus, as little endian word array
+ * @num:	Number to check against modulus, as little endian limb array
  * @return 0 if num < modulus, 1 if num >= modulus
  */
 static int greater_equal_modulus(const struct rsa_public_key *key,
-				 uint32_t num[])
+				 rsa_limb_t num[])
 {
 	int i;
 
@@ -68,38 +106,65 @@ static int greater_equal_modulus(const struct rsa_public_key *key,
 	return 1;  /* equal */
 }
 
+/**
+ * double_modulus() - double a value modulo the modulus, repeatedly
+ *
+ * @key:	Key containing modulus
+ * @num:	Number less than the modulus, as little endian limb array
+ * @count:	Number of times to double it
+ */
+static void double_modulus(const struct rsa_public_key *key, rsa_limb_t num[],
+			   int count)
+{
+	rsa_limb_t carry, top;
+	uint i;
+
+	while (count--) {
+		carry = 0;
+		for (i = 0; i < key->len; i++) {
+			top = num[i] >> (RSA_LIMB_BITS - 1);
+			num[i] = num[i] << 1 | carry;
+			carry = top;
+		}
+		if (carry || greater_equal_modulus(key, num))
+			subtract_modulus(key, num);
+	}
+}
+
 /**
  * montgomery_mul_add_step() - Perform montgomery multiply-add step
  *
  * Operation: montgomery result[] += a * b[] / n0inv % modulus
  *
  * @key:	RSA key
- * @result:	Place to put result, as little endian word array
+ * @result:	Place to put result, as little endian limb array
  * @a:		Multiplier
- * @b:		Multiplicand, as little endian word array
+ * @b:		Multiplicand, as little endian limb array
  */
 static void montgomery_mul_add_step(const struct rsa_public_key *key,
-		uint32_t result[], const uint32_t a, const uint32_t b[])
+		rsa_limb_t result[], const rsa_limb_t a, const rsa_limb_t b[])
 {
-	uint64_t acc_a, acc_b;
-	uint32_t d0;
+	rsa_dlimb_t acc_a, acc_b;
+	rsa_limb_t d0;
 	uint i;
 
-	acc_a = (uint64_t)a * b[0] + result[0];
-	d0 = (uint32_t)acc_a * key->n0inv;
-	acc_b = (uint64_t)d0 * key->modulus[0] + (uint32_t)acc_a;
+	acc_a = (rsa_dlimb_t)a * b[0] + result[0];
+	d0 = (rsa_limb_t)acc_a * key->n0inv;
+	acc_b = (rsa_dlimb_t)d0 * key->modulus[0] + (rsa_limb_t)acc_a;
 	for (i = 1; i < key->len; i++) {
-		acc_a = (acc_a >> 32) + (uint64_t)a * b[i] + result[i];
-		acc_b = (acc_b >> 32) + (uint64_t)d0 * key->modulus[i] +
-				(uint32_t)acc_a;
-		result[i - 1] = (uint32_t)acc_b;
+		acc_a = (acc_a >> RSA_LIMB_BITS) + (rsa_dlimb_t)a * b[i] +
+				result[i];
+		acc_b = (acc_b >> RSA_LIMB_BITS) +
+				(rsa_dlimb_t)d0 * key->modulus[i] +
+				(rsa_limb_t)acc_a;
+		result[i - 1] = (rsa_limb_t)acc_b;
 	}
 
-	acc_a = (acc_a >> 32) + (acc_b >> 32);
+	acc_a = (acc_a >> RSA_LIMB_BITS) + (acc_b >> RSA_LIMB_BITS);
 
-	result[i - 1] = (uint32_t)acc_a;
+	result[i - 1] = (rsa_limb_t)acc_a;
 
-	if (acc_a >> 32)
+	if (acc_a >> RSA_LIMB_BITS)
 		subtract_modulus(key, result);
 }
 
@@ -109,12 +174,12 @@ static void montgomery_mul_add_step(const struct rsa_public_key *key,
  * Operation: montgomery result[] = a[] * b[] / n0inv % modulus
  *
  * @key:	RSA key
- * @result:	Place to put result, as little endian word array
- * @a:		Multiplier, as little endian word array
- * @b:		Multiplicand, as little endian word array
+ * @result:	Place to put result, as little endian limb array
+ * @a:		Multiplier, as little endian limb array
+ * @b:		Multiplicand, as little endian limb array
  */
 static void montgomery_mul(const struct rsa_public_key *key,
-		uint32_t result[], uint32_t a[], const uint32_t b[])
+		rsa_limb_t result[], const rsa_limb_t a[], const rsa_limb_t b[])
 {
 	uint i;
 
@@ -163,36 +228,75 @@ static int num_public_exponent_bits(const struct rsa_public_key *key,
 static int is_public_exponent_bit_set(const struct rsa_public_key *key,
 		int pos)
 {
-	return key->exponent & (1ULL << pos);
+	return (key->exponent >> pos) & 1;
+}
+
+/**
+ * be_to_limbs() - Convert a big endian word array to a limb array
+ *
+ * @dst:	Place to put result, as little endian array of @limbs limbs
+ * @src:	Big endian array of @words 32-bit words
+ * @words:	Number of words in @src
+ * @limbs:	Number of limbs in @dst, any not filled from @src are zeroed
+ */
+static void be_to_limbs(rsa_limb_t dst[], const void *src, uint words,
+			uint limbs)
+{
+	const uint32_t *ptr = (const uint32_t *)src + words - 1;
+	uint i;
+
+	for (i = 0; i < limbs; i++)
+		dst[i] = 0;
+	for (i = 0; i < words; i++, ptr--)
+		dst[i / RSA_WORDS_PER_LIMB] |=
+			(rsa_limb_t)get_unaligned_be32(ptr) <<
+			(32 * (i % RSA_WORDS_PER_LIMB));
+}
+
+/**
+ * limbs_to_be() - Convert a limb array to a big endian word array
+ *
+ * @dst:	Place to put result, as big endian array of @words words
+ * @src:	Little endian limb array
+ * @words:	Number of 32-bit words to convert
+ */
+static void limbs_to_be(void *dst, const rsa_limb_t src[], uint words)
+{
+	uint32_t *ptr = (uint32_t *)dst + words - 1;
+	uint i;
+
+	for (i = 0; i < words; i++, ptr--)
+		put_unaligned_be32((uint32_t)(src[i / RSA_WORDS_PER_LIMB] >>
+				   (32 * (i % RSA_WORDS_PER_LIMB))), ptr);
 }
 
 /**
  * pow_mod() - in-place public exponentiation
  *
+ * The exponent is processed from the top in windows of odd values using a
+ * table of odd powers of the message, with its lowest bit treated as 0.
+ * This gives a^(e - 1) in Montgomery form, and a final multiplication by
+ * the plain message gives a^e, already converted back from Montgomery form.
+ *
  * @key:	RSA key
  * @inout:	Big-endian word array containing value and result
+ * @words:	Number of words in @inout
  */
-static int pow_mod(const struct rsa_public_key *key, uint32_t *inout)
+static int pow_mod(const struct rsa_public_key *key, uint32_t *inout,
+		   uint words)
 {
-	uint32_t *result, *ptr;
-	uint i;
-	int j, k;
-
-	/* Sanity check for stack size - key->len is in 32-bit words */
-	if (key->len > RSA_MAX_KEY_BITS / 32) {
-		debug("RSA key words %u exceeds maximum %d\n", key->len,
-		      RSA_MAX_KEY_BITS / 32);
+	rsa_limb_t *acc, *tmp, *swap;
+	int window, table_size;
+	int i, j, k, l;
+	uint idx;
+
+	/* Sanity check for stack size - key->len is in limbs */
+	if (key->len > RSA_MAX_KEY_BITS / RSA_LIMB_BITS) {
+		debug("RSA key limbs %u exceeds maximum %d\n", key->len,
+		      RSA_MAX_KEY_BITS / RSA_LIMB_BITS);
 		return -EINVAL;
 	}
 
-	uint32_t val[key->len], acc[key->len], tmp[key->len];
-	uint32_t a_scaled[key->len];
-	result = tmp;  /* Re-use location. */
-
-	/* Convert from big endian byte array to little endian word array. */
-	for (i = 0, ptr = inout + key->len - 1; i < key->len; i++, ptr--)
-		val[i] = get_unaligned_be32(ptr);
-
 	if (0 != num_public_exponent_bits(key, &k))
 		return -EINVAL;
 
@@ -207,93 +311,207 @@ static int pow_mod(const struct rsa_public_key *key, uint32_t *inout)
 		return -EINVAL;
 	}
 
-	/* the bit at e[k-1] is 1 by definition, so start with: C := M */
-	montgomery_mul(key, acc, val, key->rr); /* acc = a * RR / R mod n */
-	/* retain scaled version for intermediate use */
-	memcpy(a_scaled, acc, key->len * sizeof(a_scaled[0]));
+	window = k > RSA_WINDOW_MIN_EXP_BITS ? RSA_WINDOW_BITS : 1;
+	table_size = 1 << (window - 1);
 
-	for (j = k - 2; j > 0; --j) {
-		montgomery_mul(key, tmp, acc, acc); /* tmp = acc^2 / R mod n */
+	rsa_limb_t val[key->len], buf1[key->len], buf2[key->len];
+	rsa_limb_t table[table_size][key->len];
 
-		if (is_public_exponent_bit_set(key, j)) {
-			/* acc = tmp * val / R mod n */
-			montgomery_mul(key, acc, tmp, a_scaled);
-		} else {
-			/* e[j] == 0, copy tmp back to acc for next operation */
-			memcpy(acc, tmp, key->len * sizeof(acc[0]));
+	be_to_limbs(val, inout, words, key->len);
+
+	/* table[i] = a^(2i + 1) * R mod n */
+	montgomery_mul(key, table[0], val, key->rr);
+	if (table_size > 1) {
+		montgomery_mul(key, buf1, table[0], table[0]);
+		for (i = 1; i < table_size; i++)
+			montgomery_mul(key, table[i], table[i - 1], buf1);
+	}
+
+	acc = buf1;
+	tmp = buf2;
+	for (j = k - 1; j > 0; j = l - 1) {
+		if (!is_public_exponent_bit_set(key, j)) {
+			montgomery_mul(key, tmp, acc, acc);
+			swap = acc, acc = tmp, tmp = swap;
+			l = j;
+			continue;
+		}
+
+		/* widest window from bit j down to a set bit above bit 0 */
+		l = j - window + 1 > 1 ? j - window + 1 : 1;
+		while (!is_public_exponent_bit_set(key, l))
+			l++;
+		idx = (key->exponent >> l & ((1U << (j - l + 1)) - 1)) >> 1;
+
+		/* the first window starts at the top bit, which is set */
+		if (j == k - 1) {
+			memcpy(acc, table[idx], key->len * sizeof(acc[0]));
+			continue;
 		}
+		for (i = l; i <= j; i++) {
+			montgomery_mul(key, tmp, acc, acc);
+			swap = acc, acc = tmp, tmp = swap;
+		}
+		montgomery_mul(key, tmp, acc, table[idx]);
+		swap = acc, acc = tmp, tmp = swap;
 	}
 
-	/* the bit at e[0] is always 1 */
-	montgomery_mul(key, tmp, acc, acc); /* tmp = acc^2 / R mod n */
-	montgomery_mul(key, acc, tmp, val); /* acc = tmp * a / R mod M */
-	memcpy(result, acc, key->len * sizeof(result[0]));
+	/* bit 0 */
+	montgomery_mul(key, tmp, acc, acc);	/* tmp = acc^2 / R mod n */
+	montgomery_mul(key, acc, tmp, val);	/* acc = tmp * a / R mod n */
 
 	/* Make sure result < mod; result is at most 1x mod too large. */
-	if (greater_equal_modulus(key, result))
-		subtract_modulus(key, result);
+	if (greater_equal_modulus(key, acc))
+		subtract_modulus(key, acc);
+
+	limbs_to_be(inout, acc, words);
 
-	/* Convert to bigendian byte array */
-	for (i = key->len - 1, ptr = inout; (int)i >= 0; i--, ptr++)
-		put_unaligned_be32(result[i], ptr);
 	return 0;
 }
 
-static void rsa_convert_big_endian(uint32_t *dst, const uint32_t *src, int len)
+/**
+ * rsa_key_init() - Convert key properties into the form used by pow_mod()
+ *
+ * @key:	Key with len set and modulus[] and rr[] allocated
+ * @prop:	Key properties
+ * @words:	Key length in 32-bit words
+ */
+static void rsa_key_init(struct rsa_public_key *key,
+			 const struct key_prop *prop, uint words)
 {
+	rsa_limb_t inv;
 	int i;
 
-	for (i = 0; i < len; i++)
-		dst[i] = fdt32_to_cpu(src[len - 1 - i]);
+	be_to_limbs(key->modulus, prop->modulus, words, key->len);
+	be_to_limbs(key->rr, prop->rr, words, key->len);
+
+	/*
+	 * rsa,n0-inverse only has 32 bits, so work out n0inv for the limb
+	 * size in use. n * n = 1 mod 8 for odd n and each Newton step
+	 * doubles the number of correct bits.
+	 */
+	inv = key->modulus[0];
+	for (i = 0; i < 5; i++)
+		inv *= 2 - key->modulus[0] * inv;
+	key->n0inv = -inv;
+
+	/*
+	 * If the key does not fill its top limb, R is 2^32 times the one
+	 * that rsa,r-squared was calculated for.
+	 */
+	if (words % RSA_WORDS_PER_LIMB)
+		double_modulus(key, key->rr, 64);
+}
+
+/**
+ * rsa_key_lookup() - Find or create the converted form of a key
+ *
+ * Verifying several images or configurations usually uses the same key,
+ * so keep it converted between calls. An entry is found by the address of
+ * the modulus property and then checked against its contents.
+ *
+ * @prop:	Key properties
+ * @words:	Key length in 32-bit words
+ * @return converted key, or NULL if it cannot be cached
+ */
+static struct rsa_public_key *rsa_key_lookup(const struct key_prop *prop,
+					     uint words)
+{
+	static struct rsa_key_cache cache[RSA_KEY_CACHE_SIZE];
+	static int next;
+	struct rsa_key_cache *entry;
+	uint bytes = words * sizeof(uint32_t);
+	uint len = (words + RSA_WORDS_PER_LIMB - 1) / RSA_WORDS_PER_LIMB;
+	void *buf;
+	int i;
+
+#if !defined(USE_HOSTCC) && !defined(CONFIG_SPL_BUILD)
+	/* .bss is not available until after relocation */
+	if (!(gd->flags & GD_FLG_RELOC))
+		return NULL;
+#endif
+
+	for (i = 0; i < RSA_KEY_CACHE_SIZE; i++) {
+		entry = &cache[i];
+		if (entry->prop_modulus == prop->modulus &&
+		    entry->words == words &&
+		    !memcmp(entry->modulus_be, prop->modulus, bytes))
+			return &entry->key;
+	}
+
+	buf = malloc(2 * len * sizeof(rsa_limb_t) + bytes);
+	if (!buf)
+		return NULL;
+
+	entry = &cache[next];
+	next = (next + 1) % RSA_KEY_CACHE_SIZE;
+	free(entry->key.modulus);
+
+	entry->key.len = len;
+	entry->key.modulus = buf;
+	entry->key.rr = entry->key.modulus + len;
+	entry->modulus_be = (uint8_t *)(entry->key.rr + len);
+	memcpy(entry->modulus_be, prop->modulus, bytes);
+	entry->prop_modulus = prop->modulus;
+	entry->words = words;
+	rsa_key_init(&entry->key, prop, words);
+
+	return &entry->key;
 }
 
 int rsa_mod_exp_sw(const uint8_t *sig, uint32_t sig_len,
 		struct key_prop *prop, uint8_t *out)
 {
-	struct rsa_public_key key;
+	struct rsa_public_key key, *cached;
+	uint words;
 	int ret;
 
 	if (!prop) {
 		debug("%s: Skipping invalid prop", __func__);
 		return -EBADF;
 	}
-	key.n0inv = prop->n0inv;
-	key.len = prop->num_bits;
-
-	if (!prop->public_exponent)
-		key.exponent = RSA_DEFAULT_PUBEXP;
-	else
-		key.exponent =
-			fdt64_to_cpu(*((uint64_t *)(prop->public_exponent)));
 
-	if (!key.len || !prop->modulus || !prop->rr) {
+	if (!prop->num_bits || !prop->modulus || !prop->rr) {
 		debug("%s: Missing RSA key info", __func__);
 		return -EFAULT;
 	}
 
 	/* Sanity check for stack size */
-	if (key.len > RSA_MAX_KEY_BITS || key.len < RSA_MIN_KEY_BITS) {
+	if (prop->num_bits > RSA_MAX_KEY_BITS ||
+	    prop->num_bits < RSA_MIN_KEY_BITS) {
 		debug("RSA key bits %u outside allowed range %d..%d\n",
-		      key.len, RSA_MIN_KEY_BITS, RSA_MAX_KEY_BITS);
+		      prop->num_bits, RSA_MIN_KEY_BITS, RSA_MAX_KEY_BITS);
 		return -EFAULT;
 	}
-	key.len /= sizeof(uint32_t) * 8;
-	uint32_t key1[key.len], key2[key.len];
-
-	key.modulus = key1;
-	key.rr = key2;
-	rsa_convert_big_endian(key.modulus, (uint32_t *)prop->modulus, key.len);
-	rsa_convert_big_endian(key.rr, (uint32_t *)prop->rr, key.len);
-	if (!key.modulus || !key.rr) {
-		debug("%s: Out of memory", __func__);
-		return -ENOMEM;
+	words = prop->num_bits / (sizeof(uint32_t) * 8);
+	if (sig_len != words * sizeof(uint32_t)) {
+		debug("Signature is of incorrect length %u\n", sig_len);
+		return -EINVAL;
+	}
+
+	key.len = (words + RSA_WORDS_PER_LIMB - 1) / RSA_WORDS_PER_LIMB;
+	rsa_limb_t key1[key.len], key2[key.len];
+
+	cached = rsa_key_lookup(prop, words);
+	if (cached) {
+		key = *cached;
+	} else {
+		key.modulus = key1;
+		key.rr = key2;
+		rsa_key_init(&key, prop, words);
 	}
 
-	uint32_t buf[sig_len / sizeof(uint32_t)];
+	if (!prop->public_exponent)
+		key.exponent = RSA_DEFAULT_PUBEXP;
+	else
+		key.exponent =
+			fdt64_to_cpu(*((uint64_t *)(prop->public_exponent)));
+
+	uint32_t buf[words];
 
 	memcpy(buf, sig, sig_len);
 
-	ret = pow_mod(&key, buf);
+	ret = pow_mod(&key, buf, words);
 	if (ret)
 		return ret;
 
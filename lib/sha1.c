@@ -26,6 +26,11 @@
 #include <watchdog.h>
 #include <u-boot/sha1.h>
 
+#if defined(CONFIG_SHA_ARCH) && !defined(USE_HOSTCC) && \
+	!defined(CONFIG_SPL_BUILD)
+#define SHA1_USE_ARCH
+#endif
+
 const uint8_t sha1_der_prefix[SHA1_DER_LEN] = {
 	0x30, 0x21, 0x30, 0x09, 0x06, 0x05, 0x2b, 0x0e,
 	0x03, 0x02, 0x1a, 0x05, 0x00, 0x04, 0x14
@@ -220,6 +225,26 @@ static void sha1_process(sha1_context *ctx, const unsigned char data[64])
 	ctx->state[4] += E;
 }
 
+static void sha1_blocks(sha1_context *ctx, const unsigned char *data,
+			unsigned int blocks)
+{
+#ifdef SHA1_USE_ARCH
+	uint32_t state[5];
+	int i;
+
+	/* the context holds the state in longs, which may be 64-bit */
+	for (i = 0; i < 5; i++)
+		state[i] = ctx->state[i];
+	if (!arch_sha1_blocks(state, data, blocks)) {
+		for (i = 0; i < 5; i++)
+			ctx->state[i] = state[i];
+		return;
+	}
+#endif
+	for (; blocks; blocks--, data += 64)
+		sha1_process(ctx, data);
+}
+
 /*
  * SHA-1 process buffer
  */
@@ -243,16 +268,16 @@ void sha1_update(sha1_context *ctx, const unsigned char *input,
 
 	if (left && ilen >= fill) {
 		memcpy ((void *) (ctx->buffer + left), (void *) input, fill);
-		sha1_process (ctx, ctx->buffer);
+		sha1_blocks(ctx, ctx->buffer, 1);
 		input += fill;
 		ilen -= fill;
 		left = 0;
 	}
 
-	while (ilen >= 64) {
-		sha1_process (ctx, input);
-		input += 64;
-		ilen -= 64;
+	if (ilen >= 64) {
+		sha1_blocks(ctx, input, ilen / 64);
+		input += ilen & ~0x3F;
+		ilen &= 0x3F;
 	}
 
 	if (ilen > 0) {
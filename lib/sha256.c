@@ -15,6 +15,11 @@
 #include <watchdog.h>
 #include <u-boot/sha256.h>
 
+#if defined(CONFIG_SHA_ARCH) && !defined(USE_HOSTCC) && \
+	!defined(CONFIG_SPL_BUILD)
+#define SHA256_USE_ARCH
+#endif
+
 const uint8_t sha256_der_prefix[SHA256_DER_LEN] = {
 	0x30, 0x31, 0x30, 0x0d, 0x06, 0x09, 0x60, 0x86,
 	0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x01, 0x05,
@@ -187,6 +192,17 @@ static void sha256_process(sha256_context *ctx, const uint8_t data[64])
 	ctx->state[7] += H;
 }
 
+static void sha256_blocks(sha256_context *ctx, const uint8_t *data,
+			  uint32_t blocks)
+{
+#ifdef SHA256_USE_ARCH
+	if (!arch_sha256_blocks(ctx->state, data, blocks))
+		return;
+#endif
+	for (; blocks; blocks--, data += 64)
+		sha256_process(ctx, data);
+}
+
 void sha256_update(sha256_context *ctx, const uint8_t *input, uint32_t length)
 {
 	uint32_t left, fill;
@@ -205,16 +221,16 @@ void sha256_update(sha256_context *ctx, const uint8_t *input, uint32_t length)
 
 	if (left && length >= fill) {
 		memcpy((void *) (ctx->buffer + left), (void *) input, fill);
-		sha256_process(ctx, ctx->buffer);
+		sha256_blocks(ctx, ctx->buffer, 1);
 		length -= fill;
 		input += fill;
 		left = 0;
 	}
 
-	while (length >= 64) {
-		sha256_process(ctx, input);
-		length -= 64;
-		input += 64;
+	if (length >= 64) {
+		sha256_blocks(ctx, input, length / 64);
+		input += length & ~0x3F;
+		length &= 0x3F;
 	}
 
 	if (length)
@@ -0,0 +1,323 @@
+/*
+ * FIPS-180-2 compliant SHA-384/512 implementation
+ *
+ * This follows the structure of lib/sha256.c, with 64-bit words, 80
+ * rounds and 128-byte blocks.
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#ifndef USE_HOSTCC
+#include <common.h>
+#include <linux/string.h>
+#else
+#include <string.h>
+#endif /* USE_HOSTCC */
+#include <watchdog.h>
+#include <u-boot/sha512.h>
+
+const uint8_t sha384_der_prefix[SHA384_DER_LEN] = {
+	0x30, 0x41, 0x30, 0x0d, 0x06, 0x09, 0x60, 0x86,
+	0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x02, 0x05,
+	0x00, 0x04, 0x30
+};
+
+const uint8_t sha512_der_prefix[SHA512_DER_LEN] = {
+	0x30, 0x51, 0x30, 0x0d, 0x06, 0x09, 0x60, 0x86,
+	0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x03, 0x05,
+	0x00, 0x04, 0x40
+};
+
+#define ULL(x)	((uint64_t)(x##ULL))
+
+/*
+ * 64-bit integer manipulation macros (big endian)
+ */
+#define GET_UINT64_BE(n, b, i) {			\
+	(n) = ((uint64_t)(b)[(i)    ] << 56)		\
+	    | ((uint64_t)(b)[(i) + 1] << 48)		\
+	    | ((uint64_t)(b)[(i) + 2] << 40)		\
+	    | ((uint64_t)(b)[(i) + 3] << 32)		\
+	    | ((uint64_t)(b)[(i) + 4] << 24)		\
+	    | ((uint64_t)(b)[(i) + 5] << 16)		\
+	    | ((uint64_t)(b)[(i) + 6] <<  8)		\
+	    | ((uint64_t)(b)[(i) + 7]      );		\
+}
+
+#define PUT_UINT64_BE(n, b, i) {			\
+	(b)[(i)    ] = (unsigned char)((n) >> 56);	\
+	(b)[(i) + 1] = (unsigned char)((n) >> 48);	\
+	(b)[(i) + 2] = (unsigned char)((n) >> 40);	\
+	(b)[(i) + 3] = (unsigned char)((n) >> 32);	\
+	(b)[(i) + 4] = (unsigned char)((n) >> 24);	\
+	(b)[(i) + 5] = (unsigned char)((n) >> 16);	\
+	(b)[(i) + 6] = (unsigned char)((n) >>  8);	\
+	(b)[(i) + 7] = (unsigned char)((n)      );	\
+}
+
+static const uint64_t sha512_k[80] = {
+	ULL(0x428a2f98d728ae22), ULL(0x7137449123ef65cd),
+	ULL(0xb5c0fbcfec4d3b2f), ULL(0xe9b5dba58189dbbc),
+	ULL(0x3956c25bf348b538), ULL(0x59f111f1b605d019),
+	ULL(0x923f82a4af194f9b), ULL(0xab1c5ed5da6d8118),
+	ULL(0xd807aa98a3030242), ULL(0x12835b0145706fbe),
+	ULL(0x243185be4ee4b28c), ULL(0x550c7dc3d5ffb4e2),
+	ULL(0x72be5d74f27b896f), ULL(0x80deb1fe3b1696b1),
+	ULL(0x9bdc06a725c71235), ULL(0xc19bf174cf692694),
+	ULL(0xe49b69c19ef14ad2), ULL(0xefbe4786384f25e3),
+	ULL(0x0fc19dc68b8cd5b5), ULL(0x240ca1cc77ac9c65),
+	ULL(0x2de92c6f592b0275), ULL(0x4a7484aa6ea6e483),
+	ULL(0x5cb0a9dcbd41fbd4), ULL(0x76f988da831153b5),
+	ULL(0x983e5152ee66dfab), ULL(0xa831c66d2db43210),
+	ULL(0xb00327c898fb213f), ULL(0xbf597fc7beef0ee4),
+	ULL(0xc6e00bf33da88fc2), ULL(0xd5a79147930aa725),
+	ULL(0x06ca6351e003826f), ULL(0x142929670a0e6e70),
+	ULL(0x27b70a8546d22ffc), ULL(0x2e1b21385c26c926),
+	ULL(0x4d2c6dfc5ac42aed), ULL(0x53380d139d95b3df),
+	ULL(0x650a73548baf63de), ULL(0x766a0abb3c77b2a8),
+	ULL(0x81c2c92e47edaee6), ULL(0x92722c851482353b),
+	ULL(0xa2bfe8a14cf10364), ULL(0xa81a664bbc423001),
+	ULL(0xc24b8b70d0f89791), ULL(0xc76c51a30654be30),
+	ULL(0xd192e819d6ef5218), ULL(0xd69906245565a910),
+	ULL(0xf40e35855771202a), ULL(0x106aa07032bbd1b8),
+	ULL(0x19a4c116b8d2d0c8), ULL(0x1e376c085141ab53),
+	ULL(0x2748774cdf8eeb99), ULL(0x34b0bcb5e19b48a8),
+	ULL(0x391c0cb3c5c95a63), ULL(0x4ed8aa4ae3418acb),
+	ULL(0x5b9cca4f7763e373), ULL(0x682e6ff3d6b2b8a3),
+	ULL(0x748f82ee5defb2fc), ULL(0x78a5636f43172f60),
+	ULL(0x84c87814a1f0ab72), ULL(0x8cc702081a6439ec),
+	ULL(0x90befffa23631e28), ULL(0xa4506cebde82bde9),
+	ULL(0xbef9a3f7b2c67915), ULL(0xc67178f2e372532b),
+	ULL(0xca273eceea26619c), ULL(0xd186b8c721c0c207),
+	ULL(0xeada7dd6cde0eb1e), ULL(0xf57d4f7fee6ed178),
+	ULL(0x06f067aa72176fba), ULL(0x0a637dc5a2c898a6),
+	ULL(0x113f9804bef90dae), ULL(0x1b710b35131c471b),
+	ULL(0x28db77f523047d84), ULL(0x32caab7b40c72493),
+	ULL(0x3c9ebe0a15c9bebc), ULL(0x431d67c49c100d4c),
+	ULL(0x4cc5d4becb3e42b6), ULL(0x597f299cfc657e2a),
+	ULL(0x5fcb6fab3ad6faec), ULL(0x6c44198c4a475817)
+};
+
+void sha512_starts(sha512_context *ctx)
+{
+	ctx->total[0] = 0;
+	ctx->total[1] = 0;
+
+	ctx->state[0] = ULL(0x6a09e667f3bcc908);
+	ctx->state[1] = ULL(0xbb67ae8584caa73b);
+	ctx->state[2] = ULL(0x3c6ef372fe94f82b);
+	ctx->state[3] = ULL(0xa54ff53a5f1d36f1);
+	ctx->state[4] = ULL(0x510e527fade682d1);
+	ctx->state[5] = ULL(0x9b05688c2b3e6c1f);
+	ctx->state[6] = ULL(0x1f83d9abfb41bd6b);
+	ctx->state[7] = ULL(0x5be0cd19137e2179);
+}
+
+void sha384_starts(sha512_context *ctx)
+{
+	ctx->total[0] = 0;
+	ctx->total[1] = 0;
+
+	ctx->state[0] = ULL(0xcbbb9d5dc1059ed8);
+	ctx->state[1] = ULL(0x629a292a367cd507);
+	ctx->state[2] = ULL(0x9159015a3070dd17);
+	ctx->state[3] = ULL(0x152fecd8f70e5939);
+	ctx->state[4] = ULL(0x67332667ffc00b31);
+	ctx->state[5] = ULL(0x8eb44a8768581511);
+	ctx->state[6] = ULL(0xdb0c2e0d64f98fa7);
+	ctx->state[7] = ULL(0x47b5481dbefa4fa4);
+}
+
+#define SHR(x, n)	((x) >> (n))
+#define ROTR(x, n)	(SHR(x, n) | ((x) << (64 - (n))))
+
+#define S0(x)	(ROTR(x, 1) ^ ROTR(x, 8) ^ SHR(x, 7))
+#define S1(x)	(ROTR(x, 19) ^ ROTR(x, 61) ^ SHR(x, 6))
+
+#define S2(x)	(ROTR(x, 28) ^ ROTR(x, 34) ^ ROTR(x, 39))
+#define S3(x)	(ROTR(x, 14) ^ ROTR(x, 18) ^ ROTR(x, 41))
+
+#define F0(x, y, z)	(((x) & (y)) | ((z) & ((x) | (y))))
+#define F1(x, y, z)	((z) ^ ((x) & ((y) ^ (z))))
+
+#define P(a, b, c, d, e, f, g, h, x, K) {		\
+	temp1 = h + S3(e) + F1(e, f, g) + K + x;	\
+	temp2 = S2(a) + F0(a, b, c);			\
+	d += temp1; h = temp1 + temp2;			\
+}
+
+static void sha512_process(sha512_context *ctx, const uint8_t data[128])
+{
+	uint64_t temp1, temp2;
+	uint64_t W[80];
+	uint64_t A, B, C, D, E, F, G, H;
+	int i;
+
+	for (i = 0; i < 16; i++)
+		GET_UINT64_BE(W[i], data, i << 3);
+	for (; i < 80; i++)
+		W[i] = S1(W[i - 2]) + W[i - 7] + S0(W[i - 15]) + W[i - 16];
+
+	A = ctx->state[0];
+	B = ctx->state[1];
+	C = ctx->state[2];
+	D = ctx->state[3];
+	E = ctx->state[4];
+	F = ctx->state[5];
+	G = ctx->state[6];
+	H = ctx->state[7];
+
+	/* Eight rounds per pass so that the variables rotate back in place */
+	for (i = 0; i < 80; i += 8) {
+		P(A, B, C, D, E, F, G, H, W[i + 0], sha512_k[i + 0]);
+		P(H, A, B, C, D, E, F, G, W[i + 1], sha512_k[i + 1]);
+		P(G, H, A, B, C, D, E, F, W[i + 2], sha512_k[i + 2]);
+		P(F, G, H, A, B, C, D, E, W[i + 3], sha512_k[i + 3]);
+		P(E, F, G, H, A, B, C, D, W[i + 4], sha512_k[i + 4]);
+		P(D, E, F, G, H, A, B, C, W[i + 5], sha512_k[i + 5]);
+		P(C, D, E, F, G, H, A, B, W[i + 6], sha512_k[i + 6]);
+		P(B, C, D, E, F, G, H, A, W[i + 7], sha512_k[i + 7]);
+	}
+
+	ctx->state[0] += A;
+	ctx->state[1] += B;
+	ctx->state[2] += C;
+	ctx->state[3] += D;
+	ctx->state[4] += E;
+	ctx->state[5] += F;
+	ctx->state[6] += G;
+	ctx->state[7] += H;
+}
+
+void sha512_update(sha512_context *ctx, const uint8_t *input, uint32_t length)
+{
+	uint32_t left, fill;
+
+	if (!length)
+		return;
+
+	left = ctx->total[0] & 0x7F;
+	fill = 128 - left;
+
+	ctx->total[0] += length;
+	if (ctx->total[0] < length)
+		ctx->total[1]++;
+
+	if (left && length >= fill) {
+		memcpy((void *)(ctx->buffer + left), (void *)input, fill);
+		sha512_process(ctx, ctx->buffer);
+		length -= fill;
+		input += fill;
+		left = 0;
+	}
+
+	while (length >= 128) {
+		sha512_process(ctx, input);
+		length -= 128;
+		input += 128;
+	}
+
+	if (length)
+		memcpy((void *)(ctx->buffer + left), (void *)input, length);
+}
+
+static const uint8_t sha512_padding[128] = {
+	0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+/* Pad the message and leave the result in ctx->state */
+static void sha512_pad(sha512_context *ctx)
+{
+	uint32_t last, padn;
+	uint64_t high, low;
+	uint8_t msglen[16];
+
+	high = (ctx->total[0] >> 61) | (ctx->total[1] << 3);
+	low = ctx->total[0] << 3;
+
+	PUT_UINT64_BE(high, msglen, 0);
+	PUT_UINT64_BE(low, msglen, 8);
+
+	last = ctx->total[0] & 0x7F;
+	padn = (last < 112) ? (112 - last) : (240 - last);
+
+	sha512_update(ctx, sha512_padding, padn);
+	sha512_update(ctx, msglen, 16);
+}
+
+void sha512_finish(sha512_context *ctx, uint8_t digest[SHA512_SUM_LEN])
+{
+	int i;
+
+	sha512_pad(ctx);
+	for (i = 0; i < 8; i++)
+		PUT_UINT64_BE(ctx->state[i], digest, i << 3);
+}
+
+void sha384_finish(sha512_context *ctx, uint8_t digest[SHA384_SUM_LEN])
+{
+	int i;
+
+	sha512_pad(ctx);
+	for (i = 0; i < 6; i++)
+		PUT_UINT64_BE(ctx->state[i], digest, i << 3);
+}
+
+/*
+ * Feed the input to an already started context, triggering the watchdog
+ * every 'chunk_sz' bytes.
+ */
+static void sha512_update_wd(sha512_context *ctx, const unsigned char *input,
+			     unsigned int ilen, unsigned int chunk_sz)
+{
+#if defined(CONFIG_HW_WATCHDOG) || defined(CONFIG_WATCHDOG)
+	const unsigned char *end = input + ilen;
+	int chunk;
+
+	while (input < end) {
+		chunk = end - input;
+		if (chunk > chunk_sz)
+			chunk = chunk_sz;
+		sha512_update(ctx, input, chunk);
+		input += chunk;
+		WATCHDOG_RESET();
+	}
+#else
+	sha512_update(ctx, input, ilen);
+#endif
+}
+
+/*
+ * Output = SHA-512( input buffer ). Trigger the watchdog every 'chunk_sz'
+ * bytes of input processed.
+ */
+void sha512_csum_wd(const unsigned char *input, unsigned int ilen,
+		unsigned char *output, unsigned int chunk_sz)
+{
+	sha512_context ctx;
+
+	sha512_starts(&ctx);
+	sha512_update_wd(&ctx, input, ilen, chunk_sz);
+	sha512_finish(&ctx, output);
+}
+
+/*
+ * Output = SHA-384( input buffer ). Trigger the watchdog every 'chunk_sz'
+ * bytes of input processed.
+ */
+void sha384_csum_wd(const unsigned char *input, unsigned int ilen,
+		unsigned char *output, unsigned int chunk_sz)
+{
+	sha512_context ctx;
+
+	sha384_starts(&ctx);
+	sha512_update_wd(&ctx, input, ilen, chunk_sz);
+	sha384_finish(&ctx, output);
+}
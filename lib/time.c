@@ -6,6 +6,7 @@
  */
 
 #include <common.h>
+#include <cyclic.h>
 #include <dm.h>
 #include <errno.h>
 #include <timer.h>
@@ -17,6 +18,13 @@
 # define CONFIG_WD_PERIOD	(10 * 1000 * 1000)	/* 10 seconds default */
 #endif
 
+/* Give cyclic functions a chance to run at least once a millisecond */
+#if CONFIG_IS_ENABLED(CYCLIC) && CONFIG_WD_PERIOD > 1000
+# define UDELAY_PERIOD		1000
+#else
+# define UDELAY_PERIOD		CONFIG_WD_PERIOD
+#endif
+
 DECLARE_GLOBAL_DATA_PTR;
 
 #ifdef CONFIG_SYS_TIMER_RATE
@@ -165,8 +173,8 @@ void udelay(unsigned long usec)
 	ulong kv;
 
 	do {
-		WATCHDOG_RESET();
-		kv = usec > CONFIG_WD_PERIOD ? CONFIG_WD_PERIOD : usec;
+		cyclic_schedule();
+		kv = usec > UDELAY_PERIOD ? UDELAY_PERIOD : usec;
 		__udelay (kv);
 		usec -= kv;
 	} while(usec);
@@ -15,6 +15,50 @@ DECLARE_GLOBAL_DATA_PTR;
 static char trace_enabled __attribute__((section(".data")));
 static char trace_inited __attribute__((section(".data")));
 
+enum {
+	/*
+	 * The function trace is kept in a ring of blocks of this size. When
+	 * the ring is full, the oldest block is overwritten.
+	 */
+	TRACE_BLOCK_SIZE	= 4096,
+
+	/* Maximum size of an encoded function trace record */
+	TRACE_REC_MAX		= 20,
+
+	/* Number of call levels for which the time in each function is known */
+	TRACE_STACK_DEPTH	= 64,
+};
+
+/*
+ * A block of function trace records
+ *
+ * Each record holds the function offset (as a word offset, shifted left by
+ * one, with bit 0 set for an entry record), the caller offset and the time
+ * since the previous record, each encoded as an unsigned LEB128 number. The
+ * first record's time is relative to @base_us. A typical record takes 6-8
+ * bytes, compared to the 12 bytes of struct trace_call.
+ */
+struct trace_block {
+	ulong base_us;		/* Time at the start of the block */
+	uint32_t used;		/* Number of bytes of records */
+	uint32_t count;		/* Number of records */
+	uint8_t data[];		/* Records */
+};
+
+#define TRACE_BLOCK_DATA	(TRACE_BLOCK_SIZE - sizeof(struct trace_block))
+
+/* Call count and time for a function */
+struct trace_accum {
+	uint32_t call_count;	/* Number of times called */
+	uint32_t total_us;	/* Time spent in the function and its callees */
+};
+
+/* A function on the call stack */
+struct trace_frame {
+	uint32_t func;		/* Function number */
+	ulong start_us;		/* Time when it was entered */
+};
+
 /* The header block at the start of the trace memory area */
 struct trace_hdr {
 	int func_count;		/* Total number of function call sites */
@@ -23,20 +67,27 @@ struct trace_hdr {
 	int funcs_used;		/* Total number of functions used */
 
 	/*
-	 * Call count for each function. This is indexed by the word offset
-	 * of the function from gd->relocaddr
+	 * Call count and time for each function. This is indexed by the word
+	 * offset of the function from gd->relocaddr
 	 */
-	uintptr_t *call_accum;
-
-	/* Function trace list */
-	struct trace_call *ftrace;	/* The function call records */
-	ulong ftrace_size;	/* Num. of ftrace records we have space for */
+	struct trace_accum *call_accum;
+
+	/* Function trace ring buffer */
+	char *ring;		/* Start of the first block */
+	ulong ring_blocks;	/* Number of blocks in the ring */
+	ulong head;		/* Sequence number of the block being written */
+	struct trace_block *block;	/* Block being written, or NULL */
+	ulong last_us;		/* Time of the last record */
 	ulong ftrace_count;	/* Num. of ftrace records written */
+	ulong ftrace_lost;	/* Num. of ftrace records overwritten */
 	ulong ftrace_too_deep_count;	/* Functions that were too deep */
 
+	/* Functions being run, used to work out the time spent in each */
+	struct trace_frame stack[TRACE_STACK_DEPTH];
 	int depth;
 	int depth_limit;
 	int max_depth;
+	bool busy;	/* true while recording, to ignore calls it makes */
 };
 
 static struct trace_hdr *hdr;	/* Pointer to start of trace buffer */
@@ -57,33 +108,97 @@ static inline uintptr_t __attribute__((no_instrument_function))
 	return offset / FUNC_SITE_SIZE;
 }
 
-static void __attribute__((no_instrument_function)) add_ftrace(void *func_ptr,
-				void *caller, ulong flags)
+static inline struct trace_block *trace_get_block(ulong seq)
 {
-	if (hdr->depth > hdr->depth_limit) {
-		hdr->ftrace_too_deep_count++;
-		return;
-	}
-	if (hdr->ftrace_count < hdr->ftrace_size) {
-		struct trace_call *rec = &hdr->ftrace[hdr->ftrace_count];
+	ulong offset = seq % hdr->ring_blocks * TRACE_BLOCK_SIZE;
+
+	return (struct trace_block *)(hdr->ring + offset);
+}
+
+/* Get the sequence number of the oldest block in the ring */
+static inline ulong trace_oldest_block(void)
+{
+	if (hdr->head < hdr->ring_blocks)
+		return 0;
+
+	return hdr->head - hdr->ring_blocks + 1;
+}
 
-		rec->func = func_ptr_to_num(func_ptr);
-		rec->caller = func_ptr_to_num(caller);
-		rec->flags = flags | (timer_get_us() & FUNCF_TIMESTAMP_MASK);
+static inline uint8_t *put_uleb128(uint8_t *ptr, ulong val)
+{
+	while (val >= 0x80) {
+		*ptr++ = val | 0x80;
+		val >>= 7;
 	}
-	hdr->ftrace_count++;
+	*ptr++ = val;
+
+	return ptr;
+}
+
+static inline ulong get_uleb128(const uint8_t **ptrp)
+{
+	const uint8_t *ptr = *ptrp;
+	ulong val = 0;
+	int shift = 0;
+
+	do {
+		val |= (ulong)(*ptr & 0x7f) << shift;
+		shift += 7;
+	} while (*ptr++ & 0x80);
+	*ptrp = ptr;
+
+	return val;
+}
+
+static void __attribute__((no_instrument_function)) start_block(
+		struct trace_block *block, ulong now)
+{
+	block->base_us = now;
+	block->used = 0;
+	block->count = 0;
+	hdr->last_us = now;
+}
+
+/* Move to the next block in the ring, overwriting the oldest if needed */
+static struct trace_block *__attribute__((no_instrument_function))
+		next_block(ulong now)
+{
+	struct trace_block *block;
+
+	block = trace_get_block(++hdr->head);
+	if (hdr->head >= hdr->ring_blocks)
+		hdr->ftrace_lost += block->count;
+	start_block(block, now);
+	hdr->block = block;
+
+	return block;
 }
 
-static void __attribute__((no_instrument_function)) add_textbase(void)
+static void __attribute__((no_instrument_function)) add_ftrace(ulong func,
+				ulong caller, ulong flags, ulong now)
 {
-	if (hdr->ftrace_count < hdr->ftrace_size) {
-		struct trace_call *rec = &hdr->ftrace[hdr->ftrace_count];
+	struct trace_block *block = hdr->block;
+	uint8_t *ptr;
 
-		rec->func = CONFIG_SYS_TEXT_BASE;
-		rec->caller = 0;
-		rec->flags = FUNCF_TEXTBASE;
+	if (hdr->depth > hdr->depth_limit) {
+		hdr->ftrace_too_deep_count++;
+		return;
 	}
 	hdr->ftrace_count++;
+	if (!block) {
+		hdr->ftrace_lost++;
+		return;
+	}
+	if (block->used + TRACE_REC_MAX > TRACE_BLOCK_DATA)
+		block = next_block(now);
+
+	ptr = block->data + block->used;
+	ptr = put_uleb128(ptr, (func << 1) | (flags == FUNCF_ENTRY));
+	ptr = put_uleb128(ptr, (uint32_t)caller);
+	ptr = put_uleb128(ptr, now - hdr->last_us);
+	hdr->last_us = now;
+	block->used = ptr - block->data;
+	block->count++;
 }
 
 /**
@@ -98,27 +213,36 @@ static void __attribute__((no_instrument_function)) add_textbase(void)
 void __attribute__((no_instrument_function)) __cyg_profile_func_enter(
 		void *func_ptr, void *caller)
 {
-	if (trace_enabled) {
-		int func;
+	if (trace_enabled && !hdr->busy) {
+		ulong func, now;
 
-		add_ftrace(func_ptr, caller, FUNCF_ENTRY);
+		/* Reading the timer may call functions which are traced */
+		hdr->busy = true;
+		now = timer_get_us();
 		func = func_ptr_to_num(func_ptr);
+		add_ftrace(func, func_ptr_to_num(caller), FUNCF_ENTRY, now);
 		if (func < hdr->func_count) {
-			hdr->call_accum[func]++;
+			hdr->call_accum[func].call_count++;
 			hdr->call_count++;
 		} else {
 			hdr->untracked_count++;
 		}
+		if (hdr->depth >= 0 && hdr->depth < TRACE_STACK_DEPTH) {
+			hdr->stack[hdr->depth].func = func;
+			hdr->stack[hdr->depth].start_us = now;
+		}
 		hdr->depth++;
 		if (hdr->depth > hdr->depth_limit)
 			hdr->max_depth = hdr->depth;
+		hdr->busy = false;
 	}
 }
 
 /**
  * This is called on every function exit
  *
- * We do nothing here.
+ * We add the time spent in the function to its tally and add to the list of
+ * called functions.
  *
  * @param func_ptr	Pointer to function being entered
  * @param caller	Pointer to function which called this function
@@ -126,9 +250,22 @@ void __attribute__((no_instrument_function)) __cyg_profile_func_enter(
 void __attribute__((no_instrument_function)) __cyg_profile_func_exit(
 		void *func_ptr, void *caller)
 {
-	if (trace_enabled) {
-		add_ftrace(func_ptr, caller, FUNCF_EXIT);
+	if (trace_enabled && !hdr->busy) {
+		struct trace_frame *frame;
+		ulong func, now;
+
+		hdr->busy = true;
+		now = timer_get_us();
+		func = func_ptr_to_num(func_ptr);
 		hdr->depth--;
+		add_ftrace(func, func_ptr_to_num(caller), FUNCF_EXIT, now);
+		if (hdr->depth >= 0 && hdr->depth < TRACE_STACK_DEPTH) {
+			frame = &hdr->stack[hdr->depth];
+			if (frame->func == func && func < hdr->func_count)
+				hdr->call_accum[func].total_us +=
+					now - frame->start_us;
+		}
+		hdr->busy = false;
 	}
 }
 
@@ -160,16 +297,17 @@ int trace_list_functions(void *buff, int buff_size, unsigned int *needed)
 
 	/* Add information about each function */
 	for (func = upto = 0; func < hdr->func_count; func++) {
-		int calls = hdr->call_accum[func];
+		struct trace_accum *accum = &hdr->call_accum[func];
 
-		if (!calls)
+		if (!accum->call_count)
 			continue;
 
 		if (ptr + sizeof(struct trace_output_func) < end) {
 			struct trace_output_func *stats = ptr;
 
 			stats->offset = func * FUNC_SITE_SIZE;
-			stats->call_count = calls;
+			stats->call_count = accum->call_count;
+			stats->total_us = accum->total_us;
 			upto++;
 		}
 		ptr += sizeof(struct trace_output_func);
@@ -188,13 +326,33 @@ int trace_list_functions(void *buff, int buff_size, unsigned int *needed)
 	return 0;
 }
 
+/* Write a call record if there is space, returning the number written */
+static int put_call(void **ptrp, void *end, uint32_t func, uint32_t caller,
+		    uint32_t flags)
+{
+	struct trace_call *out = *ptrp;
+
+	*ptrp += sizeof(*out);
+	if (*ptrp > end)
+		return 0;
+	out->func = func;
+	out->caller = caller;
+	out->flags = flags;
+
+	return 1;
+}
+
 int trace_list_calls(void *buff, int buff_size, unsigned *needed)
 {
 	struct trace_output_hdr *output_hdr = NULL;
 	void *end, *ptr = buff;
-	int rec, upto;
-	int count;
+	char was_enabled;
+	ulong seq;
+	int upto;
 
+	/* Stop the ring changing while it is read */
+	was_enabled = trace_enabled;
+	trace_enabled = 0;
 	end = buff ? buff + buff_size : NULL;
 
 	/* Place some header information */
@@ -202,21 +360,28 @@ int trace_list_calls(void *buff, int buff_size, unsigned *needed)
 		output_hdr = ptr;
 	ptr += sizeof(struct trace_output_hdr);
 
-	/* Add information about each call */
-	count = hdr->ftrace_count;
-	if (count > hdr->ftrace_size)
-		count = hdr->ftrace_size;
-	for (rec = upto = 0; rec < count; rec++) {
-		if (ptr + sizeof(struct trace_call) < end) {
-			struct trace_call *call = &hdr->ftrace[rec];
-			struct trace_call *out = ptr;
-
-			out->func = call->func * FUNC_SITE_SIZE;
-			out->caller = call->caller * FUNC_SITE_SIZE;
-			out->flags = call->flags;
-			upto++;
+	upto = put_call(&ptr, end, CONFIG_SYS_TEXT_BASE, 0, FUNCF_TEXTBASE);
+
+	/* Add information about each call, from oldest to newest */
+	for (seq = trace_oldest_block(); hdr->block && seq <= hdr->head;
+	     seq++) {
+		struct trace_block *block = trace_get_block(seq);
+		const uint8_t *rec = block->data;
+		ulong time = block->base_us;
+		int i;
+
+		for (i = 0; i < block->count; i++) {
+			ulong func, caller, flags;
+
+			func = get_uleb128(&rec);
+			caller = get_uleb128(&rec);
+			time += get_uleb128(&rec);
+			flags = func & 1 ? FUNCF_ENTRY : FUNCF_EXIT;
+			func = (func >> 1) * FUNC_SITE_SIZE;
+			flags |= time & FUNCF_TIMESTAMP_MASK;
+			upto += put_call(&ptr, end, func,
+					 caller * FUNC_SITE_SIZE, flags);
 		}
-		ptr += sizeof(struct trace_call);
 	}
 
 	/* Update the header */
@@ -224,6 +389,7 @@ int trace_list_calls(void *buff, int buff_size, unsigned *needed)
 		output_hdr->rec_count = upto;
 		output_hdr->type = TRACE_CHUNK_CALLS;
 	}
+	trace_enabled = was_enabled;
 
 	/* Work out how must of the buffer we used */
 	*needed = ptr - buff;
@@ -235,7 +401,7 @@ int trace_list_calls(void *buff, int buff_size, unsigned *needed)
 /* Print basic information about tracing */
 void trace_print_stats(void)
 {
-	ulong count;
+	ulong blocks;
 
 #ifndef FTRACE
 	puts("Warning: make U-Boot with FTRACE to enable function instrumenting.\n");
@@ -251,14 +417,15 @@ void trace_print_stats(void)
 	puts(" function calls\n");
 	print_grouped_ull(hdr->untracked_count, 10);
 	puts(" untracked function calls\n");
-	count = min(hdr->ftrace_count, hdr->ftrace_size);
-	print_grouped_ull(count, 10);
+	print_grouped_ull(hdr->ftrace_count, 10);
 	puts(" traced function calls");
-	if (hdr->ftrace_count > hdr->ftrace_size) {
-		printf(" (%lu dropped due to overflow)",
-		       hdr->ftrace_count - hdr->ftrace_size);
-	}
+	if (hdr->ftrace_lost)
+		printf(" (%lu oldest overwritten)", hdr->ftrace_lost);
 	puts("\n");
+	blocks = hdr->block ? min(hdr->head + 1, hdr->ring_blocks) : 0;
+	print_grouped_ull(blocks * TRACE_BLOCK_SIZE, 10);
+	printf(" bytes of trace buffer used, of %lu\n",
+	       hdr->ring_blocks * TRACE_BLOCK_SIZE);
 	printf("%15d maximum observed call depth\n", hdr->max_depth);
 	printf("%15d call depth limit\n", hdr->depth_limit);
 	print_grouped_ull(hdr->ftrace_too_deep_count, 10);
@@ -270,6 +437,52 @@ void __attribute__((no_instrument_function)) trace_set_enabled(int enabled)
 	trace_enabled = enabled != 0;
 }
 
+/**
+ * Set up the function trace ring buffer
+ *
+ * If there is an early trace buffer, its blocks are copied over, oldest
+ * first. If there is not enough space for them all, the oldest are dropped.
+ *
+ * @param ring		Start of space for the ring
+ * @param size		Size of space in bytes
+ * @param early		Header of the early trace buffer, or NULL if none
+ */
+static void __attribute__((no_instrument_function)) setup_ring(char *ring,
+		size_t size, struct trace_hdr *early)
+{
+	ulong oldest, seq, count = 0;
+
+	hdr->ring = ring;
+	hdr->ring_blocks = size / TRACE_BLOCK_SIZE;
+	hdr->head = 0;
+	hdr->block = NULL;
+	if (!hdr->ring_blocks)
+		return;
+
+	if (early && early->block) {
+		oldest = early->head - min(early->head, early->ring_blocks - 1);
+		for (seq = oldest; seq <= early->head; seq++) {
+			struct trace_block *block = (struct trace_block *)
+				(early->ring +
+				 seq % early->ring_blocks * TRACE_BLOCK_SIZE);
+
+			if (early->head - seq >= hdr->ring_blocks) {
+				hdr->ftrace_lost += block->count;
+				continue;
+			}
+			memcpy(trace_get_block(count++), block,
+			       TRACE_BLOCK_SIZE);
+		}
+	}
+	if (count) {
+		hdr->head = count - 1;
+		hdr->block = trace_get_block(hdr->head);
+	} else {
+		hdr->block = trace_get_block(0);
+		start_block(hdr->block, timer_get_us());
+	}
+}
+
 /**
  * Init the tracing system ready for used, and enable it
  *
@@ -280,49 +493,43 @@ int __attribute__((no_instrument_function)) trace_init(void *buff,
 		size_t buff_size)
 {
 	ulong func_count = gd->mon_len / FUNC_SITE_SIZE;
+	struct trace_hdr *early = NULL;
 	size_t needed;
 	int was_disabled = !trace_enabled;
 
+	needed = sizeof(*hdr) + func_count * sizeof(struct trace_accum);
+	if (needed > buff_size) {
+		printf("trace: buffer size %zd bytes: at least %zd needed\n",
+		       buff_size, needed);
+		return -1;
+	}
+
 	if (!was_disabled) {
 #ifdef CONFIG_TRACE_EARLY
-		char *end;
-		ulong used;
-
 		/*
 		 * Copy over the early trace data if we have it. Disable
 		 * tracing while we are doing this.
 		 */
 		trace_enabled = 0;
-		hdr = map_sysmem(CONFIG_TRACE_EARLY_ADDR,
-				 CONFIG_TRACE_EARLY_SIZE);
-		end = (char *)&hdr->ftrace[hdr->ftrace_count];
-		used = end - (char *)hdr;
-		printf("trace: copying %08lx bytes of early data from %x to %08lx\n",
-		       used, CONFIG_TRACE_EARLY_ADDR,
-		       (ulong)map_to_sysmem(buff));
-		memcpy(buff, hdr, used);
+		early = map_sysmem(CONFIG_TRACE_EARLY_ADDR,
+				   CONFIG_TRACE_EARLY_SIZE);
+		printf("trace: copying early data from %x to %08lx\n",
+		       CONFIG_TRACE_EARLY_ADDR, (ulong)map_to_sysmem(buff));
+		memcpy(buff, early, needed);
 #else
 		puts("trace: already enabled\n");
 		return -1;
 #endif
 	}
 	hdr = (struct trace_hdr *)buff;
-	needed = sizeof(*hdr) + func_count * sizeof(uintptr_t);
-	if (needed > buff_size) {
-		printf("trace: buffer size %zd bytes: at least %zd needed\n",
-		       buff_size, needed);
-		return -1;
-	}
 
 	if (was_disabled)
 		memset(hdr, '\0', needed);
 	hdr->func_count = func_count;
-	hdr->call_accum = (uintptr_t *)(hdr + 1);
+	hdr->call_accum = (struct trace_accum *)(hdr + 1);
 
 	/* Use any remaining space for the timed function trace */
-	hdr->ftrace = (struct trace_call *)(buff + needed);
-	hdr->ftrace_size = (buff_size - needed) / sizeof(*hdr->ftrace);
-	add_textbase();
+	setup_ring(buff + needed, buff_size - needed, early);
 
 	puts("trace: enabled\n");
 	hdr->depth_limit = 15;
@@ -343,7 +550,7 @@ int __attribute__((no_instrument_function)) trace_early_init(void)
 		return 0;
 
 	hdr = map_sysmem(CONFIG_TRACE_EARLY_ADDR, CONFIG_TRACE_EARLY_SIZE);
-	needed = sizeof(*hdr) + func_count * sizeof(uintptr_t);
+	needed = sizeof(*hdr) + func_count * sizeof(struct trace_accum);
 	if (needed > buff_size) {
 		printf("trace: buffer size is %zd bytes, at least %zd needed\n",
 		       buff_size, needed);
@@ -351,13 +558,11 @@ int __attribute__((no_instrument_function)) trace_early_init(void)
 	}
 
 	memset(hdr, '\0', needed);
-	hdr->call_accum = (uintptr_t *)(hdr + 1);
+	hdr->call_accum = (struct trace_accum *)(hdr + 1);
 	hdr->func_count = func_count;
 
 	/* Use any remaining space for the timed function trace */
-	hdr->ftrace = (struct trace_call *)((char *)hdr + needed);
-	hdr->ftrace_size = (buff_size - needed) / sizeof(*hdr->ftrace);
-	add_textbase();
+	setup_ring((char *)hdr + needed, buff_size - needed, NULL);
 	hdr->depth_limit = 200;
 	printf("trace: early enable at %08x\n", CONFIG_TRACE_EARLY_ADDR);
 
@@ -31,6 +31,74 @@
 #  define PUP(a) *++(a)
 #endif
 
+/*
+   U-Boot: on machines with a 64-bit unsigned long, the bit buffer is
+   refilled with a single unaligned eight byte load while at least eight
+   input bytes remain, leaving 48 or more bits in hold. Only six of those
+   bytes are counted in bits; the other two land above them in hold, which
+   is harmless because a later refill loads exactly the same bits into the
+   same place. For the same reason every refill ORs into hold rather than
+   adding to it.
+ */
+#define WIDE_HOLD (sizeof(unsigned long) >= 8)
+
+#define REFILL() \
+    do { \
+        if (WIDE_HOLD && in < wlast) { \
+            hold |= (unsigned long)get_unaligned_le64(in + OFF) << bits; \
+            in += 6; \
+            bits += 48; \
+        } \
+        else { \
+            hold |= (unsigned long)(PUP(in)) << bits; \
+            bits += 8; \
+            hold |= (unsigned long)(PUP(in)) << bits; \
+            bits += 8; \
+        } \
+    } while (0)
+
+/*
+   U-Boot: copy a match of len bytes starting dist bytes back from dst, the
+   next output byte, and return the new end of the output. A distance of one
+   is a run of a single byte; when the distance is at least a word the copy
+   goes a word at a time, since each word read lies entirely before the
+   word being written. inflate_fast() always has room for 258 bytes, so a
+   match of up to 250 bytes may be rounded up to whole words: the bytes
+   written past its end are overwritten by what follows.
+ */
+local unsigned char FAR *copy_match(unsigned char FAR *dst, unsigned dist,
+                                    unsigned len)
+{
+    unsigned char FAR *from = dst - dist;
+    unsigned char FAR *end = dst + len;
+
+    if (dist == 1) {
+        memset(dst, *from, len);
+        return end;
+    }
+    if (dist >= sizeof(unsigned long)) {
+        if (len <= MAX_MATCH - 8) {
+            do {
+                put_unaligned(get_unaligned((unsigned long *)from),
+                              (unsigned long *)dst);
+                from += sizeof(unsigned long);
+                dst += sizeof(unsigned long);
+            } while (dst < end);
+            return end;
+        }
+        while (len >= sizeof(unsigned long)) {
+            put_unaligned(get_unaligned((unsigned long *)from),
+                          (unsigned long *)dst);
+            from += sizeof(unsigned long);
+            dst += sizeof(unsigned long);
+            len -= sizeof(unsigned long);
+        }
+    }
+    while (len--)
+        *dst++ = *from++;
+    return dst;
+}
+
 /*
    Decode literal, length, and distance codes and write out the resulting
    literal and match bytes until either not enough input or output is
@@ -72,6 +140,7 @@ void inflate_fast(z_streamp strm, unsigned start)
     struct inflate_state FAR *state;
     unsigned char FAR *in;      /* local strm->next_in */
     unsigned char FAR *last;    /* while in < last, enough input available */
+    unsigned char FAR *wlast;   /* while in < wlast, wide refills are safe */
     unsigned char FAR *out;     /* local strm->next_out */
     unsigned char FAR *beg;     /* inflate()'s initial strm->next_out */
     unsigned char FAR *end;     /* while out < end, enough space available */
@@ -107,6 +176,7 @@ void inflate_fast(z_streamp strm, unsigned start)
 	strm->avail_in = 0xffffffff - (uintptr_t)in;
         last = in + (strm->avail_in - 5);
     }
+    wlast = in + (strm->avail_in > 7 ? strm->avail_in - 7 : 0);
     out = strm->next_out - OFF;
     beg = out - (start - strm->avail_out);
     end = out + (strm->avail_out - 257);
@@ -127,12 +197,8 @@ void inflate_fast(z_streamp strm, unsigned start)
     /* decode literals and length/distances until end-of-block or not enough
        input data or output space */
     do {
-        if (bits < 15) {
-            hold += (unsigned long)(PUP(in)) << bits;
-            bits += 8;
-            hold += (unsigned long)(PUP(in)) << bits;
-            bits += 8;
-        }
+        if (bits < 15)
+            REFILL();
         this = lcode[hold & lmask];
       dolen:
         op = (unsigned)(this.bits);
@@ -150,7 +216,7 @@ void inflate_fast(z_streamp strm, unsigned start)
             op &= 15;                           /* number of extra bits */
             if (op) {
                 if (bits < op) {
-                    hold += (unsigned long)(PUP(in)) << bits;
+                    hold |= (unsigned long)(PUP(in)) << bits;
                     bits += 8;
                 }
                 len += (unsigned)hold & ((1U << op) - 1);
@@ -158,12 +224,8 @@ void inflate_fast(z_streamp strm, unsigned start)
                 bits -= op;
             }
             Tracevv((stderr, "inflate:         length %u\n", len));
-            if (bits < 15) {
-                hold += (unsigned long)(PUP(in)) << bits;
-                bits += 8;
-                hold += (unsigned long)(PUP(in)) << bits;
-                bits += 8;
-            }
+            if (bits < 15)
+                REFILL();
             this = dcode[hold & dmask];
           dodist:
             op = (unsigned)(this.bits);
@@ -174,10 +236,10 @@ void inflate_fast(z_streamp strm, unsigned start)
                 dist = (unsigned)(this.val);
                 op &= 15;                       /* number of extra bits */
                 if (bits < op) {
-                    hold += (unsigned long)(PUP(in)) << bits;
+                    hold |= (unsigned long)(PUP(in)) << bits;
                     bits += 8;
                     if (bits < op) {
-                        hold += (unsigned long)(PUP(in)) << bits;
+                        hold |= (unsigned long)(PUP(in)) << bits;
                         bits += 8;
                     }
                 }
@@ -253,47 +315,8 @@ void inflate_fast(z_streamp strm, unsigned start)
                     }
                 }
                 else {
-		    unsigned short *sout;
-		    unsigned long loops;
-
-                    from = out - dist;          /* copy direct from output */
-                    /* minimum length is three */
-		    /* Align out addr */
-		    if (!((long)(out - 1 + OFF) & 1)) {
-			PUP(out) = PUP(from);
-			len--;
-		    }
-		    sout = (unsigned short *)(out - OFF);
-		    if (dist > 2 ) {
-			unsigned short *sfrom;
-
-			sfrom = (unsigned short *)(from - OFF);
-			loops = len >> 1;
-			do
-			    PUP(sout) = get_unaligned(++sfrom);
-			while (--loops);
-			out = (unsigned char *)sout + OFF;
-			from = (unsigned char *)sfrom + OFF;
-		    } else { /* dist == 1 or dist == 2 */
-			unsigned short pat16;
-
-			pat16 = *(sout-2+2*OFF);
-			if (dist == 1)
-#if defined(__BIG_ENDIAN)
-			    pat16 = (pat16 & 0xff) | ((pat16 & 0xff ) << 8);
-#elif defined(__LITTLE_ENDIAN)
-			    pat16 = (pat16 & 0xff00) | ((pat16 & 0xff00 ) >> 8);
-#else
-#error __BIG_ENDIAN nor __LITTLE_ENDIAN is defined
-#endif
-			loops = len >> 1;
-			do
-			    PUP(sout) = pat16;
-			while (--loops);
-			out = (unsigned char *)sout + OFF;
-		    }
-		    if (len & 1)
-			PUP(out) = PUP(from);
+                    /* copy direct from output */
+                    out = copy_match(out + OFF, dist, len) - OFF;
                 }
             }
             else if ((op & 64) == 0) {          /* 2nd level distance code */
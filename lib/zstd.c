@@ -0,0 +1,1125 @@
+/*
+ * Zstandard decompressor
+ *
+ * This is a compact, single-pass implementation of the Zstandard frame
+ * format as described in RFC 8878. It decodes into a flat output buffer,
+ * so no separate window is kept: back-references are resolved against the
+ * data already written for the current frame. Dictionaries are not
+ * supported.
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <errno.h>
+#include <malloc.h>
+#include <asm/unaligned.h>
+#include <linux/bitops.h>
+#include <linux/compiler.h>
+#include <linux/kernel.h>
+
+#define ZSTD_MAGIC		0xfd2fb528
+#define ZSTD_SKIP_MAGIC		0x184d2a50	/* low nibble is user-defined */
+#define ZSTD_SKIP_MASK		0xfffffff0
+
+#define ZSTD_BLOCK_MAX		(128 << 10)
+
+#define ZSTD_BLOCK_RAW		0
+#define ZSTD_BLOCK_RLE		1
+#define ZSTD_BLOCK_COMPRESSED	2
+
+#define ZSTD_LIT_RAW		0
+#define ZSTD_LIT_RLE		1
+#define ZSTD_LIT_COMPRESSED	2
+#define ZSTD_LIT_TREELESS	3
+
+#define ZSTD_MODE_PREDEFINED	0
+#define ZSTD_MODE_RLE		1
+#define ZSTD_MODE_FSE		2
+#define ZSTD_MODE_REPEAT	3
+
+#define ZSTD_HUF_LOG_MAX	11
+#define ZSTD_HUF_WEIGHTS_LOG	6
+#define ZSTD_LL_LOG_MAX		9
+#define ZSTD_ML_LOG_MAX		9
+#define ZSTD_OF_LOG_MAX		8
+#define ZSTD_FSE_LOG_MAX	9
+
+#define ZSTD_LL_MAX		35
+#define ZSTD_ML_MAX		52
+#define ZSTD_OF_MAX		31
+
+static const u32 zstd_ll_base[ZSTD_LL_MAX + 1] = {
+	0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+	16, 18, 20, 22, 24, 28, 32, 40, 48, 64, 128, 256, 512, 1024, 2048,
+	4096, 8192, 16384, 32768, 65536,
+};
+
+static const u8 zstd_ll_bits[ZSTD_LL_MAX + 1] = {
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	1, 1, 1, 1, 2, 2, 3, 3, 4, 6, 7, 8, 9, 10, 11, 12,
+	13, 14, 15, 16,
+};
+
+static const u32 zstd_ml_base[ZSTD_ML_MAX + 1] = {
+	3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18,
+	19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34,
+	35, 37, 39, 41, 43, 47, 51, 59, 67, 83, 99, 131, 259, 515, 1027,
+	2051, 4099, 8195, 16387, 32771, 65539,
+};
+
+static const u8 zstd_ml_bits[ZSTD_ML_MAX + 1] = {
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	1, 1, 1, 1, 2, 2, 3, 3, 4, 4, 5, 7, 8, 9, 10, 11,
+	12, 13, 14, 15, 16,
+};
+
+/* Predefined distributions, used when a table is in ZSTD_MODE_PREDEFINED */
+static const s16 zstd_ll_default[ZSTD_LL_MAX + 1] = {
+	4, 3, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 1, 1, 1,
+	2, 2, 2, 2, 2, 2, 2, 2, 2, 3, 2, 1, 1, 1, 1, 1,
+	-1, -1, -1, -1,
+};
+
+static const s16 zstd_ml_default[ZSTD_ML_MAX + 1] = {
+	1, 4, 3, 2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, -1, -1,
+	-1, -1, -1, -1, -1,
+};
+
+static const s16 zstd_of_default[29] = {
+	1, 1, 1, 1, 1, 1, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, -1, -1, -1, -1, -1,
+};
+
+struct zstd_fse_entry {
+	u8 symbol;
+	u8 nbits;
+	u16 base;
+};
+
+struct zstd_fse_table {
+	int log;
+	bool valid;
+	struct zstd_fse_entry e[1 << ZSTD_FSE_LOG_MAX];
+};
+
+struct zstd_huf_entry {
+	u8 symbol;
+	u8 nbits;
+};
+
+struct zstd_ctx {
+	/* state carried between the blocks of a frame */
+	u32 rep[3];
+	int huf_log;			/* 0 if no Huffman table yet */
+	struct zstd_huf_entry huf[1 << ZSTD_HUF_LOG_MAX];
+	struct zstd_fse_table ll, of, ml;
+	struct zstd_fse_table scratch;	/* Huffman weight decoding */
+	u8 lit[ZSTD_BLOCK_MAX];		/* decoded literals of a block */
+};
+
+/*
+ * Backward bit stream, as used for Huffman and FSE coded data. The stream
+ * is read from its last byte towards the first; the highest set bit of the
+ * last byte marks the start. Bits are taken from the top of a 64-bit
+ * container holding the eight bytes at @ptr.
+ */
+struct zstd_bits {
+	const u8 *start;
+	const u8 *ptr;
+	u64 container;
+	unsigned int consumed;
+};
+
+enum {
+	ZSTD_BITS_MORE,		/* container refilled */
+	ZSTD_BITS_END,		/* reached the start of the stream */
+	ZSTD_BITS_DONE,		/* all bits consumed exactly */
+	ZSTD_BITS_OVERFLOW,	/* read past the start: corrupt */
+};
+
+static int zstd_bits_init(struct zstd_bits *br, const u8 *src, size_t len)
+{
+	u8 last;
+	int i;
+
+	if (!len)
+		return -EPROTO;
+	last = src[len - 1];
+	if (!last)
+		return -EPROTO;
+	br->start = src;
+	if (len >= sizeof(u64)) {
+		br->ptr = src + len - sizeof(u64);
+		br->container = get_unaligned_le64(br->ptr);
+		br->consumed = 8 - (fls(last) - 1);
+	} else {
+		br->ptr = src;
+		br->container = 0;
+		for (i = 0; i < len; i++)
+			br->container |= (u64)src[i] << (8 * i);
+		br->consumed = 8 - (fls(last) - 1) + (sizeof(u64) - len) * 8;
+	}
+
+	return 0;
+}
+
+static inline u64 zstd_bits_look(const struct zstd_bits *br, int nbits)
+{
+	return (br->container << (br->consumed & 63)) >> 1 >> (63 - nbits);
+}
+
+static inline u32 zstd_bits_read(struct zstd_bits *br, int nbits)
+{
+	u32 val = zstd_bits_look(br, nbits);
+
+	br->consumed += nbits;
+	return val;
+}
+
+static inline int zstd_bits_reload(struct zstd_bits *br)
+{
+	unsigned int nbytes;
+
+	if (br->consumed > 64)
+		return ZSTD_BITS_OVERFLOW;
+	if (br->ptr >= br->start + sizeof(u64)) {
+		br->ptr -= br->consumed >> 3;
+		br->consumed &= 7;
+		br->container = get_unaligned_le64(br->ptr);
+		return ZSTD_BITS_MORE;
+	}
+	if (br->ptr == br->start)
+		return br->consumed < 64 ? ZSTD_BITS_END : ZSTD_BITS_DONE;
+	nbytes = br->consumed >> 3;
+	if (nbytes > br->ptr - br->start)
+		nbytes = br->ptr - br->start;
+	br->ptr -= nbytes;
+	br->consumed -= nbytes * 8;
+	br->container = get_unaligned_le64(br->ptr);
+
+	return ZSTD_BITS_MORE;
+}
+
+static bool zstd_bits_done(const struct zstd_bits *br)
+{
+	return br->ptr == br->start && br->consumed == 64;
+}
+
+/* Read up to 24 bits of a forward (little-endian) bit stream */
+static u32 zstd_peek_fwd(const u8 *src, size_t len, size_t pos)
+{
+	size_t i = pos >> 3;
+	u32 val = 0;
+	int k;
+
+	for (k = 0; k < 4 && i + k < len; k++)
+		val |= (u32)src[i + k] << (8 * k);
+
+	return val >> (pos & 7);
+}
+
+/**
+ * zstd_fse_read_counts() - read an FSE table description
+ *
+ * @src:	start of the description
+ * @len:	bytes available at @src
+ * @norm:	returns the normalised count of each symbol
+ * @max_sym:	on entry the largest allowed symbol, on exit the largest one
+ *		present
+ * @logp:	returns the accuracy log of the table
+ * @max_log:	largest accuracy log allowed
+ * @return number of bytes used, or -ve on error
+ */
+static int zstd_fse_read_counts(const u8 *src, size_t len, s16 *norm,
+				int *max_sym, int *logp, int max_log)
+{
+	int remaining, threshold, nbits, log;
+	size_t pos = 4;
+	int sym = 0;
+
+	if (!len)
+		return -EINVAL;
+	log = (src[0] & 0xf) + 5;
+	if (log > max_log)
+		return -EPROTO;
+	remaining = (1 << log) + 1;
+	threshold = 1 << log;
+	nbits = log + 1;
+
+	while (remaining > 1) {
+		u32 val = zstd_peek_fwd(src, len, pos);
+		int max = (2 * threshold - 1) - remaining;
+		int count;
+
+		if (sym > *max_sym)
+			return -EPROTO;
+		if ((val & (threshold - 1)) < max) {
+			count = val & (threshold - 1);
+			pos += nbits - 1;
+		} else {
+			count = val & (2 * threshold - 1);
+			if (count >= threshold)
+				count -= max;
+			pos += nbits;
+		}
+		count--;	/* -1 means "less than one" */
+		remaining -= abs(count);
+		norm[sym++] = count;
+		if (remaining < 1)
+			return -EPROTO;
+
+		/* a zero is followed by 2-bit repeat flags for more zeroes */
+		while (!count) {
+			int repeat = zstd_peek_fwd(src, len, pos) & 3;
+			int i;
+
+			pos += 2;
+			if (sym + repeat > *max_sym + 1)
+				return -EPROTO;
+			for (i = 0; i < repeat; i++)
+				norm[sym++] = 0;
+			if (repeat != 3)
+				break;
+		}
+		while (remaining < threshold) {
+			nbits--;
+			threshold >>= 1;
+		}
+	}
+	if (pos > len * 8)
+		return -EINVAL;
+	*max_sym = sym - 1;
+	*logp = log;
+
+	return (pos + 7) / 8;
+}
+
+static int zstd_fse_build(struct zstd_fse_table *t, const s16 *norm,
+			  int max_sym, int log)
+{
+	int size = 1 << log;
+	int high = size - 1;
+	int step = (size >> 1) + (size >> 3) + 3;
+	u16 next[ZSTD_ML_MAX + 1];
+	int pos = 0;
+	int sym, i;
+
+	for (sym = 0; sym <= max_sym; sym++) {
+		if (norm[sym] == -1) {
+			t->e[high--].symbol = sym;
+			next[sym] = 1;
+		} else {
+			next[sym] = norm[sym];
+		}
+	}
+	for (sym = 0; sym <= max_sym; sym++) {
+		for (i = 0; i < norm[sym]; i++) {
+			t->e[pos].symbol = sym;
+			do {
+				pos = (pos + step) & (size - 1);
+			} while (pos > high);
+		}
+	}
+	if (pos)
+		return -EPROTO;
+
+	for (i = 0; i < size; i++) {
+		u32 state = next[t->e[i].symbol]++;
+		int nbits = log - (fls(state) - 1);
+
+		t->e[i].nbits = nbits;
+		t->e[i].base = (state << nbits) - size;
+	}
+	t->log = log;
+	t->valid = true;
+
+	return 0;
+}
+
+static void zstd_fse_rle(struct zstd_fse_table *t, u8 symbol)
+{
+	t->e[0].symbol = symbol;
+	t->e[0].nbits = 0;
+	t->e[0].base = 0;
+	t->log = 0;
+	t->valid = true;
+}
+
+static inline u8 zstd_fse_decode(const struct zstd_fse_table *t, u32 *state,
+				 struct zstd_bits *br)
+{
+	const struct zstd_fse_entry *e = &t->e[*state];
+
+	*state = e->base + zstd_bits_read(br, e->nbits);
+
+	return e->symbol;
+}
+
+/* Decode the FSE-compressed weights of a Huffman table description */
+static int zstd_huf_fse_weights(struct zstd_ctx *ctx, u8 *weights,
+				const u8 *src, size_t len)
+{
+	struct zstd_fse_table *t = &ctx->scratch;
+	struct zstd_bits br;
+	int max_sym = ZSTD_HUF_LOG_MAX;
+	s16 norm[ZSTD_HUF_LOG_MAX + 1];
+	u32 state1, state2;
+	int log, ret;
+	int n = 0;
+
+	ret = zstd_fse_read_counts(src, len, norm, &max_sym, &log,
+				   ZSTD_HUF_WEIGHTS_LOG);
+	if (ret < 0)
+		return ret;
+	if (zstd_fse_build(t, norm, max_sym, log))
+		return -EPROTO;
+	if (zstd_bits_init(&br, src + ret, len - ret))
+		return -EPROTO;
+
+	state1 = zstd_bits_read(&br, log);
+	state2 = zstd_bits_read(&br, log);
+	zstd_bits_reload(&br);
+
+	/* two interleaved states share the stream until it runs dry */
+	for (;;) {
+		if (n + 2 > 255)
+			return -EPROTO;
+		weights[n++] = zstd_fse_decode(t, &state1, &br);
+		if (zstd_bits_reload(&br) == ZSTD_BITS_OVERFLOW) {
+			weights[n++] = t->e[state2].symbol;
+			break;
+		}
+		if (n + 2 > 255)
+			return -EPROTO;
+		weights[n++] = zstd_fse_decode(t, &state2, &br);
+		if (zstd_bits_reload(&br) == ZSTD_BITS_OVERFLOW) {
+			weights[n++] = t->e[state1].symbol;
+			break;
+		}
+	}
+
+	return n;
+}
+
+/* Read a Huffman tree description and build the decoding table */
+static int zstd_huf_read(struct zstd_ctx *ctx, const u8 *src, size_t len)
+{
+	u32 rank[ZSTD_HUF_LOG_MAX + 2];
+	u32 count[ZSTD_HUF_LOG_MAX + 2];
+	u8 weights[256];
+	u32 total = 0, rest;
+	int nweights, size;
+	int log, w, i;
+
+	if (!len)
+		return -EINVAL;
+	if (src[0] >= 128) {
+		nweights = src[0] - 127;
+		size = (nweights + 1) / 2;
+		if (1 + size > len)
+			return -EINVAL;
+		for (i = 0; i < nweights; i++) {
+			u8 byte = src[1 + i / 2];
+
+			weights[i] = i & 1 ? byte & 0xf : byte >> 4;
+		}
+	} else {
+		size = src[0];
+		if (1 + size > len)
+			return -EINVAL;
+		nweights = zstd_huf_fse_weights(ctx, weights, src + 1, size);
+		if (nweights < 0)
+			return nweights;
+	}
+
+	memset(count, '\0', sizeof(count));
+	for (i = 0; i < nweights; i++) {
+		if (weights[i] > ZSTD_HUF_LOG_MAX)
+			return -EPROTO;
+		count[weights[i]]++;
+		if (weights[i])
+			total += 1 << (weights[i] - 1);
+	}
+	if (!total)
+		return -EPROTO;
+
+	/* the weight of the last symbol is implied */
+	log = fls(total);
+	if (log > ZSTD_HUF_LOG_MAX)
+		return -EPROTO;
+	rest = (1 << log) - total;
+	if (rest & (rest - 1))
+		return -EPROTO;
+	weights[nweights] = fls(rest);
+	count[weights[nweights]]++;
+	nweights++;
+	if (count[1] < 2 || count[1] & 1)
+		return -EPROTO;
+
+	/* longest codes (lowest weights) come first in the table */
+	rank[1] = 0;
+	for (w = 1; w <= log; w++)
+		rank[w + 1] = rank[w] + (count[w] << (w - 1));
+
+	for (i = 0; i < nweights; i++) {
+		struct zstd_huf_entry entry;
+		u32 start, length, j;
+
+		w = weights[i];
+		if (!w)
+			continue;
+		entry.symbol = i;
+		entry.nbits = log + 1 - w;
+		start = rank[w];
+		length = 1 << (w - 1);
+		for (j = 0; j < length; j++)
+			ctx->huf[start + j] = entry;
+		rank[w] += length;
+	}
+	ctx->huf_log = log;
+
+	return 1 + size;
+}
+
+static int zstd_huf_stream(struct zstd_ctx *ctx, u8 *dst, size_t n,
+			   const u8 *src, size_t len)
+{
+	const struct zstd_huf_entry *huf = ctx->huf;
+	const int log = ctx->huf_log;
+	u8 *end = dst + n;
+	struct zstd_bits br;
+
+	if (zstd_bits_init(&br, src, len))
+		return -EPROTO;
+
+	/* a refilled container always holds four symbols */
+	while (end - dst >= 4) {
+		int i;
+
+		zstd_bits_reload(&br);
+		for (i = 0; i < 4; i++) {
+			const struct zstd_huf_entry *e;
+
+			e = &huf[zstd_bits_look(&br, log)];
+			*dst++ = e->symbol;
+			br.consumed += e->nbits;
+		}
+	}
+	while (dst < end) {
+		const struct zstd_huf_entry *e;
+
+		zstd_bits_reload(&br);
+		e = &huf[zstd_bits_look(&br, log)];
+		*dst++ = e->symbol;
+		br.consumed += e->nbits;
+	}
+	zstd_bits_reload(&br);
+	if (!zstd_bits_done(&br))
+		return -EPROTO;
+
+	return 0;
+}
+
+static int zstd_huf_decode(struct zstd_ctx *ctx, u8 *dst, size_t n,
+			   const u8 *src, size_t len, bool four)
+{
+	size_t size[4], seg;
+	int i, ret;
+
+	if (!four)
+		return zstd_huf_stream(ctx, dst, n, src, len);
+
+	if (len < 6)
+		return -EINVAL;
+	size[0] = get_unaligned_le16(src);
+	size[1] = get_unaligned_le16(src + 2);
+	size[2] = get_unaligned_le16(src + 4);
+	if (size[0] + size[1] + size[2] + 6 > len)
+		return -EINVAL;
+	size[3] = len - 6 - size[0] - size[1] - size[2];
+	src += 6;
+
+	seg = (n + 3) / 4;
+	if (seg * 3 > n)
+		return -EPROTO;
+	for (i = 0; i < 4; i++) {
+		size_t count = i < 3 ? seg : n - seg * 3;
+
+		ret = zstd_huf_stream(ctx, dst, count, src, size[i]);
+		if (ret)
+			return ret;
+		dst += count;
+		src += size[i];
+	}
+
+	return 0;
+}
+
+/**
+ * zstd_literals() - decode the literals section of a compressed block
+ *
+ * @ctx:	decompression context
+ * @src:	start of the block
+ * @len:	size of the block
+ * @litp:	returns a pointer to the literals
+ * @litlenp:	returns the number of literals
+ * @return number of bytes used, or -ve on error
+ */
+static int zstd_literals(struct zstd_ctx *ctx, const u8 *src, size_t len,
+			 const u8 **litp, size_t *litlenp)
+{
+	int type = src[0] & 3;
+	int format = (src[0] >> 2) & 3;
+	size_t hsize, regen, csize;
+	bool four = true;
+	int ret;
+
+	if (type == ZSTD_LIT_RAW || type == ZSTD_LIT_RLE) {
+		switch (format) {
+		case 1:
+			hsize = 2;
+			break;
+		case 3:
+			hsize = 3;
+			break;
+		default:
+			hsize = 1;
+			break;
+		}
+		if (hsize > len)
+			return -EINVAL;
+		if (hsize == 1)
+			regen = src[0] >> 3;
+		else if (hsize == 2)
+			regen = (src[0] >> 4) + (src[1] << 4);
+		else
+			regen = (src[0] >> 4) + (src[1] << 4) + (src[2] << 12);
+		if (regen > ZSTD_BLOCK_MAX)
+			return -EPROTO;
+		*litlenp = regen;
+		if (type == ZSTD_LIT_RAW) {
+			if (hsize + regen > len)
+				return -EINVAL;
+			*litp = src + hsize;
+			return hsize + regen;
+		}
+		if (hsize + 1 > len)
+			return -EINVAL;
+		memset(ctx->lit, src[hsize], regen);
+		*litp = ctx->lit;
+		return hsize + 1;
+	}
+
+	hsize = format < 2 ? 3 : format + 2;
+	if (hsize > len)
+		return -EINVAL;
+	switch (format) {
+	case 0:
+		four = false;
+		/* fall through */
+	case 1: {
+		u32 lhc = src[0] | src[1] << 8 | src[2] << 16;
+
+		regen = (lhc >> 4) & 0x3ff;
+		csize = (lhc >> 14) & 0x3ff;
+		break;
+	}
+	case 2: {
+		u32 lhc = get_unaligned_le32(src);
+
+		regen = (lhc >> 4) & 0x3fff;
+		csize = lhc >> 18;
+		break;
+	}
+	default: {
+		u32 lhc = get_unaligned_le32(src);
+
+		regen = (lhc >> 4) & 0x3ffff;
+		csize = (lhc >> 22) + (src[4] << 10);
+		break;
+	}
+	}
+	if (regen > ZSTD_BLOCK_MAX)
+		return -EPROTO;
+	if (hsize + csize > len)
+		return -EINVAL;
+	src += hsize;
+	len = csize;
+
+	if (type == ZSTD_LIT_COMPRESSED) {
+		ret = zstd_huf_read(ctx, src, len);
+		if (ret < 0)
+			return ret;
+		src += ret;
+		len -= ret;
+	} else if (!ctx->huf_log) {
+		return -EPROTO;
+	}
+	ret = zstd_huf_decode(ctx, ctx->lit, regen, src, len, four);
+	if (ret)
+		return ret;
+	*litp = ctx->lit;
+	*litlenp = regen;
+
+	return hsize + csize;
+}
+
+static int zstd_seq_table(struct zstd_fse_table *t, int mode, const u8 **ipp,
+			  const u8 *iend, const s16 *def, int def_max,
+			  int def_log, int max_sym, int max_log)
+{
+	s16 norm[ZSTD_ML_MAX + 1];
+	int log, ret;
+
+	switch (mode) {
+	case ZSTD_MODE_PREDEFINED:
+		return zstd_fse_build(t, def, def_max, def_log);
+	case ZSTD_MODE_RLE:
+		if (*ipp >= iend)
+			return -EINVAL;
+		if (**ipp > max_sym)
+			return -EPROTO;
+		zstd_fse_rle(t, *(*ipp)++);
+		return 0;
+	case ZSTD_MODE_FSE:
+		ret = zstd_fse_read_counts(*ipp, iend - *ipp, norm, &max_sym,
+					   &log, max_log);
+		if (ret < 0)
+			return ret;
+		*ipp += ret;
+		return zstd_fse_build(t, norm, max_sym, log);
+	default:
+		return t->valid ? 0 : -EPROTO;
+	}
+}
+
+static void zstd_copy_match(u8 *op, size_t offset, size_t len, u8 *oend)
+{
+	const u8 *match = op - offset;
+	size_t i;
+
+	/* over-copy in 16-byte chunks while there is room past the match */
+	if (offset >= 16 && len + 16 <= oend - op) {
+		for (i = 0; i < len; i += 16)
+			memcpy(op + i, match + i, 16);
+		return;
+	}
+	if (offset >= len) {
+		memcpy(op, match, len);
+		return;
+	}
+	while (len >= 8 && offset >= 8) {
+		memcpy(op, match, 8);
+		op += 8;
+		match += 8;
+		len -= 8;
+	}
+	while (len--)
+		*op++ = *match++;
+}
+
+/* Work out the real offset from an offset value and the repeat history */
+static inline u32 zstd_offset(struct zstd_ctx *ctx, u32 value, u32 ll)
+{
+	u32 offset;
+	int idx;
+
+	if (value > 3) {
+		offset = value - 3;
+	} else {
+		idx = value - 1 + !ll;
+		if (idx < 3) {
+			offset = ctx->rep[idx];
+			if (idx) {
+				if (idx == 2)
+					ctx->rep[2] = ctx->rep[1];
+				ctx->rep[1] = ctx->rep[0];
+				ctx->rep[0] = offset;
+			}
+			return offset;
+		}
+		offset = ctx->rep[0] - 1;
+	}
+	ctx->rep[2] = ctx->rep[1];
+	ctx->rep[1] = ctx->rep[0];
+	ctx->rep[0] = offset;
+
+	return offset;
+}
+
+/**
+ * zstd_sequences() - decode and execute the sequences of a block
+ *
+ * @ctx:	decompression context
+ * @src:	start of the sequences section
+ * @len:	size of the sequences section
+ * @lit:	literals of the block
+ * @litlen:	number of literals
+ * @ostart:	start of the output for this frame
+ * @opp:	output pointer, updated on success
+ * @oend:	end of the output buffer
+ * @return 0 if OK, -ve on error
+ */
+static int zstd_sequences(struct zstd_ctx *ctx, const u8 *src, size_t len,
+			  const u8 *lit, size_t litlen, u8 *ostart, u8 **opp,
+			  u8 *oend)
+{
+	const u8 *iend = src + len;
+	const u8 *lend = lit + litlen;
+	const u8 *ip = src;
+	u32 ll_state = 0, of_state = 0, ml_state = 0;
+	struct zstd_bits br;
+	u8 *op = *opp;
+	int nseq, modes;
+	bool coded;
+	int ret;
+
+	if (ip >= iend)
+		return -EINVAL;
+	nseq = *ip++;
+	if (nseq >= 128) {
+		if (ip >= iend)
+			return -EINVAL;
+		if (nseq == 255) {
+			if (ip + 1 >= iend)
+				return -EINVAL;
+			nseq = get_unaligned_le16(ip) + 0x7f00;
+			ip += 2;
+		} else {
+			nseq = ((nseq - 128) << 8) + *ip++;
+		}
+	}
+
+	coded = nseq != 0;
+	if (coded) {
+		if (ip >= iend)
+			return -EINVAL;
+		modes = *ip++;
+		if (modes & 3)
+			return -EPROTO;
+		ret = zstd_seq_table(&ctx->ll, modes >> 6, &ip, iend,
+				     zstd_ll_default, ZSTD_LL_MAX, 6,
+				     ZSTD_LL_MAX, ZSTD_LL_LOG_MAX);
+		if (!ret)
+			ret = zstd_seq_table(&ctx->of, (modes >> 4) & 3, &ip,
+					     iend, zstd_of_default,
+					     ARRAY_SIZE(zstd_of_default) - 1,
+					     5, ZSTD_OF_MAX, ZSTD_OF_LOG_MAX);
+		if (!ret)
+			ret = zstd_seq_table(&ctx->ml, (modes >> 2) & 3, &ip,
+					     iend, zstd_ml_default, ZSTD_ML_MAX,
+					     6, ZSTD_ML_MAX, ZSTD_ML_LOG_MAX);
+		if (ret)
+			return ret;
+
+		if (zstd_bits_init(&br, ip, iend - ip))
+			return -EPROTO;
+		ll_state = zstd_bits_read(&br, ctx->ll.log);
+		of_state = zstd_bits_read(&br, ctx->of.log);
+		ml_state = zstd_bits_read(&br, ctx->ml.log);
+		zstd_bits_reload(&br);
+	}
+
+	while (nseq--) {
+		u8 llc = ctx->ll.e[ll_state].symbol;
+		u8 mlc = ctx->ml.e[ml_state].symbol;
+		u8 ofc = ctx->of.e[of_state].symbol;
+		u32 offset, ml, ll;
+
+		/* extra bits are read offset first, then match, then literal */
+		offset = (1U << ofc) + zstd_bits_read(&br, ofc);
+		zstd_bits_reload(&br);
+		ml = zstd_ml_base[mlc] + zstd_bits_read(&br, zstd_ml_bits[mlc]);
+		ll = zstd_ll_base[llc] + zstd_bits_read(&br, zstd_ll_bits[llc]);
+		zstd_bits_reload(&br);
+		if (nseq) {
+			zstd_fse_decode(&ctx->ll, &ll_state, &br);
+			zstd_fse_decode(&ctx->ml, &ml_state, &br);
+			zstd_fse_decode(&ctx->of, &of_state, &br);
+		}
+
+		offset = zstd_offset(ctx, offset, ll);
+		if (ll > lend - lit)
+			return -EPROTO;
+		if (ll + ml > oend - op)
+			return -ENOBUFS;
+		if (ll <= 16 && lend - lit >= 16 && oend - op >= ll + ml + 16)
+			memcpy(op, lit, 16);
+		else
+			memcpy(op, lit, ll);
+		op += ll;
+		lit += ll;
+		if (!offset || offset > op - ostart)
+			return -EPROTO;
+		zstd_copy_match(op, offset, ml, oend);
+		op += ml;
+	}
+	if (coded) {
+		zstd_bits_reload(&br);
+		if (!zstd_bits_done(&br))
+			return -EPROTO;
+	}
+
+	if (lend - lit > oend - op)
+		return -ENOBUFS;
+	memcpy(op, lit, lend - lit);
+	op += lend - lit;
+	*opp = op;
+
+	return 0;
+}
+
+static int zstd_block(struct zstd_ctx *ctx, const u8 *src, size_t len,
+		      u8 *ostart, u8 **opp, u8 *oend)
+{
+	const u8 *lit = NULL;
+	size_t litlen = 0;
+	int ret;
+
+	if (!len)
+		return -EINVAL;
+	ret = zstd_literals(ctx, src, len, &lit, &litlen);
+	if (ret < 0)
+		return ret;
+
+	return zstd_sequences(ctx, src + ret, len - ret, lit, litlen, ostart,
+			      opp, oend);
+}
+
+#define XXH_PRIME64_1	0x9e3779b185ebca87ULL
+#define XXH_PRIME64_2	0xc2b2ae3d27d4eb4fULL
+#define XXH_PRIME64_3	0x165667b19e3779f9ULL
+#define XXH_PRIME64_4	0x85ebca77c2b2ae63ULL
+#define XXH_PRIME64_5	0x27d4eb2f165667c5ULL
+
+static inline u64 xxh64_rotl(u64 val, int bits)
+{
+	return (val << bits) | (val >> (64 - bits));
+}
+
+static inline u64 xxh64_round(u64 acc, u64 input)
+{
+	acc += input * XXH_PRIME64_2;
+	acc = xxh64_rotl(acc, 31);
+
+	return acc * XXH_PRIME64_1;
+}
+
+static inline u64 xxh64_merge(u64 acc, u64 val)
+{
+	acc ^= xxh64_round(0, val);
+
+	return acc * XXH_PRIME64_1 + XXH_PRIME64_4;
+}
+
+/* XXH64 with a seed of 0, used for the frame content checksum */
+static u64 xxh64(const u8 *p, size_t len)
+{
+	const u8 *end = p + len;
+	u64 h;
+
+	if (len >= 32) {
+		u64 v1 = XXH_PRIME64_1 + XXH_PRIME64_2;
+		u64 v2 = XXH_PRIME64_2;
+		u64 v3 = 0;
+		u64 v4 = -XXH_PRIME64_1;
+
+		do {
+			v1 = xxh64_round(v1, get_unaligned_le64(p));
+			v2 = xxh64_round(v2, get_unaligned_le64(p + 8));
+			v3 = xxh64_round(v3, get_unaligned_le64(p + 16));
+			v4 = xxh64_round(v4, get_unaligned_le64(p + 24));
+			p += 32;
+		} while (end - p >= 32);
+		h = xxh64_rotl(v1, 1) + xxh64_rotl(v2, 7) +
+			xxh64_rotl(v3, 12) + xxh64_rotl(v4, 18);
+		h = xxh64_merge(h, v1);
+		h = xxh64_merge(h, v2);
+		h = xxh64_merge(h, v3);
+		h = xxh64_merge(h, v4);
+	} else {
+		h = XXH_PRIME64_5;
+	}
+	h += len;
+
+	for (; end - p >= 8; p += 8) {
+		h ^= xxh64_round(0, get_unaligned_le64(p));
+		h = xxh64_rotl(h, 27) * XXH_PRIME64_1 + XXH_PRIME64_4;
+	}
+	if (end - p >= 4) {
+		h ^= get_unaligned_le32(p) * XXH_PRIME64_1;
+		h = xxh64_rotl(h, 23) * XXH_PRIME64_2 + XXH_PRIME64_3;
+		p += 4;
+	}
+	for (; p < end; p++) {
+		h ^= *p * XXH_PRIME64_5;
+		h = xxh64_rotl(h, 11) * XXH_PRIME64_1;
+	}
+	h ^= h >> 33;
+	h *= XXH_PRIME64_2;
+	h ^= h >> 29;
+	h *= XXH_PRIME64_3;
+	h ^= h >> 32;
+
+	return h;
+}
+
+static int zstd_frame(struct zstd_ctx *ctx, const u8 **ipp, const u8 *iend,
+		      u8 **opp, u8 *oend)
+{
+	static const u8 did_size[] = { 0, 1, 2, 4 };
+	static const u8 fcs_size[] = { 0, 2, 4, 8 };
+	const u8 *ip = *ipp + 4;
+	u8 *ostart = *opp;
+	u8 *op = ostart;
+	int desc, nfcs, ndid;
+	u64 fcs = 0;
+	u32 did = 0;
+	bool last;
+	int i, ret;
+
+	if (ip >= iend)
+		return -EINVAL;
+	desc = *ip++;
+	if (desc & 0x08)
+		return -EPROTO;		/* reserved bit */
+	nfcs = fcs_size[desc >> 6];
+	if (!nfcs && (desc & 0x20))
+		nfcs = 1;		/* single segment: always one byte */
+	ndid = did_size[desc & 3];
+	if (!(desc & 0x20))
+		ip++;			/* window descriptor, not needed */
+	if (ndid + nfcs > iend - ip)
+		return -EINVAL;
+	for (i = 0; i < ndid; i++)
+		did |= *ip++ << (8 * i);
+	if (did)
+		return -EPROTONOSUPPORT;
+	for (i = 0; i < nfcs; i++)
+		fcs |= (u64)*ip++ << (8 * i);
+	if (nfcs == 2)
+		fcs += 256;
+
+	ctx->rep[0] = 1;
+	ctx->rep[1] = 4;
+	ctx->rep[2] = 8;
+	ctx->huf_log = 0;
+	ctx->ll.valid = false;
+	ctx->of.valid = false;
+	ctx->ml.valid = false;
+
+	do {
+		u32 hdr, size;
+
+		if (iend - ip < 3)
+			return -EINVAL;
+		hdr = ip[0] | ip[1] << 8 | ip[2] << 16;
+		ip += 3;
+		last = hdr & 1;
+		size = hdr >> 3;
+		switch ((hdr >> 1) & 3) {
+		case ZSTD_BLOCK_RAW:
+			if (size > iend - ip)
+				return -EINVAL;
+			if (size > oend - op)
+				return -ENOBUFS;
+			memcpy(op, ip, size);
+			op += size;
+			ip += size;
+			break;
+		case ZSTD_BLOCK_RLE:
+			if (ip >= iend)
+				return -EINVAL;
+			if (size > oend - op)
+				return -ENOBUFS;
+			memset(op, *ip++, size);
+			op += size;
+			break;
+		case ZSTD_BLOCK_COMPRESSED:
+			if (size > iend - ip)
+				return -EINVAL;
+			if (size > ZSTD_BLOCK_MAX)
+				return -EPROTO;
+			ret = zstd_block(ctx, ip, size, ostart, &op, oend);
+			if (ret)
+				return ret;
+			ip += size;
+			break;
+		default:
+			return -EPROTO;
+		}
+	} while (!last);
+
+	if (nfcs && fcs != op - ostart)
+		return -EPROTO;
+	if (desc & 0x04) {
+		if (iend - ip < 4)
+			return -EINVAL;
+		if ((u32)xxh64(ostart, op - ostart) != get_unaligned_le32(ip))
+			return -EPROTO;
+		ip += 4;
+	}
+	*ipp = ip;
+	*opp = op;
+
+	return 0;
+}
+
+int zstd_decompress(const void *src, size_t srcn, void *dst, size_t *dstn)
+{
+	const u8 *ip = src;
+	const u8 *iend;
+	u8 *op = dst;
+	u8 *oend;
+	struct zstd_ctx *ctx;
+	int frames = 0;
+	int ret = 0;
+
+	/* callers may pass ~0 for 'unknown', do not let the pointers wrap */
+	iend = ip + min(srcn, (size_t)(~(uintptr_t)0 - (uintptr_t)ip));
+	oend = op + min(*dstn, (size_t)(~(uintptr_t)0 - (uintptr_t)op));
+
+	ctx = malloc(sizeof(*ctx));
+	if (!ctx)
+		return -ENOMEM;
+
+	while (iend - ip >= 4) {
+		u32 magic = get_unaligned_le32(ip);
+
+		if ((magic & ZSTD_SKIP_MASK) == ZSTD_SKIP_MAGIC) {
+			u32 size;
+
+			if (iend - ip < 8) {
+				ret = -EINVAL;
+				break;
+			}
+			size = get_unaligned_le32(ip + 4);
+			if (size > iend - ip - 8) {
+				ret = -EINVAL;
+				break;
+			}
+			ip += 8 + size;
+			continue;
+		}
+		/* anything after the first frame that is not a frame ends it */
+		if (magic != ZSTD_MAGIC) {
+			if (!frames)
+				ret = -EPROTO;
+			break;
+		}
+		ret = zstd_frame(ctx, &ip, iend, &op, oend);
+		if (ret)
+			break;
+		frames++;
+	}
+	if (!ret && !frames)
+		ret = -EPROTO;
+	free(ctx);
+	*dstn = op - (u8 *)dst;
+
+	return ret;
+}
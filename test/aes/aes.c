@@ -0,0 +1,300 @@
+/*
+ * Tests and benchmarks for AES
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <errno.h>
+#include <hash.h>
+#include <malloc.h>
+#include <uboot_aes.h>
+#include <test/aes.h>
+#include <test/ut.h>
+
+#include "aes_vectors.h"
+
+/* Size of the buffers used for the hash and the benchmark */
+#define AES_TEST_BUF_SIZE	(1 << 20)
+
+struct aes_test_key {
+	int bits;
+	const u8 *key;
+	const u8 *cbc;
+	const u8 *ctr;
+};
+
+static const struct aes_test_key aes_test_keys[] = {
+	{ 128, aes128_key, aes128_cbc, aes128_ctr },
+	{ 192, aes192_key, aes192_cbc, aes192_ctr },
+	{ 256, aes256_key, aes256_cbc, aes256_ctr },
+};
+
+/* Test CBC encryption and decryption against known-good values */
+static int aes_test_cbc(struct unit_test_state *uts)
+{
+	const int len = sizeof(aes_test_plain);
+	const int blocks = len / AES_BLOCK_LENGTH;
+	const struct aes_test_key *key;
+	u8 buf[sizeof(aes_test_plain)];
+	u8 iv[AES_BLOCK_LENGTH];
+	struct aes_ctx ctx;
+
+	for (key = aes_test_keys; key < aes_test_keys +
+	     ARRAY_SIZE(aes_test_keys); key++) {
+		ut_assertok(aes_setkey(&ctx, key->key, key->bits / 8));
+
+		memcpy(iv, aes_test_cbc_iv, sizeof(iv));
+		aes_cbc_encrypt(&ctx, iv, aes_test_plain, buf, blocks);
+		ut_assertok(memcmp(key->cbc, buf, len));
+		/* the IV is left ready for the next block */
+		ut_assertok(memcmp(key->cbc + len - AES_BLOCK_LENGTH, iv,
+				   sizeof(iv)));
+
+		memcpy(iv, aes_test_cbc_iv, sizeof(iv));
+		aes_cbc_decrypt(&ctx, iv, key->cbc, buf, blocks);
+		ut_assertok(memcmp(aes_test_plain, buf, len));
+
+		/* in place, in two parts */
+		memcpy(iv, aes_test_cbc_iv, sizeof(iv));
+		memcpy(buf, aes_test_plain, len);
+		aes_cbc_encrypt(&ctx, iv, buf, buf, 1);
+		aes_cbc_encrypt(&ctx, iv, buf + AES_BLOCK_LENGTH,
+				buf + AES_BLOCK_LENGTH, blocks - 1);
+		ut_assertok(memcmp(key->cbc, buf, len));
+
+		memcpy(iv, aes_test_cbc_iv, sizeof(iv));
+		aes_cbc_decrypt(&ctx, iv, buf, buf, 1);
+		aes_cbc_decrypt(&ctx, iv, buf + AES_BLOCK_LENGTH,
+				buf + AES_BLOCK_LENGTH, blocks - 1);
+		ut_assertok(memcmp(aes_test_plain, buf, len));
+	}
+
+	return 0;
+}
+AES_TEST(aes_test_cbc, 0);
+
+/* Test CTR mode against known-good values */
+static int aes_test_ctr(struct unit_test_state *uts)
+{
+	const int len = sizeof(aes_test_plain);
+	const struct aes_test_key *key;
+	u8 buf[sizeof(aes_test_plain)];
+	u8 ctr[AES_BLOCK_LENGTH];
+	struct aes_ctx ctx;
+
+	for (key = aes_test_keys; key < aes_test_keys +
+	     ARRAY_SIZE(aes_test_keys); key++) {
+		ut_assertok(aes_setkey(&ctx, key->key, key->bits / 8));
+
+		memcpy(ctr, aes_test_ctr_iv, sizeof(ctr));
+		aes_ctr_crypt(&ctx, ctr, aes_test_plain, buf, len);
+		ut_assertok(memcmp(key->ctr, buf, len));
+
+		/* in place, ending with a partial block */
+		memcpy(ctr, aes_test_ctr_iv, sizeof(ctr));
+		memcpy(buf, key->ctr, len);
+		aes_ctr_crypt(&ctx, ctr, buf, buf, AES_BLOCK_LENGTH);
+		aes_ctr_crypt(&ctx, ctr, buf + AES_BLOCK_LENGTH,
+			      buf + AES_BLOCK_LENGTH,
+			      len - AES_BLOCK_LENGTH - 5);
+		ut_assertok(memcmp(aes_test_plain, buf, len - 5));
+		ut_assertok(memcmp(key->ctr + len - 5, buf + len - 5, 5));
+	}
+
+	return 0;
+}
+AES_TEST(aes_test_ctr, 0);
+
+/* Test that the counter carries across all 128 bits */
+static int aes_test_ctr_wrap(struct unit_test_state *uts)
+{
+	u8 ctr[AES_BLOCK_LENGTH], zero[AES_BLOCK_LENGTH * 2];
+	u8 expect[AES_BLOCK_LENGTH * 2], buf[AES_BLOCK_LENGTH * 2];
+	u8 iv[AES_BLOCK_LENGTH];
+	struct aes_ctx ctx;
+
+	ut_assertok(aes_setkey(&ctx, aes128_key, AES128_KEY_LENGTH));
+	memset(zero, '\0', sizeof(zero));
+
+	/* The key stream is the encryption of ff..ff and then 00..00 */
+	memset(expect, 0xff, AES_BLOCK_LENGTH);
+	memset(expect + AES_BLOCK_LENGTH, '\0', AES_BLOCK_LENGTH);
+	memset(iv, '\0', sizeof(iv));
+	aes_cbc_encrypt(&ctx, iv, expect, expect, 1);
+	memset(iv, '\0', sizeof(iv));
+	aes_cbc_encrypt(&ctx, iv, expect + AES_BLOCK_LENGTH,
+			expect + AES_BLOCK_LENGTH, 1);
+
+	memset(ctr, 0xff, sizeof(ctr));
+	aes_ctr_crypt(&ctx, ctr, zero, buf, sizeof(buf));
+	ut_assertok(memcmp(expect, buf, sizeof(buf)));
+	ut_assertok(memcmp(zero, ctr, AES_BLOCK_LENGTH - 1));
+	ut_asserteq(1, ctr[AES_BLOCK_LENGTH - 1]);
+
+	return 0;
+}
+AES_TEST(aes_test_ctr_wrap, 0);
+
+/* Test that the 128-bit expanded-key API gives the same results */
+static int aes_test_legacy(struct unit_test_state *uts)
+{
+	const int blocks = sizeof(aes_test_plain) / AES_BLOCK_LENGTH;
+	u8 key_exp[AES_EXPAND_KEY_LENGTH];
+	u8 in[sizeof(aes_test_plain)], buf[sizeof(aes_test_plain)];
+	u8 expect[sizeof(aes_test_plain)];
+	u8 key[AES_KEY_LENGTH], iv[AES_BLOCK_LENGTH];
+	struct aes_ctx ctx;
+
+	/* The old API takes non-const pointers */
+	memcpy(key, aes128_key, sizeof(key));
+	memcpy(in, aes_test_plain, sizeof(in));
+	ut_assertok(aes_setkey(&ctx, key, sizeof(key)));
+	aes_expand_key(key, key_exp);
+
+	/* aes_cbc_encrypt_blocks() uses a zero IV */
+	memset(iv, '\0', sizeof(iv));
+	aes_cbc_encrypt(&ctx, iv, in, expect, blocks);
+	aes_cbc_encrypt_blocks(key_exp, in, buf, blocks);
+	ut_assertok(memcmp(expect, buf, sizeof(buf)));
+	aes_cbc_decrypt_blocks(key_exp, buf, buf, blocks);
+	ut_assertok(memcmp(aes_test_plain, buf, sizeof(buf)));
+
+	/* Single blocks, which is ECB */
+	aes_encrypt(in, key_exp, buf);
+	ut_assertok(memcmp(expect, buf, AES_BLOCK_LENGTH));
+	aes_decrypt(buf, key_exp, buf);
+	ut_assertok(memcmp(aes_test_plain, buf, AES_BLOCK_LENGTH));
+
+	return 0;
+}
+AES_TEST(aes_test_legacy, 0);
+
+/* Test that invalid key lengths are rejected */
+static int aes_test_errors(struct unit_test_state *uts)
+{
+	u8 key[AES256_KEY_LENGTH + 1];
+	struct aes_ctx ctx;
+
+	memset(key, '\0', sizeof(key));
+	ut_asserteq(-EINVAL, aes_setkey(&ctx, key, 0));
+	ut_asserteq(-EINVAL, aes_setkey(&ctx, key, AES128_KEY_LENGTH - 1));
+	ut_asserteq(-EINVAL, aes_setkey(&ctx, key, AES256_KEY_LENGTH + 1));
+	ut_assertok(aes_setkey(&ctx, key, AES192_KEY_LENGTH));
+
+	return 0;
+}
+AES_TEST(aes_test_errors, 0);
+
+#if CONFIG_IS_ENABLED(HASH)
+/* Test hashing and decrypting together against doing each separately */
+static int aes_test_hash_decrypt(struct unit_test_state *uts)
+{
+	static const enum aes_mode modes[] = { AES_MODE_CBC, AES_MODE_CTR };
+	/* not a whole number of chunks, or of blocks for CTR */
+	const u32 len = AES_TEST_BUF_SIZE / 4 + AES_BLOCK_LENGTH * 3;
+	u8 hash[HASH_MAX_DIGEST_SIZE], expect_hash[HASH_MAX_DIGEST_SIZE];
+	u8 iv[AES_BLOCK_LENGTH], iv2[AES_BLOCK_LENGTH];
+	u8 *src, *expect, *buf;
+	struct hash_algo *algo;
+	struct aes_ctx ctx;
+	int i, j;
+
+	ut_assertok(hash_lookup_algo("sha256", &algo));
+	ut_assertok(aes_setkey(&ctx, aes256_key, AES256_KEY_LENGTH));
+
+	src = malloc(len);
+	expect = malloc(len);
+	buf = malloc(len);
+	ut_assertnonnull(src);
+	ut_assertnonnull(expect);
+	ut_assertnonnull(buf);
+	for (i = 0; i < len; i++)
+		src[i] = i * 0x9d + 0x13;
+
+	for (i = 0; i < ARRAY_SIZE(modes); i++) {
+		u32 size = len - (modes[i] == AES_MODE_CTR ? 7 : 0);
+
+		algo->hash_func_ws(src, size, expect_hash, algo->chunk_size);
+		memcpy(iv, aes_test_cbc_iv, sizeof(iv));
+		if (modes[i] == AES_MODE_CBC)
+			aes_cbc_decrypt(&ctx, iv, src, expect,
+					size / AES_BLOCK_LENGTH);
+		else
+			aes_ctr_crypt(&ctx, iv, src, expect, size);
+
+		/* Once to a separate buffer and once in place */
+		for (j = 0; j < 2; j++) {
+			if (j)
+				memcpy(buf, src, size);
+			memcpy(iv2, aes_test_cbc_iv, sizeof(iv2));
+			ut_assertok(aes_hash_decrypt(&ctx, modes[i], iv2,
+						     j ? buf : src, buf, size,
+						     algo, hash,
+						     sizeof(hash)));
+			ut_assertok(memcmp(expect_hash, hash,
+					   algo->digest_size));
+			ut_assertok(memcmp(expect, buf, size));
+			ut_assertok(memcmp(iv, iv2, sizeof(iv)));
+		}
+	}
+
+	/* CBC needs whole blocks */
+	ut_asserteq(-EINVAL, aes_hash_decrypt(&ctx, AES_MODE_CBC, iv, src, buf,
+					      AES_BLOCK_LENGTH + 1, algo, hash,
+					      sizeof(hash)));
+
+	/* The hash buffer must hold the whole digest */
+	ut_asserteq(-EINVAL, aes_hash_decrypt(&ctx, AES_MODE_CBC, iv, src, buf,
+					      AES_BLOCK_LENGTH, algo, hash,
+					      algo->digest_size - 1));
+
+	free(buf);
+	free(expect);
+	free(src);
+
+	return 0;
+}
+AES_TEST(aes_test_hash_decrypt, 0);
+#endif
+
+/* Report the time taken by each mode and key size */
+static int aes_test_bench(struct unit_test_state *uts)
+{
+	const u32 blocks = AES_TEST_BUF_SIZE / AES_BLOCK_LENGTH;
+	const struct aes_test_key *key;
+	u8 iv[AES_BLOCK_LENGTH];
+	struct aes_ctx ctx;
+	ulong start;
+	u8 *buf;
+
+	buf = malloc(AES_TEST_BUF_SIZE);
+	ut_assertnonnull(buf);
+	memset(buf, '\0', AES_TEST_BUF_SIZE);
+	memset(iv, '\0', sizeof(iv));
+
+	printf("%d KiB each\n", AES_TEST_BUF_SIZE >> 10);
+	for (key = aes_test_keys; key < aes_test_keys +
+	     ARRAY_SIZE(aes_test_keys); key++) {
+		ut_assertok(aes_setkey(&ctx, key->key, key->bits / 8));
+
+		start = timer_get_us();
+		aes_cbc_encrypt(&ctx, iv, buf, buf, blocks);
+		printf(" aes%d cbc encrypt: %lu us\n", key->bits,
+		       timer_get_us() - start);
+
+		start = timer_get_us();
+		aes_cbc_decrypt(&ctx, iv, buf, buf, blocks);
+		printf(" aes%d cbc decrypt: %lu us\n", key->bits,
+		       timer_get_us() - start);
+
+		start = timer_get_us();
+		aes_ctr_crypt(&ctx, iv, buf, buf, AES_TEST_BUF_SIZE);
+		printf(" aes%d ctr: %lu us\n", key->bits,
+		       timer_get_us() - start);
+	}
+	free(buf);
+
+	return 0;
+}
+AES_TEST(aes_test_bench, 0);
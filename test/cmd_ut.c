@@ -13,6 +13,12 @@ static int do_ut_all(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[]);
 
 static cmd_tbl_t cmd_ut_sub[] = {
 	U_BOOT_CMD_MKENT(all, CONFIG_SYS_MAXARGS, 1, do_ut_all, "", ""),
+#ifdef CONFIG_UT_AES
+	U_BOOT_CMD_MKENT(aes, CONFIG_SYS_MAXARGS, 1, do_ut_aes, "", ""),
+#endif
+#ifdef CONFIG_UT_CYCLIC
+	U_BOOT_CMD_MKENT(cyclic, CONFIG_SYS_MAXARGS, 1, do_ut_cyclic, "", ""),
+#endif
 #if defined(CONFIG_UT_DM)
 	U_BOOT_CMD_MKENT(dm, CONFIG_SYS_MAXARGS, 1, do_ut_dm, "", ""),
 #endif
@@ -22,6 +28,9 @@ static cmd_tbl_t cmd_ut_sub[] = {
 #ifdef CONFIG_UT_OVERLAY
 	U_BOOT_CMD_MKENT(overlay, CONFIG_SYS_MAXARGS, 1, do_ut_overlay, "", ""),
 #endif
+#ifdef CONFIG_UT_RSA
+	U_BOOT_CMD_MKENT(rsa, CONFIG_SYS_MAXARGS, 1, do_ut_rsa, "", ""),
+#endif
 #ifdef CONFIG_UT_TIME
 	U_BOOT_CMD_MKENT(time, CONFIG_SYS_MAXARGS, 1, do_ut_time, "", ""),
 #endif
@@ -65,6 +74,12 @@ static int do_ut(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 #ifdef CONFIG_SYS_LONGHELP
 static char ut_help_text[] =
 	"all - execute all enabled tests\n"
+#ifdef CONFIG_UT_AES
+	"ut aes [test-name] - AES results and timings\n"
+#endif
+#ifdef CONFIG_UT_CYCLIC
+	"ut cyclic - Test cyclic functions\n"
+#endif
 #ifdef CONFIG_UT_DM
 	"ut dm [test-name]\n"
 #endif
@@ -74,6 +89,9 @@ static char ut_help_text[] =
 #ifdef CONFIG_UT_OVERLAY
 	"ut overlay [test-name]\n"
 #endif
+#ifdef CONFIG_UT_RSA
+	"ut rsa [test-name] - RSA results and timings\n"
+#endif
 #ifdef CONFIG_UT_TIME
 	"ut time - Very basic test of time functions\n"
 #endif
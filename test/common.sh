@@ -16,5 +16,14 @@ build_uboot() {
 	NUM_CPUS=$(grep -c processor /proc/cpuinfo)
 	echo ${OPTS}
 	make ${OPTS} sandbox_config
+	# Enable any extra options needed by the test, e.g. "CMD_TRACE"
+	if [ -n "$2" ]; then
+		for opt in $2; do
+			opt="CONFIG_${opt}"
+			sed -i "s/^# ${opt} is not set$/${opt}=y/" \
+				${OUTPUT_DIR}/.config
+		done
+		make ${OPTS} olddefconfig
+	fi
 	make ${OPTS} -s -j${NUM_CPUS}
 }
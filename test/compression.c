@@ -9,9 +9,11 @@
 #include <common.h>
 #include <bootm.h>
 #include <command.h>
+#include <div64.h>
 #include <malloc.h>
 #include <mapmem.h>
 #include <asm/io.h>
+#include <asm/unaligned.h>
 
 #include <u-boot/zlib.h>
 #include <bzlib.h>
@@ -21,6 +23,7 @@
 #include <lzma/LzmaTools.h>
 
 #include <linux/lzo.h>
+#include "../lib/lzo/lzodefs.h"
 
 static const char plain[] =
 	"I am a highly compressable bit of text.\n"
@@ -117,6 +120,23 @@ static const char lz4_compressed[] =
 	"\x9d\x12\x8c\x9d";
 static const unsigned long lz4_compressed_size = 276;
 
+/* zstd -19 /tmp/plain.txt -o /tmp/plain.zst */
+static const char zstd_compressed[] =
+	"\x28\xb5\x2f\xfd\x64\x5e\x00\xad\x05\x00\x42\x4e\x26\x17\x90\x3b"
+	"\x07\x04\x5a\x13\x8b\xa7\x65\x34\x12\x21\x6d\xb0\x39\xbb\xae\xe8"
+	"\xba\xc9\xcd\x5e\x02\x49\xd0\x2b\xa9\xfa\x96\x92\xe7\x1f\x19\x19"
+	"\x7c\x8f\xf1\x9d\x54\x37\xfc\xd6\x0a\xf3\x0c\x93\x56\xc7\x52\x4f"
+	"\x0a\x62\x3e\xd1\xa5\x83\x17\x31\xab\x5d\x8f\x57\xf3\xcc\x3b\x58"
+	"\xf8\x91\x8c\xf1\x2a\x5c\x89\xdd\xf2\x9b\x15\xb7\x92\x5b\xbe\xba"
+	"\xab\xd5\xd1\x34\xdf\xf0\x02\x0e\x61\xcd\x7b\xd6\x01\xfc\xc2\xa7"
+	"\xd4\xd1\x3d\x26\x9c\x10\x49\xb8\x5b\xcd\xba\x7c\xf7\xac\x4b\xad"
+	"\xb7\x31\x1c\xbc\xf9\xcb\x62\x8e\x2e\x9b\x0f\xd3\x87\x57\x45\x12"
+	"\x16\xfa\x3a\x79\xde\x65\xf8\xcc\x48\xd5\x43\xa6\xbd\xc3\x91\x29"
+	"\x65\x29\xa7\x5b\x9a\x08\x08\x00\x60\x13\x00\x63\xa3\x8e\x28\x94"
+	"\x79\x41\x2a\x78\xc2\x91\x70\x9f\xaa\x6a\x21\x7a\xa1\xaa\x0c\xe4"
+	"\xf4\x6e\xfa";
+static const unsigned long zstd_compressed_size = 195;
+
 
 #define TEST_BUFFER_SIZE	512
 
@@ -282,6 +302,38 @@ static int uncompress_using_lz4(void *in, unsigned long in_size,
 	return (ret != 0);
 }
 
+static int compress_using_zstd(void *in, unsigned long in_size,
+			       void *out, unsigned long out_max,
+			       unsigned long *out_size)
+{
+	/* There is no zstd compression in u-boot, so fake it. */
+	assert(in_size == strlen(plain));
+	assert(memcmp(plain, in, in_size) == 0);
+
+	if (zstd_compressed_size > out_max)
+		return -1;
+
+	memcpy(out, zstd_compressed, zstd_compressed_size);
+	if (out_size)
+		*out_size = zstd_compressed_size;
+
+	return 0;
+}
+
+static int uncompress_using_zstd(void *in, unsigned long in_size,
+				 void *out, unsigned long out_max,
+				 unsigned long *out_size)
+{
+	int ret;
+	size_t output_size = out_max;
+
+	ret = zstd_decompress(in, in_size, out, &output_size);
+	if (out_size)
+		*out_size = output_size;
+
+	return (ret != 0);
+}
+
 #define errcheck(statement) if (!(statement)) { \
 	fprintf(stderr, "\tFailed: %s\n", #statement); \
 	ret = 1; \
@@ -371,16 +423,260 @@ out:
 	return ret;
 }
 
+#define BENCH_BUFFER_SIZE	(1 << 20)
+
+/*
+ * Fill a buffer with lines made of a counter, a pseudo-random number and a
+ * slice of the test text. This gives short matches mixed with literals,
+ * which is closer to a real kernel image than the test text on its own.
+ */
+static void bench_fill(char *buf, ulong size)
+{
+	const int text_len = strlen(plain);
+	uint seed = 1, line = 0;
+	ulong pos = 0;
+	char tmp[80];
+
+	while (pos < size) {
+		int len;
+
+		seed = seed * 1103515245 + 12345;
+		len = snprintf(tmp, sizeof(tmp), "%u %08x %.*s\n", line++, seed,
+			       (int)(seed >> 28) + 20,
+			       plain + (seed >> 8) % (text_len - 40));
+		len = min((ulong)len, size - pos);
+		memcpy(buf + pos, tmp, len);
+		pos += len;
+	}
+}
+
+#define LZO_BENCH_HASH_BITS	14
+
+static void lzo_put_count(u8 **opp, ulong count)
+{
+	u8 *op = *opp;
+
+	while (count > 255) {
+		*op++ = 0;
+		count -= 255;
+	}
+	*op++ = count;
+	*opp = op;
+}
+
+/*
+ * There is no LZO compressor in U-Boot, so the benchmark makes its own
+ * LZO1X stream with a greedy matcher. It emits literal runs and M2, M3 and
+ * M4 matches, which covers the main paths of the decoder.
+ */
+static ulong lzo_bench_compress(const u8 *in, ulong in_len, u8 *out,
+				u32 *table)
+{
+	const u8 *ip = in, *lit = in;
+	const u8 *in_end = in + in_len;
+	u8 *op = out;
+	u8 *next = NULL;	/* where the previous match keeps its literals */
+	ulong len;
+
+	memset(table, 0xff, sizeof(u32) << LZO_BENCH_HASH_BITS);
+	for (;;) {
+		const u8 *m_pos = NULL;
+		ulong dist = 0;
+		u32 seq, hash;
+
+		if (in_end - ip >= 4) {
+			seq = get_unaligned((u32 *)ip);
+			hash = (seq * 2654435761U) >> (32 - LZO_BENCH_HASH_BITS);
+			if (table[hash] != ~0U) {
+				m_pos = in + table[hash];
+				dist = ip - m_pos;
+			}
+			table[hash] = ip - in;
+			if (!m_pos || dist > M4_MAX_OFFSET ||
+			    dist == 0x4000 ||
+			    get_unaligned((u32 *)m_pos) != seq) {
+				ip++;
+				continue;
+			}
+		} else {
+			ip = in_end;
+		}
+
+		/* flush the literals before this match, or the final ones */
+		len = ip - lit;
+		if (len && len < 4 && next) {
+			*next |= len;
+		} else if (len && op == out && len <= 238) {
+			*op++ = 17 + len;
+		} else if (len >= 4 && len <= 18) {
+			*op++ = len - 3;
+		} else if (len) {
+			*op++ = 0;
+			lzo_put_count(&op, len - 18);
+		}
+		memcpy(op, lit, len);
+		op += len;
+		if (ip == in_end)
+			break;
+
+		for (len = 4; ip + len < in_end && m_pos[len] == ip[len]; len++)
+			;
+		if (len <= M2_MAX_LEN && dist <= M2_MAX_OFFSET) {
+			dist--;
+			next = op;
+			*op++ = (len - 1) << 5 | (dist & 7) << 2;
+			*op++ = dist >> 3;
+		} else {
+			if (dist <= M3_MAX_OFFSET) {
+				dist--;
+				if (len <= M3_MAX_LEN) {
+					*op++ = M3_MARKER | (len - 2);
+				} else {
+					*op++ = M3_MARKER;
+					lzo_put_count(&op, len - M3_MAX_LEN);
+				}
+			} else {
+				dist -= 0x4000;
+				if (len <= M4_MAX_LEN) {
+					*op++ = M4_MARKER | (dist & 0x4000) >> 11 |
+						(len - 2);
+				} else {
+					*op++ = M4_MARKER | (dist & 0x4000) >> 11;
+					lzo_put_count(&op, len - M4_MAX_LEN);
+				}
+			}
+			next = op;
+			*op++ = (dist & 0x3fff) << 2;
+			*op++ = (dist & 0x3fff) >> 6;
+		}
+		ip += len;
+		lit = ip;
+	}
+
+	/* end of stream: an M4 match with a distance of 0x4000 */
+	*op++ = M4_MARKER | 1;
+	*op++ = 0;
+	*op++ = 0;
+
+	return op - out;
+}
+
+static int compress_using_lzo1x(void *in, unsigned long in_size,
+				void *out, unsigned long out_max,
+				unsigned long *out_size)
+{
+	u32 *table;
+
+	/* worst case is one run of literals plus a few header bytes */
+	if (in_size + in_size / 255 + 16 > out_max)
+		return -1;
+
+	table = malloc(sizeof(u32) << LZO_BENCH_HASH_BITS);
+	if (!table)
+		return -1;
+	*out_size = lzo_bench_compress(in, in_size, out, table);
+	free(table);
+
+	return 0;
+}
+
+static int uncompress_using_lzo1x(void *in, unsigned long in_size,
+				  void *out, unsigned long out_max,
+				  unsigned long *out_size)
+{
+	int ret;
+	size_t output_size = out_max;
+
+	ret = lzo1x_decompress_safe(in, in_size, out, &output_size);
+	if (out_size)
+		*out_size = output_size;
+
+	return (ret != LZO_E_OK);
+}
+
+/**
+ * run_bench() - Measure decompression throughput on a larger buffer
+ *
+ * @name:	Name of the algorithm
+ * @compress:	Our function to compress data
+ * @uncompress:	Our function to uncompress data
+ * @loops:	Number of times to run the decompressor
+ * @return 0 if OK, non-zero on failure
+ */
+static int run_bench(char *name, mutate_func compress, mutate_func uncompress,
+		     int loops)
+{
+	const ulong size = BENCH_BUFFER_SIZE;
+	ulong compressed_size, uncompressed_size;
+	void *orig_buf, *compressed_buf, *uncompressed_buf;
+	ulong start, delta;
+	int ret, i;
+
+	orig_buf = malloc(size);
+	compressed_buf = malloc(size * 2);
+	uncompressed_buf = malloc(size);
+	errcheck(orig_buf && compressed_buf && uncompressed_buf);
+
+	bench_fill(orig_buf, size);
+	ret = compress(orig_buf, size, compressed_buf, size * 2,
+		       &compressed_size);
+	errcheck(ret == 0);
+
+	start = timer_get_us();
+	for (i = 0; i < loops; i++) {
+		ret = uncompress(compressed_buf, compressed_size,
+				 uncompressed_buf, size, &uncompressed_size);
+		errcheck(ret == 0);
+	}
+	delta = max(timer_get_us() - start, 1UL);
+	errcheck(uncompressed_size == size);
+	errcheck(memcmp(orig_buf, uncompressed_buf, size) == 0);
+
+	printf(" %-6s %lu -> %lu bytes: %lu us per run, %llu KiB/s\n", name,
+	       size, compressed_size, delta / loops,
+	       lldiv((u64)(size >> 10) * loops * 1000000, delta));
+	ret = 0;
+
+out:
+	free(uncompressed_buf);
+	free(compressed_buf);
+	free(orig_buf);
+
+	return ret;
+}
+
+static int do_ut_compression_bench(int loops)
+{
+	int err = 0;
+
+	printf("Decompressing %d KiB, %d runs each\n", BENCH_BUFFER_SIZE >> 10,
+	       loops);
+	err += run_bench("gzip", compress_using_gzip, uncompress_using_gzip,
+			 loops);
+	err += run_bench("lzo", compress_using_lzo1x, uncompress_using_lzo1x,
+			 loops);
+
+	printf("ut_compression bench %s\n", err == 0 ? "ok" : "FAILED");
+
+	return err;
+}
+
 static int do_ut_compression(cmd_tbl_t *cmdtp, int flag, int argc,
 			     char *const argv[])
 {
 	int err = 0;
 
+	if (argc > 1 && !strcmp(argv[1], "bench"))
+		return do_ut_compression_bench(argc > 2 ?
+				max(simple_strtoul(argv[2], NULL, 10), 1UL) :
+				10);
+
 	err += run_test("gzip", compress_using_gzip, uncompress_using_gzip);
 	err += run_test("bzip2", compress_using_bzip2, uncompress_using_bzip2);
 	err += run_test("lzma", compress_using_lzma, uncompress_using_lzma);
 	err += run_test("lzo", compress_using_lzo, uncompress_using_lzo);
 	err += run_test("lz4", compress_using_lz4, uncompress_using_lz4);
+	err += run_test("zstd", compress_using_zstd, uncompress_using_zstd);
 
 	printf("ut_compression %s\n", err == 0 ? "ok" : "FAILED");
 
@@ -458,6 +754,7 @@ static int do_ut_image_decomp(cmd_tbl_t *cmdtp, int flag, int argc,
 	err |= run_bootm_test(IH_COMP_LZMA, compress_using_lzma);
 	err |= run_bootm_test(IH_COMP_LZO, compress_using_lzo);
 	err |= run_bootm_test(IH_COMP_LZ4, compress_using_lz4);
+	err |= run_bootm_test(IH_COMP_ZSTD, compress_using_zstd);
 	err |= run_bootm_test(IH_COMP_NONE, compress_using_none);
 
 	printf("ut_image_decomp %s\n", err == 0 ? "ok" : "FAILED");
@@ -467,7 +764,9 @@ static int do_ut_image_decomp(cmd_tbl_t *cmdtp, int flag, int argc,
 
 U_BOOT_CMD(
 	ut_compression,	5,	1,	do_ut_compression,
-	"Basic test of compressors: gzip bzip2 lzma lzo", ""
+	"Basic test of compressors: gzip bzip2 lzma lzo lz4 zstd",
+	"[bench [loops]]\n"
+	"  - with 'bench', measure decompression throughput instead"
 );
 
 U_BOOT_CMD(
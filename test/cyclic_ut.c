@@ -0,0 +1,201 @@
+/*
+ * Tests for cyclic functions
+ *
+ * The sandbox timer is moved forward between calls to cyclic_run(), so the
+ * number of calls does not depend on how long the host takes.
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <command.h>
+#include <cyclic.h>
+#include <asm/test.h>
+#include <test/cyclic.h>
+#include <test/suites.h>
+#include <test/ut.h>
+
+/* Period of the test function, which is long compared to a cyclic_run() */
+#define PERIOD_MS	1000
+
+/**
+ * struct cyclic_test_state - State of the test function
+ *
+ * @cyclic: Cyclic function, NULL once it has unregistered itself
+ * @count: Number of calls
+ * @depth: Current nesting depth
+ * @max_depth: Maximum nesting depth seen
+ * @unregister_at: Call count at which to unregister, 0 for never
+ * @time_ms: Time to let pass on the sandbox timer during each call
+ */
+struct cyclic_test_state {
+	struct cyclic_info *cyclic;
+	int count;
+	int depth;
+	int max_depth;
+	int unregister_at;
+	ulong time_ms;
+};
+
+static void cyclic_test_func(void *ctx)
+{
+	struct cyclic_test_state *state = ctx;
+
+	state->depth++;
+	if (state->depth > state->max_depth)
+		state->max_depth = state->depth;
+	state->count++;
+	if (state->time_ms) {
+		sandbox_timer_add_offset(state->time_ms);
+		/* This runs cyclic functions, which must not call us again */
+		udelay(1);
+	}
+	state->depth--;
+	if (state->count == state->unregister_at) {
+		cyclic_unregister(state->cyclic);
+		state->cyclic = NULL;
+	}
+}
+
+/* Let time pass and run any cyclic functions which are due */
+static void cyclic_test_wait(ulong time_ms)
+{
+	sandbox_timer_add_offset(time_ms);
+	cyclic_run();
+}
+
+/* Test that a function is called at its period */
+static int cyclic_test_run(struct unit_test_state *uts)
+{
+	struct cyclic_test_state state = {};
+
+	state.cyclic = cyclic_register(cyclic_test_func, PERIOD_MS * 1000,
+				       "cyclic_test", &state);
+	ut_assertnonnull(state.cyclic);
+	ut_assert(cyclic_registered());
+
+	/* Not due yet */
+	cyclic_run();
+	ut_asserteq(0, state.count);
+
+	cyclic_test_wait(PERIOD_MS);
+	ut_asserteq(1, state.count);
+	cyclic_run();
+	ut_asserteq(1, state.count);
+	cyclic_test_wait(PERIOD_MS);
+	ut_asserteq(2, state.count);
+	ut_asserteq(2, state.cyclic->run_cnt);
+
+	/* Missed periods are skipped rather than caught up */
+	cyclic_test_wait(PERIOD_MS * 5);
+	ut_asserteq(3, state.count);
+	cyclic_run();
+	ut_asserteq(3, state.count);
+
+	cyclic_unregister(state.cyclic);
+	ut_assert(!cyclic_registered());
+	cyclic_test_wait(PERIOD_MS);
+	ut_asserteq(3, state.count);
+
+	return 0;
+}
+CYCLIC_TEST(cyclic_test_run, 0);
+
+/* Test that a function can unregister itself */
+static int cyclic_test_unregister_self(struct unit_test_state *uts)
+{
+	struct cyclic_test_state state = { .unregister_at = 2 };
+
+	state.cyclic = cyclic_register(cyclic_test_func, PERIOD_MS * 1000,
+				       "cyclic_test", &state);
+	ut_assertnonnull(state.cyclic);
+
+	cyclic_test_wait(PERIOD_MS);
+	ut_asserteq(1, state.count);
+	ut_assertnonnull(state.cyclic);
+	cyclic_test_wait(PERIOD_MS);
+	ut_asserteq(2, state.count);
+	ut_assert(!state.cyclic);
+	cyclic_test_wait(PERIOD_MS);
+	ut_asserteq(2, state.count);
+
+	return 0;
+}
+CYCLIC_TEST(cyclic_test_unregister_self, 0);
+
+/* Test that a function which waits is not nested and goes over budget */
+static int cyclic_test_nested(struct unit_test_state *uts)
+{
+	struct cyclic_test_state state = { .time_ms = 2 };
+	struct cyclic_info *cyclic;
+
+	cyclic = cyclic_register(cyclic_test_func, PERIOD_MS * 1000,
+				 "cyclic_test", &state);
+	ut_assertnonnull(cyclic);
+	state.cyclic = cyclic;
+	cyclic->budget_us = 1000;
+
+	cyclic_test_wait(PERIOD_MS);
+	ut_asserteq(1, state.count);
+	ut_asserteq(1, state.max_depth);
+	ut_assert(cyclic->max_time_us >= 2000);
+	ut_assert(cyclic->already_warned);
+	cyclic_unregister(cyclic);
+
+	return 0;
+}
+CYCLIC_TEST(cyclic_test_nested, 0);
+
+/* Test that cyclic_uninit() removes the functions and the state */
+static int cyclic_test_uninit(struct unit_test_state *uts)
+{
+	struct cyclic_test_state state = {};
+
+	state.cyclic = cyclic_register(cyclic_test_func, PERIOD_MS * 1000,
+				       "cyclic_test", &state);
+	ut_assertnonnull(state.cyclic);
+
+	cyclic_uninit();
+	ut_assert(!cyclic_get_list());
+	ut_assert(!cyclic_registered());
+
+	/* As a driver's remove() method would, once the state is gone */
+	cyclic_unregister(state.cyclic);
+	ut_assert(!cyclic_register(cyclic_test_func, PERIOD_MS * 1000,
+				   "cyclic_test", &state));
+	cyclic_test_wait(PERIOD_MS);
+	ut_asserteq(0, state.count);
+
+	ut_assertok(cyclic_init());
+	ut_assertnonnull(cyclic_get_list());
+
+	return 0;
+}
+CYCLIC_TEST(cyclic_test_uninit, 0);
+
+int do_ut_cyclic(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
+{
+	struct unit_test *tests = ll_entry_start(struct unit_test, cyclic_test);
+	const int n_ents = ll_entry_count(struct unit_test, cyclic_test);
+	struct unit_test_state uts = { .fail_count = 0 };
+	struct unit_test *test;
+	const int prefix_len = strlen("cyclic_test_");
+
+	if (argc == 1)
+		printf("Running %d cyclic tests\n", n_ents);
+
+	for (test = tests; test < tests + n_ents; test++) {
+		if (argc > 1 && strcmp(argv[1], test->name) &&
+		    strcmp(argv[1], test->name + prefix_len))
+			continue;
+		printf("Test: %s\n", test->name);
+
+		uts.start = mallinfo();
+
+		test->func(&uts);
+	}
+
+	printf("Failures: %d\n", uts.fail_count);
+
+	return uts.fail_count ? CMD_RET_FAILURE : 0;
+}
@@ -0,0 +1,181 @@
+/*
+ * Tests for probing devices in the background
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <dm.h>
+#include <dm/device-internal.h>
+#include <dm/root.h>
+#include <dm/test.h>
+#include <dm/util.h>
+#include <test/ut.h>
+
+/**
+ * struct testasync_pdata - Test setup for an asynchronous device
+ *
+ * @polls: Number of calls to probe_poll() before the device is ready
+ * @probe_err: Final result of the probe
+ */
+struct testasync_pdata {
+	int polls;
+	int probe_err;
+};
+
+/**
+ * struct testasync_priv - State of an asynchronous device
+ *
+ * @polls_left: Number of calls to probe_poll() still needed
+ * @poll_count: Number of calls to probe_poll() so far
+ */
+struct testasync_priv {
+	int polls_left;
+	int poll_count;
+};
+
+static int testasync_drv_probe(struct udevice *dev)
+{
+	struct testasync_pdata *pdata = dev_get_platdata(dev);
+	struct testasync_priv *priv = dev_get_priv(dev);
+
+	priv->polls_left = pdata->polls;
+	priv->poll_count = 0;
+	if (priv->polls_left)
+		return -EINPROGRESS;
+
+	return pdata->probe_err;
+}
+
+static int testasync_drv_probe_poll(struct udevice *dev)
+{
+	struct testasync_pdata *pdata = dev_get_platdata(dev);
+	struct testasync_priv *priv = dev_get_priv(dev);
+
+	priv->poll_count++;
+	if (--priv->polls_left)
+		return -EINPROGRESS;
+
+	return pdata->probe_err;
+}
+
+U_BOOT_DRIVER(testasync_drv) = {
+	.name	= "testasync_drv",
+	.id	= UCLASS_TEST_PROBE,
+	.probe	= testasync_drv_probe,
+	.probe_poll	= testasync_drv_probe_poll,
+	.priv_auto_alloc_size	= sizeof(struct testasync_priv),
+};
+
+static int bind_async(struct unit_test_state *uts, struct udevice *parent,
+		      const char *name, struct testasync_pdata *pdata,
+		      struct udevice **devp)
+{
+	ut_assertok(device_bind(parent, DM_GET_DRIVER(testasync_drv), name,
+				pdata, -1, devp));
+
+	return 0;
+}
+
+static int poll_count(struct udevice *dev)
+{
+	struct testasync_priv *priv = dev_get_priv(dev);
+
+	return priv->poll_count;
+}
+
+/* Test that several devices are probed together */
+static int dm_test_async_probe(struct unit_test_state *uts)
+{
+	struct testasync_pdata pdata_a = { .polls = 3 };
+	struct testasync_pdata pdata_b = { .polls = 5 };
+	struct testasync_pdata pdata_c = { .polls = 2 };
+	struct udevice *dev_a, *dev_b, *dev_c;
+
+	ut_assertok(bind_async(uts, dm_root(), "a", &pdata_a, &dev_a));
+	ut_assertok(bind_async(uts, dm_root(), "b", &pdata_b, &dev_b));
+	ut_assertok(bind_async(uts, dev_a, "c", &pdata_c, &dev_c));
+
+	ut_asserteq(-EINPROGRESS, device_probe_async(dev_a));
+	ut_asserteq(-EINPROGRESS, device_probe_async(dev_b));
+	ut_assert(!device_active(dev_a));
+
+	/* The child waits for its parent before starting */
+	ut_asserteq(-EINPROGRESS, device_probe_async(dev_c));
+	ut_assert(!(dev_c->flags & DM_FLAG_ACTIVATED));
+
+	/* The first poll moves all the devices along */
+	ut_asserteq(3, dm_async_poll());
+	ut_asserteq(1, poll_count(dev_a));
+	ut_asserteq(1, poll_count(dev_b));
+
+	/* Waiting for one device lets the others finish too */
+	ut_assertok(device_probe(dev_b));
+	ut_assert(device_active(dev_b));
+	ut_asserteq(5, poll_count(dev_b));
+	ut_assert(device_active(dev_a));
+	ut_asserteq(3, poll_count(dev_a));
+	ut_assert(device_active(dev_c));
+	ut_asserteq(0, dm_async_poll());
+
+	/* Probing an active device does nothing */
+	ut_assertok(device_probe_async(dev_a));
+
+	return 0;
+}
+DM_TEST(dm_test_async_probe, 0);
+
+/* Test errors from devices probed in the background */
+static int dm_test_async_probe_err(struct unit_test_state *uts)
+{
+	struct testasync_pdata pdata_a = { .polls = 2, .probe_err = -EIO };
+	struct testasync_pdata pdata_b = { .polls = 1 };
+	struct udevice *dev_a, *dev_b;
+
+	ut_assertok(bind_async(uts, dm_root(), "a", &pdata_a, &dev_a));
+	ut_assertok(bind_async(uts, dev_a, "b", &pdata_b, &dev_b));
+
+	ut_asserteq(-EINPROGRESS, device_probe_async(dev_b));
+	ut_asserteq(-EIO, device_probe_wait(dev_a));
+	ut_assert(!(dev_a->flags & (DM_FLAG_ACTIVATED |
+				    DM_FLAG_PROBE_PENDING)));
+
+	/* The child tries to probe its parent again, which fails again */
+	ut_asserteq(-EIO, device_probe(dev_b));
+	ut_assert(!(dev_b->flags & (DM_FLAG_ACTIVATED |
+				    DM_FLAG_PROBE_PENDING)));
+
+	/* Removing a device waits for it */
+	pdata_a.probe_err = 0;
+	ut_asserteq(-EINPROGRESS, device_probe_async(dev_a));
+	ut_assertok(device_remove(dev_a, DM_REMOVE_NORMAL));
+	ut_assert(!(dev_a->flags & (DM_FLAG_ACTIVATED |
+				    DM_FLAG_PROBE_PENDING)));
+
+	return 0;
+}
+DM_TEST(dm_test_async_probe_err, 0);
+
+/* Test probing all devices in a uclass */
+static int dm_test_async_probe_uclass(struct unit_test_state *uts)
+{
+	struct testasync_pdata pdata[3] = {
+		{ .polls = 4 }, { .polls = 0 }, { .polls = 2 },
+	};
+	struct udevice *dev[3];
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(dev); i++)
+		ut_assertok(bind_async(uts, dm_root(), "async", &pdata[i],
+				       &dev[i]));
+	ut_assertok(dm_async_probe_uclass(UCLASS_TEST_PROBE));
+	ut_assert(device_active(dev[1]));
+	ut_asserteq(2, dm_async_poll());
+	dm_async_wait_all();
+	for (i = 0; i < ARRAY_SIZE(dev); i++)
+		ut_assert(device_active(dev[i]));
+	ut_asserteq(4, poll_count(dev[0]));
+
+	return 0;
+}
+DM_TEST(dm_test_async_probe_uclass, 0);
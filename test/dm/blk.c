@@ -6,6 +6,9 @@
 
 #include <common.h>
 #include <dm.h>
+#include <fs.h>
+#include <os.h>
+#include <sandboxblockdev.h>
 #include <usb.h>
 #include <asm/state.h>
 #include <dm/test.h>
@@ -168,3 +171,41 @@ static int dm_test_blk_get_from_parent(struct unit_test_state *uts)
 	return 0;
 }
 DM_TEST(dm_test_blk_get_from_parent, DM_TESTF_SCAN_PDATA | DM_TESTF_SCAN_FDT);
+
+#ifdef CONFIG_FS_CACHE
+/* Test that a write to a block device drops the files cached from it */
+static int dm_test_blk_fs_cache(struct unit_test_state *uts)
+{
+	char fname[] = "fs_cache.img";
+	char data[512], buf[512];
+	struct blk_desc *desc;
+	loff_t actread;
+	int fd;
+
+	memset(data, '\xa5', sizeof(data));
+	fd = os_open(fname, OS_O_RDWR | OS_O_CREAT);
+	ut_assert(fd >= 0);
+	ut_asserteq(sizeof(data), os_write(fd, data, sizeof(data)));
+	os_close(fd);
+	ut_assertok(host_dev_bind(0, fname));
+	ut_assertok(blk_get_device_by_str("host", "0", &desc));
+
+	/* A read of the stored file is served from the cache */
+	fs_cache_store(desc, 0, FS_TYPE_EXT, "/file", data, sizeof(data));
+	ut_assertok(fs_cache_read(desc, 0, FS_TYPE_EXT, "/file", sizeof(data),
+				  buf, 0, 0, &actread));
+	ut_asserteq(sizeof(data), actread);
+	ut_assertok(memcmp(data, buf, sizeof(data)));
+
+	/* Writing any block must drop it */
+	ut_asserteq(1, blk_dwrite(desc, 0, 1, data));
+	ut_asserteq(-ENOENT, fs_cache_read(desc, 0, FS_TYPE_EXT, "/file",
+					   sizeof(data), buf, 0, 0, &actread));
+
+	ut_assertok(host_dev_bind(0, NULL));
+	os_unlink(fname);
+
+	return 0;
+}
+DM_TEST(dm_test_blk_fs_cache, DM_TESTF_SCAN_PDATA | DM_TESTF_SCAN_FDT);
+#endif
@@ -11,6 +11,7 @@
 #include <dm.h>
 #include <fdtdec.h>
 #include <malloc.h>
+#include <asm/sections.h>
 #include <dm/device-internal.h>
 #include <dm/root.h>
 #include <dm/util.h>
@@ -92,6 +93,8 @@ int dm_leak_check_end(struct unit_test_state *uts)
 			continue;
 		ut_assertok(uclass_destroy(uc));
 	}
+	/* Nodes still waiting to be bound went with their devices */
+	dm_lazy_reset();
 
 	end = mallinfo();
 	diff = end.uordblks - uts->start.uordblks;
@@ -862,3 +865,303 @@ static int dm_test_device_get_uclass_id(struct unit_test_state *uts)
 	return 0;
 }
 DM_TEST(dm_test_device_get_uclass_id, DM_TESTF_SCAN_PDATA);
+
+/* Find a device by node by searching the uclass's device list */
+static struct udevice *find_by_node_in_list(struct uclass *uc, ofnode node)
+{
+	struct udevice *dev;
+
+	list_for_each_entry(dev, &uc->dev_head, uclass_node) {
+		if (ofnode_equal(dev_ofnode(dev), node))
+			return dev;
+	}
+
+	return NULL;
+}
+
+/* Check that uclass and device lookups agree with the lists */
+static int check_uclass_index(struct unit_test_state *uts)
+{
+	struct udevice *dev, *found;
+	struct uclass *uc;
+	enum uclass_id id;
+	ofnode node;
+
+	list_for_each_entry(uc, &gd->uclass_root, sibling_node) {
+		id = uc->uc_drv->id;
+		ut_asserteq_ptr(uc, uclass_find(id));
+		list_for_each_entry(dev, &uc->dev_head, uclass_node) {
+			if (dev->seq != -1) {
+				ut_assertok(uclass_find_device_by_seq(id,
+					dev->seq, false, &found));
+				ut_asserteq_ptr(dev, found);
+			}
+			node = dev_ofnode(dev);
+			if (!ofnode_valid(node))
+				continue;
+			ut_assertok(uclass_find_device_by_ofnode(id, node,
+								 &found));
+			ut_asserteq_ptr(find_by_node_in_list(uc, node), found);
+		}
+	}
+
+	return 0;
+}
+
+/* Test that the uclass index stays up to date */
+static int dm_test_uclass_index(struct unit_test_state *uts)
+{
+	struct udevice *dev, *found;
+	ofnode node;
+	int seq;
+
+	ut_assertok(check_uclass_index(uts));
+
+	/* Probing allocates sequence numbers */
+	for (uclass_first_device(UCLASS_TEST_FDT, &dev); dev;
+	     uclass_next_device(&dev))
+		;
+	ut_assertok(check_uclass_index(uts));
+
+	/* Removing the device frees its sequence number */
+	ut_assertok(uclass_first_device_err(UCLASS_TEST_FDT, &dev));
+	seq = dev->seq;
+	ut_assert(seq != -1);
+	ut_assertok(device_remove(dev, DM_REMOVE_NORMAL));
+	ut_asserteq(-ENODEV, uclass_find_device_by_seq(UCLASS_TEST_FDT, seq,
+						       false, &found));
+	ut_assertok(device_probe(dev));
+	ut_assertok(uclass_find_device_by_seq(UCLASS_TEST_FDT, dev->seq,
+					      false, &found));
+	ut_asserteq_ptr(dev, found);
+
+	/* Changing the node updates the index */
+	node = dev_ofnode(dev);
+	dev_set_ofnode(dev, ofnode_null());
+	ut_asserteq(-ENODEV, uclass_find_device_by_ofnode(UCLASS_TEST_FDT, node,
+							  &found));
+	dev_set_ofnode(dev, node);
+	ut_assertok(uclass_find_device_by_ofnode(UCLASS_TEST_FDT, node,
+						 &found));
+	ut_asserteq_ptr(dev, found);
+
+	/* Unbinding removes the device */
+	ut_assertok(device_remove(dev, DM_REMOVE_NORMAL));
+	ut_assertok(device_unbind(dev));
+	ut_asserteq(-ENODEV, uclass_find_device_by_ofnode(UCLASS_TEST_FDT, node,
+							  &found));
+	ut_assertok(check_uclass_index(uts));
+
+	/* Look up by phandle: the first cell of 'mboxes' is the mailbox */
+	ut_assertok(uclass_get_device_by_name(UCLASS_MISC, "mbox-test", &dev));
+	ut_assertok(uclass_get_device_by_phandle(UCLASS_MAILBOX, dev, "mboxes",
+						 &found));
+	ut_asserteq_str("mbox", found->name);
+	ut_asserteq(-ENODEV, uclass_get_device_by_phandle(UCLASS_GPIO, dev,
+							  "mboxes", &found));
+
+	return 0;
+}
+DM_TEST(dm_test_uclass_index, DM_TESTF_SCAN_PDATA | DM_TESTF_SCAN_FDT);
+
+#define INDEX_BENCH_DEVICES	100
+#define INDEX_BENCH_LOOPS	10000
+
+/* Compare the speed of indexed lookups with a search of the lists */
+static int dm_test_uclass_index_bench(struct unit_test_state *uts)
+{
+	struct dm_test_state *dms = uts->priv;
+	struct udevice *dev, *found;
+	ulong start, indexed, listed;
+	struct uclass *uc;
+	int i, seq, id;
+
+	for (i = 0; i < INDEX_BENCH_DEVICES; i++) {
+		ut_assertok(device_bind_by_name(dms->root, false,
+						&driver_info_manual, &dev));
+		ut_assertok(device_probe(dev));
+	}
+
+	start = timer_get_us();
+	for (i = 0; i < INDEX_BENCH_LOOPS; i++) {
+		seq = i % INDEX_BENCH_DEVICES;
+		ut_assertok(uclass_find_device_by_seq(UCLASS_TEST, seq, false,
+						      &found));
+	}
+	indexed = timer_get_us() - start;
+
+	ut_assertok(uclass_get(UCLASS_TEST, &uc));
+	start = timer_get_us();
+	for (i = 0; i < INDEX_BENCH_LOOPS; i++) {
+		seq = i % INDEX_BENCH_DEVICES;
+		found = NULL;
+		list_for_each_entry(dev, &uc->dev_head, uclass_node) {
+			if (dev->seq == seq) {
+				found = dev;
+				break;
+			}
+		}
+		ut_assertnonnull(found);
+	}
+	listed = timer_get_us() - start;
+	printf("%d lookups by seq in %d devices: index %lu us, list %lu us\n",
+	       INDEX_BENCH_LOOPS, INDEX_BENCH_DEVICES, indexed, listed);
+
+	start = timer_get_us();
+	for (i = 0; i < INDEX_BENCH_LOOPS; i++)
+		uclass_find(i % UCLASS_COUNT);
+	indexed = timer_get_us() - start;
+
+	start = timer_get_us();
+	for (i = 0; i < INDEX_BENCH_LOOPS; i++) {
+		id = i % UCLASS_COUNT;
+		list_for_each_entry(uc, &gd->uclass_root, sibling_node) {
+			if (uc->uc_drv->id == id)
+				break;
+		}
+	}
+	listed = timer_get_us() - start;
+	printf("%d uclass lookups: index %lu us, list %lu us\n",
+	       INDEX_BENCH_LOOPS, indexed, listed);
+
+	return 0;
+}
+DM_TEST(dm_test_uclass_index_bench, 0);
+
+#ifdef CONFIG_DM_RELOC_TREE
+/* Count a device and all of its descendants */
+static int count_devices(struct udevice *parent)
+{
+	struct udevice *dev;
+	int count = 1;
+
+	list_for_each_entry(dev, &parent->child_head, sibling_node)
+		count += count_devices(dev);
+
+	return count;
+}
+
+/* Test moving the pre-relocation devices instead of binding them again */
+static int dm_test_reloc_tree(struct unit_test_state *uts)
+{
+	struct udevice *root_f, *old, *dev;
+	int count;
+
+	/* See how many devices there are when everything is bound */
+	dm_uninit();
+	gd->dm_root = NULL;
+	ut_assertok(dm_init_and_scan(false));
+	count = count_devices(dm_root());
+	dm_uninit();
+	gd->dm_root = NULL;
+
+	/* Bind the pre-relocation devices again and move them */
+	ut_assertok(dm_init_and_scan(true));
+	root_f = dm_root();
+	ut_assert(!list_empty(&root_f->child_head));
+	gd->dm_root = NULL;
+	ut_assertok(dm_init_and_relocate(root_f));
+	ut_asserteq(count, count_devices(dm_root()));
+
+	/*
+	 * Each device bound from the device tree has moved, unless its driver
+	 * has a bind() method or its uclass a post_bind() method
+	 */
+	list_for_each_entry(old, &root_f->child_head, sibling_node) {
+		if (!ofnode_valid(dev_ofnode(old)))
+			continue;
+		ut_assertok(uclass_find_device_by_ofnode(
+				device_get_uclass_id(old), dev_ofnode(old),
+				&dev));
+		ut_assert(dev != old);
+		if (old->driver->bind || old->uclass->uc_drv->post_bind) {
+			ut_assert(!(dev->flags & DM_FLAG_RELOCATED));
+			continue;
+		}
+		ut_assert(dev->flags & DM_FLAG_RELOCATED);
+		ut_asserteq_ptr(dm_root(), dev_get_parent(dev));
+		ut_asserteq_str(old->name, dev->name);
+		ut_asserteq_ptr(old->driver, dev->driver);
+		ut_assert(!device_active(dev));
+	}
+
+	/* A moved device can be probed and used */
+	ut_assertok(uclass_get_device_by_ofnode(UCLASS_TEST_FDT,
+						ofnode_path("/a-test"), &dev));
+	ut_assert(dev->flags & DM_FLAG_RELOCATED);
+	ut_assert(device_active(dev));
+
+	/* Nodes that were not bound before relocation are bound as usual */
+	ut_assertok(uclass_get_device_by_ofnode(UCLASS_TEST_FDT,
+						ofnode_path("/b-test"), &dev));
+	ut_assert(!(dev->flags & DM_FLAG_RELOCATED));
+
+	ut_assertok(device_remove(root_f, DM_REMOVE_NORMAL));
+	ut_assertok(device_unbind(root_f));
+
+	return 0;
+}
+DM_TEST(dm_test_reloc_tree, 0);
+
+/* Test moving devices when U-Boot has been relocated to a new address */
+static int dm_test_reloc_tree_offset(struct unit_test_state *uts)
+{
+	ulong relocaddr = gd->relocaddr;
+	ulong reloc_off = gd->reloc_off;
+	ulong mon_len = gd->mon_len;
+	ulong size = _end - _init;
+	struct udevice *root_f, *dev;
+	char *copy;
+	long off;
+	int ret;
+
+	/*
+	 * Sandbox does not relocate, so make a copy of the image to stand in
+	 * for the relocated one. The copy is not fixed up, so the function
+	 * pointers in it still point to the real code and can be called.
+	 */
+	copy = malloc(size);
+	ut_assertnonnull(copy);
+	memcpy(copy, _init, size);
+	off = copy - _init;
+
+	dm_uninit();
+	gd->dm_root = NULL;
+	ut_assertok(dm_init_and_scan(true));
+	root_f = dm_root();
+	gd->dm_root = NULL;
+	gd->relocaddr = (ulong)copy;
+	gd->reloc_off = off;
+	gd->mon_len = size;
+	ret = dm_init_and_relocate(root_f);
+	gd->relocaddr = relocaddr;
+	gd->reloc_off = reloc_off;
+	gd->mon_len = mon_len;
+	ut_assertok(ret);
+
+	/* The moved device uses the relocated copy of its driver */
+	ut_assertok(uclass_find_device_by_ofnode(UCLASS_TEST_FDT,
+						 ofnode_path("/a-test"), &dev));
+	ut_assert(dev->flags & DM_FLAG_RELOCATED);
+	ut_asserteq_ptr((char *)DM_GET_DRIVER(testfdt_drv) + off,
+			dev->driver);
+	ut_asserteq(UCLASS_TEST_FDT, dev->driver->id);
+	ut_asserteq_str("a-test", dev->name);
+	ut_assertok(device_probe(dev));
+
+	/* A device whose uclass has a post_bind() method is bound again */
+	ut_assertok(uclass_find_device_by_ofnode(UCLASS_VIDEO,
+						 ofnode_path("/lcd"), &dev));
+	ut_assert(!(dev->flags & DM_FLAG_RELOCATED));
+
+	/* The copy must stay around until the devices using it are gone */
+	ut_assertok(device_remove(root_f, DM_REMOVE_NORMAL));
+	ut_assertok(device_unbind(root_f));
+	dm_uninit();
+	gd->dm_root = NULL;
+	free(copy);
+
+	return 0;
+}
+DM_TEST(dm_test_reloc_tree_offset, 0);
+#endif
@@ -0,0 +1,186 @@
+/*
+ * Tests for the driver model hash uclass
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <dm.h>
+#include <hash.h>
+#include <malloc.h>
+#include <asm/test.h>
+#include <dm/test.h>
+#include <test/ut.h>
+#include <u-boot/hash.h>
+#include <u-boot/sha1.h>
+#include <u-boot/sha256.h>
+#include <u-boot/sha512.h>
+
+/* Large enough that the sandbox engine needs several polls */
+#define HASH_TEST_SIZE		(64 << 10)
+
+/* Fill in a buffer of test data */
+static void *hash_test_data(int size)
+{
+	u8 *buf;
+	int i;
+
+	buf = malloc(size);
+	if (buf) {
+		for (i = 0; i < size; i++)
+			buf[i] = i * 0x9d + 0x13;
+	}
+
+	return buf;
+}
+
+/* Calculate a digest in software */
+static void hash_test_sw(enum hash_algo_id algo, const void *buf, int size,
+			 u8 *digest)
+{
+	switch (algo) {
+	case HASH_ALGO_SHA1:
+		sha1_csum_wd(buf, size, digest, CHUNKSZ_SHA1);
+		break;
+	case HASH_ALGO_SHA256:
+		sha256_csum_wd(buf, size, digest, CHUNKSZ_SHA256);
+		break;
+	case HASH_ALGO_SHA384:
+		sha384_csum_wd(buf, size, digest, CHUNKSZ_SHA384);
+		break;
+	default:
+		sha512_csum_wd(buf, size, digest, CHUNKSZ_SHA512);
+		break;
+	}
+}
+
+/* Test progressive hashing with each algorithm */
+static int dm_test_hash_base(struct unit_test_state *uts)
+{
+	u8 digest[HASH_MAX_DIGEST_SIZE], expect[HASH_MAX_DIGEST_SIZE];
+	const int size = 1000;
+	struct udevice *dev;
+	int algo, len;
+	void *ctx;
+	u8 *buf;
+
+	ut_assertok(uclass_get_device(UCLASS_HASH, 0, &dev));
+	buf = hash_test_data(size);
+	ut_assertnonnull(buf);
+
+	for (algo = 0; algo < HASH_ALGO_COUNT; algo++) {
+		hash_test_sw(algo, buf, size, expect);
+		len = dm_hash_digest_size(algo);
+
+		ut_assertok(dm_hash_init(dev, algo, &ctx));
+		ut_assertok(dm_hash_update(dev, ctx, buf, 123));
+		ut_assertok(dm_hash_update(dev, ctx, buf + 123, size - 123));
+		ut_assertok(dm_hash_finish(dev, ctx, digest));
+		ut_assertok(memcmp(expect, digest, len));
+
+		ut_assertok(dm_hash_digest(dev, algo, buf, size, digest));
+		ut_assertok(memcmp(expect, digest, len));
+	}
+	ut_asserteq(HASH_ALGO_SHA256, dm_hash_lookup_algo("sha256"));
+	ut_asserteq(-EPROTONOSUPPORT, dm_hash_lookup_algo("crc32"));
+
+	/* An engine without the algorithm refuses it */
+	sandbox_hash_set_algos(dev, 1 << HASH_ALGO_SHA1);
+	ut_asserteq(-EPROTONOSUPPORT, dm_hash_init(dev, HASH_ALGO_SHA256,
+						   &ctx));
+	ut_asserteq(-ENODEV, dm_hash_find(HASH_ALGO_SHA256, &dev));
+	free(buf);
+
+	return 0;
+}
+DM_TEST(dm_test_hash_base, DM_TESTF_SCAN_PDATA | DM_TESTF_SCAN_FDT);
+
+/* Test hashing in the background */
+static int dm_test_hash_async(struct unit_test_state *uts)
+{
+	u8 digest[SHA256_SUM_LEN], expect[SHA256_SUM_LEN];
+	struct udevice *dev;
+	void *ctx;
+	u8 *buf;
+
+	ut_assertok(uclass_get_device(UCLASS_HASH, 0, &dev));
+	buf = hash_test_data(HASH_TEST_SIZE);
+	ut_assertnonnull(buf);
+	hash_test_sw(HASH_ALGO_SHA256, buf, HASH_TEST_SIZE, expect);
+
+	ut_assertok(dm_hash_init(dev, HASH_ALGO_SHA256, &ctx));
+	ut_assertok(dm_hash_submit(dev, ctx, buf, HASH_TEST_SIZE));
+	ut_asserteq(0, sandbox_hash_get_bytes(dev));
+
+	/* Only one submission at a time */
+	ut_asserteq(-EBUSY, dm_hash_submit(dev, ctx, buf, HASH_TEST_SIZE));
+	ut_asserteq(-EBUSY, dm_hash_update(dev, ctx, buf, HASH_TEST_SIZE));
+
+	ut_asserteq(-EBUSY, dm_hash_poll(dev, ctx));
+	ut_assert(sandbox_hash_get_bytes(dev) < HASH_TEST_SIZE);
+	ut_assertok(dm_hash_wait(dev, ctx));
+	ut_asserteq(HASH_TEST_SIZE, sandbox_hash_get_bytes(dev));
+	ut_assert(sandbox_hash_get_polls(dev) > 1);
+	ut_assertok(dm_hash_poll(dev, ctx));
+
+	ut_assertok(dm_hash_finish(dev, ctx, digest));
+	ut_assertok(memcmp(expect, digest, sizeof(digest)));
+
+	/* finish() waits for the engine */
+	ut_assertok(dm_hash_init(dev, HASH_ALGO_SHA256, &ctx));
+	ut_assertok(dm_hash_submit(dev, ctx, buf, HASH_TEST_SIZE));
+	ut_assertok(dm_hash_finish(dev, ctx, digest));
+	ut_assertok(memcmp(expect, digest, sizeof(digest)));
+	free(buf);
+
+	return 0;
+}
+DM_TEST(dm_test_hash_async, DM_TESTF_SCAN_PDATA | DM_TESTF_SCAN_FDT);
+
+/* Test that common/hash.c uses the engine, and software without it */
+static int dm_test_hash_select(struct unit_test_state *uts)
+{
+	u8 digest[SHA256_SUM_LEN], expect[SHA256_SUM_LEN];
+	struct hash_algo *algo;
+	struct udevice *dev;
+	ulong bytes;
+	int i, size;
+	void *ctx;
+	u8 *buf;
+
+	ut_assertok(uclass_get_device(UCLASS_HASH, 0, &dev));
+	buf = hash_test_data(HASH_TEST_SIZE);
+	ut_assertnonnull(buf);
+	hash_test_sw(HASH_ALGO_SHA256, buf, HASH_TEST_SIZE, expect);
+
+	/* First with the engine, then with software */
+	for (i = 0; i < 2; i++) {
+		if (i)
+			sandbox_hash_set_algos(dev, 0);
+		bytes = sandbox_hash_get_bytes(dev);
+
+		size = sizeof(digest);
+		memset(digest, '\0', sizeof(digest));
+		ut_assertok(hash_block("sha256", buf, HASH_TEST_SIZE, digest,
+				       &size));
+		ut_asserteq(SHA256_SUM_LEN, size);
+		ut_assertok(memcmp(expect, digest, sizeof(digest)));
+
+		memset(digest, '\0', sizeof(digest));
+		ut_assertok(hash_progressive_lookup_algo("sha256", &algo));
+		ut_assertok(algo->hash_init(algo, &ctx));
+		ut_assertok(algo->hash_update(algo, ctx, buf, 100, 0));
+		ut_assertok(algo->hash_update(algo, ctx, buf + 100,
+					      HASH_TEST_SIZE - 100, 1));
+		ut_assertok(algo->hash_finish(algo, ctx, digest,
+					      sizeof(digest)));
+		ut_assertok(memcmp(expect, digest, sizeof(digest)));
+
+		ut_asserteq(i ? bytes : bytes + 2 * HASH_TEST_SIZE,
+			    sandbox_hash_get_bytes(dev));
+	}
+	free(buf);
+
+	return 0;
+}
+DM_TEST(dm_test_hash_select, DM_TESTF_SCAN_PDATA | DM_TESTF_SCAN_FDT);
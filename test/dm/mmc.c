@@ -7,7 +7,10 @@
 #include <common.h>
 #include <dm.h>
 #include <mmc.h>
+#include <dm/device-internal.h>
+#include <dm/root.h>
 #include <dm/test.h>
+#include <dm/uclass-internal.h>
 #include <test/ut.h>
 
 DECLARE_GLOBAL_DATA_PTR;
@@ -44,3 +47,33 @@ static int dm_test_mmc_blk(struct unit_test_state *uts)
 	return 0;
 }
 DM_TEST(dm_test_mmc_blk, DM_TESTF_SCAN_PDATA | DM_TESTF_SCAN_FDT);
+
+#ifdef CONFIG_DM_ASYNC_PROBE
+/* Test that the card is initialised while the MMC device probes */
+static int dm_test_mmc_async(struct unit_test_state *uts)
+{
+	struct udevice *dev;
+	struct mmc *mmc;
+
+	ut_assertok(uclass_find_first_device(UCLASS_MMC, &dev));
+	ut_assertnonnull(dev);
+	ut_asserteq(-EINPROGRESS, device_probe_async(dev));
+	ut_assert(!device_active(dev));
+
+	/* The emulated card is ready straight away */
+	ut_asserteq(0, dm_async_poll());
+	ut_assert(device_active(dev));
+	mmc = mmc_get_mmc_dev(dev);
+	ut_assertnonnull(mmc);
+	ut_assert(mmc->has_init);
+	ut_assert(!mmc->init_in_progress);
+
+	/* The others finish when they are needed */
+	ut_assertok(dm_async_probe_uclass(UCLASS_MMC));
+	ut_assertok(uclass_get_device(UCLASS_MMC, 1, &dev));
+	ut_assert(mmc_get_mmc_dev(dev)->has_init);
+
+	return 0;
+}
+DM_TEST(dm_test_mmc_async, DM_TESTF_SCAN_PDATA | DM_TESTF_SCAN_FDT);
+#endif
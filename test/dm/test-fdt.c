@@ -13,6 +13,7 @@
 #include <dm/test.h>
 #include <dm/root.h>
 #include <dm/device-internal.h>
+#include <dm/lists.h>
 #include <dm/uclass-internal.h>
 #include <dm/util.h>
 #include <test/ut.h>
@@ -419,3 +420,89 @@ static int dm_test_first_next_ok_device(struct unit_test_state *uts)
 	return 0;
 }
 DM_TEST(dm_test_first_next_ok_device, DM_TESTF_SCAN_PDATA | DM_TESTF_SCAN_FDT);
+
+/* Test that the compatible-string index agrees with a linear scan */
+static int dm_test_fdt_compat_index(struct unit_test_state *uts)
+{
+	struct driver *driver = ll_entry_start(struct driver, driver);
+	const int n_ents = ll_entry_count(struct driver, driver);
+	const struct udevice_id *of_match, *id, *lin_id;
+	struct driver *entry, *drv, *lin_drv;
+	char compat[80];
+	int count = 0;
+
+	for (entry = driver; entry != driver + n_ents; entry++) {
+		for (of_match = entry->of_match;
+		     of_match && of_match->compatible; of_match++) {
+			/* Use a copy so that only the string contents match */
+			strlcpy(compat, of_match->compatible, sizeof(compat));
+			ut_assertok(lists_driver_lookup_compat(compat, false,
+							       &lin_drv,
+							       &lin_id));
+			ut_assertok(lists_driver_lookup_compat(compat, true,
+							       &drv, &id));
+			ut_asserteq_ptr(lin_drv, drv);
+			ut_asserteq_ptr(lin_id, id);
+			ut_asserteq_str(compat, id->compatible);
+			count++;
+		}
+	}
+	ut_assert(count > 0);
+#ifdef CONFIG_DM_COMPAT_INDEX
+	ut_asserteq(count, gd->dm_compat_count);
+#endif
+
+	/* Strings either side of every entry must not match */
+	ut_asserteq(-ENOENT, lists_driver_lookup_compat("", true, &drv, &id));
+	ut_asserteq(-ENOENT, lists_driver_lookup_compat("~~~", true, &drv,
+							&id));
+	ut_asserteq(-ENOENT, lists_driver_lookup_compat("sandbox,no-such", true,
+							&drv, &id));
+	ut_asserteq(-ENOENT, lists_driver_lookup_compat("sandbox,no-such",
+							false, &drv, &id));
+
+	return 0;
+}
+DM_TEST(dm_test_fdt_compat_index, 0);
+
+/* Test that deferred nodes are bound when they are looked up */
+static int dm_test_fdt_lazy_bind(struct unit_test_state *uts)
+{
+	struct udevice *dev;
+	struct uclass *uc;
+	ofnode node;
+	int count;
+
+	node = ofnode_path("/b-test");
+	ut_assert(ofnode_valid(node));
+	count = dm_lazy_count();
+	ut_asserteq(IS_ENABLED(CONFIG_DM_LAZY_BIND), count > 0);
+
+	/* Looking up a node binds just that node */
+	ut_assertok(uclass_get_device_by_ofnode(UCLASS_TEST_FDT, node, &dev));
+	ut_assert(ofnode_equal(dev_ofnode(dev), node));
+	if (IS_ENABLED(CONFIG_DM_LAZY_BIND))
+		count--;
+	ut_asserteq(count, dm_lazy_count());
+	ut_assertok(uclass_find_device_by_ofnode(UCLASS_TEST_FDT, node, &dev));
+	ut_asserteq(count, dm_lazy_count());
+
+	/* Asking for the uclass binds the rest of it, but nothing else */
+	ut_assertok(uclass_get(UCLASS_TEST_FDT, &uc));
+	ut_assert(dm_lazy_count() <= count);
+	count = dm_lazy_count();
+	ut_assertok(uclass_get(UCLASS_TEST_FDT, &uc));
+	ut_asserteq(count, dm_lazy_count());
+	if (IS_ENABLED(CONFIG_DM_LAZY_BIND))
+		ut_assert(count > 0);
+
+	/* A node in another uclass is still found */
+	node = ofnode_path("/mbox");
+	ut_assert(ofnode_valid(node));
+	ut_assertok(uclass_get_device_by_ofnode(UCLASS_MAILBOX, node, &dev));
+	ut_asserteq(-ENODEV, uclass_get_device_by_ofnode(UCLASS_TEST_FDT, node,
+							 &dev));
+
+	return 0;
+}
+DM_TEST(dm_test_fdt_lazy_bind, DM_TESTF_SCAN_PDATA | DM_TESTF_SCAN_FDT);
@@ -131,6 +131,7 @@ static int dm_test_main(const char *test_name)
 	const int n_ents = ll_entry_count(struct unit_test, dm_test);
 	struct unit_test_state *uts = &global_dm_test_state;
 	struct unit_test *test;
+	bool spans;
 	int run_count;
 
 	uts->priv = &_global_priv_dm_test_state;
@@ -149,6 +150,8 @@ static int dm_test_main(const char *test_name)
 	if (!test_name)
 		printf("Running %d driver model tests\n", n_ents);
 
+	/* Probing test devices is not part of the boot, so do not time it */
+	spans = bootstage_set_spans(false);
 	run_count = 0;
 #ifdef CONFIG_OF_LIVE
 	uts->of_root = gd->of_root;
@@ -188,6 +191,7 @@ static int dm_test_main(const char *test_name)
 		printf("Test '%s' not found\n", test_name);
 	else
 		printf("Failures: %d\n", uts->fail_count);
+	bootstage_set_spans(spans);
 
 	gd->dm_root = NULL;
 	ut_assertok(dm_init(false));
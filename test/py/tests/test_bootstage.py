@@ -0,0 +1,49 @@
+# Tests for the bootstage command
+#
+# SPDX-License-Identifier: GPL-2.0+
+
+import json
+import os
+import pytest
+
+@pytest.mark.buildconfigspec('cmd_bootstage')
+def test_bootstage_report(u_boot_console):
+    """Test that the boot timing report can be shown."""
+
+    output = u_boot_console.run_command('bootstage report')
+    assert 'Timer summary in microseconds' in output
+    assert 'reset' in output
+
+@pytest.mark.buildconfigspec('cmd_bootstage')
+def test_bootstage_export(u_boot_console):
+    """Test that the records can be exported as a Chrome trace."""
+
+    output = u_boot_console.run_command('bootstage export')
+    trace = json.loads(output)
+    events = trace['traceEvents']
+    assert events[0]['name'] == 'reset'
+    for event in events:
+        assert event['ph'] in ('i', 'X')
+        if event['ph'] == 'X':
+            assert event['dur'] >= 0
+
+@pytest.mark.buildconfigspec('cmd_bootstage')
+@pytest.mark.buildconfigspec('bootstage_initcall')
+def test_bootstage_initcall(u_boot_console):
+    """Test that each initcall is timed."""
+
+    output = u_boot_console.run_command('bootstage export')
+    trace = json.loads(output)
+    calls = [event for event in trace['traceEvents']
+             if event['name'].startswith('call ')]
+    assert len(calls) > 10
+
+    # The addresses should be those in System.map, even on sandbox
+    fname = os.path.join(u_boot_console.config.build_dir, 'System.map')
+    if not os.path.exists(fname):
+        return
+    with open(fname) as fd:
+        funcs = set(int(line.split()[0], 16) for line in fd
+                    if line.split()[1] in ('T', 't', 'W', 'w'))
+    for event in calls:
+        assert int(event['name'][5:], 16) in funcs
@@ -26,6 +26,7 @@ base_its = '''
                         compression = "none";
                         load = <0x40000>;
                         entry = <0x8>;
+                        %(kernel_hash)s
                 };
                 kernel@2 {
                         data = /incbin/("%(loadables1)s");
@@ -323,6 +324,7 @@ def test_fit(u_boot_console):
             'kernel_out' : kernel_out,
             'kernel_addr' : 0x40000,
             'kernel_size' : filesize(kernel),
+            'kernel_hash' : '',
 
             'fdt_out' : fdt_out,
             'fdt_addr' : 0x80000,
@@ -415,6 +417,30 @@ def test_fit(u_boot_console):
             check_equal(loadables2, loadables2_out,
                         'Loadables2 (ramdisk) not loaded')
 
+        # Kernel hashes are checked while the kernel is copied
+        with cons.log.section('Kernel with hashes'):
+            params['kernel_hash'] = ('hash@1 { algo = "crc32"; }; '
+                                     'hash@2 { algo = "sha1"; };')
+            fit = make_fit(mkimage, params)
+            cons.restart_uboot()
+            output = cons.run_command_list(cmd.splitlines())
+            check_equal(kernel, kernel_out, 'Kernel not loaded')
+            assert 'crc32+ sha1+ OK' in ''.join(output)
+
+        # Corrupt one byte of the kernel after loading the FIT
+        with cons.log.section('Kernel with a bad hash'):
+            offset = read_file(fit).find(read_file(kernel))
+            assert offset != -1
+            lines = cmd.splitlines()
+            pos = [i for i, line in enumerate(lines)
+                   if line.startswith('sb load')][0] + 1
+            lines.insert(pos, 'mw.b %x 0 1' %
+                         (params['fit_addr'] + offset + 10))
+            cons.restart_uboot()
+            output = cons.run_command_list(lines)
+            assert 'Bad Data Hash' in ''.join(output)
+            check_not_equal(kernel, kernel_out, 'Corrupted kernel loaded')
+
     cons = u_boot_console
     try:
         # We need to use our own device tree file. Remember to restore it
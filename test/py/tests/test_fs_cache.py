@@ -0,0 +1,69 @@
+# Tests for the file cache of the generic filesystem layer
+#
+# SPDX-License-Identifier:	GPL-2.0+
+#
+# Load a file from an ext4 image twice, so that the second load can be served
+# from the cache, then overwrite it with contents of the same size and check
+# that the next load sees the new contents rather than the cached ones.
+
+import binascii
+import os
+import pytest
+import shutil
+import u_boot_utils as util
+from distutils.spawn import find_executable
+
+SIZE = 3000
+
+@pytest.fixture(scope='module')
+def ext4_image(u_boot_console):
+    """Build an ext4 image holding one file, returning the image filename
+    and the file contents"""
+    if not find_executable('mkfs.ext4'):
+        pytest.skip('mkfs.ext4 not available')
+    cons = u_boot_console
+    base = os.path.join(cons.config.persistent_data_dir, 'fs_cache')
+    src = base + '.d'
+    image = base + '.ext4'
+    if os.path.exists(src):
+        shutil.rmtree(src)
+    os.makedirs(src)
+    data = bytearray(i & 0xff for i in range(SIZE))
+    with open(os.path.join(src, 'file.bin'), 'wb') as fd:
+        fd.write(data)
+    if os.path.exists(image):
+        os.remove(image)
+    util.run_and_log(cons, ['mkfs.ext4', '-q', '-F', '-d', src, image, '1M'])
+    return image, data
+
+def load_crc(cons, addr):
+    """Load the file and return the CRC32 U-Boot calculates for it"""
+    cons.run_command('mw.b %x 0 %x' % (addr, SIZE))
+    output = cons.run_command('load host 0 %x /file.bin' % addr)
+    assert '%d bytes read' % SIZE in output
+    output = cons.run_command('crc32 %x %x' % (addr, SIZE))
+    return output.split('==> ')[-1]
+
+@pytest.mark.boardspec('sandbox')
+@pytest.mark.buildconfigspec('fs_cache')
+@pytest.mark.buildconfigspec('cmd_ext4_write')
+@pytest.mark.buildconfigspec('cmd_crc32')
+def test_fs_cache_write(u_boot_console, ext4_image):
+    """Test that a cached file is read again after it is written"""
+    cons = u_boot_console
+    image, data = ext4_image
+    output = cons.run_command('host bind 0 %s' % image)
+    assert 'Failed' not in output
+    addr = util.find_ram_base(cons)
+    new_addr = addr + 0x100000
+
+    crc = '%08x' % (binascii.crc32(bytes(data)) & 0xffffffff)
+    assert load_crc(cons, addr) == crc
+    assert load_crc(cons, addr) == crc
+
+    cons.run_command('mw.b %x 5a %x' % (new_addr, SIZE))
+    output = cons.run_command('ext4write host 0 %x /file.bin %x' %
+                              (new_addr, SIZE))
+    assert '%d bytes written' % SIZE in output
+    crc = '%08x' % (binascii.crc32(b'\x5a' * SIZE) & 0xffffffff)
+    assert load_crc(cons, addr) == crc
@@ -0,0 +1,89 @@
+# Tests for the cat command
+#
+# SPDX-License-Identifier:	GPL-2.0+
+#
+# The cat command reads a file in chunks through the fs_file_*() handle API.
+# Check it on the host filesystem and on an ext4 image attached to sandbox as
+# a host block device.
+
+import os
+import pytest
+import shutil
+import u_boot_utils as util
+from distutils.spawn import find_executable
+
+SMALL = 'hello from cat\nsecond line\n'
+# Larger than the command's chunk size and the ext4 block size
+BIG = ''.join('line %d of a multi-block file\n' % i for i in range(400))
+
+@pytest.fixture(scope='module')
+def cat_files(u_boot_console):
+    """Create the files to print, returning the directory holding them"""
+    cons = u_boot_console
+    src = os.path.join(cons.config.persistent_data_dir, 'cat.d')
+    if os.path.exists(src):
+        shutil.rmtree(src)
+    os.makedirs(src)
+    for name, data in (('small.txt', SMALL), ('big.txt', BIG)):
+        with open(os.path.join(src, name), 'w') as fd:
+            fd.write(data)
+    return src
+
+@pytest.fixture(scope='module')
+def ext4_image(u_boot_console, cat_files):
+    """Build an ext4 image containing the files, returning its filename"""
+    if not find_executable('mkfs.ext4'):
+        pytest.skip('mkfs.ext4 not available')
+    cons = u_boot_console
+    image = os.path.join(cons.config.persistent_data_dir, 'cat.ext4')
+    if os.path.exists(image):
+        os.remove(image)
+    util.run_and_log(cons, ['mkfs.ext4', '-q', '-F', '-d', cat_files, image,
+                            '1M'])
+    return image
+
+def check_cat(cons, dev):
+    """Check printing whole files, part of a file and a missing file
+
+    Args:
+        cons: U-Boot console
+        dev: Function returning the cat arguments for a file name, e.g.
+            'host 0 /small.txt'
+    """
+    def cat(args):
+        output = cons.run_command('cat %s' % args)
+        return output.replace('\r\n', '\n')
+
+    # Partition probing may print a message before the file itself
+    assert cat(dev('small.txt')).endswith(SMALL.strip('\n'))
+    assert cat(dev('big.txt')).endswith(BIG.strip('\n'))
+
+    # Whole lines part-way through the file, crossing a chunk boundary
+    lines = BIG.splitlines(True)
+    pos = len(''.join(lines[:15]))
+    data = ''.join(lines[15:20])
+    output = cat('%s %x %x' % (dev('big.txt'), len(data), pos))
+    assert output.endswith(data.strip('\n'))
+    assert lines[14] not in output
+
+    output = cat('%s 0 %x' % (dev('small.txt'), len(SMALL) + 1))
+    assert 'beyond the end' in output
+
+    assert 'Unable to open file' in cat(dev('missing.txt'))
+
+@pytest.mark.boardspec('sandbox')
+@pytest.mark.buildconfigspec('cmd_fs_generic')
+def test_cat_hostfs(u_boot_console, cat_files):
+    """Test cat on the host filesystem"""
+    check_cat(u_boot_console,
+              lambda name: 'hostfs - %s' % os.path.join(cat_files, name))
+
+@pytest.mark.boardspec('sandbox')
+@pytest.mark.buildconfigspec('cmd_fs_generic')
+@pytest.mark.buildconfigspec('fs_ext4')
+def test_cat_ext4(u_boot_console, ext4_image):
+    """Test cat on an ext4 filesystem"""
+    cons = u_boot_console
+    output = cons.run_command('host bind 0 %s' % ext4_image)
+    assert 'Failed' not in output
+    check_cat(cons, lambda name: 'host 0 /%s' % name)
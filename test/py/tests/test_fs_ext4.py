@@ -0,0 +1,191 @@
+# Tests for ext4 support
+#
+# SPDX-License-Identifier:	GPL-2.0+
+#
+# Build a small ext4 image with 1KiB blocks whose free space is split into
+# hundreds of single-block holes, then write files to it from sandbox. A file
+# written there needs an extent tree more than one level deep, and a file
+# which only just fits the free blocks has no room left for that tree.
+#
+# Also look up files in a directory with an HTree (hash tree) index,
+# including names whose hashes collide and paths using "..".
+
+import binascii
+import os
+import pytest
+import random
+import shutil
+import u_boot_utils as util
+from distutils.spawn import find_executable
+
+BLKSZ = 1024
+NUM_FILES = 800
+
+# These names all have the legacy hash 0x90b6ac32, which does not depend on
+# the hash seed. There are too many to fit in one leaf block, so the index
+# has an entry with the collision bit set.
+COLLIDING = [
+    'hc0000000', 'hcaaf33eok', 'hcba57g1oa', 'hcbap60x5n', 'hccarv6pzg',
+    'hcfa5shjsc', 'hcfaxcak86', 'hciadbmzoi', 'hciaqr4u05', 'hcna8ic4iv',
+    'hcoatre4x1', 'hcpa6o47pi', 'hcpaccg5lr', 'hcpan6czjl',
+]
+NUM_HASHED = 200
+
+@pytest.fixture(scope='module')
+def frag_image(u_boot_console):
+    """Build a fragmented ext4 image, returning its filename"""
+    for tool in ('mkfs.ext4', 'debugfs', 'e2fsck'):
+        if not find_executable(tool):
+            pytest.skip('%s not available' % tool)
+    cons = u_boot_console
+    base = os.path.join(cons.config.persistent_data_dir, 'ext4_frag')
+    src = base + '.d'
+    image = base + '.img'
+    if os.path.exists(src):
+        shutil.rmtree(src)
+    os.makedirs(src)
+    rand = random.Random(1)
+    for i in range(NUM_FILES):
+        with open(os.path.join(src, 'f%d' % i), 'wb') as fd:
+            fd.write(bytearray(rand.getrandbits(8) for j in range(BLKSZ)))
+    if os.path.exists(image):
+        os.remove(image)
+    util.run_and_log(cons, ['mkfs.ext4', '-q', '-F', '-b', str(BLKSZ),
+                            '-O', '^metadata_csum', '-d', src, image, '4M'])
+
+    # Delete every other file, leaving a one-block hole for each
+    cmds = base + '.cmds'
+    with open(cmds, 'w') as fd:
+        for i in range(0, NUM_FILES, 2):
+            fd.write('rm f%d\n' % i)
+    util.run_and_log(cons, ['debugfs', '-w', '-f', cmds, image])
+    return image
+
+def free_blocks(cons, image):
+    """Return the number of free blocks in an image"""
+    output = util.run_and_log(cons, ['debugfs', '-R', 'stats', image])
+    for line in output.splitlines():
+        if line.startswith('Free blocks:'):
+            return int(line.split(':')[1])
+
+def fsck(cons, image):
+    """Check that an image is consistent, failing the test if not"""
+    util.run_and_log(cons, ['e2fsck', '-f', '-n', image])
+
+@pytest.mark.boardspec('sandbox')
+@pytest.mark.buildconfigspec('cmd_ext4_write')
+@pytest.mark.buildconfigspec('cmd_crc32')
+def test_ext4_write_fragmented(u_boot_console, frag_image):
+    """Test writing a file made of hundreds of extents and reading it back"""
+    cons = u_boot_console
+    image = frag_image + '.write'
+    shutil.copyfile(frag_image, image)
+    output = cons.run_command('host bind 0 %s' % image)
+    assert 'Failed' not in output
+    addr = util.find_ram_base(cons)
+    new_addr = addr + 0x100000
+
+    # More blocks than there are holes, with a partial last block
+    size = NUM_FILES * BLKSZ * 3 // 4 + 100
+    rand = random.Random(2)
+    data = bytearray(rand.getrandbits(8) for i in range(size))
+    fname = frag_image + '.data'
+    with open(fname, 'wb') as fd:
+        fd.write(data)
+    output = cons.run_command('load hostfs - %x %s' % (addr, fname))
+    assert '%d bytes read' % size in output
+    output = cons.run_command('ext4write host 0 %x /big.bin %x' %
+                              (addr, size))
+    assert '%d bytes written' % size in output
+
+    cons.run_command('mw.b %x 0 %x' % (new_addr, size))
+    output = cons.run_command('ext4load host 0 %x /big.bin' % new_addr)
+    assert '%d bytes read' % size in output
+    crc = binascii.crc32(bytes(data)) & 0xffffffff
+    output = cons.run_command('crc32 %x %x' % (new_addr, size))
+    assert output.endswith('==> %08x' % crc)
+    fsck(cons, image)
+
+    output = util.run_and_log(cons, ['debugfs', '-R', 'ex big.bin', image])
+    assert ' 2/ 2 ' in output
+
+@pytest.mark.boardspec('sandbox')
+@pytest.mark.buildconfigspec('cmd_ext4_write')
+def test_ext4_write_nospace(u_boot_console, frag_image):
+    """Test that a write fails if there is no room for the extent tree"""
+    cons = u_boot_console
+    image = frag_image + '.nospace'
+    shutil.copyfile(frag_image, image)
+    output = cons.run_command('host bind 0 %s' % image)
+    assert 'Failed' not in output
+    addr = util.find_ram_base(cons)
+
+    # Every free block is needed for data, leaving none for the tree
+    size = free_blocks(cons, image) * BLKSZ
+    output = cons.run_command('ext4write host 0 %x /full.bin %x' %
+                              (addr, size))
+    assert 'bytes written' not in output
+    fsck(cons, image)
+    output = util.run_and_log(cons, ['debugfs', '-R', 'ls', image])
+    assert 'full.bin' not in output
+
+    # The blocks are not lost, so a smaller file can still be written
+    output = cons.run_command('ext4write host 0 %x /ok.bin %x' %
+                              (addr, 100 * BLKSZ))
+    assert '%d bytes written' % (100 * BLKSZ) in output
+    fsck(cons, image)
+
+@pytest.fixture(scope='module')
+def htree_image(u_boot_console):
+    """Build an image with an HTree directory, returning its filename"""
+    for tool in ('mkfs.ext4', 'tune2fs', 'e2fsck'):
+        if not find_executable(tool):
+            pytest.skip('%s not available' % tool)
+    cons = u_boot_console
+    base = os.path.join(cons.config.persistent_data_dir, 'ext4_htree')
+    src = base + '.d'
+    image = base + '.img'
+    if os.path.exists(src):
+        shutil.rmtree(src)
+    os.makedirs(os.path.join(src, 'hashed', 'sub'))
+    names = ['file%d' % i for i in range(NUM_HASHED)] + COLLIDING
+    for name in names:
+        with open(os.path.join(src, 'hashed', name), 'w') as fd:
+            fd.write(name + '\n')
+    with open(os.path.join(src, 'top.txt'), 'w') as fd:
+        fd.write('top\n')
+    with open(os.path.join(src, 'hashed', 'sub', 'inner.txt'), 'w') as fd:
+        fd.write('inner\n')
+    os.symlink('../top.txt', os.path.join(src, 'hashed', 'link'))
+    if os.path.exists(image):
+        os.remove(image)
+    util.run_and_log(cons, ['mkfs.ext4', '-q', '-F', '-b', str(BLKSZ),
+                            '-O', '^metadata_csum', '-d', src, image, '4M'])
+
+    # Index every directory again, using the legacy hash
+    util.run_and_log(cons, ['tune2fs', '-E', 'hash_alg=legacy', image])
+    util.run_and_log(cons, ['e2fsck', '-f', '-y', '-D', image],
+                     ignore_errors=True)
+    return image
+
+@pytest.mark.boardspec('sandbox')
+@pytest.mark.buildconfigspec('cmd_fs_generic')
+def test_ext4_htree(u_boot_console, htree_image):
+    """Test looking up files in a hash-indexed directory"""
+    cons = u_boot_console
+    output = cons.run_command('host bind 0 %s' % htree_image)
+    assert 'Failed' not in output
+
+    def cat(path):
+        output = cons.run_command('cat host 0 %s' % path)
+        return output.replace('\r\n', '\n')
+
+    for name in COLLIDING + ['file0', 'file%d' % (NUM_HASHED - 1)]:
+        assert cat('/hashed/%s' % name).endswith(name)
+    assert 'Unable to open file' in cat('/hashed/missing')
+
+    # "." and ".." are not in the index
+    assert cat('/hashed/../top.txt').endswith('top')
+    assert cat('/hashed/./sub/inner.txt').endswith('inner')
+    assert cat('/hashed/sub/../file1').endswith('file1')
+    assert cat('/hashed/link').endswith('top')
@@ -0,0 +1,131 @@
+# Tests for SquashFS support
+#
+# SPDX-License-Identifier:	GPL-2.0+
+#
+# Builds an image with mksquashfs, attaches it to sandbox as a host block
+# device and checks that files can be listed, sized and loaded.
+
+import binascii
+import os
+import pytest
+import random
+import shutil
+import u_boot_utils as util
+from distutils.spawn import find_executable
+
+BLOCK_SIZE = 128 * 1024
+
+def make_files(path):
+    """Create the files to put in the image
+
+    Args:
+        path: Directory to create the files in
+
+    Returns:
+        dict of file contents, keyed by the path within the image
+    """
+    rand = random.Random(1)
+    def rand_data(size):
+        return bytearray(rand.getrandbits(8) for i in range(size))
+
+    files = {
+        # Random data does not compress, so is stored as it is
+        'regular.bin': rand_data(2 * BLOCK_SIZE),
+        # Small files are packed together into a fragment block
+        'small.txt': b'SquashFS small file\n',
+        'sub/frag.bin': rand_data(1000),
+        # A full block followed by a tail end in a fragment
+        'tail.bin': rand_data(BLOCK_SIZE + 5000),
+        # This compresses well, so its blocks are compressed
+        'compressed.txt': b''.join(b'line %d of a compressible file\n' % i
+                                   for i in range(20000)),
+    }
+    for name, data in files.items():
+        fname = os.path.join(path, name)
+        if not os.path.exists(os.path.dirname(fname)):
+            os.makedirs(os.path.dirname(fname))
+        with open(fname, 'wb') as fd:
+            fd.write(data)
+    return files
+
+@pytest.fixture(scope='module')
+def sqfs_image(u_boot_console):
+    """Build a SquashFS image, returning its filename and file contents"""
+    if not find_executable('mksquashfs'):
+        pytest.skip('mksquashfs not available')
+    cons = u_boot_console
+    base = os.path.join(cons.config.persistent_data_dir, 'sqfs')
+    src = base + '.d'
+    image = base + '.img'
+    if os.path.exists(src):
+        shutil.rmtree(src)
+    os.makedirs(src)
+    files = make_files(src)
+    if os.path.exists(image):
+        os.remove(image)
+    util.run_and_log(cons, ['mksquashfs', src, image, '-noappend',
+                            '-comp', 'gzip', '-b', str(BLOCK_SIZE)])
+    return image, files
+
+def bind_image(cons, image):
+    output = cons.run_command('host bind 0 %s' % image)
+    assert 'Failed' not in output
+
+@pytest.mark.boardspec('sandbox')
+@pytest.mark.buildconfigspec('cmd_squashfs')
+def test_squashfs_ls(u_boot_console, sqfs_image):
+    """Test listing the root directory and a subdirectory"""
+    cons = u_boot_console
+    image, files = sqfs_image
+    bind_image(cons, image)
+
+    output = cons.run_command('sqfsls host 0 /')
+    for name in ('regular.bin', 'small.txt', 'tail.bin', 'compressed.txt',
+                 'sub/'):
+        assert name in output
+    output = cons.run_command('sqfsls host 0 /sub')
+    assert 'frag.bin' in output
+    assert 'small.txt' not in output
+
+@pytest.mark.boardspec('sandbox')
+@pytest.mark.buildconfigspec('cmd_squashfs')
+def test_squashfs_size(u_boot_console, sqfs_image):
+    """Test that the size of each file is reported correctly"""
+    cons = u_boot_console
+    image, files = sqfs_image
+    bind_image(cons, image)
+
+    for name, data in files.items():
+        cons.run_command('size host 0 /%s' % name)
+        output = cons.run_command('printenv filesize')
+        assert output.endswith('filesize=%x' % len(data))
+
+@pytest.mark.boardspec('sandbox')
+@pytest.mark.buildconfigspec('cmd_squashfs')
+@pytest.mark.buildconfigspec('cmd_crc32')
+def test_squashfs_load(u_boot_console, sqfs_image):
+    """Test loading regular, fragmented and compressed files"""
+    cons = u_boot_console
+    image, files = sqfs_image
+    bind_image(cons, image)
+    addr = util.find_ram_base(cons)
+
+    for name, data in files.items():
+        output = cons.run_command('sqfsload host 0 %x /%s' % (addr, name))
+        assert '%d bytes read' % len(data) in output
+        crc = binascii.crc32(bytes(data)) & 0xffffffff
+        output = cons.run_command('crc32 %x %x' % (addr, len(data)))
+        assert output.endswith('==> %08x' % crc)
+
+    # Part of a file, starting part-way through a block
+    name = 'tail.bin'
+    data = files[name][1000:BLOCK_SIZE + 2000]
+    output = cons.run_command('load host 0 %x /%s %x %x' %
+                              (addr, name, len(data), 1000))
+    assert '%d bytes read' % len(data) in output
+    crc = binascii.crc32(bytes(data)) & 0xffffffff
+    output = cons.run_command('crc32 %x %x' % (addr, len(data)))
+    assert output.endswith('==> %08x' % crc)
+
+    output = cons.run_command('sqfsload host 0 %x /missing' % addr)
+    assert 'bytes read' not in output
@@ -22,7 +22,8 @@ For configuration verification:
 - Corrupt the signature
 - Check that image verification no-longer works
 
-Tests run with both SHA1 and SHA256 hashing.
+Tests run with SHA1, SHA256 and SHA512 hashing using RSA, and with SHA256
+hashing using ECDSA on the P-256 curve.
 """
 
 import pytest
@@ -62,8 +63,8 @@ def test_vboot(u_boot_console):
         Args:
             test_type: A string identifying the test type.
             expect_string: A string which is expected in the output.
-            sha_algo: Either 'sha1' or 'sha256', to select the algorithm to
-                    use.
+            sha_algo: One of 'sha1', 'sha256' or 'sha512', to select the
+                    algorithm to use.
             boots: A boolean that is True if Linux should boot and False if
                     we are expected to not boot
         """
@@ -95,23 +96,50 @@ def test_vboot(u_boot_console):
         public key into the dtb.
 
         Args:
-            sha_algo: Either 'sha1' or 'sha256', to select the algorithm to
-                    use.
+            sha_algo: One of 'sha1', 'sha256' or 'sha512', to select the
+                    algorithm to use.
         """
         cons.log.action('%s: Sign images' % sha_algo)
         util.run_and_log(cons, [mkimage, '-F', '-k', tmpdir, '-K', dtb,
                                 '-r', fit])
 
-    def test_with_algo(sha_algo):
+    def create_key(crypto_algo):
+        """Create the dev key pair and certificate
+
+        Args:
+            crypto_algo: Either 'rsa2048' or 'ecdsa256', to select the type
+                    of key to create.
+        """
+        if crypto_algo == 'ecdsa256':
+            util.run_and_log(cons, 'openssl ecparam -name prime256v1 -genkey '
+                             '-noout -out %sdev.key' % tmpdir)
+        else:
+            util.run_and_log(cons, 'openssl genpkey -algorithm RSA -out '
+                             '%sdev.key -pkeyopt rsa_keygen_bits:2048 '
+                             '-pkeyopt rsa_keygen_pubexp:%d '
+                             '2>/dev/null'  % (tmpdir, public_exponent))
+
+        # Create a certificate containing the public key
+        util.run_and_log(cons, 'openssl req -batch -new -x509 -key %sdev.key '
+                         '-out %sdev.crt' % (tmpdir, tmpdir))
+
+    def test_with_algo(sha_algo, crypto_algo='rsa2048'):
         """Test verified boot with the given hash algorithm.
 
         This is the main part of the test code. The same procedure is followed
-        for both hashing algorithms.
+        for all hashing and signing algorithms.
 
         Args:
-            sha_algo: Either 'sha1' or 'sha256', to select the algorithm to
-                    use.
+            sha_algo: One of 'sha1', 'sha256' or 'sha512', to select the
+                    algorithm to use.
+            crypto_algo: Either 'rsa2048' or 'ecdsa256', to select the
+                    signing algorithm. The dev key must be of this type.
         """
+        if crypto_algo == 'rsa2048':
+            its_name = sha_algo
+        else:
+            its_name = '%s-%s' % (sha_algo, crypto_algo)
+
         # Compile our device tree files for kernel and U-Boot. These are
         # regenerated here since mkimage will modify them (by adding a
         # public key) below.
@@ -120,7 +148,7 @@ def test_vboot(u_boot_console):
 
         # Build the FIT, but don't sign anything yet
         cons.log.action('%s: Test FIT with signed images' % sha_algo)
-        make_fit('sign-images-%s.its' % sha_algo)
+        make_fit('sign-images-%s.its' % its_name)
         run_bootm(sha_algo, 'unsigned images', 'dev-', True)
 
         # Sign images with our dev keys
@@ -131,7 +159,7 @@ def test_vboot(u_boot_console):
         dtc('sandbox-u-boot.dts')
 
         cons.log.action('%s: Test FIT with signed configuration' % sha_algo)
-        make_fit('sign-configs-%s.its' % sha_algo)
+        make_fit('sign-configs-%s.its' % its_name)
         run_bootm(sha_algo, 'unsigned config', '%s+ OK' % sha_algo, True)
 
         # Sign images with our dev keys
@@ -170,16 +198,7 @@ def test_vboot(u_boot_console):
     dtb = '%ssandbox-u-boot.dtb' % tmpdir
     sig_node = '/configurations/conf@1/signature@1'
 
-    # Create an RSA key pair
     public_exponent = 65537
-    util.run_and_log(cons, 'openssl genpkey -algorithm RSA -out %sdev.key '
-                     '-pkeyopt rsa_keygen_bits:2048 '
-                     '-pkeyopt rsa_keygen_pubexp:%d '
-                     '2>/dev/null'  % (tmpdir, public_exponent))
-
-    # Create a certificate containing the public key
-    util.run_and_log(cons, 'openssl req -batch -new -x509 -key %sdev.key -out '
-                     '%sdev.crt' % (tmpdir, tmpdir))
 
     # Create a number kernel image with zeroes
     with open('%stest-kernel.bin' % tmpdir, 'w') as fd:
@@ -190,8 +209,12 @@ def test_vboot(u_boot_console):
         # afterwards.
         old_dtb = cons.config.dtb
         cons.config.dtb = dtb
+        create_key('rsa2048')
         test_with_algo('sha1')
         test_with_algo('sha256')
+        test_with_algo('sha512')
+        create_key('ecdsa256')
+        test_with_algo('sha256', 'ecdsa256')
     finally:
         # Go back to the original U-Boot with the correct dtb.
         cons.config.dtb = old_dtb
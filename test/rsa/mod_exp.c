@@ -0,0 +1,180 @@
+/*
+ * Tests and benchmarks for RSA modular exponentiation
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <errno.h>
+#include <test/rsa.h>
+#include <test/ut.h>
+#include <u-boot/rsa.h>
+#include <u-boot/rsa-mod-exp.h>
+
+#define RSA_TEST_BIG_EXP	0xc0ffee0123456789ULL
+
+#include "mod_exp_vectors.h"
+
+/* Number of exponentiations timed for each key and exponent */
+#define RSA_BENCH_LOOPS		20
+
+struct rsa_test_key {
+	int bits;
+	const u8 *modulus;
+	const u8 *rr;
+	const u8 *f4_result;
+	const u8 *big_result;
+};
+
+static const struct rsa_test_key rsa_test_keys[] = {
+	{ 2048, rsa2048_modulus, rsa2048_rr, rsa2048_f4_result,
+	  rsa2048_big_result },
+	/* not a whole number of 64-bit words */
+	{ 2080, rsa2080_modulus, rsa2080_rr, rsa2080_f4_result,
+	  rsa2080_big_result },
+	{ 4096, rsa4096_modulus, rsa4096_rr, rsa4096_f4_result,
+	  rsa4096_big_result },
+};
+
+/* Fill in the message that the results in mod_exp_vectors.h are for */
+static void rsa_test_message(u8 *msg, int len)
+{
+	int i;
+
+	msg[0] = 0;
+	for (i = 1; i < len; i++)
+		msg[i] = i * 0x9d + 0x13;
+}
+
+/* Set up @prop for @key, with the exponent stored big endian in @exp */
+static void rsa_test_prop(struct key_prop *prop,
+			  const struct rsa_test_key *key, fdt64_t *exp)
+{
+	prop->modulus = key->modulus;
+	prop->rr = key->rr;
+	prop->public_exponent = exp;
+	prop->n0inv = 0;	/* not used by rsa_mod_exp_sw() */
+	prop->num_bits = key->bits;
+	prop->exp_len = sizeof(*exp);
+}
+
+/* Test results against known-good values */
+static int rsa_test_mod_exp(struct unit_test_state *uts)
+{
+	u8 msg[RSA_MAX_KEY_BITS / 8], out[RSA_MAX_KEY_BITS / 8];
+	const struct rsa_test_key *key;
+	struct key_prop prop;
+	fdt64_t exp;
+	int len;
+
+	for (key = rsa_test_keys; key < rsa_test_keys +
+	     ARRAY_SIZE(rsa_test_keys); key++) {
+		len = key->bits / 8;
+		rsa_test_message(msg, len);
+		rsa_test_prop(&prop, key, &exp);
+
+		exp = cpu_to_fdt64(65537);
+		ut_assertok(rsa_mod_exp_sw(msg, len, &prop, out));
+		ut_assertok(memcmp(key->f4_result, out, len));
+
+		exp = cpu_to_fdt64(RSA_TEST_BIG_EXP);
+		ut_assertok(rsa_mod_exp_sw(msg, len, &prop, out));
+		ut_assertok(memcmp(key->big_result, out, len));
+
+		/* 65537 is the default */
+		prop.public_exponent = NULL;
+		ut_assertok(rsa_mod_exp_sw(msg, len, &prop, out));
+		ut_assertok(memcmp(key->f4_result, out, len));
+	}
+
+	return 0;
+}
+RSA_TEST(rsa_test_mod_exp, 0);
+
+/* Test that a new key at the address of a cached one is not mixed up */
+static int rsa_test_mod_exp_cache(struct unit_test_state *uts)
+{
+	const struct rsa_test_key *key = &rsa_test_keys[0];
+	u8 msg[RSA2048_BYTES], out[RSA2048_BYTES];
+	u8 modulus[RSA2048_BYTES], rr[RSA2048_BYTES];
+	const int len = RSA2048_BYTES;
+	struct key_prop prop;
+	fdt64_t exp = cpu_to_fdt64(65537);
+
+	rsa_test_message(msg, len);
+	rsa_test_prop(&prop, key, &exp);
+	prop.modulus = modulus;
+	prop.rr = rr;
+
+	memcpy(modulus, key->modulus, len);
+	memcpy(rr, key->rr, len);
+	ut_assertok(rsa_mod_exp_sw(msg, len, &prop, out));
+	ut_assertok(memcmp(key->f4_result, out, len));
+
+	memcpy(modulus, rsa2048b_modulus, len);
+	memcpy(rr, rsa2048b_rr, len);
+	ut_assertok(rsa_mod_exp_sw(msg, len, &prop, out));
+	ut_assertok(memcmp(rsa2048b_f4_result, out, len));
+
+	return 0;
+}
+RSA_TEST(rsa_test_mod_exp_cache, 0);
+
+/* Test that invalid parameters are rejected */
+static int rsa_test_mod_exp_errors(struct unit_test_state *uts)
+{
+	const struct rsa_test_key *key = &rsa_test_keys[0];
+	u8 msg[RSA2048_BYTES], out[RSA2048_BYTES];
+	struct key_prop prop;
+	fdt64_t exp;
+
+	rsa_test_message(msg, sizeof(msg));
+	rsa_test_prop(&prop, key, &exp);
+
+	exp = cpu_to_fdt64(65536);
+	ut_asserteq(-EINVAL, rsa_mod_exp_sw(msg, sizeof(msg), &prop, out));
+	exp = cpu_to_fdt64(1);
+	ut_asserteq(-EINVAL, rsa_mod_exp_sw(msg, sizeof(msg), &prop, out));
+	exp = cpu_to_fdt64(65537);
+	ut_asserteq(-EINVAL,
+		    rsa_mod_exp_sw(msg, sizeof(msg) - 4, &prop, out));
+	prop.num_bits = 1024;
+	ut_asserteq(-EFAULT, rsa_mod_exp_sw(msg, 128, &prop, out));
+	ut_asserteq(-EBADF, rsa_mod_exp_sw(msg, sizeof(msg), NULL, out));
+
+	return 0;
+}
+RSA_TEST(rsa_test_mod_exp_errors, 0);
+
+/* Report the time taken by each key size and exponent */
+static int rsa_test_mod_exp_bench(struct unit_test_state *uts)
+{
+	static const u64 exps[] = { 3, 65537, RSA_TEST_BIG_EXP };
+	u8 msg[RSA_MAX_KEY_BITS / 8], out[RSA_MAX_KEY_BITS / 8];
+	const struct rsa_test_key *key;
+	struct key_prop prop;
+	fdt64_t exp;
+	ulong start;
+	int len, i, j;
+
+	printf("%d-bit limbs, %d runs each\n", RSA_LIMB_BITS, RSA_BENCH_LOOPS);
+	for (key = rsa_test_keys; key < rsa_test_keys +
+	     ARRAY_SIZE(rsa_test_keys); key++) {
+		len = key->bits / 8;
+		rsa_test_message(msg, len);
+		rsa_test_prop(&prop, key, &exp);
+
+		for (i = 0; i < ARRAY_SIZE(exps); i++) {
+			exp = cpu_to_fdt64(exps[i]);
+			start = timer_get_us();
+			for (j = 0; j < RSA_BENCH_LOOPS; j++)
+				ut_assertok(rsa_mod_exp_sw(msg, len, &prop,
+							   out));
+			printf(" rsa%d e=%#llx: %lu us\n", key->bits, exps[i],
+			       (timer_get_us() - start) / RSA_BENCH_LOOPS);
+		}
+	}
+
+	return 0;
+}
+RSA_TEST(rsa_test_mod_exp_bench, 0);
@@ -0,0 +1,469 @@
+/*
+ * Test vectors for RSA modular exponentiation
+ *
+ * Each key has its modulus, R^2 mod modulus (R = 2^bits) and the results of
+ * raising the message from rsa_test_message() to the exponents 65537 and
+ * RSA_TEST_BIG_EXP, all big endian.
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+static const u8 rsa2048_modulus[] = {
+	0xdd, 0x74, 0x33, 0x2f, 0x59, 0x55, 0x29, 0x8a, 0x84, 0x87, 0x86, 0xe1,
+	0x76, 0x2d, 0xc8, 0xd1, 0xb7, 0xb3, 0xb6, 0x22, 0xee, 0x02, 0x3b, 0x4d,
+	0x34, 0xf7, 0x9d, 0x1e, 0xa3, 0x08, 0xbb, 0x96, 0x49, 0x60, 0x82, 0xaa,
+	0x0e, 0x30, 0xfd, 0xa9, 0x1a, 0x77, 0x0a, 0x87, 0x6a, 0x63, 0xdf, 0x12,
+	0xb7, 0x19, 0x27, 0x3c, 0x3c, 0xf6, 0x98, 0x1e, 0x49, 0x80, 0x59, 0xd8,
+	0x54, 0xbf, 0x8d, 0x7c, 0xf9, 0x01, 0x79, 0x94, 0x7f, 0x00, 0x7d, 0x83,
+	0x8c, 0x39, 0xb4, 0x28, 0xcb, 0x3d, 0x78, 0x0c, 0x39, 0x58, 0xa2, 0xf1,
+	0xcf, 0x65, 0x9b, 0x70, 0xe0, 0x94, 0x54, 0xfb, 0x34, 0x59, 0xdc, 0x32,
+	0x2c, 0x83, 0x0d, 0xa7, 0xfa, 0xbf, 0x82, 0x24, 0xa9, 0xda, 0x3a, 0xd2,
+	0xb6, 0xfb, 0xff, 0xbf, 0xa2, 0x67, 0x1a, 0x33, 0x7e, 0xee, 0x41, 0x28,
+	0xfc, 0xb5, 0x34, 0x13, 0x2a, 0x27, 0xae, 0x8d, 0xbb, 0xe4, 0xcb, 0xe0,
+	0x1e, 0x0e, 0x83, 0x86, 0xa1, 0xe3, 0x80, 0x26, 0x4d, 0x77, 0x2b, 0xb3,
+	0xac, 0x47, 0x09, 0x75, 0xf9, 0x7a, 0xda, 0x5e, 0x6d, 0xde, 0xfd, 0x7f,
+	0x84, 0x6e, 0xee, 0x7e, 0x2a, 0xc4, 0xd5, 0xac, 0x70, 0xce, 0x07, 0xd3,
+	0x65, 0x7c, 0xcc, 0x87, 0xd8, 0x7a, 0x8c, 0xa8, 0xee, 0x59, 0x59, 0xae,
+	0x34, 0x47, 0x10, 0xab, 0xfd, 0xa1, 0x62, 0xa1, 0x93, 0xc2, 0xf8, 0x31,
+	0x59, 0x86, 0xeb, 0x8a, 0xfb, 0xee, 0xfc, 0x03, 0x8a, 0x22, 0x04, 0x42,
+	0x9a, 0x89, 0x88, 0x51, 0x89, 0x97, 0x28, 0x63, 0x97, 0x8a, 0xcb, 0xb9,
+	0x38, 0x02, 0xe0, 0x4c, 0x92, 0x3b, 0xc4, 0x6f, 0xf0, 0xfd, 0x67, 0xbb,
+	0xf3, 0xea, 0xe9, 0x7b, 0xd4, 0xb0, 0x0f, 0x81, 0x56, 0x61, 0x6b, 0xf3,
+	0x88, 0x4f, 0xa0, 0xe8, 0x2e, 0xb0, 0xdc, 0xff, 0x9f, 0xbf, 0x7b, 0x3a,
+	0xf9, 0x1d, 0x32, 0x75,
+};
+
+static const u8 rsa2048_rr[] = {
+	0x98, 0xdc, 0x37, 0x69, 0x01, 0x5a, 0xe8, 0x34, 0x14, 0x21, 0x1b, 0x13,
+	0xaa, 0x2b, 0x8f, 0x8c, 0x59, 0xa3, 0xaa, 0x9c, 0xc2, 0x0d, 0x6e, 0xe8,
+	0x87, 0x9f, 0xa3, 0x49, 0x44, 0x47, 0xd8, 0x4b, 0x5a, 0x96, 0x42, 0x3a,
+	0xc8, 0x81, 0xf9, 0x4f, 0xce, 0x7e, 0x1b, 0x02, 0xda, 0xf8, 0xaf, 0x2b,
+	0x46, 0x44, 0x05, 0x59, 0x41, 0xf4, 0x8a, 0x8b, 0x84, 0xdc, 0xd3, 0xfb,
+	0xde, 0x4e, 0xa5, 0x90, 0x1c, 0xcb, 0x98, 0xf1, 0x02, 0x91, 0xbc, 0xdf,
+	0x76, 0xfe, 0x8a, 0xd4, 0x90, 0x0b, 0x6f, 0x63, 0x1f, 0xa3, 0x99, 0x4e,
+	0x97, 0xa5, 0x53, 0xb1, 0xb1, 0x4d, 0xa0, 0x4a, 0x88, 0xfa, 0x4c, 0x45,
+	0x29, 0x29, 0xad, 0xfb, 0x2d, 0xc3, 0x9a, 0x39, 0xbd, 0xbd, 0xcf, 0x10,
+	0xbb, 0x12, 0xc6, 0xb4, 0x30, 0x97, 0x94, 0xf9, 0x0e, 0xe6, 0xe6, 0x6f,
+	0x5a, 0x25, 0x63, 0xa0, 0xaf, 0x52, 0x78, 0x14, 0x5a, 0x20, 0x4e, 0xd3,
+	0xf2, 0x0d, 0x47, 0xe8, 0x9a, 0x5e, 0xd9, 0x07, 0x38, 0x0a, 0xaf, 0x97,
+	0xb3, 0x13, 0x96, 0x78, 0x3a, 0x58, 0xdf, 0xc1, 0xbb, 0x6d, 0x68, 0xa5,
+	0xef, 0xed, 0x11, 0x2b, 0x88, 0xf6, 0xde, 0x7e, 0x08, 0xa8, 0xaa, 0x5c,
+	0x45, 0x85, 0x24, 0x0a, 0x58, 0xea, 0xfa, 0xdc, 0x83, 0x9c, 0x98, 0x3d,
+	0x4b, 0xd4, 0xe2, 0xdc, 0xcd, 0x98, 0x13, 0xb1, 0x62, 0x66, 0xea, 0x09,
+	0x6a, 0x2b, 0x04, 0xa0, 0x37, 0x8b, 0xf2, 0x31, 0xa2, 0x18, 0xe1, 0xcf,
+	0xa0, 0x6a, 0x38, 0x5b, 0x2b, 0xe1, 0x2f, 0xb2, 0x22, 0x18, 0x0d, 0x52,
+	0xcc, 0x2a, 0xfa, 0x73, 0xac, 0xd7, 0x6b, 0x66, 0xc8, 0x27, 0xdc, 0x07,
+	0x00, 0xf5, 0xf8, 0x68, 0xd8, 0xeb, 0x1a, 0xc4, 0xa2, 0x6a, 0xcc, 0x45,
+	0x45, 0x3e, 0xc0, 0x56, 0x75, 0x67, 0x30, 0x62, 0xf4, 0xa8, 0xbb, 0x66,
+	0x93, 0x08, 0x61, 0x37,
+};
+
+static const u8 rsa2048_f4_result[] = {
+	0x8c, 0xfd, 0xb5, 0x8b, 0x2b, 0xe7, 0x24, 0xc0, 0x4a, 0xc7, 0xac, 0x99,
+	0x55, 0xe1, 0xc4, 0x2b, 0x39, 0x8b, 0x7c, 0x33, 0x89, 0xd4, 0x2c, 0x58,
+	0x53, 0x91, 0xcc, 0xff, 0xc7, 0x39, 0xfe, 0xd6, 0x9a, 0xad, 0x36, 0x41,
+	0xd6, 0x00, 0x10, 0xf6, 0x3a, 0xc5, 0x99, 0xfa, 0x74, 0xb5, 0x01, 0x0a,
+	0xb5, 0xef, 0x28, 0x9e, 0x5e, 0x08, 0x3e, 0x70, 0x3e, 0x4a, 0x84, 0x99,
+	0x14, 0xc0, 0x31, 0x54, 0x1f, 0xa0, 0x58, 0x11, 0x18, 0x47, 0x31, 0x82,
+	0x7a, 0x2c, 0x28, 0x25, 0xbe, 0x4b, 0x87, 0xb2, 0x31, 0xd8, 0xc0, 0xb6,
+	0xc7, 0xf9, 0xcf, 0x27, 0x97, 0x02, 0x3d, 0x9a, 0x09, 0xc5, 0x36, 0x69,
+	0x96, 0xeb, 0xda, 0xa1, 0x7d, 0x0e, 0x0a, 0x1d, 0x12, 0xfa, 0xf6, 0x38,
+	0xfe, 0xe2, 0xa6, 0xab, 0xc2, 0x58, 0x60, 0x50, 0x52, 0x13, 0x87, 0x25,
+	0xf3, 0x0c, 0xd5, 0xd3, 0x32, 0xc1, 0x73, 0xa5, 0xdc, 0x28, 0x2c, 0x54,
+	0x5a, 0x33, 0x4c, 0xe5, 0x34, 0x6c, 0x3f, 0x80, 0x03, 0x88, 0x7b, 0xe3,
+	0xb2, 0xc2, 0x96, 0x04, 0x1f, 0x33, 0xee, 0xc0, 0x64, 0x6a, 0xc9, 0x9b,
+	0x51, 0x5d, 0x5d, 0xf8, 0x23, 0x4a, 0x97, 0xa3, 0x16, 0x42, 0xbd, 0x0a,
+	0x23, 0x71, 0x90, 0xd6, 0x59, 0x81, 0xa2, 0xc3, 0x70, 0x95, 0x6e, 0x04,
+	0xb9, 0x3c, 0x2a, 0x2b, 0xaf, 0x42, 0x4f, 0x04, 0x77, 0x77, 0xdf, 0x76,
+	0x1c, 0x91, 0xe2, 0x5d, 0x25, 0x97, 0x34, 0x3e, 0xc5, 0xfe, 0xa5, 0xa4,
+	0x2b, 0xb5, 0x95, 0x22, 0x55, 0x0b, 0x0d, 0xf1, 0x79, 0xbe, 0x94, 0x62,
+	0x38, 0x52, 0x71, 0x42, 0xc7, 0xf6, 0x40, 0xb7, 0xac, 0x40, 0x50, 0x31,
+	0xf9, 0x2c, 0xea, 0x66, 0xd2, 0xa0, 0x25, 0x51, 0xdb, 0xa0, 0x8c, 0x31,
+	0xe7, 0x2e, 0x99, 0x7f, 0xa9, 0xc5, 0x2f, 0x94, 0xad, 0x0a, 0x2e, 0x36,
+	0x11, 0x2e, 0x49, 0x9b,
+};
+
+static const u8 rsa2048_big_result[] = {
+	0x82, 0xf4, 0x39, 0x40, 0x0f, 0x19, 0x48, 0x37, 0x67, 0x66, 0x86, 0x12,
+	0x4a, 0x47, 0x63, 0x3c, 0xed, 0x00, 0x78, 0x90, 0x4f, 0x84, 0xfa, 0x7e,
+	0x76, 0x0d, 0xcb, 0xb4, 0x56, 0x07, 0x15, 0xc9, 0x78, 0xd2, 0x23, 0x2b,
+	0x7b, 0x2f, 0x99, 0xc7, 0xd6, 0xab, 0x74, 0x3f, 0x18, 0x9c, 0xeb, 0x7e,
+	0xe1, 0x76, 0xf4, 0x9b, 0x1e, 0xdf, 0x2e, 0xbe, 0xaa, 0xed, 0x53, 0x92,
+	0x17, 0x2a, 0x79, 0xb5, 0xbb, 0x4e, 0x35, 0xf2, 0xb6, 0xb3, 0xd7, 0x1b,
+	0x87, 0x3f, 0x81, 0xc6, 0x1b, 0xa2, 0x3f, 0x51, 0xad, 0xf0, 0x42, 0xe5,
+	0x66, 0x79, 0xe3, 0x07, 0xfb, 0x87, 0xde, 0x0a, 0x6c, 0x85, 0x4e, 0x70,
+	0xc3, 0x87, 0x3a, 0xfc, 0x66, 0x65, 0xda, 0x24, 0x90, 0xdd, 0xf5, 0x69,
+	0x7c, 0xcb, 0x82, 0x48, 0xa7, 0x2a, 0xd3, 0x79, 0x47, 0x8e, 0x5b, 0x08,
+	0xed, 0xeb, 0xa5, 0x28, 0xdc, 0x17, 0xfe, 0x15, 0x41, 0xd0, 0x95, 0x22,
+	0x6a, 0xb7, 0x88, 0xd6, 0x37, 0xf9, 0x9e, 0xa3, 0x7c, 0x29, 0x03, 0x03,
+	0xe6, 0x4a, 0x32, 0xd5, 0x47, 0x73, 0x23, 0xeb, 0xe8, 0x62, 0xda, 0x39,
+	0x07, 0xe6, 0xae, 0xa3, 0x3e, 0xac, 0x98, 0xb7, 0xf6, 0xd1, 0x26, 0x85,
+	0xc8, 0x27, 0x37, 0x13, 0x58, 0x72, 0x71, 0x53, 0x3a, 0xcd, 0xec, 0xc7,
+	0xb8, 0x5c, 0x15, 0xf0, 0x48, 0x75, 0xbe, 0xb7, 0x1e, 0xf8, 0x72, 0x44,
+	0x6a, 0x6c, 0x14, 0x94, 0xa2, 0x4b, 0xec, 0x6f, 0x51, 0x99, 0x5a, 0x06,
+	0x5e, 0x2b, 0x81, 0x07, 0x7b, 0x5b, 0xe0, 0x0e, 0x86, 0x67, 0x2e, 0x42,
+	0x58, 0x37, 0xe0, 0x15, 0xb8, 0xb2, 0x3a, 0x7d, 0x52, 0x6b, 0x1d, 0x43,
+	0x9e, 0xab, 0xae, 0x5f, 0x73, 0x89, 0xb2, 0xe6, 0x17, 0x4f, 0x2d, 0x51,
+	0xdb, 0xa0, 0x49, 0xea, 0x65, 0xfe, 0xcb, 0xed, 0x7b, 0xe8, 0x17, 0xc7,
+	0x95, 0xdf, 0x58, 0x24,
+};
+
+static const u8 rsa2080_modulus[] = {
+	0xbc, 0xc3, 0x23, 0xdb, 0x53, 0x51, 0xbb, 0x8b, 0x35, 0x26, 0x98, 0x7e,
+	0xd1, 0xe5, 0xcc, 0x57, 0x5e, 0x02, 0x4a, 0x9d, 0xaa, 0xe0, 0xa6, 0xd7,
+	0x90, 0xdb, 0xe5, 0xb4, 0xe6, 0x16, 0x7e, 0x9e, 0x95, 0x69, 0x74, 0xd1,
+	0xcc, 0x87, 0x3c, 0xa9, 0x7b, 0x81, 0xdf, 0x72, 0xe8, 0x87, 0x19, 0x17,
+	0x52, 0x05, 0x41, 0x66, 0x0c, 0xd0, 0x12, 0xc2, 0xd4, 0xc9, 0xcb, 0x43,
+	0xdc, 0xc6, 0x6e, 0x74, 0xd6, 0xd9, 0xdf, 0x61, 0x63, 0x8f, 0xc8, 0xd0,
+	0x70, 0x71, 0xab, 0x94, 0x21, 0xfb, 0x28, 0xd7, 0x45, 0x7a, 0x96, 0xa1,
+	0xf8, 0x74, 0xbc, 0xce, 0x63, 0xd9, 0x96, 0x28, 0xd4, 0x10, 0xb7, 0xc9,
+	0x47, 0xd4, 0xed, 0x1b, 0x77, 0x02, 0xdc, 0x6d, 0x08, 0xe7, 0x85, 0x23,
+	0x68, 0x39, 0xdd, 0x61, 0x91, 0x49, 0xab, 0xe5, 0xd0, 0x9a, 0x2d, 0x86,
+	0x0a, 0xa3, 0x5f, 0x8a, 0xf3, 0x4b, 0xa2, 0x93, 0x3c, 0x85, 0xd5, 0xff,
+	0x9e, 0x65, 0x97, 0x7f, 0xf2, 0xef, 0x52, 0xfd, 0x25, 0x5c, 0xef, 0x2b,
+	0x64, 0xcc, 0xd8, 0xd3, 0x4c, 0x02, 0x4f, 0xad, 0x6f, 0x7a, 0x44, 0x67,
+	0x65, 0xb0, 0x1c, 0x87, 0x9d, 0xf0, 0xdf, 0x99, 0x5f, 0xd8, 0xec, 0x46,
+	0x87, 0xe3, 0x69, 0x99, 0x5f, 0xdb, 0xeb, 0xbc, 0xe1, 0xf6, 0x84, 0x04,
+	0xd7, 0x24, 0xa9, 0x95, 0x17, 0xd8, 0xa2, 0x79, 0xf7, 0x86, 0x7b, 0x23,
+	0x35, 0x22, 0xf0, 0x95, 0xf4, 0x96, 0x23, 0x80, 0xcb, 0x30, 0x8e, 0x3e,
+	0x4f, 0xa5, 0x20, 0x0e, 0xe5, 0x1f, 0x7a, 0x3d, 0xa4, 0x6a, 0xac, 0x0a,
+	0x4f, 0xe8, 0x41, 0x5a, 0x5c, 0x67, 0x28, 0x62, 0x7c, 0x95, 0x0f, 0x61,
+	0x4d, 0x4c, 0xb9, 0xe4, 0x9e, 0xad, 0x21, 0xe7, 0xcd, 0x25, 0xcb, 0x01,
+	0xb7, 0xea, 0xd1, 0xc4, 0x13, 0xe1, 0x24, 0xaa, 0x53, 0x71, 0x52, 0xd5,
+	0xe7, 0x31, 0xca, 0x13, 0xdf, 0x4c, 0x0f, 0x39,
+};
+
+static const u8 rsa2080_rr[] = {
+	0x71, 0x0b, 0x59, 0x83, 0xc3, 0xee, 0x4c, 0x8e, 0x2b, 0x51, 0xe9, 0x30,
+	0xe1, 0x55, 0xbb, 0xd1, 0xb4, 0x8a, 0x1b, 0x1a, 0x3b, 0x05, 0x0c, 0x5c,
+	0x0a, 0x2f, 0x15, 0x83, 0x7c, 0x96, 0xf0, 0x4c, 0xf7, 0x32, 0xb7, 0x2e,
+	0x81, 0x3b, 0xcb, 0x65, 0xc9, 0x9d, 0x18, 0x32, 0xb4, 0x77, 0xf1, 0x6a,
+	0x43, 0x2a, 0x23, 0xd0, 0xa6, 0xdf, 0xc6, 0xff, 0x7e, 0x00, 0xe3, 0xca,
+	0xcc, 0xe1, 0x4c, 0x8f, 0xc1, 0x42, 0x8b, 0x8b, 0x82, 0x6a, 0xf2, 0xe8,
+	0x88, 0x8d, 0x9a, 0x49, 0xec, 0xf7, 0x81, 0x62, 0x27, 0x8f, 0xb3, 0x21,
+	0x5e, 0x0b, 0xc7, 0x94, 0x03, 0x15, 0x45, 0x38, 0xfb, 0x07, 0x66, 0x05,
+	0xd6, 0x97, 0x3a, 0x6d, 0xd7, 0x27, 0xa9, 0x8d, 0x38, 0x2f, 0x0a, 0x5c,
+	0x43, 0x82, 0x9c, 0x87, 0x91, 0xb4, 0x1d, 0x40, 0x8c, 0x29, 0xb7, 0xa8,
+	0x7b, 0xa5, 0x38, 0xb6, 0x0f, 0xbe, 0xeb, 0x61, 0x52, 0x50, 0x75, 0x20,
+	0xe7, 0x73, 0xd9, 0x6b, 0xdd, 0x15, 0xba, 0x49, 0x0b, 0x50, 0xf2, 0x76,
+	0xbd, 0x49, 0x32, 0xd3, 0xba, 0x13, 0x81, 0x24, 0x97, 0x8e, 0x91, 0x45,
+	0x39, 0xfd, 0x0f, 0xaf, 0x88, 0xb9, 0xb1, 0x36, 0xf1, 0xd1, 0xfb, 0xca,
+	0x8f, 0xee, 0xf8, 0xff, 0xf4, 0xf3, 0x2b, 0x44, 0x23, 0x82, 0xfd, 0x04,
+	0x92, 0x23, 0x4b, 0xfd, 0xac, 0x06, 0xb2, 0x59, 0xd0, 0x2c, 0x49, 0x15,
+	0xdd, 0xc0, 0xe3, 0x3f, 0x8c, 0x69, 0xf4, 0xa7, 0x79, 0x87, 0xdb, 0x51,
+	0xa1, 0x7f, 0x48, 0x7f, 0xcb, 0x3b, 0x34, 0x11, 0x92, 0x64, 0x1d, 0x49,
+	0xf0, 0x3e, 0x28, 0x1e, 0x20, 0x75, 0xa4, 0xd6, 0xe2, 0x9a, 0xda, 0x8c,
+	0xc9, 0x0f, 0xc4, 0xe1, 0xee, 0xa6, 0xbb, 0xdd, 0xf3, 0x1b, 0x4e, 0xe5,
+	0x71, 0xda, 0xc7, 0x6b, 0x27, 0xce, 0xa8, 0xe6, 0x59, 0x5d, 0xfa, 0xbb,
+	0x58, 0xb2, 0xbe, 0x05, 0xff, 0xee, 0x80, 0x78,
+};
+
+static const u8 rsa2080_f4_result[] = {
+	0x2e, 0x90, 0xb2, 0xd6, 0x67, 0xcb, 0xed, 0x3c, 0xf0, 0xc8, 0x2b, 0x97,
+	0x5a, 0x9c, 0x16, 0xed, 0x1b, 0x03, 0x74, 0x0a, 0xd2, 0x7d, 0xae, 0x31,
+	0x2a, 0x2d, 0xe3, 0x98, 0x2d, 0x3a, 0x00, 0xa9, 0x2c, 0x0b, 0x10, 0x0e,
+	0x9c, 0xd4, 0xb4, 0x12, 0xda, 0x3a, 0x99, 0x52, 0xff, 0xc3, 0x4a, 0x51,
+	0xb1, 0x4a, 0x78, 0x09, 0x39, 0xd8, 0x62, 0x0f, 0x68, 0x48, 0x1c, 0xf1,
+	0x77, 0xcb, 0xcb, 0xe4, 0xd2, 0x77, 0xf5, 0x33, 0xa2, 0x84, 0x54, 0xef,
+	0x28, 0xee, 0x7e, 0x70, 0x25, 0x15, 0x01, 0x9e, 0x65, 0x52, 0x73, 0x1b,
+	0xce, 0x18, 0xe8, 0x7c, 0xe0, 0x92, 0x12, 0xcc, 0xa0, 0xa9, 0x36, 0xfd,
+	0xb9, 0x97, 0xc3, 0x7d, 0x2d, 0x3b, 0xd5, 0xa8, 0xaa, 0x4f, 0xd3, 0x3a,
+	0x7f, 0xd6, 0x04, 0xb4, 0xf9, 0x4f, 0xef, 0xdd, 0xb2, 0xfc, 0x8b, 0x21,
+	0x9f, 0xe2, 0x0f, 0x66, 0x64, 0xb5, 0x00, 0x0c, 0x4c, 0x87, 0x2c, 0x97,
+	0xef, 0xb5, 0x9c, 0x9b, 0x30, 0x03, 0xec, 0x05, 0x07, 0xd4, 0x78, 0x0c,
+	0x6d, 0x19, 0xb1, 0x60, 0x56, 0x85, 0x77, 0xb9, 0x93, 0x2c, 0x34, 0xdc,
+	0x76, 0x73, 0x12, 0xba, 0xa7, 0x12, 0x80, 0x76, 0xa7, 0x9e, 0x5b, 0x7b,
+	0x38, 0x7e, 0xef, 0x26, 0x86, 0x7d, 0xfa, 0x0d, 0xb2, 0xc1, 0x41, 0x61,
+	0x09, 0x5f, 0x15, 0x08, 0xbb, 0x0e, 0x5b, 0x72, 0xb6, 0x08, 0x27, 0xed,
+	0x61, 0x79, 0x6e, 0xcd, 0x22, 0x7f, 0xf7, 0x63, 0x28, 0x9b, 0xc0, 0x8c,
+	0x94, 0xd3, 0x17, 0x22, 0xa6, 0x16, 0xcb, 0xb1, 0xcd, 0x15, 0xbd, 0x17,
+	0x1a, 0xbf, 0x12, 0xc5, 0x89, 0x6c, 0xde, 0x54, 0x06, 0x61, 0x4c, 0x1f,
+	0xaa, 0xd5, 0x3d, 0xeb, 0x9b, 0xa8, 0xd6, 0x45, 0xbb, 0x9c, 0xc3, 0x75,
+	0x14, 0x53, 0xf9, 0x52, 0x91, 0xa5, 0xbe, 0x98, 0x5c, 0x2f, 0x92, 0xdd,
+	0x12, 0xa6, 0xaf, 0x62, 0xb1, 0x67, 0x1c, 0x22,
+};
+
+static const u8 rsa2080_big_result[] = {
+	0x97, 0xb3, 0xbe, 0xe1, 0xc6, 0xc1, 0xff, 0xa5, 0xed, 0x89, 0x9a, 0xd3,
+	0x80, 0xab, 0xad, 0x0d, 0x55, 0x8a, 0xde, 0x28, 0xb7, 0x68, 0x6d, 0x14,
+	0x39, 0x59, 0x09, 0xd5, 0xc0, 0x95, 0x81, 0xe7, 0x88, 0xe2, 0x4d, 0xe8,
+	0xce, 0xf0, 0xde, 0xd5, 0x9c, 0xac, 0x77, 0x0a, 0xef, 0x6e, 0x6b, 0x6a,
+	0x22, 0xd9, 0x02, 0x44, 0x1b, 0x0d, 0xfc, 0x96, 0xaf, 0x12, 0x32, 0x42,
+	0xb4, 0x72, 0x3f, 0x75, 0x1b, 0x08, 0x46, 0x72, 0xd6, 0xf5, 0xd9, 0x00,
+	0x59, 0x63, 0x76, 0xba, 0x5b, 0xd0, 0x70, 0x99, 0xb2, 0x2e, 0x76, 0xf9,
+	0x6c, 0x5d, 0x00, 0xd5, 0x81, 0xa7, 0xa6, 0x6c, 0xc5, 0xfa, 0x1c, 0x52,
+	0x99, 0xe7, 0x5e, 0x22, 0x69, 0x40, 0x17, 0xc6, 0x36, 0x86, 0x23, 0x61,
+	0xca, 0x27, 0x11, 0xe0, 0x84, 0xd1, 0xea, 0x20, 0x56, 0x1e, 0x63, 0xca,
+	0x40, 0xba, 0x48, 0xd3, 0x16, 0xf9, 0xb4, 0x12, 0x03, 0x87, 0xfe, 0x26,
+	0x64, 0x6a, 0xe9, 0xce, 0x5f, 0xdf, 0xb6, 0xc5, 0xb4, 0x3c, 0x9b, 0x52,
+	0xe3, 0x18, 0x88, 0xb0, 0x88, 0x80, 0xe8, 0xd0, 0xa2, 0x36, 0x57, 0x53,
+	0x22, 0x1d, 0x72, 0x6d, 0xd5, 0x10, 0xa6, 0x0c, 0xc5, 0x16, 0x45, 0xae,
+	0x87, 0xdb, 0x7f, 0xaa, 0xb8, 0x62, 0xcb, 0x4e, 0x0d, 0x07, 0xc5, 0xb6,
+	0x82, 0x73, 0x0f, 0x61, 0x75, 0x03, 0xd0, 0xd3, 0x7d, 0xda, 0x64, 0x1c,
+	0x0e, 0x86, 0x93, 0x57, 0xc3, 0x5f, 0x1d, 0x5f, 0xc2, 0xeb, 0xfd, 0x19,
+	0x77, 0x31, 0xba, 0xe1, 0x85, 0x96, 0xbf, 0x8a, 0x16, 0x52, 0x13, 0x5f,
+	0xbb, 0xa2, 0x61, 0xfb, 0x65, 0x66, 0x90, 0xc8, 0xfc, 0x87, 0xad, 0x9b,
+	0xec, 0xf5, 0x96, 0x4d, 0x13, 0x02, 0x94, 0x9a, 0x18, 0xd4, 0xd1, 0x3d,
+	0xf0, 0x0b, 0x9c, 0x24, 0x42, 0x5c, 0xc3, 0x52, 0x87, 0x65, 0x12, 0x7f,
+	0xf6, 0x70, 0xf6, 0x47, 0x9d, 0x38, 0xcd, 0xd6,
+};
+
+static const u8 rsa4096_modulus[] = {
+	0xbd, 0xb8, 0xbe, 0xfe, 0xe0, 0x2d, 0x1d, 0x36, 0x52, 0x22, 0x20, 0x9a,
+	0xae, 0x6f, 0x70, 0x0d, 0x42, 0x93, 0x14, 0xa6, 0x54, 0xf8, 0x0e, 0x05,
+	0xce, 0xe6, 0xf1, 0x7e, 0xa5, 0x62, 0x2d, 0x5f, 0xc1, 0xe7, 0x7b, 0x5a,
+	0xe4, 0x61, 0xbd, 0xeb, 0x7c, 0x7a, 0x64, 0xe9, 0x70, 0x80, 0xbb, 0x02,
+	0x73, 0xd2, 0xf8, 0xbb, 0xed, 0xff, 0x7d, 0x27, 0x13, 0x54, 0x85, 0x86,
+	0x1b, 0x38, 0x72, 0x9b, 0x9c, 0x42, 0xe8, 0xbd, 0x75, 0xab, 0x4c, 0x3a,
+	0x91, 0xa1, 0xd1, 0xb8, 0xc2, 0x3a, 0x48, 0x0a, 0x00, 0xf6, 0x77, 0xcf,
+	0x90, 0x3a, 0xc8, 0x80, 0x1b, 0xa7, 0xd4, 0x07, 0x9e, 0x45, 0x0c, 0x4d,
+	0x0f, 0xe4, 0x92, 0x28, 0x24, 0xc0, 0x0d, 0xf7, 0x73, 0xb6, 0x84, 0x88,
+	0xaf, 0x19, 0x9a, 0x04, 0xac, 0xd4, 0x75, 0xec, 0xc7, 0x82, 0x5a, 0x7b,
+	0xca, 0xcf, 0x12, 0x12, 0xbb, 0xbf, 0x15, 0x88, 0x16, 0x1a, 0x46, 0x0d,
+	0x0e, 0xb6, 0xdd, 0xe6, 0xa1, 0x11, 0x7d, 0x75, 0x0b, 0xd7, 0x22, 0xdb,
+	0x9b, 0x79, 0xcb, 0x36, 0x85, 0x5f, 0x68, 0x94, 0x54, 0x7f, 0x11, 0xee,
+	0xaa, 0x27, 0xe5, 0x10, 0xa0, 0x85, 0xa1, 0x11, 0xc2, 0x00, 0xdf, 0x7b,
+	0xb4, 0xd6, 0xed, 0x8d, 0x2f, 0xc1, 0xf8, 0x3f, 0xf9, 0xb8, 0xd0, 0x68,
+	0xc8, 0xf6, 0xac, 0x98, 0x7b, 0xd7, 0xdf, 0x82, 0xe7, 0xb5, 0x4f, 0xd8,
+	0xc9, 0xbc, 0xac, 0xfc, 0x3d, 0x05, 0xd7, 0x62, 0x1c, 0x28, 0xb8, 0xf2,
+	0x83, 0x13, 0x81, 0x11, 0x15, 0xf5, 0x71, 0x75, 0x58, 0x5f, 0x75, 0xc5,
+	0x84, 0x6f, 0xb1, 0x6e, 0x4a, 0xb6, 0x8e, 0x44, 0x0f, 0xa2, 0xbd, 0xe9,
+	0xf5, 0x63, 0x0e, 0x62, 0x06, 0xe1, 0x46, 0x95, 0x44, 0x81, 0x68, 0x36,
+	0xa7, 0xba, 0x10, 0x69, 0x8f, 0x90, 0xc1, 0xd9, 0x2a, 0xbd, 0x2c, 0x12,
+	0x76, 0x24, 0xfb, 0x1e, 0xe4, 0x41, 0xc2, 0xdf, 0xba, 0xd0, 0xa2, 0x8c,
+	0x85, 0xe1, 0x1e, 0xb0, 0x43, 0x07, 0x43, 0x09, 0x63, 0xec, 0x88, 0x14,
+	0x65, 0x6e, 0x12, 0x62, 0xeb, 0xc1, 0x03, 0xb7, 0x59, 0xef, 0x73, 0x95,
+	0x7a, 0x87, 0x89, 0x1e, 0xf4, 0xd0, 0xa2, 0x14, 0x38, 0x40, 0xa4, 0x3c,
+	0x40, 0xd9, 0xf7, 0x72, 0x22, 0x47, 0x64, 0xe1, 0xd5, 0x15, 0x27, 0xeb,
+	0x02, 0xf1, 0x50, 0x92, 0xf6, 0xf5, 0xb9, 0x62, 0x74, 0x3d, 0x10, 0x9a,
+	0x64, 0xcc, 0xea, 0x7e, 0xae, 0xa8, 0x57, 0xd9, 0x5e, 0x4a, 0x49, 0x74,
+	0xaf, 0xdf, 0xe9, 0x89, 0x93, 0xe5, 0xc1, 0x5f, 0xd0, 0x9f, 0x8d, 0xef,
+	0x30, 0x11, 0xe3, 0x03, 0x91, 0x10, 0xd5, 0x91, 0x40, 0x0a, 0x07, 0xa9,
+	0x73, 0x98, 0x42, 0x28, 0x7c, 0x19, 0xd2, 0xd4, 0x66, 0x34, 0x81, 0x9c,
+	0x92, 0x09, 0x53, 0x11, 0x53, 0x36, 0x4d, 0x4f, 0x2e, 0xfa, 0xf0, 0xd3,
+	0x88, 0xd1, 0xdf, 0x07, 0xa0, 0xfe, 0xd8, 0x1c, 0x81, 0x42, 0xd2, 0x3c,
+	0xb2, 0x45, 0x20, 0xe4, 0xc1, 0xc6, 0xeb, 0x2e, 0x7c, 0x3c, 0xbb, 0xf8,
+	0x9e, 0xf4, 0xf1, 0x79, 0xf6, 0xf7, 0x22, 0x84, 0xbf, 0x79, 0x77, 0x59,
+	0x35, 0x81, 0xbf, 0xe1, 0xd5, 0xa3, 0x36, 0x72, 0x7b, 0x62, 0x73, 0x50,
+	0x35, 0xda, 0xe4, 0x2f, 0x8e, 0x8f, 0x5f, 0x18, 0xf0, 0x67, 0xf2, 0xf3,
+	0x28, 0xd2, 0xff, 0xac, 0xe4, 0x57, 0xb8, 0xdc, 0xfe, 0x11, 0xdb, 0x7d,
+	0x77, 0xc1, 0x02, 0x2e, 0xaf, 0x96, 0x21, 0x02, 0x90, 0xcb, 0xfc, 0x15,
+	0x0d, 0xc4, 0x40, 0xbc, 0x85, 0xdc, 0xcd, 0x7e, 0x62, 0x0f, 0x2e, 0x11,
+	0x80, 0x97, 0xc9, 0xc5, 0xc3, 0x81, 0x7d, 0x0c, 0xda, 0x92, 0x8b, 0x48,
+	0x6b, 0xbd, 0x50, 0x5c, 0x71, 0xd0, 0x5c, 0x7f, 0xa4, 0x6a, 0x46, 0x9b,
+	0xf4, 0xa5, 0x01, 0x06, 0x2d, 0xdd, 0xdc, 0x87,
+};
+
+static const u8 rsa4096_rr[] = {
+	0x3a, 0x91, 0x98, 0x8a, 0x5b, 0xa6, 0xca, 0x96, 0x7b, 0x6c, 0xbb, 0xa0,
+	0xf3, 0xe9, 0x57, 0xa9, 0x91, 0xbb, 0x8e, 0x27, 0xa8, 0x3b, 0xf1, 0xa4,
+	0x17, 0x43, 0x21, 0xda, 0xba, 0xdf, 0xa6, 0x84, 0x19, 0x93, 0x11, 0x5e,
+	0x86, 0xcf, 0x18, 0x0e, 0x52, 0x70, 0x10, 0x3f, 0xaf, 0x2c, 0x02, 0x0d,
+	0x3b, 0x2a, 0x4f, 0x69, 0x11, 0x48, 0xf6, 0xb4, 0xe3, 0x2f, 0xe4, 0x61,
+	0xd6, 0x0d, 0xe5, 0x75, 0xf5, 0x3d, 0x34, 0xe0, 0x76, 0x6a, 0xba, 0xf9,
+	0x9b, 0xe2, 0x67, 0xf9, 0xac, 0x52, 0x8d, 0x4e, 0xe4, 0x87, 0xd9, 0xbe,
+	0xe3, 0xcb, 0x1b, 0x81, 0xa8, 0xa2, 0xb4, 0x99, 0x6e, 0x2d, 0x56, 0xf2,
+	0x68, 0xc8, 0xf1, 0x1d, 0xc5, 0x1e, 0x39, 0xbf, 0xa8, 0x85, 0x5b, 0x27,
+	0xaa, 0x7d, 0x68, 0x2f, 0xed, 0xb3, 0x87, 0xa6, 0x93, 0x67, 0xb8, 0x13,
+	0xe6, 0x9c, 0xd5, 0x9f, 0xf5, 0x7f, 0x89, 0x40, 0xd0, 0x20, 0x27, 0x4b,
+	0x26, 0x8a, 0xbe, 0x25, 0x11, 0x2a, 0x94, 0xd9, 0x05, 0xba, 0x23, 0x94,
+	0x3a, 0xfa, 0x58, 0x18, 0x6b, 0xf4, 0x89, 0x10, 0xe3, 0x30, 0x9e, 0xb2,
+	0xb9, 0x92, 0xbe, 0x24, 0x2c, 0xe7, 0xa0, 0x58, 0xa3, 0xde, 0x4b, 0xb7,
+	0xd5, 0x6d, 0x0f, 0x80, 0x20, 0x18, 0x01, 0x8b, 0x63, 0x9c, 0xdb, 0x96,
+	0x60, 0x2e, 0x39, 0x6c, 0x4b, 0xbe, 0x93, 0x05, 0xdc, 0x6a, 0x2f, 0xb8,
+	0x3e, 0x38, 0xce, 0x20, 0x4e, 0x53, 0x23, 0x44, 0x2a, 0x6b, 0x5e, 0x48,
+	0xa8, 0xd9, 0x4d, 0xb5, 0x28, 0xf5, 0x2e, 0xe1, 0x2c, 0xc3, 0x1c, 0xcb,
+	0x7b, 0xb3, 0xb3, 0x0d, 0x05, 0xd1, 0xbf, 0x9c, 0x4d, 0x55, 0x4e, 0x49,
+	0xa7, 0xd4, 0x28, 0xa8, 0x40, 0xfa, 0x1b, 0xdc, 0x41, 0xf3, 0x42, 0xa3,
+	0x62, 0x83, 0x1b, 0xc4, 0x04, 0x42, 0x4d, 0x74, 0xd2, 0xc1, 0xbb, 0x29,
+	0x01, 0x64, 0xf0, 0xd9, 0x99, 0xab, 0x25, 0x39, 0xf0, 0xfe, 0x1d, 0x94,
+	0x09, 0xbc, 0x4c, 0x06, 0x1b, 0xf3, 0x1a, 0x63, 0xfa, 0xa4, 0x32, 0x34,
+	0x4b, 0x65, 0xfd, 0xe0, 0xce, 0xc8, 0x56, 0x06, 0x5e, 0xda, 0xd5, 0x9f,
+	0x4c, 0xa0, 0xeb, 0xe9, 0xd7, 0x98, 0x00, 0xfb, 0x29, 0x4c, 0xd6, 0x15,
+	0x90, 0x46, 0x23, 0x98, 0x47, 0xb1, 0x93, 0x66, 0x44, 0xba, 0x9c, 0x9e,
+	0x00, 0x69, 0xcd, 0x54, 0x3e, 0x7c, 0xc0, 0x22, 0xb0, 0x5f, 0x51, 0x62,
+	0x26, 0x5c, 0x76, 0x2c, 0xbd, 0xd7, 0x8d, 0x8a, 0x32, 0x12, 0xca, 0x03,
+	0xdf, 0xdc, 0xb2, 0x66, 0x0d, 0xa8, 0x16, 0xf3, 0x3b, 0xb2, 0xca, 0xda,
+	0x0d, 0x03, 0x3c, 0x5b, 0x7d, 0x08, 0x47, 0x0c, 0xf9, 0xc6, 0xab, 0x12,
+	0xbb, 0xb2, 0x89, 0xb3, 0x18, 0xd3, 0x74, 0x7f, 0xd3, 0xe8, 0x4f, 0xdd,
+	0x8c, 0xa2, 0xc9, 0xc3, 0x9c, 0x48, 0x09, 0xab, 0xac, 0x54, 0x93, 0xc3,
+	0xaa, 0x11, 0x3e, 0xa3, 0x59, 0x9d, 0xa9, 0x34, 0xbe, 0xa6, 0x05, 0x4f,
+	0x0c, 0x60, 0x1e, 0xd0, 0x50, 0x5c, 0xe6, 0xb8, 0x57, 0xe4, 0x49, 0x69,
+	0x95, 0x24, 0x13, 0xe4, 0xe7, 0x9b, 0x99, 0x36, 0x69, 0xac, 0x9f, 0x61,
+	0x37, 0x5c, 0xd5, 0xea, 0xc4, 0xc4, 0x3d, 0xd8, 0x76, 0x50, 0xb0, 0x70,
+	0x02, 0x0e, 0xc8, 0x95, 0xad, 0x40, 0x6e, 0x04, 0xe9, 0x47, 0xa7, 0xaa,
+	0xa1, 0xd1, 0xdd, 0xd5, 0x58, 0xc8, 0x51, 0x6e, 0x39, 0x32, 0x5b, 0x36,
+	0xa5, 0x05, 0x06, 0xd1, 0x92, 0x6d, 0x83, 0x0b, 0x42, 0x97, 0x1a, 0x86,
+	0xab, 0x41, 0x8a, 0x5c, 0xd4, 0x62, 0x90, 0xa7, 0xa9, 0x84, 0x30, 0xb9,
+	0x5c, 0xfe, 0x0e, 0x42, 0x59, 0xbd, 0xbb, 0x0c, 0x59, 0x61, 0xd9, 0x60,
+	0xc1, 0xba, 0x74, 0x3a, 0x62, 0x73, 0x0b, 0x8d, 0x45, 0x68, 0x52, 0xe7,
+	0xe1, 0x20, 0xfb, 0xcf, 0x79, 0x93, 0x6d, 0x7c,
+};
+
+static const u8 rsa4096_f4_result[] = {
+	0x1b, 0x86, 0xf1, 0x86, 0xb8, 0x00, 0x20, 0x7a, 0x78, 0x23, 0xac, 0xe1,
+	0x93, 0x70, 0x7d, 0x55, 0x63, 0x30, 0x35, 0x8c, 0xb4, 0x1d, 0x1f, 0x9f,
+	0x50, 0x6a, 0xf8, 0x3b, 0x11, 0x3c, 0x40, 0x90, 0xa8, 0xf6, 0x0f, 0x42,
+	0x81, 0xb2, 0x9f, 0x95, 0xac, 0x76, 0xbf, 0xd9, 0x26, 0x28, 0xa5, 0x4c,
+	0xbf, 0xb6, 0x1d, 0x18, 0x64, 0x1d, 0x64, 0x5d, 0x6d, 0xd7, 0x49, 0x28,
+	0x58, 0x5e, 0x88, 0x1a, 0x52, 0x5c, 0x15, 0xcf, 0x44, 0x62, 0xa8, 0x12,
+	0xdd, 0x3e, 0x75, 0x3f, 0x3c, 0xda, 0xeb, 0xf2, 0x19, 0x3b, 0x3a, 0xf6,
+	0x3b, 0x6f, 0x62, 0xdc, 0x14, 0x82, 0x7a, 0x0f, 0x06, 0x66, 0x91, 0xb9,
+	0xcd, 0xb7, 0x60, 0xf1, 0xff, 0x52, 0x00, 0x19, 0xdc, 0xeb, 0x1d, 0x47,
+	0x8a, 0x47, 0x06, 0xd9, 0x14, 0x12, 0x49, 0x6c, 0x7a, 0x41, 0x99, 0xc5,
+	0x6d, 0x4e, 0x9d, 0xe8, 0x98, 0x10, 0x22, 0x78, 0xaa, 0x5f, 0x20, 0x8c,
+	0x68, 0xab, 0x5b, 0xf9, 0x3b, 0x23, 0xea, 0x3a, 0x09, 0xd7, 0xe5, 0x23,
+	0x01, 0x53, 0x81, 0x75, 0x26, 0x8e, 0xa9, 0x40, 0x37, 0x3f, 0x26, 0x37,
+	0x83, 0x32, 0x21, 0xa4, 0x32, 0x27, 0xf2, 0x59, 0xf8, 0x05, 0xb6, 0xd0,
+	0x4f, 0x54, 0xe8, 0x40, 0x5a, 0x7d, 0xfb, 0x1e, 0xc3, 0x32, 0xcd, 0x20,
+	0x43, 0x66, 0x24, 0xb3, 0x9b, 0xb8, 0x9a, 0x25, 0xa1, 0x06, 0x6d, 0x92,
+	0xd7, 0x0f, 0x7f, 0xd8, 0x2c, 0xd2, 0x41, 0x2d, 0x75, 0x3a, 0xd4, 0x9b,
+	0x84, 0x57, 0x16, 0xc7, 0x27, 0x21, 0xda, 0x73, 0x14, 0x59, 0xd7, 0x41,
+	0x97, 0x56, 0x11, 0xfb, 0x86, 0xa0, 0xa7, 0xb6, 0x17, 0x98, 0x61, 0x2b,
+	0x1f, 0x86, 0xd1, 0x40, 0x4a, 0x76, 0x97, 0x03, 0x88, 0xbd, 0xb9, 0x41,
+	0xc0, 0x7a, 0x16, 0x04, 0x27, 0x73, 0x4e, 0xe5, 0x55, 0xe5, 0x4d, 0x81,
+	0x48, 0x6d, 0xf2, 0x54, 0x4c, 0x98, 0x8e, 0x2b, 0x2b, 0x2d, 0x70, 0x26,
+	0xa6, 0xa1, 0x16, 0xfa, 0x8e, 0x7c, 0xce, 0x20, 0x26, 0xaf, 0xb8, 0x1f,
+	0x86, 0xab, 0xd3, 0xf6, 0x6f, 0xd4, 0xf2, 0x5d, 0xe4, 0x5d, 0x25, 0xab,
+	0x3a, 0x53, 0x83, 0xfd, 0x39, 0x3b, 0x1c, 0xec, 0x6b, 0x9b, 0x8d, 0x3c,
+	0x43, 0xa0, 0x7f, 0x66, 0x26, 0xbc, 0x34, 0xf2, 0xd6, 0xbb, 0xbb, 0x18,
+	0xd6, 0xee, 0xbe, 0x0f, 0xb1, 0x05, 0xc9, 0x94, 0xe5, 0x6e, 0xc2, 0xd7,
+	0xa5, 0x58, 0xb2, 0xe5, 0xa0, 0x76, 0x8d, 0xed, 0x89, 0x31, 0xd4, 0xf2,
+	0xa4, 0x1f, 0x8f, 0xea, 0xab, 0x4a, 0x39, 0x04, 0xd3, 0x23, 0x52, 0x62,
+	0x58, 0xd1, 0x55, 0xaa, 0x97, 0x10, 0xbb, 0xcf, 0x95, 0x17, 0xb8, 0x86,
+	0xef, 0xe5, 0x20, 0x54, 0xd6, 0xd4, 0xe1, 0x56, 0xc5, 0xbe, 0x3a, 0x9b,
+	0xdc, 0xa9, 0xef, 0xc6, 0xa3, 0xcf, 0x8a, 0xd2, 0xd7, 0x79, 0x39, 0xf6,
+	0x56, 0x96, 0xfa, 0xfd, 0xdd, 0xfe, 0xe4, 0x15, 0x5d, 0xdd, 0x1d, 0x31,
+	0x11, 0x2b, 0x5b, 0x3f, 0xfd, 0xe9, 0x7d, 0x3b, 0x77, 0xa9, 0xdb, 0xee,
+	0xf3, 0x6e, 0xf2, 0xbd, 0x07, 0x2f, 0x7e, 0x5f, 0xee, 0xc3, 0xff, 0x63,
+	0x7e, 0x67, 0x1a, 0x26, 0x2d, 0x41, 0x08, 0xf8, 0x1f, 0xb6, 0xaa, 0xf1,
+	0x37, 0x61, 0x1d, 0xe4, 0xde, 0x8d, 0x8f, 0x66, 0x03, 0xae, 0xa2, 0xb7,
+	0xc9, 0x77, 0xd8, 0xff, 0x1f, 0xbe, 0xfe, 0xa2, 0x1c, 0x73, 0xe3, 0xfc,
+	0x6a, 0x3c, 0xf1, 0x95, 0xb2, 0x39, 0x2b, 0x47, 0xb4, 0x54, 0x3b, 0x80,
+	0x2d, 0xc9, 0x9e, 0xbe, 0x22, 0xaa, 0xde, 0x0f, 0x0f, 0x4d, 0xca, 0xee,
+	0x36, 0xc0, 0x67, 0x06, 0xc8, 0xd2, 0x40, 0x2b, 0xf0, 0xe8, 0xde, 0x75,
+	0xed, 0xaa, 0x01, 0x00, 0x15, 0xe1, 0xc9, 0x56, 0xef, 0xa3, 0x3b, 0x97,
+	0x4f, 0xac, 0x7f, 0x36, 0xa2, 0x94, 0xd8, 0xab,
+};
+
+static const u8 rsa4096_big_result[] = {
+	0x29, 0x5e, 0x3b, 0x69, 0x11, 0xec, 0x6f, 0x99, 0x77, 0xaa, 0x00, 0x91,
+	0x11, 0xb1, 0x0a, 0xb4, 0xc4, 0x8a, 0xd3, 0x86, 0xd4, 0x44, 0xc7, 0x1c,
+	0xb9, 0x9d, 0xc0, 0xea, 0x90, 0x37, 0x10, 0x1e, 0x5a, 0x9b, 0x18, 0x52,
+	0x81, 0xa5, 0xb1, 0x3b, 0xb6, 0x95, 0x6c, 0x2f, 0xc7, 0xce, 0x38, 0x50,
+	0x3d, 0x52, 0xde, 0xed, 0x8d, 0x70, 0x0b, 0x4f, 0x2a, 0xdb, 0x32, 0x08,
+	0xad, 0x01, 0xe5, 0x70, 0x73, 0x4e, 0x5e, 0x2f, 0x63, 0xdc, 0x0b, 0x56,
+	0x51, 0x44, 0x94, 0xe8, 0x94, 0xf5, 0xee, 0x7e, 0x4b, 0x47, 0x98, 0xa0,
+	0xc6, 0xf6, 0x2d, 0x0c, 0xf0, 0xb4, 0x4f, 0xd2, 0x71, 0x93, 0xdd, 0x68,
+	0x88, 0x5d, 0x27, 0x4c, 0xcf, 0x14, 0x94, 0x14, 0x82, 0xfa, 0x41, 0x91,
+	0xd3, 0x7c, 0xf4, 0xe6, 0xb3, 0x53, 0xd7, 0xf9, 0x49, 0xe3, 0xa4, 0x21,
+	0x4b, 0x89, 0x7f, 0xa9, 0x70, 0x4f, 0xda, 0x97, 0xc1, 0xdf, 0x0d, 0x70,
+	0xfb, 0x6a, 0xd3, 0xca, 0xe7, 0xfc, 0x36, 0x1a, 0x8f, 0x1b, 0xb8, 0x5e,
+	0xae, 0x95, 0x3d, 0x13, 0xe7, 0x3b, 0x8a, 0xe2, 0x0f, 0xe8, 0xa9, 0xf6,
+	0x15, 0xcf, 0x6e, 0xab, 0x99, 0xda, 0x49, 0x21, 0xc9, 0x25, 0xc8, 0x72,
+	0x41, 0x30, 0x6c, 0x71, 0xd5, 0xb8, 0x93, 0x53, 0x6a, 0x67, 0x94, 0xa1,
+	0x2c, 0x63, 0x33, 0x91, 0x1b, 0xdc, 0x2b, 0xdc, 0xdd, 0xc4, 0x6d, 0x7b,
+	0x40, 0x31, 0xd6, 0x37, 0x7e, 0xe2, 0x2c, 0x47, 0xa2, 0xbe, 0xcb, 0x9c,
+	0x3d, 0xc7, 0x0c, 0xef, 0xcd, 0xba, 0xde, 0x81, 0x56, 0x3f, 0x61, 0x9a,
+	0xd9, 0x40, 0xb9, 0xf2, 0x9a, 0xa3, 0x13, 0xd8, 0x11, 0xd7, 0x67, 0x8a,
+	0x80, 0xd3, 0xcc, 0xd3, 0xf3, 0x34, 0x2d, 0x74, 0x89, 0x56, 0x79, 0x54,
+	0xbd, 0x85, 0x4f, 0xfb, 0xfc, 0x4c, 0xc2, 0xcc, 0xf3, 0xbc, 0x2e, 0x02,
+	0x39, 0x83, 0x41, 0x16, 0xc5, 0xb8, 0x39, 0xe6, 0x69, 0xa7, 0xd0, 0x00,
+	0x2b, 0xe9, 0x90, 0x4b, 0x55, 0xca, 0x95, 0xe6, 0x07, 0xb2, 0x84, 0x0e,
+	0xfb, 0x0b, 0xc7, 0xbd, 0x19, 0xdc, 0x13, 0x4d, 0x6e, 0xbf, 0x8c, 0xa6,
+	0x36, 0xdd, 0x23, 0x34, 0x89, 0x65, 0x00, 0x7e, 0x6f, 0xaa, 0x41, 0xb4,
+	0x5d, 0x62, 0x07, 0x3e, 0x2e, 0xbd, 0x92, 0x1a, 0x38, 0x82, 0xf1, 0xfa,
+	0xde, 0x28, 0x42, 0xe1, 0xe7, 0x75, 0x29, 0x09, 0x38, 0xc6, 0xb0, 0x69,
+	0xb8, 0x89, 0x59, 0xb5, 0xe8, 0xd7, 0x9f, 0xec, 0xfe, 0x58, 0xbd, 0x7a,
+	0x03, 0x10, 0x27, 0xd7, 0x8e, 0xb6, 0x97, 0xc4, 0x48, 0xd7, 0xda, 0x0d,
+	0x45, 0x84, 0x6a, 0x23, 0xe8, 0x2d, 0x15, 0x11, 0xfa, 0x6a, 0x00, 0x25,
+	0x74, 0x92, 0x04, 0x34, 0x28, 0x68, 0xbe, 0xbf, 0xd9, 0x17, 0x3d, 0x6a,
+	0x86, 0xae, 0x9e, 0x5f, 0xcb, 0x25, 0x8c, 0x0d, 0x1d, 0x23, 0x46, 0x11,
+	0x83, 0x80, 0xf0, 0x50, 0x18, 0xef, 0x9f, 0x7e, 0xf4, 0x76, 0x07, 0x1b,
+	0xfe, 0x87, 0x09, 0xc7, 0xc7, 0xab, 0x45, 0xff, 0x3f, 0x8e, 0x26, 0x5c,
+	0x08, 0x23, 0x7d, 0xb9, 0xf0, 0x7b, 0xc9, 0x6a, 0xa5, 0x35, 0x8c, 0x33,
+	0x00, 0xf9, 0x7c, 0xb3, 0x6b, 0xff, 0xaf, 0xbe, 0x3a, 0x90, 0x84, 0x36,
+	0xe1, 0x18, 0xfb, 0xa2, 0xb6, 0x2f, 0x68, 0xe3, 0x77, 0xac, 0xd1, 0xe2,
+	0xf8, 0x23, 0xac, 0x69, 0xd0, 0x95, 0x3c, 0xfc, 0x14, 0x3c, 0x18, 0x66,
+	0x4b, 0x95, 0xf5, 0xbf, 0xd3, 0xed, 0xe9, 0xf8, 0x19, 0x2c, 0x74, 0x9b,
+	0x1c, 0x42, 0xa1, 0x93, 0x08, 0x5d, 0xc9, 0x47, 0x52, 0x36, 0x39, 0x32,
+	0x7d, 0xc0, 0x08, 0xb0, 0x03, 0xea, 0x0b, 0x71, 0x3b, 0xd8, 0xfd, 0x60,
+	0x00, 0x63, 0xad, 0x39, 0xb3, 0xd5, 0xeb, 0xb6, 0x0e, 0x24, 0xc9, 0x82,
+	0xfb, 0x23, 0x84, 0x4e, 0x46, 0x2b, 0x62, 0xbc,
+};
+
+/* a second 2048-bit key, for checking that keys are not mixed up */
+static const u8 rsa2048b_modulus[] = {
+	0xec, 0xb5, 0x6f, 0x52, 0x12, 0xbb, 0xd4, 0xa1, 0xb8, 0x5c, 0x95, 0x24,
+	0x16, 0x6c, 0xcb, 0x13, 0x76, 0x09, 0x50, 0x8f, 0xdb, 0xdb, 0xf3, 0x89,
+	0x1f, 0x88, 0x8a, 0x6d, 0x82, 0x08, 0xd9, 0xa6, 0xfb, 0x24, 0xf5, 0xd9,
+	0xef, 0x04, 0x4d, 0xe9, 0x42, 0xd9, 0x18, 0x14, 0xf9, 0xee, 0x6d, 0xec,
+	0x76, 0xf7, 0xcd, 0xcf, 0xd6, 0xda, 0xf0, 0xee, 0xb5, 0xd4, 0xa7, 0x8e,
+	0xc4, 0x10, 0x11, 0xd3, 0x53, 0x76, 0x35, 0xff, 0x04, 0xf3, 0x23, 0x5d,
+	0x0b, 0x8a, 0x44, 0x56, 0xba, 0x9d, 0xae, 0xee, 0x33, 0xb5, 0xf5, 0xeb,
+	0x4d, 0xaa, 0x4e, 0xf3, 0x8a, 0x65, 0x6f, 0x26, 0xab, 0x97, 0x36, 0x78,
+	0xb0, 0xb9, 0xbb, 0x7c, 0x44, 0xcf, 0xbd, 0x14, 0x9b, 0xef, 0x4a, 0xb3,
+	0x74, 0xbf, 0xb4, 0x49, 0x0c, 0x7b, 0xaf, 0x67, 0xe0, 0x31, 0x9d, 0x29,
+	0xb1, 0x9f, 0x16, 0x7e, 0x44, 0x6a, 0xfa, 0x51, 0x0f, 0x5e, 0x8f, 0x00,
+	0xb3, 0x5a, 0x7c, 0xdb, 0x1e, 0x81, 0xa9, 0xe4, 0x23, 0x33, 0x07, 0x75,
+	0x61, 0x09, 0x12, 0xe0, 0x89, 0xdc, 0x60, 0x8c, 0x30, 0x21, 0x4e, 0xc0,
+	0xed, 0x8f, 0xbe, 0x4a, 0x09, 0xbf, 0xf8, 0x17, 0xba, 0x93, 0x1d, 0x92,
+	0x43, 0x1e, 0x83, 0x56, 0x98, 0xff, 0xd6, 0x4e, 0x4b, 0xaf, 0x55, 0xb4,
+	0x33, 0xfa, 0x8f, 0x61, 0xb1, 0x66, 0xee, 0x0e, 0x12, 0xc1, 0x72, 0x04,
+	0xae, 0x08, 0xb5, 0xa8, 0x89, 0xd6, 0xdc, 0xef, 0x95, 0x8d, 0xfe, 0xc7,
+	0x65, 0xd4, 0xb7, 0xfc, 0x34, 0xaa, 0xc9, 0x5a, 0x3f, 0x5b, 0xe8, 0x21,
+	0x46, 0x17, 0x08, 0x98, 0x93, 0x5d, 0x24, 0x7f, 0x69, 0xd3, 0x4d, 0xdb,
+	0x56, 0xef, 0xe9, 0x61, 0x82, 0x8c, 0x07, 0x35, 0x27, 0xb1, 0xb5, 0xc6,
+	0xa1, 0xad, 0xe7, 0x9d, 0xd6, 0x70, 0x41, 0x5a, 0x76, 0x17, 0x76, 0xc0,
+	0x92, 0xe5, 0x44, 0x99,
+};
+
+static const u8 rsa2048b_rr[] = {
+	0x66, 0x52, 0xb7, 0x54, 0x2c, 0xb3, 0x35, 0x51, 0x82, 0x0b, 0xfb, 0xba,
+	0x6f, 0xcb, 0x18, 0x84, 0x61, 0x9c, 0x83, 0xb3, 0xb5, 0x7e, 0x5b, 0x52,
+	0x43, 0xe6, 0x1e, 0x84, 0xa3, 0x5b, 0xfa, 0xe5, 0x7e, 0x19, 0xcd, 0x6d,
+	0x24, 0x92, 0x9c, 0x9a, 0xb8, 0x49, 0x5c, 0x87, 0xd0, 0xde, 0x6a, 0xdb,
+	0x66, 0x57, 0xb7, 0x6b, 0x4e, 0x31, 0x64, 0x9f, 0x9e, 0xd5, 0xbb, 0x82,
+	0x64, 0x04, 0x09, 0x9f, 0xbd, 0xcf, 0xcf, 0xc1, 0x90, 0xdd, 0x4a, 0x35,
+	0x10, 0x90, 0xd9, 0x95, 0x28, 0x99, 0x2c, 0x19, 0x24, 0xbe, 0xdc, 0xf3,
+	0x88, 0x20, 0xc5, 0xe6, 0xed, 0x3c, 0x29, 0x1c, 0x6d, 0xf6, 0x18, 0x81,
+	0xa7, 0x49, 0xdc, 0x28, 0xea, 0xfd, 0xe5, 0x4b, 0xc1, 0xfa, 0x29, 0x66,
+	0x00, 0xce, 0xc1, 0x7b, 0xab, 0x1e, 0x86, 0xe7, 0x37, 0xae, 0xd6, 0xd5,
+	0xb2, 0xfb, 0x26, 0x66, 0xd3, 0x0d, 0x89, 0xfc, 0x0c, 0x8c, 0x70, 0xe6,
+	0x6b, 0xc9, 0xe3, 0x5e, 0x39, 0xcd, 0xdf, 0x2c, 0x17, 0xc7, 0x7a, 0xe7,
+	0xa6, 0xd8, 0x79, 0x94, 0xc0, 0x47, 0x4d, 0x3a, 0x38, 0x10, 0xdf, 0xff,
+	0xff, 0x68, 0x1c, 0x2f, 0xc3, 0x17, 0xa0, 0xc8, 0x85, 0xbb, 0x31, 0x99,
+	0xd4, 0x7b, 0xa2, 0x4b, 0xf9, 0x7d, 0x2a, 0x00, 0x08, 0x57, 0x59, 0x0f,
+	0x48, 0xe3, 0x87, 0x02, 0x18, 0x0e, 0x65, 0x2f, 0x5c, 0x60, 0xb8, 0x4e,
+	0xa5, 0x0c, 0x07, 0x25, 0x8f, 0xdb, 0x96, 0x42, 0xf2, 0xcc, 0xee, 0x35,
+	0x0f, 0x7c, 0x87, 0xcc, 0xdf, 0x48, 0x7b, 0x2d, 0x38, 0xc1, 0x80, 0x43,
+	0x22, 0xca, 0xcd, 0x18, 0xc6, 0x50, 0xd9, 0xeb, 0x28, 0x44, 0x6c, 0xff,
+	0x7a, 0x98, 0x62, 0xc6, 0x36, 0xdf, 0x3b, 0x08, 0xa1, 0xf0, 0x8a, 0xac,
+	0x0d, 0x95, 0xb0, 0x42, 0xeb, 0x50, 0xd1, 0x76, 0x24, 0xb8, 0x13, 0x7c,
+	0x00, 0xd6, 0xac, 0x89,
+};
+
+static const u8 rsa2048b_f4_result[] = {
+	0x4b, 0x53, 0xc8, 0x2e, 0x10, 0x40, 0x8f, 0xd8, 0x58, 0x19, 0xd0, 0x0f,
+	0x44, 0x56, 0x5a, 0x54, 0xed, 0x17, 0xb6, 0x28, 0x8b, 0xab, 0x62, 0x85,
+	0x15, 0xbf, 0x9c, 0x75, 0xfd, 0x86, 0x37, 0x72, 0xae, 0x94, 0x5a, 0xeb,
+	0x40, 0x3d, 0xa5, 0x99, 0xba, 0xc2, 0xa4, 0x65, 0xfd, 0xca, 0x9b, 0xf3,
+	0xfe, 0xf7, 0xf3, 0x2f, 0x9e, 0x9d, 0xb0, 0x40, 0xb4, 0x92, 0x58, 0x5b,
+	0x0c, 0xb8, 0x5c, 0x92, 0x72, 0x97, 0xc6, 0x27, 0xfb, 0x73, 0x4b, 0x0b,
+	0xd0, 0x04, 0x7a, 0x83, 0x00, 0x2f, 0xb4, 0xc3, 0xc5, 0x0b, 0x1d, 0xaa,
+	0x4b, 0xbc, 0x52, 0xb2, 0xa7, 0x21, 0x46, 0x54, 0x86, 0x12, 0xde, 0xd5,
+	0xad, 0x28, 0x5f, 0xea, 0x78, 0x5e, 0x65, 0x37, 0xe8, 0xdb, 0x90, 0xec,
+	0xa7, 0xc1, 0x03, 0x12, 0x3e, 0x02, 0x7d, 0x74, 0xbe, 0xee, 0x04, 0xa9,
+	0x17, 0x12, 0xd5, 0x6b, 0x72, 0x51, 0xe0, 0xd0, 0xf7, 0xa3, 0x10, 0x69,
+	0x74, 0xe2, 0x5a, 0xb8, 0x04, 0x70, 0xbe, 0x2c, 0x19, 0x8c, 0xb7, 0x96,
+	0x4b, 0xa4, 0xae, 0x56, 0x9c, 0x02, 0x84, 0x56, 0xe6, 0x6d, 0x4b, 0xef,
+	0x19, 0xf1, 0x11, 0xa0, 0xf5, 0xdc, 0x8e, 0xda, 0x90, 0x15, 0xba, 0x8c,
+	0x28, 0x22, 0xf8, 0x33, 0x35, 0xa4, 0x40, 0x58, 0x66, 0x7e, 0xff, 0xfd,
+	0x71, 0x55, 0x7a, 0x41, 0x96, 0xfd, 0x13, 0x33, 0xb2, 0x5d, 0xe2, 0xf1,
+	0x0d, 0xa0, 0xbe, 0xfb, 0x38, 0x49, 0xa6, 0xe5, 0x17, 0xf3, 0xb6, 0xfa,
+	0x84, 0xd6, 0x55, 0x26, 0x9f, 0xbb, 0xe5, 0x65, 0x4c, 0x1c, 0x72, 0x19,
+	0xb4, 0xe0, 0x1e, 0x48, 0x68, 0x5c, 0x22, 0x71, 0xff, 0xa1, 0xa2, 0x48,
+	0xa4, 0x5e, 0x7c, 0x72, 0x9f, 0x0f, 0x5c, 0x55, 0xea, 0x60, 0x3a, 0x36,
+	0x9a, 0xff, 0xf3, 0x44, 0x48, 0x26, 0xf3, 0xc2, 0x45, 0x68, 0x96, 0x99,
+	0x60, 0xd2, 0x05, 0x27,
+};
@@ -6,6 +6,8 @@
 # Simple test script for tracing with sandbox
 
 TRACE_OPT="FTRACE=1"
+# sandbox_defconfig does not enable the trace command
+TRACE_CONFIG="CMD_TRACE"
 
 BASE="$(dirname $0)/.."
 . $BASE/common.sh
@@ -23,6 +25,9 @@ trace resume
 hash sha256 0 10000
 trace pause
 trace stats
+trace funclist 2000000 4000000
+trace calls
+save hostfs - 2000000 ${trace_data} \${profoffset}
 reset
 END
 }
@@ -54,11 +59,35 @@ check_results() {
 	fi
 }
 
+check_proftool() {
+	echo "Check proftool"
+	proftool="./${OUTPUT_DIR}/tools/proftool -m ${OUTPUT_DIR}/System.map"
+	proftool="${proftool} -p ${trace_data} -v1"
+
+	# The sha256 calculation should show up in the call stacks
+	${proftool} dump-flamegraph >${tmp}
+	if ! grep -q "^.*;hash_command;.*sha256.* [0-9]*$" ${tmp}; then
+		fail "flamegraph error"
+	fi
+
+	${proftool} dump-chrome >${tmp}
+	if [ $(grep -c '"name":"sha256_.*","ph":"X"' ${tmp}) -lt 3 ]; then
+		fail "chrome trace error"
+	fi
+
+	${proftool} dump-funcs >${tmp}
+	if ! grep -q " hash_command$" ${tmp}; then
+		fail "function list error"
+	fi
+}
+
 echo "Simple trace test / sanity check using sandbox"
 echo
 tmp="$(tempfile)"
-build_uboot "${TRACE_OPT}"
+trace_data="$(tempfile)"
+build_uboot "${TRACE_OPT}" "${TRACE_CONFIG}"
 run_trace >${tmp}
 check_results ${tmp}
-rm ${tmp}
+check_proftool
+rm ${tmp} ${trace_data}
 echo "Test passed"
@@ -14,7 +14,9 @@ static data.
 
 import collections
 import copy
+import struct
 import sys
+import zlib
 
 import fdt
 import fdt_util
@@ -44,6 +46,19 @@ TYPE_NAMES = {
 
 STRUCT_PREFIX = 'dtd_'
 VAL_PREFIX = 'dtv_'
+LIVE_PREFIX = 'dtl_'
+
+# Properties which hold a list of phandles, each followed by arguments. The
+# number of argument cells is given by a property of the target node.
+PHANDLE_PROPS = {
+    'clocks': '#clock-cells',
+    'dmas': '#dma-cells',
+    'mboxes': '#mbox-cells',
+    'phys': '#phy-cells',
+    'power-domains': '#power-domain-cells',
+    'pwms': '#pwm-cells',
+    'resets': '#reset-cells',
+}
 
 # This holds information about a property which includes phandles.
 #
@@ -70,6 +85,23 @@ def conv_name_to_c(name):
     new = new.replace('.', '_')
     return new
 
+def get_phandle_cells_name(prop_name):
+    """Get the name of the property giving the number of phandle arguments
+
+    Args:
+        prop_name: Name of a property which may hold phandles
+    Return:
+        Name of the property in the target node which gives the number of
+        argument cells, e.g. '#clock-cells', or None if prop_name is not
+        known to hold phandles
+    """
+    # Some integer properties share the suffix, e.g. 'snps,nr-gpios'
+    if prop_name.endswith('nr-gpios') or prop_name.endswith('num-gpios'):
+        return None
+    if prop_name == 'gpios' or prop_name.endswith('-gpios'):
+        return '#gpio-cells'
+    return PHANDLE_PROPS.get(prop_name)
+
 def tab_to(num_tabs, line):
     """Append tabs to a line of text to reach a tab stop.
 
@@ -125,6 +157,54 @@ def get_compat_name(node):
         compat, aliases = compat[0], compat[1:]
     return conv_name_to_c(compat), [conv_name_to_c(a) for a in aliases]
 
+def get_c_string(value):
+    """Get a NUL-terminated string of bytes as a C string literal
+
+    Args:
+        value: String of bytes, possibly containing a NUL terminator
+    Return:
+        String containing the C literal, with anything after the first NUL
+        dropped and non-printable characters escaped
+    """
+    out = ''
+    for ch in value.split('\0')[0]:
+        if ch in '"\\':
+            out += '\\' + ch
+        elif ch < ' ' or ch > '~':
+            out += '\\%03o' % ord(ch)
+        else:
+            out += ch
+    return '"%s"' % out
+
+
+class LiveNode(object):
+    """A node in the live tree being generated
+
+    This holds the same information as struct device_node, using indexes into
+    the lists of nodes and properties instead of pointers.
+
+    Properties:
+        name: Value of the node's 'name' property
+        type: Value of the node's 'device_type' property, or '<NULL>'
+        phandle: Phandle of the node, or 0 if none
+        full_name: Full path to the node
+        prop: Index of the node's first property
+        num_props: Number of properties in the node
+        parent: Index of the parent node, or None for the root node
+        child: Index of the first subnode, or None if none
+        sibling: Index of the next node with the same parent, or None
+    """
+    def __init__(self, full_name, parent):
+        self.name = '<NULL>'
+        self.type = '<NULL>'
+        self.phandle = 0
+        self.full_name = full_name
+        self.prop = None
+        self.num_props = 0
+        self.parent = parent
+        self.child = None
+        self.sibling = None
+
 
 class DtbPlatdata(object):
     """Provide a means to convert device tree binary data to platform data
@@ -204,14 +284,16 @@ class DtbPlatdata(object):
         """Check if a node contains phandles
 
         We have no reliable way of detecting whether a node uses a phandle
-        or not. As an interim measure, use a list of known property names.
+        or not. As an interim measure, use a list of known property names
+        (see get_phandle_cells_name()).
 
         Args:
             prop: Prop object to check
         Return:
             Number of argument cells is this is a phandle, else None
         """
-        if prop.name in ['clocks']:
+        cells_name = get_phandle_cells_name(prop.name)
+        if cells_name:
             val = prop.value
             if not isinstance(val, list):
                 val = [val]
@@ -221,15 +303,19 @@ class DtbPlatdata(object):
             args = []
             while i < len(val):
                 phandle = fdt_util.fdt32_to_cpu(val[i])
+                # A zero phandle is an empty entry, e.g. in cs-gpios
+                if not phandle:
+                    args.append(0)
+                    i += 1
+                    continue
                 target = self._fdt.phandle_to_node.get(phandle)
                 if not target:
                     raise ValueError("Cannot parse '%s' in node '%s'" %
                                      (prop.name, node_name))
-                prop_name = '#clock-cells'
-                cells = target.props.get(prop_name)
+                cells = target.props.get(cells_name)
                 if not cells:
                     raise ValueError("Node '%s' has no '%s' property" %
-                            (target.name, prop_name))
+                            (target.name, cells_name))
                 num_args = fdt_util.fdt32_to_cpu(cells.value)
                 max_args = max(max_args, num_args)
                 args.append(num_args)
@@ -269,9 +355,22 @@ class DtbPlatdata(object):
         This fills in the following properties:
             _valid_nodes: A list of nodes we wish to consider include in the
                 platform data
+
+        Each valid node is given a var_name, which is used for its platform
+        data and U_BOOT_DEVICE() declaration. This is normally based on the
+        node name, but the full path is used where several nodes have the
+        same name.
         """
         self._valid_nodes = []
-        return self.scan_node(self._fdt.GetRoot())
+        self.scan_node(self._fdt.GetRoot())
+
+        var_names = set()
+        for node in self._valid_nodes:
+            var_name = conv_name_to_c(node.name)
+            if var_name in var_names:
+                var_name = conv_name_to_c(node.path[1:].replace('/', '_'))
+            var_names.add(var_name)
+            node.var_name = var_name
 
     @staticmethod
     def get_num_cells(node):
@@ -408,8 +507,9 @@ class DtbPlatdata(object):
                     for args in info.args:
                         phandle_cell = prop.value[pos]
                         phandle = fdt_util.fdt32_to_cpu(phandle_cell)
-                        target_node = self._fdt.phandle_to_node[phandle]
-                        node.phandles.add(target_node)
+                        target_node = self._fdt.phandle_to_node.get(phandle)
+                        if target_node:
+                            node.phandles.add(target_node)
                         pos += 1 + args
 
 
@@ -456,7 +556,7 @@ class DtbPlatdata(object):
             node: node to output
         """
         struct_name, _ = get_compat_name(node)
-        var_name = conv_name_to_c(node.name)
+        var_name = node.var_name
         self.buf('static struct %s%s %s%s = {\n' %
                  (STRUCT_PREFIX, struct_name, VAL_PREFIX, var_name))
         for pname, prop in node.props.items():
@@ -478,14 +578,20 @@ class DtbPlatdata(object):
                     for args in info.args:
                         phandle_cell = prop.value[pos]
                         phandle = fdt_util.fdt32_to_cpu(phandle_cell)
-                        target_node = self._fdt.phandle_to_node[phandle]
-                        name = conv_name_to_c(target_node.name)
+                        target_node = self._fdt.phandle_to_node.get(phandle)
                         arg_values = []
                         for i in range(args):
                             arg_values.append(str(fdt_util.fdt32_to_cpu(prop.value[pos + 1 + i])))
                         pos += 1 + args
-                        vals.append('\t{&%s%s, {%s}}' % (VAL_PREFIX, name,
-                                                     ', '.join(arg_values)))
+                        # The entry may be empty, or the target may have no
+                        # platform data, e.g. if it is disabled
+                        if target_node in self._valid_nodes:
+                            target = '&%s%s' % (VAL_PREFIX,
+                                                target_node.var_name)
+                        else:
+                            target = 'NULL'
+                        vals.append('\t{%s, {%s}}' % (target,
+                                                   ', '.join(arg_values)))
                     for val in vals:
                         self.buf('\n\t\t%s,' % val)
                 else:
@@ -541,6 +647,151 @@ class DtbPlatdata(object):
             self.output_node(node)
             nodes_to_output.remove(node)
 
+    def add_live_data(self, value):
+        """Add a property value to the live-tree data
+
+        Values are aligned to 4 bytes, as they are in the .dtb, so that cells
+        can be read directly.
+
+        Args:
+            value: String of bytes to add
+        Returns:
+            Offset of the value within the data
+        """
+        while len(self._live_data) % 4:
+            self._live_data.append(0)
+        offset = len(self._live_data)
+        self._live_data.extend(value)
+        return offset
+
+    def scan_live_node(self, node, parent):
+        """Add a node and its subnodes to the live tree
+
+        This follows what unflatten_dt_node() in lib/of_live.c does, so that
+        the result is the same as the tree built at run time.
+
+        Args:
+            node: Node object to add
+            parent: Index of the parent node, or None for the root node
+        Returns:
+            Index of the new node
+        """
+        live = LiveNode(node.path, parent)
+        index = len(self._live_nodes)
+        self._live_nodes.append(live)
+
+        # Keep the properties in the same order as the .dtb
+        props = sorted(node.props.values(), key=lambda prop: prop._offset)
+        values = [(prop.name, prop.bytes) for prop in props]
+        if 'name' not in node.props:
+            unit_name = node.name if parent is not None else ''
+            values.append(('name', unit_name.rsplit('@', 1)[0] + '\0'))
+        live.prop = len(self._live_props)
+        for pname, value in values:
+            if pname in ('phandle', 'linux,phandle') and not live.phandle:
+                live.phandle = fdt_util.fdt32_to_cpu(value[:4])
+            elif pname == 'ibm,phandle':
+                live.phandle = fdt_util.fdt32_to_cpu(value[:4])
+            if pname == 'name' and live.name == '<NULL>':
+                live.name = value
+            elif pname == 'device_type' and live.type == '<NULL>':
+                live.type = value
+            self._live_props.append((pname, len(value),
+                                     self.add_live_data(value)))
+        live.num_props = len(values)
+
+        prev = None
+        for subnode in node.subnodes:
+            child = self.scan_live_node(subnode, index)
+            if prev is None:
+                live.child = child
+            else:
+                self._live_nodes[prev].sibling = child
+            prev = child
+        return index
+
+    def generate_livetree(self):
+        """Generate a live tree for U-Boot proper
+
+        This writes out C data for a struct device_node tree equivalent to the
+        one that of_live_build() creates from the .dtb at run time, along with
+        the size and CRC32 of the .dtb so that U-Boot can check that it
+        matches the device tree it is using. See
+        doc/driver-model/livetree.txt for more information.
+        """
+        self._live_nodes = []
+        self._live_props = []
+        self._live_data = bytearray()
+        self.scan_live_node(self._fdt.GetRoot(), None)
+
+        self.out_header()
+        self.out('#include <common.h>\n')
+        self.out('#include <of_live.h>\n')
+        self.out('#include <dm/of.h>\n')
+        self.out('\n')
+        self.out('static struct device_node %snode[%d];\n' %
+                 (LIVE_PREFIX, len(self._live_nodes)))
+        self.out('static struct property %sprop[%d];\n' %
+                 (LIVE_PREFIX, len(self._live_props)))
+        self.out('\n')
+
+        self.out('static unsigned char %sdata[] __aligned(4) = {\n' %
+                 LIVE_PREFIX)
+        for i in xrange(0, len(self._live_data), 8):
+            vals = ['%#x' % byte for byte in self._live_data[i:i + 8]]
+            self.out('\t%s,\n' % ', '.join(vals))
+        self.out('};\n')
+        self.out('\n')
+
+        self.out('static struct property %sprop[%d] = {\n' %
+                 (LIVE_PREFIX, len(self._live_props)))
+        for node in self._live_nodes:
+            end = node.prop + node.num_props
+            for index in xrange(node.prop, end):
+                pname, length, offset = self._live_props[index]
+                if index + 1 < end:
+                    next_prop = '&%sprop[%d]' % (LIVE_PREFIX, index + 1)
+                else:
+                    next_prop = 'NULL'
+                self.out('\t{ .name = %s, .length = %d, '
+                         '.value = &%sdata[%#x], .next = %s },\n' %
+                         (get_c_string(pname), length, LIVE_PREFIX, offset, next_prop))
+        self.out('};\n')
+        self.out('\n')
+
+        self.out('static struct device_node %snode[%d] = {\n' %
+                 (LIVE_PREFIX, len(self._live_nodes)))
+        for node in self._live_nodes:
+            self.out('\t{\n')
+            self.out('\t\t%s= %s,\n' % (tab_to(2, '.name'),
+                                          get_c_string(node.name)))
+            self.out('\t\t%s= %s,\n' % (tab_to(2, '.type'),
+                                          get_c_string(node.type)))
+            if node.phandle:
+                self.out('\t\t%s= %#x,\n' % (tab_to(2, '.phandle'),
+                                               node.phandle))
+            self.out('\t\t%s= "%s",\n' % (tab_to(2, '.full_name'),
+                                            node.full_name))
+            self.out('\t\t%s= &%sprop[%d],\n' %
+                     (tab_to(2, '.properties'), LIVE_PREFIX, node.prop))
+            for member in ['parent', 'child', 'sibling']:
+                index = getattr(node, member)
+                if index is not None:
+                    self.out('\t\t%s= &%snode[%d],\n' %
+                             (tab_to(2, '.' + member), LIVE_PREFIX, index))
+            self.out('\t},\n')
+        self.out('};\n')
+        self.out('\n')
+
+        contents = self._fdt.GetFdt()
+        fdt_size = struct.unpack('>I', str(contents[4:8]))[0]
+        fdt_crc32 = zlib.crc32(str(contents[:fdt_size])) & 0xffffffff
+        self.out('const struct of_live_builtin of_live_builtin = {\n')
+        self.out('\t%s= &%snode[0],\n' % (tab_to(2, '.root'), LIVE_PREFIX))
+        self.out('\t%s= %#x,\n' % (tab_to(2, '.fdt_size'), fdt_size))
+        self.out('\t%s= %#x,\n' % (tab_to(2, '.fdt_crc32'), fdt_crc32))
+        self.out('};\n')
+
 
 def run_steps(args, dtb_file, include_disabled, output):
     """Run all the steps of the dtoc tool
@@ -552,7 +803,8 @@ def run_steps(args, dtb_file, include_disabled, output):
         output: Name of output file
     """
     if not args:
-        raise ValueError('Please specify a command: struct, platdata')
+        raise ValueError('Please specify a command: struct, platdata, '
+                         'livetree')
 
     plat = DtbPlatdata(dtb_file, include_disabled)
     plat.scan_dtb()
@@ -567,6 +819,8 @@ def run_steps(args, dtb_file, include_disabled, output):
             plat.generate_structs(structs)
         elif cmd == 'platdata':
             plat.generate_tables()
+        elif cmd == 'livetree':
+            plat.generate_livetree()
         else:
-            raise ValueError("Unknown command '%s': (use: struct, platdata)" %
-                             cmd)
+            raise ValueError("Unknown command '%s': (use: struct, platdata, "
+                             "livetree)" % cmd)
@@ -24,6 +24,10 @@ This tool is used in U-Boot to provide device tree data to SPL without
 increasing the code size of SPL. This supports the CONFIG_SPL_OF_PLATDATA
 options. For more information about the use of this options and tool please
 see doc/driver-model/of-plat.txt
+
+It can also produce a ready-made live tree (dt-live.c) for U-Boot proper,
+with the 'livetree' command. This supports the CONFIG_OF_LIVE_BUILTIN option.
+See doc/driver-model/livetree.txt
 """
 
 from optparse import OptionParser
@@ -13,6 +13,7 @@ import collections
 import os
 import struct
 import unittest
+import zlib
 
 import dtb_platdata
 from dtb_platdata import conv_name_to_c
@@ -282,6 +283,78 @@ U_BOOT_DEVICE(phandle_source) = {
 \t.platdata_size\t= sizeof(dtv_phandle_source),
 };
 
+''', data)
+
+    def test_phandle_gpio(self):
+        """Test output from gpios phandles and nodes with the same name"""
+        dtb_file = get_dtb_file('dtoc_test_phandle_gpio.dts')
+        output = tools.GetOutputFilename('output')
+        dtb_platdata.run_steps(['struct'], dtb_file, False, output)
+        with open(output) as infile:
+            data = infile.read()
+        self.assertEqual('''/*
+ * DO NOT MODIFY
+ *
+ * This file was generated by dtoc from a .dtb (device tree binary) file.
+ */
+
+#include <stdbool.h>
+#include <libfdt.h>
+struct dtd_gpio_target {
+\tbool\t\tgpio_controller;
+};
+struct dtd_source {
+\tstruct phandle_2_arg cd_gpios[1];
+\tstruct phandle_1_arg clocks[1];
+};
+''', data)
+
+        dtb_platdata.run_steps(['platdata'], dtb_file, False, output)
+        with open(output) as infile:
+            data = infile.read()
+        self.assertEqual('''/*
+ * DO NOT MODIFY
+ *
+ * This file was generated by dtoc from a .dtb (device tree binary) file.
+ */
+
+#include <common.h>
+#include <dm.h>
+#include <dt-structs.h>
+
+static struct dtd_gpio_target dtv_gpio_target = {
+\t.gpio_controller\t= true,
+};
+U_BOOT_DEVICE(gpio_target) = {
+\t.name\t\t= "gpio_target",
+\t.platdata\t= &dtv_gpio_target,
+\t.platdata_size\t= sizeof(dtv_gpio_target),
+};
+
+static struct dtd_source dtv_leds = {
+\t.clocks\t\t\t= {
+\t\t\t{NULL, {4}},},
+\t.cd_gpios\t\t= {
+\t\t\t{&dtv_gpio_target, {3, 0}},},
+};
+U_BOOT_DEVICE(leds) = {
+\t.name\t\t= "source",
+\t.platdata\t= &dtv_leds,
+\t.platdata_size\t= sizeof(dtv_leds),
+};
+
+static struct dtd_source dtv_bus2_leds = {
+\t.clocks\t\t\t= {
+\t\t\t{NULL, {6}},},
+\t.cd_gpios\t\t= {
+\t\t\t{&dtv_gpio_target, {5, 1}},},
+};
+U_BOOT_DEVICE(bus2_leds) = {
+\t.name\t\t= "source",
+\t.platdata\t= &dtv_bus2_leds,
+\t.platdata_size\t= sizeof(dtv_bus2_leds),
+};
+
 ''', data)
 
     def test_aliases(self):
@@ -529,3 +602,91 @@ U_BOOT_DEVICE(test3) = {
 };
 
 ''', data)
+
+    def test_livetree(self):
+        """Test output of a live tree"""
+        dtb_file = get_dtb_file('dtoc_test_livetree.dts')
+        output = tools.GetOutputFilename('output')
+        dtb_platdata.run_steps(['livetree'], dtb_file, False, output)
+        with open(output) as infile:
+            data = infile.read()
+        with open(dtb_file) as infile:
+            dtb = infile.read()
+        fdt_size = struct.unpack('>I', dtb[4:8])[0]
+        fdt_crc32 = zlib.crc32(dtb[:fdt_size]) & 0xffffffff
+        self.assertEqual('''/*
+ * DO NOT MODIFY
+ *
+ * This file was generated by dtoc from a .dtb (device tree binary) file.
+ */
+
+#include <common.h>
+#include <of_live.h>
+#include <dm/of.h>
+
+static struct device_node dtl_node[4];
+static struct property dtl_prop[11];
+
+static unsigned char dtl_data[] __aligned(4) = {
+\t0x0, 0x0, 0x0, 0x1, 0x0, 0x0, 0x0, 0x0,
+\t0x0, 0x0, 0x0, 0x0, 0x63, 0x70, 0x75, 0x0,
+\t0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x1,
+\t0x63, 0x70, 0x75, 0x0, 0x73, 0x75, 0x62, 0x0,
+\t0x0, 0x0, 0x0, 0x1, 0x63, 0x68, 0x69, 0x6c,
+\t0x64, 0x0,
+};
+
+static struct property dtl_prop[11] = {
+\t{ .name = "#address-cells", .length = 4, .value = &dtl_data[0x0], .next = &dtl_prop[1] },
+\t{ .name = "#size-cells", .length = 4, .value = &dtl_data[0x4], .next = &dtl_prop[2] },
+\t{ .name = "name", .length = 1, .value = &dtl_data[0x8], .next = NULL },
+\t{ .name = "device_type", .length = 4, .value = &dtl_data[0xc], .next = &dtl_prop[4] },
+\t{ .name = "reg", .length = 4, .value = &dtl_data[0x10], .next = &dtl_prop[5] },
+\t{ .name = "phandle", .length = 4, .value = &dtl_data[0x14], .next = &dtl_prop[6] },
+\t{ .name = "name", .length = 4, .value = &dtl_data[0x18], .next = NULL },
+\t{ .name = "name", .length = 4, .value = &dtl_data[0x1c], .next = NULL },
+\t{ .name = "cpu", .length = 4, .value = &dtl_data[0x20], .next = &dtl_prop[9] },
+\t{ .name = "enabled", .length = 0, .value = &dtl_data[0x24], .next = &dtl_prop[10] },
+\t{ .name = "name", .length = 6, .value = &dtl_data[0x24], .next = NULL },
+};
+
+static struct device_node dtl_node[4] = {
+\t{
+\t\t.name\t\t= "",
+\t\t.type\t\t= "<NULL>",
+\t\t.full_name\t= "/",
+\t\t.properties\t= &dtl_prop[0],
+\t\t.child\t\t= &dtl_node[1],
+\t},
+\t{
+\t\t.name\t\t= "cpu",
+\t\t.type\t\t= "cpu",
+\t\t.phandle\t= 0x1,
+\t\t.full_name\t= "/cpu@0",
+\t\t.properties\t= &dtl_prop[3],
+\t\t.parent\t\t= &dtl_node[0],
+\t\t.sibling\t= &dtl_node[2],
+\t},
+\t{
+\t\t.name\t\t= "sub",
+\t\t.type\t\t= "<NULL>",
+\t\t.full_name\t= "/bus",
+\t\t.properties\t= &dtl_prop[7],
+\t\t.parent\t\t= &dtl_node[0],
+\t\t.child\t\t= &dtl_node[3],
+\t},
+\t{
+\t\t.name\t\t= "child",
+\t\t.type\t\t= "<NULL>",
+\t\t.full_name\t= "/bus/child",
+\t\t.properties\t= &dtl_prop[8],
+\t\t.parent\t\t= &dtl_node[2],
+\t},
+};
+
+const struct of_live_builtin of_live_builtin = {
+\t.root\t\t= &dtl_node[0],
+\t.fdt_size\t= %#x,
+\t.fdt_crc32\t= %#x,
+};
+''' % (fdt_size, fdt_crc32), data)
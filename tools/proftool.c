@@ -32,6 +32,7 @@ struct func_info {
 	const char *name;
 	unsigned long code_size;
 	unsigned long call_count;
+	unsigned long total_us;
 	unsigned flags;
 	/* the section this function is in */
 	struct objsection_info *objsection;
@@ -52,6 +53,31 @@ struct trace_configline_info {
 /* The contents of the trace config file */
 struct trace_configline_info *trace_config_head;
 
+/* A node in the call tree, used for flamegraph output */
+struct flame_node {
+	struct func_info *func;		/* Function, or NULL for the root */
+	struct flame_node *parent;
+	struct flame_node *child;	/* First child */
+	struct flame_node *sibling;	/* Next child of the parent */
+	unsigned long total_us;		/* Time spent, including children */
+};
+
+/* A function on the call stack while walking the call list */
+struct stack_entry {
+	struct func_info *func;
+	unsigned long start_us;		/* Time when it was entered */
+};
+
+/* Callbacks used by walk_calls() */
+struct walk_ops {
+	void (*enter)(void *ctx, struct func_info *func, unsigned long time);
+	void (*exit)(void *ctx, struct func_info *func, unsigned long start,
+		     unsigned long time);
+};
+
+#define MAX_STACK_DEPTH	1000
+#define MAX_PATH_LEN	(MAX_LINE_LEN * 8)
+
 struct func_info *func_list;
 int func_count;
 struct trace_call *call_list;
@@ -86,8 +112,13 @@ static void usage(void)
 		"\n"
 		"Commands\n"
 		"   dump-ftrace\t\tDump out textual data in ftrace format\n"
+		"   dump-flamegraph\tDump out stack traces in folded format\n"
+		"   dump-chrome\t\tDump out Chrome trace-event JSON\n"
+		"   dump-funcs\t\tDump out call counts and times\n"
+		"   dump-bootstage\tAdd function names to bootstage export\n"
 		"\n"
 		"Options:\n"
+		"   -b <file>\tSpecify 'bootstage export' output file\n"
 		"   -m <map>\tSpecify Systen.map file\n"
 		"   -t <trace>\tSpecific trace data file (from U-Boot)\n"
 		"   -v <0-4>\tSpecify verbosity\n");
@@ -227,6 +258,27 @@ static int read_calls(FILE *fin, int count)
 	return 0;
 }
 
+static int read_funcs(FILE *fin, int count, int *not_found)
+{
+	struct trace_output_func stats;
+	struct func_info *func;
+	int i;
+
+	notice("function count: %d\n", count);
+	for (i = 0; i < count; i++) {
+		if (read_data(fin, &stats, sizeof(stats)))
+			return 1;
+		func = find_func_by_offset(stats.offset);
+		if (!func) {
+			(*not_found)++;
+			continue;
+		}
+		func->call_count = stats.call_count;
+		func->total_us = stats.total_us;
+	}
+	return 0;
+}
+
 static int read_profile(FILE *fin, int *not_found)
 {
 	struct trace_output_hdr hdr;
@@ -243,7 +295,8 @@ static int read_profile(FILE *fin, int *not_found)
 
 		switch (hdr.type) {
 		case TRACE_CHUNK_FUNCS:
-			/* Ignored at present */
+			if (read_funcs(fin, hdr.rec_count, not_found))
+				return 1;
 			break;
 
 		case TRACE_CHUNK_CALLS:
@@ -533,9 +586,300 @@ static int make_ftrace(void)
 	return 0;
 }
 
+/**
+ * walk_calls() - Follow the call list, tracking the call stack
+ *
+ * The call list may start part-way through a call (if the trace buffer
+ * wrapped) and records may be missing (if the call depth limit was
+ * reached), so exits are matched up with the entry of the same function.
+ * An exit with no matching entry is ignored and functions which never exit
+ * are treated as exiting at the end of the trace.
+ *
+ * Times in the call list wrap, so these are converted to a time which
+ * counts up from the first record.
+ *
+ * @ops: Callbacks to call on each function entry and exit
+ * @ctx: Context pointer to pass to the callbacks
+ * @return 0 if OK, -1 if the call stack is too deep
+ */
+static int walk_calls(const struct walk_ops *ops, void *ctx)
+{
+	struct stack_entry stack[MAX_STACK_DEPTH];
+	unsigned long time = 0, last = 0;
+	struct trace_call *call;
+	bool started = false;
+	int depth = 0;
+	int i, upto;
+
+	for (i = 0, call = call_list; i < call_count; i++, call++) {
+		struct func_info *func = find_func_by_offset(call->func);
+		unsigned long stamp = call->flags & FUNCF_TIMESTAMP_MASK;
+
+		if (TRACE_CALL_TYPE(call) != FUNCF_ENTRY &&
+		    TRACE_CALL_TYPE(call) != FUNCF_EXIT)
+			continue;
+		if (started)
+			time += (stamp - last) & FUNCF_TIMESTAMP_MASK;
+		started = true;
+		last = stamp;
+		if (!func || !(func->flags & FUNCF_TRACE))
+			continue;
+
+		if (TRACE_CALL_TYPE(call) == FUNCF_ENTRY) {
+			if (depth == MAX_STACK_DEPTH) {
+				error("Call stack too deep at record %d\n", i);
+				return -1;
+			}
+			stack[depth].func = func;
+			stack[depth].start_us = time;
+			depth++;
+			if (ops->enter)
+				ops->enter(ctx, func, time);
+			continue;
+		}
+
+		for (upto = depth - 1; upto >= 0; upto--) {
+			if (stack[upto].func == func)
+				break;
+		}
+		if (upto < 0) {
+			debug("Exit from '%s' without entry\n", func->name);
+			continue;
+		}
+		while (depth > upto) {
+			depth--;
+			ops->exit(ctx, stack[depth].func, stack[depth].start_us,
+				  time);
+		}
+	}
+	while (depth) {
+		depth--;
+		ops->exit(ctx, stack[depth].func, stack[depth].start_us, time);
+	}
+
+	return 0;
+}
+
+static void flame_enter(void *ctx, struct func_info *func,
+			unsigned long time)
+{
+	struct flame_node **nodep = ctx, *node = *nodep, *child;
+
+	for (child = node->child; child; child = child->sibling) {
+		if (child->func == func)
+			break;
+	}
+	if (!child) {
+		child = calloc(1, sizeof(*child));
+		assert(child);
+		child->func = func;
+		child->parent = node;
+		child->sibling = node->child;
+		node->child = child;
+	}
+	*nodep = child;
+}
+
+static void flame_exit(void *ctx, struct func_info *func,
+		       unsigned long start, unsigned long time)
+{
+	struct flame_node **nodep = ctx, *node = *nodep;
+
+	node->total_us += time - start;
+	*nodep = node->parent;
+}
+
+static int flame_print(struct flame_node *node, char *path, int len)
+{
+	unsigned long self_us = node->total_us;
+	struct flame_node *child;
+
+	if (node->func) {
+		len += snprintf(path + len, MAX_PATH_LEN - len, "%s%s",
+				node->parent->func ? ";" : "",
+				node->func->name);
+		if (len >= MAX_PATH_LEN) {
+			error("Call stack too long to print\n");
+			return -1;
+		}
+	}
+	for (child = node->child; child; child = child->sibling) {
+		if (flame_print(child, path, len))
+			return -1;
+		if (child->total_us < self_us)
+			self_us -= child->total_us;
+		else
+			self_us = 0;
+	}
+	path[len] = '\0';
+	if (node->func && self_us)
+		printf("%s %lu\n", path, self_us);
+
+	return 0;
+}
+
+/* Free the children of a node, and their children */
+static void flame_free(struct flame_node *node)
+{
+	struct flame_node *child, *next;
+
+	for (child = node->child; child; child = next) {
+		next = child->sibling;
+		flame_free(child);
+		free(child);
+	}
+	node->child = NULL;
+}
+
+/*
+ * Write out the time spent in each call stack, in the 'folded' format used
+ * by flamegraph.pl:
+ *
+ * board_init_r;initr_dm;dm_init_and_scan;dm_scan_fdt 1250
+ *
+ * Each line shows the time in microseconds spent in the last function
+ * when called from that stack, not including the functions it calls.
+ */
+static int make_flamegraph(void)
+{
+	static const struct walk_ops ops = {
+		.enter	= flame_enter,
+		.exit	= flame_exit,
+	};
+	struct flame_node root, *node = &root;
+	char path[MAX_PATH_LEN];
+	int err;
+
+	memset(&root, '\0', sizeof(root));
+	err = walk_calls(&ops, &node);
+
+	/* The root is not a function, so do not print a time for it */
+	if (!err)
+		err = flame_print(&root, path, 0);
+	flame_free(&root);
+
+	return err;
+}
+
+static void chrome_exit(void *ctx, struct func_info *func,
+			unsigned long start, unsigned long time)
+{
+	int *countp = ctx;
+
+	printf("%s{\"name\":\"%s\",\"ph\":\"X\",", (*countp)++ ? ",\n" : "",
+	       func->name);
+	printf("\"ts\":%lu,\"dur\":%lu,\"pid\":0,\"tid\":0}", start,
+	       time - start);
+}
+
+/*
+ * Write out each function call as a 'complete' event in the Chrome
+ * trace-event format, for viewing in chrome://tracing or Perfetto
+ */
+static int make_chrome(void)
+{
+	static const struct walk_ops ops = {
+		.exit	= chrome_exit,
+	};
+	int count = 0;
+	int err;
+
+	printf("{\"traceEvents\":[\n");
+	err = walk_calls(&ops, &count);
+	printf("\n],\"displayTimeUnit\":\"ms\"}\n");
+	info("chrome: %d events\n", count);
+
+	return err;
+}
+
+static int h_cmp_total(const void *v1, const void *v2)
+{
+	const struct func_info *f1 = *(struct func_info **)v1;
+	const struct func_info *f2 = *(struct func_info **)v2;
+
+	if (f1->total_us != f2->total_us)
+		return f1->total_us < f2->total_us ? 1 : -1;
+
+	return strcmp(f1->name, f2->name);
+}
+
+/*
+ * Write out the call count and total time for each function which was
+ * called, from the 'trace funclist' data, most expensive first
+ */
+static int make_funcs(void)
+{
+	struct func_info **sorted;
+	int i, count;
+
+	sorted = calloc(func_count, sizeof(*sorted));
+	if (!sorted) {
+		error("Cannot allocate function list\n");
+		return -1;
+	}
+	for (i = count = 0; i < func_count; i++) {
+		if (func_list[i].call_count)
+			sorted[count++] = &func_list[i];
+	}
+	qsort(sorted, count, sizeof(*sorted), h_cmp_total);
+
+	printf("%10s %12s  %s\n", "Calls", "Total us", "Function");
+	for (i = 0; i < count; i++)
+		printf("%10lu %12lu  %s\n", sorted[i]->call_count,
+		       sorted[i]->total_us, sorted[i]->name);
+	free(sorted);
+
+	return 0;
+}
+
+/*
+ * Copy the output of 'bootstage export' to stdout, replacing the
+ * "call <address>" names of initcall records with the function name
+ */
+static int make_bootstage(const char *fname)
+{
+	char line[MAX_LINE_LEN], *name, *end;
+	struct func_info *func;
+	unsigned long addr;
+	int count = 0;
+	FILE *fin;
+
+	if (!fname) {
+		error("No bootstage file specified (use -b)\n");
+		return -1;
+	}
+	fin = fopen(fname, "r");
+	if (!fin) {
+		error("Cannot open bootstage file '%s'\n", fname);
+		return -1;
+	}
+	while (fgets(line, sizeof(line), fin)) {
+		func = NULL;
+		name = strstr(line, "\"name\":\"call ");
+		if (name) {
+			name += strlen("\"name\":\"");
+			addr = strtoul(name + strlen("call "), &end, 16);
+			if (*end == '"' && addr >= text_offset)
+				func = find_func_by_offset(addr - text_offset);
+		}
+		if (func) {
+			printf("%.*s%s%s", (int)(name - line), line, func->name,
+			       end);
+			count++;
+		} else {
+			fputs(line, stdout);
+		}
+	}
+	fclose(fin);
+	info("bootstage: %d calls found\n", count);
+
+	return 0;
+}
+
 static int prof_tool(int argc, char * const argv[],
 		     const char *prof_fname, const char *map_fname,
-		     const char *trace_config_fname)
+		     const char *trace_config_fname,
+		     const char *bootstage_fname)
 {
 	int err = 0;
 
@@ -553,6 +897,14 @@ static int prof_tool(int argc, char * const argv[],
 
 		if (0 == strcmp(cmd, "dump-ftrace"))
 			err = make_ftrace();
+		else if (0 == strcmp(cmd, "dump-flamegraph"))
+			err = make_flamegraph();
+		else if (0 == strcmp(cmd, "dump-chrome"))
+			err = make_chrome();
+		else if (0 == strcmp(cmd, "dump-funcs"))
+			err = make_funcs();
+		else if (0 == strcmp(cmd, "dump-bootstage"))
+			err = make_bootstage(bootstage_fname);
 		else
 			warn("Unknown command '%s'\n", cmd);
 	}
@@ -563,13 +915,18 @@ static int prof_tool(int argc, char * const argv[],
 int main(int argc, char *argv[])
 {
 	const char *map_fname = "System.map";
+	const char *bootstage_fname = NULL;
 	const char *prof_fname = NULL;
 	const char *trace_config_fname = NULL;
 	int opt;
 
 	verbose = 2;
-	while ((opt = getopt(argc, argv, "m:p:t:v:")) != -1) {
+	while ((opt = getopt(argc, argv, "b:m:p:t:v:")) != -1) {
 		switch (opt) {
+		case 'b':
+			bootstage_fname = optarg;
+			break;
+
 		case 'm':
 			map_fname = optarg;
 			break;
@@ -596,5 +953,5 @@ int main(int argc, char *argv[])
 
 	debug("Debug enabled\n");
 	return prof_tool(argc, argv, prof_fname, map_fname,
-			 trace_config_fname);
+			 trace_config_fname, bootstage_fname);
 }